@@ -8,10 +8,10 @@ fi
 
 if [ $opttype == "debug" ]; then
     CFLAGS="-g -Wall --coverage"
-    CXXFLAGS="-std=c++11 -Wterminate -g -Wall --coverage"
+    CXXFLAGS="-std=c++17 -Wterminate -g -Wall --coverage"
 elif [ $opttype == "opt" ]; then
     CFLAGS="-O3 -march=native"
-    CXXFLAGS="-std=c++11 -O3 -march=native -g"
+    CXXFLAGS="-std=c++17 -O3 -march=native -g"
     CPPFLAGS_OPT="-DNDEBUG"
 else
     echo "Unknown optimization '$opttype' setting requested."
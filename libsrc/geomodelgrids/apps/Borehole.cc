@@ -3,6 +3,7 @@
 #include "Borehole.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
@@ -27,6 +28,7 @@ geomodelgrids::apps::Borehole::Borehole() :
     _pointsCRS("EPSG:4326"),
     _outputFilename(""),
     _logFilename(""),
+    _ioProfile(""),
     _maxDepth(5000.0),
     _dz(10.0),
     _showHelp(false) {
@@ -58,6 +60,9 @@ geomodelgrids::apps::Borehole::run(int argc,
         errorHandler->setLogFilename(_logFilename.c_str());
         errorHandler->setLoggingOn(true);
     } // if
+    if (!_ioProfile.empty()) {
+        query.setIOProfile(geomodelgrids::serial::IOProfile::fromString(_ioProfile.c_str()));
+    } // if
     query.initialize(_modelFilenames, _valueNames, _pointsCRS);
 
     const double groundOffset = -1.0e-6;
@@ -78,21 +83,26 @@ geomodelgrids::apps::Borehole::run(int argc,
     } // if
     sout << _createOutputHeader(argc, argv);
 
+    // Query all points along borehole as a single profile.
+    std::vector<double> elevations(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        elevations[iPt] = groundSurf - _dz*iPt;
+    } // for
     const size_t numQueryValues = _valueNames.size();
-    std::vector<double> values(numQueryValues);
+    std::vector<double> values(numPoints*numQueryValues);
+    query.queryProfile(values.data(), nullptr, _location[0], _location[1], elevations.data(), numPoints);
+
     sout << std::scientific << std::setprecision(6);
     for (size_t iPt = 0; iPt < numPoints; ++iPt) {
-        const double elevation = groundSurf - _dz*iPt;
-        query.query(&values[0], _location[0], _location[1], elevation);
-
+        const double elevation = elevations[iPt];
         const double depth = groundSurf - elevation;
         sout << std::setw(_Borehole::cwidth) << elevation
              << std::setw(_Borehole::cwidth) << depth;
         for (size_t i = 0; i < numQueryValues; ++i) {
-            sout << std::setw(_Borehole::cwidth) << values[i];
+            sout << std::setw(_Borehole::cwidth) << values[iPt*numQueryValues+i];
         } // for
         sout << "\n";
-    } // while
+    } // for
 
     query.finalize();
 
@@ -115,12 +125,13 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
+        {"io-profile", required_argument, nullptr, 'i'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:d:o:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:d:o:r:p:c:o:l:m:i:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -173,6 +184,10 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
             } // while
             break;
         } // 'm'
+        case 'i': {
+            _ioProfile = optarg;
+            break;
+        } // 'i'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -220,7 +235,8 @@ void
 geomodelgrids::apps::Borehole::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_borehole "
               << "[--help] [--log=FILE_LOG] --location=X,Y --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
-              << "--output=FILE_OUTPUT [--max-depth=Z] [--dz=RESOLUTION] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "--output=FILE_OUTPUT [--max-depth=Z] [--dz=RESOLUTION] [--points-coordsys=PROJ|EPSG|WKT] "
+              << "[--io-profile=PROFILE]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --location=X,Y                   Location of virtual borehole in point coordinate system.\n"
@@ -231,7 +247,9 @@ geomodelgrids::apps::Borehole::_printHelp(void) {
               << "vertical units (default=5000m).\n"
               << "    --dz=RESOLUTION                  Vertical resolution of query points in virtual borehole "
               << "in point coordinate system vertical units (default=10m).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --io-profile=PROFILE             Parameters for reading models (preset default|borehole|grid "
+              << "and/or KEY=VALUE,...)."
               << std::endl;
 } // _printHelp
 
@@ -31,6 +31,7 @@ public:
      *   --max-depth=DEPTH
      *   --dz=RESOLUTION
      *   --points-coordsys=PROJ|EPSG|WKT
+     *   --io-profile=PROFILE
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -70,6 +71,7 @@ private:
     std::string _pointsCRS;
     std::string _outputFilename;
     std::string _logFilename;
+    std::string _ioProfile;
     double _maxDepth;
     double _location[2];
     double _dz;
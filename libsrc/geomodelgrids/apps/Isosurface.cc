@@ -3,6 +3,8 @@
 #include "Isosurface.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryContext.hh" // USES QueryContext
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 #include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
 #include "geomodelgrids/utils/GeoTiff.hh" // USES GeoTiff
@@ -15,11 +17,34 @@
 #include <iomanip>
 #include <fstream> // USES std::ofstream
 #include <sstream> // USES std::ostringstream, std::istringstream
+#include <thread> // USES std::thread
+#include <mutex> // USES std::mutex, std::lock_guard
+#include <atomic> // USES std::atomic
+#include <exception> // USES std::exception_ptr
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
 
 namespace geomodelgrids {
     namespace apps {
+        namespace _Isosurface {
+            /** Check whether target value lies between two values.
+             *
+             * @param[in] vA First value.
+             * @param[in] vB Second value.
+             * @param[in] vTarget Target value.
+             * @returns True if vTarget is between vA and vB (inclusive), false otherwise.
+             */
+            inline
+            bool isBracketed(const double vA,
+                             const double vB,
+                             const double vTarget) {
+                return ((vA <= vTarget) && (vTarget <= vB)) || ((vA >= vTarget) && (vTarget >= vB));
+            } // isBracketed
+
+            /// Number of raster rows computed and written at a time when the output is not tiled.
+            static const size_t numStripRows = 256;
+        } // _Isosurface
+
         // ----------------------------------------------------------------------------------------
         class Isosurfacer {
 public:
@@ -27,6 +52,8 @@ public:
             typedef std::pair<std::string,double> isosurface_t;
 
             Isosurfacer(const Isosurface& app);
+            Isosurfacer(const Isosurface& app,
+                        geomodelgrids::serial::Query* query);
             ~Isosurfacer(void);
 
             geomodelgrids::serial::Query* getQuery(void) const;
@@ -41,75 +68,25 @@ public:
 
 private:
 
+            /// Interval along profile containing the crossing of an isosurface value.
+            struct Bracket {
+                double zTop; ///< Elevation of top of interval.
+                double zBot; ///< Elevation of bottom of interval.
+                double vTop; ///< Value at top of interval.
+                double vBot; ///< Value at bottom of interval.
+                size_t iPoint; ///< Index of midpoint in profile buffer.
+            }; // Bracket
+
             const Isosurface& _app;
             geomodelgrids::serial::Query* _query;
-            size_t _numLevels;
-            std::vector<double> _vbuffer;
+            geomodelgrids::serial::QueryContext* _context;
+            bool _isSharedQuery; ///< True if query is owned by another isosurfacer.
+            std::vector<Bracket> _brackets; ///< Bracket for each isosurface.
+            std::vector<double> _zbuffer; ///< Elevations of points in profile.
+            std::vector<double> _vbuffer; ///< Values at points in profile.
 
         }; // Isosurfacer
 
-        // ----------------------------------------------------------------------------------------
-        class LineSearch {
-public:
-
-            LineSearch(geomodelgrids::serial::Query* query,
-                       std::vector<double>& vbuffer,
-                       const size_t numSeachPoints,
-                       const double x,
-                       const double y);
-
-            virtual ~LineSearch(void);
-
-            virtual
-            size_t search(const double zTop,
-                          const double zBot,
-                          const double dz,
-                          const double vTarget,
-                          const size_t iValue) = 0;
-
-protected:
-
-            geomodelgrids::serial::Query* _query;
-            std::vector<double>& _vbuffer;
-            const size_t _numSearchPoints;
-            const double _x;
-            const double _y;
-
-        }; // LineSearch
-
-        class LineSearchDown : public LineSearch {
-public:
-
-            LineSearchDown(geomodelgrids::serial::Query* query,
-                           std::vector<double>& vbuffer,
-                           const size_t numSeachPoints,
-                           const double x,
-                           const double y);
-
-            size_t search(const double zTop,
-                          const double zBot,
-                          const double dz,
-                          const double vTarget,
-                          const size_t iValue);
-
-        }; // LineSearchDown
-
-        class LineSearchUp : public LineSearch {
-public:
-
-            LineSearchUp(geomodelgrids::serial::Query* query,
-                         std::vector<double>& vbuffer,
-                         const size_t numSeachPoints,
-                         const double x,
-                         const double y);
-
-            size_t search(const double zTop,
-                          const double zBot,
-                          const double dz,
-                          const double vTarget,
-                          const size_t iValue);
-
-        }; // LineSearchUp
     } // apps
 } // geomodelgrids
 
@@ -119,6 +96,7 @@ geomodelgrids::apps::Isosurface::Isosurface(void) :
     _bboxCRS("EPSG:4326"),
     _outputFilename(""),
     _logFilename(""),
+    _ioProfile(""),
     _minX(geomodelgrids::NODATA_VALUE),
     _maxX(geomodelgrids::NODATA_VALUE),
     _minY(geomodelgrids::NODATA_VALUE),
@@ -127,8 +105,11 @@ geomodelgrids::apps::Isosurface::Isosurface(void) :
     _vertRes(10.0),
     _maxDepth(0.0),
     _numSearchPoints(10),
+    _numThreads(1),
+    _tileSize(256),
     _depthSurface(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY),
     _preferShallow(true),
+    _cloudOptimized(false),
     _showHelp(false) {
     _isosurfaces.resize(2);
     _isosurfaces[0] = Isosurfacer::isosurface_t("Vs", 1.0e+3);
@@ -192,28 +173,102 @@ geomodelgrids::apps::Isosurface::run(int argc,
         writer.setCRS(_bboxCRS.c_str());
         writer.setBBox(_minX, _maxX, _minY, _maxY);
         writer.setNoDataValue(geomodelgrids::NODATA_VALUE);
+        writer.setTileSize(_tileSize);
+        writer.setCloudOptimized(_cloudOptimized);
         writer.create(_outputFilename.c_str());
 
-        std::vector<double> values(numIsosurfaces);
-        float* buffer = writer.getBands();
-        for (size_t iY = 0, iPt = 0; iY < numY; ++iY) {
-            const size_t row = numY - iY - 1;
-            const double y = _minY + (iY + 0.5) * _horizRes;
-            double xCRS, yCRS;
-
-            for (size_t iX = 0; iX < numX; ++iX, ++iPt) {
-                const size_t col = iX;
-                const double x = _minX + (iX + 0.5) * _horizRes;
-
-                toXYOrder->inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
-                isosurfacer.query(&values[0], xCRS, yCRS);
-                for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
-                    buffer[iValue*numY*numX + row*numX + col] = values[iValue];
+        // Raster rows are computed and written in blocks (one row of tiles when tiled), so memory
+        // does not depend on the size of the raster. Within a block, each thread takes the next row
+        // that has not been computed, so threads fill disjoint rows.
+        const size_t numBlockRows = std::min(numY, (_tileSize > 0) ? _tileSize : _Isosurface::numStripRows);
+        std::vector<float> buffer(numIsosurfaces*numBlockRows*numX);
+        std::atomic<size_t> nextRow(0);
+        size_t blockRowStart = 0;
+        size_t blockNumRows = 0;
+        auto computeRows = [&](Isosurfacer* rowIsosurfacer,
+                               geomodelgrids::utils::CRSTransformer* rowToXYOrder) {
+            std::vector<double> values(numIsosurfaces);
+            const size_t blockRowEnd = blockRowStart + blockNumRows;
+            for (size_t row = nextRow++; row < blockRowEnd; row = nextRow++) {
+                const size_t iY = numY - row - 1;
+                const double y = _minY + (iY + 0.5) * _horizRes;
+                double xCRS, yCRS;
+
+                float* rowBuffer = &buffer[(row - blockRowStart)*numX];
+                for (size_t iX = 0; iX < numX; ++iX) {
+                    const size_t col = iX;
+                    const double x = _minX + (iX + 0.5) * _horizRes;
+
+                    rowToXYOrder->inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
+                    rowIsosurfacer->query(&values[0], xCRS, yCRS);
+                    for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
+                        rowBuffer[iValue*blockNumRows*numX + col] = values[iValue];
+                    } // for
                 } // for
             } // for
+        };
+
+        // Each thread uses its own isosurfacer (query context) and CRS transformer.
+        const size_t numThreads = std::min(_numThreads, numBlockRows);
+        std::vector<Isosurfacer*> isosurfacers;
+        std::vector<geomodelgrids::utils::CRSTransformer*> transformers;
+        std::exception_ptr error;
+        try {
+            for (size_t iThread = 0; iThread < numThreads && numThreads > 1; ++iThread) {
+                isosurfacers.push_back(new Isosurfacer(*this, isosurfacer.getQuery()));
+                isosurfacers.back()->initialize();
+                transformers.push_back(toXYOrder->clone());
+            } // for
+
+            for (blockRowStart = 0; blockRowStart < numY; blockRowStart += blockNumRows) {
+                blockNumRows = std::min(numBlockRows, numY - blockRowStart);
+                nextRow = blockRowStart;
+                if (numThreads > 1) {
+                    std::vector<std::thread> threads;
+                    std::mutex errorMutex;
+                    try {
+                        for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+                            threads.push_back(std::thread([&, iThread]() {
+                                try {
+                                    computeRows(isosurfacers[iThread], transformers[iThread]);
+                                } catch (...) {
+                                    std::lock_guard<std::mutex> lock(errorMutex);
+                                    if (!error) {
+                                        error = std::current_exception();
+                                    } // if
+                                    nextRow = numY;
+                                } // try/catch
+                            }));
+                        } // for
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        } // if
+                        nextRow = numY;
+                    } // try/catch
+                    for (size_t iThread = 0; iThread < threads.size(); ++iThread) {
+                        threads[iThread].join();
+                    } // for
+                    if (error) {
+                        break;
+                    } // if
+                } else {
+                    computeRows(&isosurfacer, toXYOrder);
+                } // if/else
+                writer.writeRows(buffer.data(), blockRowStart, blockNumRows);
+            } // for
+        } catch (...) {
+            error = std::current_exception();
+        } // try/catch
+        for (size_t iThread = 0; iThread < isosurfacers.size(); ++iThread) {
+            delete isosurfacers[iThread];isosurfacers[iThread] = nullptr;
+            delete transformers[iThread];transformers[iThread] = nullptr;
         } // for
+        if (error) {
+            std::rethrow_exception(error);
+        } // if
         delete toXYOrder;toXYOrder = nullptr;
-        writer.write();
         writer.close();
         isosurfacer.finalize();
     } catch (const std::exception& err) {
@@ -234,7 +289,7 @@ geomodelgrids::apps::Isosurface::run(int argc,
 void
 geomodelgrids::apps::Isosurface::_parseArgs(int argc,
                                             char* argv[]) {
-    static struct option options[14] = {
+    static struct option options[18] = {
         {"help", no_argument, nullptr, 'h'},
         {"log", required_argument, nullptr, 'l'},
         {"bbox", required_argument, nullptr, 'b'},
@@ -248,13 +303,17 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"prefer-deep", no_argument, nullptr, 'p'},
         {"bbox-coordsys", required_argument, nullptr, 'c'},
+        {"io-profile", required_argument, nullptr, 'f'},
+        {"threads", required_argument, nullptr, 't'},
+        {"tile-size", required_argument, nullptr, 'T'},
+        {"cloud-optimized", no_argument, nullptr, 'C'},
         {0, 0, 0, 0}
     };
 
     _isosurfaces.clear();
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:f:t:T:C", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -343,6 +402,36 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
             _bboxCRS = optarg;
             break;
         } // 'c'
+        case 'f': {
+            _ioProfile = optarg;
+            break;
+        } // 'f'
+        case 't': {
+            size_t numChars = 0;
+            int numThreads = 0;
+            try {
+                numThreads = std::stoi(optarg, &numChars);
+            } catch (const std::exception&) {
+                numChars = 0;
+            } // try/catch
+            if (!numChars || optarg[numChars] || (numThreads <= 0)) {
+                throw std::invalid_argument(std::string("Number of threads for --threads must be a positive integer. Got '") + optarg + "'.");
+            } // if
+            _numThreads = size_t(numThreads);
+            break;
+        } // 't'
+        case 'T': {
+            const int tileSize = std::stoi(optarg);
+            if ((tileSize < 0) || (tileSize % 16)) {
+                throw std::invalid_argument(std::string("Tile size must be a nonnegative multiple of 16. Got '") + optarg + "'.");
+            } // if
+            _tileSize = size_t(tileSize);
+            break;
+        } // 'T'
+        case 'C': {
+            _cloudOptimized = true;
+            break;
+        } // 'C'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -425,7 +514,8 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "[--help] [--log=FILE_LOG] --bbox=XMIN,XMAX,YMIN,YMAX --hresolution=RESOLUTION "
               << "[--vresolution=RESOLUTION] --isosurface=NAME,VALUE [--depth-reference=SURFACE] "
               << "--max-depth=DEPTH [--num-search-points=NUM] --models=FILE_0,...,FILE_M --output=FILE_OUTPUT "
-              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT]\n\n"
+              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT] [--io-profile=PROFILE] [--threads=NUM_THREADS] "
+              << "[--tile-size=SIZE] [--cloud-optimized]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --bbox=XMIN,XMAX,YMIN,YMAX       Bounding box for iosurface.\n"
@@ -434,14 +524,20 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "    --depth-reference=SURFACE        Surface to use for calculating depth "
               << "(default=topography_bathymetry)\n"
               << "    --max-depth=DEPTH                Maximum depth allowed for isosurface.\n"
-              << "    --num-search-points=NUM          Number of search points in each iteration (default=10).\n"
+              << "    --num-search-points=NUM          Number of search points in initial sweep (default=10).\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --hresolution=RESOLUTION         Horizontal resolution of isosurface.\n"
               << "    --vresolution=RESOLUTION         Vertical resolution for depth of isosurface (default=10.0).\n"
               << "    --prefer-deep                    Prefer deepest elevation for isosurface rather than "
               << "shallowest (default=shallowest).\n"
-              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326)."
+              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326).\n"
+              << "    --io-profile=PROFILE             Parameters for reading models (preset default|borehole|grid "
+              << "and/or KEY=VALUE,...).\n"
+              << "    --threads=NUM_THREADS            Number of threads computing rows of isosurface (default=1).\n"
+              << "    --tile-size=SIZE                 Width and height of tiles in output (multiple of 16, 0 for "
+              << "strips, default=256).\n"
+              << "    --cloud-optimized                Write output as cloud optimized GeoTiff with overviews."
               << std::endl;
 } // _printHelp
 
@@ -449,32 +545,61 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::Isosurfacer::Isosurfacer(const Isosurface& app) :
     _app(app),
-    _query(nullptr) {}
+    _query(nullptr),
+    _context(nullptr),
+    _isSharedQuery(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor for isosurfacer using query initialized by another isosurfacer with its own query context.
+geomodelgrids::apps::Isosurfacer::Isosurfacer(const Isosurface& app,
+                                              geomodelgrids::serial::Query* query) :
+    _app(app),
+    _query(query),
+    _context(nullptr),
+    _isSharedQuery(true) {
+    assert(_query);
+}
 
 
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::Isosurfacer::~Isosurfacer(void) {
-    delete _query;_query = nullptr;
+    if (_isSharedQuery) {
+        delete _context;_context = nullptr;
+    } else {
+        _context = nullptr;
+        delete _query;_query = nullptr;
+    } // if/else
 }
 
 
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::apps::Isosurfacer::initialize(void) {
-    delete _query;_query = new geomodelgrids::serial::Query();assert(_query);
-
-    const size_t numIsosurfaces = _app._isosurfaces.size();
-    std::vector<std::string> valueNames(numIsosurfaces);
-    for (size_t i = 0; i < numIsosurfaces; ++i) {
-        valueNames[i] = _app._isosurfaces[i].first;
-    } // for
-    _query->initialize(_app._modelFilenames, valueNames, _app._bboxCRS);
-
-    _numLevels = size_t(ceil(log(_app._maxDepth/_app._vertRes) / log(_app._numSearchPoints)));
-    assert(_numLevels >= 1);
+    if (_isSharedQuery) {
+        assert(_query);
+        delete _context;_context = new geomodelgrids::serial::QueryContext(*_query);assert(_context);
+    } else {
+        delete _query;_query = new geomodelgrids::serial::Query();assert(_query);
+
+        const size_t numIsosurfaces = _app._isosurfaces.size();
+        std::vector<std::string> valueNames(numIsosurfaces);
+        for (size_t i = 0; i < numIsosurfaces; ++i) {
+            valueNames[i] = _app._isosurfaces[i].first;
+        } // for
+        if (!_app._ioProfile.empty()) {
+            _query->setIOProfile(geomodelgrids::serial::IOProfile::fromString(_app._ioProfile.c_str()));
+        } // if
+        _query->initialize(_app._modelFilenames, valueNames, _app._bboxCRS);
+        _context = _query->getContext();assert(_context);
+    } // if/else
 
+    // Buffers hold the points of the sweep or one bisection step for all isosurfaces.
     const size_t numValues = _app._isosurfaces.size();
-    _vbuffer.resize(numValues);
+    const size_t numPoints = std::max(size_t(_app._numSearchPoints), numValues);
+    _brackets.resize(numValues);
+    _zbuffer.resize(numPoints);
+    _vbuffer.resize(numPoints*numValues);
 }
 
 
@@ -486,70 +611,140 @@ geomodelgrids::apps::Isosurfacer::getQuery(void) const {
 
 
 // ------------------------------------------------------------------------------------------------
+// Find depth of isosurfaces at point.
+//
+// A single sweep down the column brackets the crossing of every isosurface value, and the brackets
+// are refined together by bisection, so each query returns the values needed by all isosurfaces.
 void
 geomodelgrids::apps::Isosurfacer::query(double* values,
                                         const double x,
                                         const double y) {
     assert(values);
     assert(_query);
+    assert(_context);
 
+    const size_t numValues = _app._isosurfaces.size();
     double topElev = 0.0;
     switch (_app._depthSurface) {
     case geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY:
-        topElev = _query->queryTopoBathyElevation(x, y);
+        topElev = _query->queryTopoBathyElevation(x, y, _context);
         break;
     case geomodelgrids::serial::Query::SQUASH_TOP_SURFACE:
-        topElev = _query->queryTopElevation(x, y);
+        topElev = _query->queryTopElevation(x, y, _context);
         break;
     default:
         throw std::logic_error("Unknown top surface in Isosurfacer::query().");
     } // switch
     if (topElev == geomodelgrids::NODATA_VALUE) {
-        const size_t numValues = _vbuffer.size();
         for (size_t iValue = 0; iValue < numValues; ++iValue) {
             values[iValue] = geomodelgrids::NODATA_VALUE;
         } // for
         return;
     } // if
 
-    LineSearch* lineSearch = _app._preferShallow ?
-                             (LineSearch*) new LineSearchDown(_query, _vbuffer, _app._numSearchPoints, x, y) :
-                             (LineSearch*) new LineSearchUp(_query, _vbuffer, _app._numSearchPoints, x, y);
+    // Sweep down column.
+    const size_t numSearchPoints = _app._numSearchPoints;
+    const double zTop = topElev - 1.0e-4;
+    const double zBot = topElev - _app._maxDepth;
+    assert(zTop > zBot);
+    const double dz = (zTop - zBot) / (numSearchPoints-1);
+    for (size_t iPt = 0; iPt < numSearchPoints; ++iPt) {
+        _zbuffer[iPt] = zTop - iPt*dz;
+    } // for
+    _query->queryProfile(&_vbuffer[0], nullptr, x, y, &_zbuffer[0], numSearchPoints, _context);
 
-    const size_t numValues = _vbuffer.size();
+    // Bracket shallowest (or deepest) crossing of each isosurface value. Without a crossing, the
+    // bracket is the top interval.
     for (size_t iValue = 0; iValue < numValues; ++iValue) {
         const double vTarget = _app._isosurfaces[iValue].second;
-        double zTop = topElev - 1.0e-4;
-        double zBot = topElev - _app._maxDepth;
-        assert(zTop > zBot);
-
-        for (size_t iLevel = 0; iLevel < _numLevels; ++iLevel) {
-            const double dz = (zTop - zBot) / (_app._numSearchPoints-1);
-            const size_t iTop = lineSearch->search(zTop, zBot, dz, vTarget, iValue);
-            zTop -= iTop*dz;
-            zBot = zTop - dz;
+        size_t iTop = 0;
+        if (_app._preferShallow) {
+            for (size_t iPt = 1; iPt < numSearchPoints; ++iPt) {
+                if (_vbuffer[iPt*numValues+iValue] >= vTarget) {
+                    iTop = iPt - 1;
+                    break;
+                } // if
+            } // for
+        } else {
+            for (size_t iPt = numSearchPoints-1; iPt > 0; --iPt) {
+                if (_vbuffer[(iPt-1)*numValues+iValue] < vTarget) {
+                    iTop = iPt - 1;
+                    break;
+                } // if
+            } // for
+        } // if/else
+
+        Bracket& bracket = _brackets[iValue];
+        bracket.zTop = _zbuffer[iTop];
+        bracket.zBot = _zbuffer[iTop+1];
+        bracket.vTop = _vbuffer[iTop*numValues+iValue];
+        bracket.vBot = _vbuffer[(iTop+1)*numValues+iValue];
+    } // for
+
+    // Refine brackets by bisection to vertical resolution. Isosurfaces with the same bracket share
+    // the query at the midpoint.
+    const size_t noPoint = size_t(-1);
+    while (true) {
+        size_t numPoints = 0;
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            Bracket& bracket = _brackets[iValue];
+            const double vTarget = _app._isosurfaces[iValue].second;
+            bracket.iPoint = noPoint;
+            if (!_Isosurface::isBracketed(bracket.vTop, bracket.vBot, vTarget) ||
+                (bracket.zTop - bracket.zBot <= _app._vertRes)) {
+                continue;
+            } // if
+
+            const double zMid = 0.5 * (bracket.zTop + bracket.zBot);
+            size_t iPoint = 0;
+            while (iPoint < numPoints && _zbuffer[iPoint] != zMid) {
+                ++iPoint;
+            } // while
+            if (iPoint == numPoints) {
+                _zbuffer[numPoints++] = zMid;
+            } // if
+            bracket.iPoint = iPoint;
         } // for
+        if (!numPoints) {
+            break;
+        } // if
 
-        // Final interpolation
-        _query->query(&_vbuffer[0], x, y, zTop);
-        const double vTop = _vbuffer[iValue];
+        _query->queryProfile(&_vbuffer[0], nullptr, x, y, &_zbuffer[0], numPoints, _context);
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            Bracket& bracket = _brackets[iValue];
+            if (noPoint == bracket.iPoint) {
+                continue;
+            } // if
 
-        _query->query(&_vbuffer[0], x, y, zBot);
-        const double vBot = _vbuffer[iValue];
+            const double vTarget = _app._isosurfaces[iValue].second;
+            const double zMid = _zbuffer[bracket.iPoint];
+            const double vMid = _vbuffer[bracket.iPoint*numValues+iValue];
+            const bool inTop = _Isosurface::isBracketed(bracket.vTop, vMid, vTarget);
+            const bool inBot = _Isosurface::isBracketed(vMid, bracket.vBot, vTarget);
+            if ((inTop && _app._preferShallow) || !inBot) {
+                bracket.zBot = zMid;
+                bracket.vBot = vMid;
+            } else {
+                bracket.zTop = zMid;
+                bracket.vTop = vMid;
+            } // if/else
+        } // for
+    } // while
 
-        if (((vTop <= vTarget) && (vTarget <= vBot)) || ((vTop >= vTarget) && (vTarget >= vBot))) {
-            const double a = (vTop-vBot) / (zTop-zBot);
-            const double b = vTop - a*zTop;
+    // Final interpolation
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        const Bracket& bracket = _brackets[iValue];
+        const double vTarget = _app._isosurfaces[iValue].second;
+        if (_Isosurface::isBracketed(bracket.vTop, bracket.vBot, vTarget)) {
+            const double a = (bracket.vTop-bracket.vBot) / (bracket.zTop-bracket.zBot);
+            const double b = bracket.vTop - a*bracket.zTop;
             values[iValue] = topElev - (vTarget - b) / a;
-        } else if (vTarget < vTop) {
+        } else if (vTarget < bracket.vTop) {
             values[iValue] = 0.0;
         } else {
             values[iValue] = geomodelgrids::NODATA_VALUE;
         } // if/else
-
     } // for
-
-    delete lineSearch;lineSearch = nullptr;
 }
 
 
@@ -557,86 +752,10 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
 void
 geomodelgrids::apps::Isosurfacer::finalize(void) {
     assert(_query);
-    _query->finalize();
-}
-
-
-// ------------------------------------------------------------------------------------------------
-geomodelgrids::apps::LineSearch::LineSearch(geomodelgrids::serial::Query* query,
-                                            std::vector<double>& vbuffer,
-                                            const size_t numSeachPoints,
-                                            const double x,
-                                            const double y) :
-    _query(query),
-    _vbuffer(vbuffer),
-    _numSearchPoints(numSeachPoints),
-    _x(x),
-    _y(y) {}
-
-
-// ------------------------------------------------------------------------------------------------
-geomodelgrids::apps::LineSearch::~LineSearch(void) {}
-
-
-// ------------------------------------------------------------------------------------------------
-geomodelgrids::apps::LineSearchDown::LineSearchDown(geomodelgrids::serial::Query* query,
-                                                    std::vector<double>& vbuffer,
-                                                    const size_t numSeachPoints,
-                                                    const double x,
-                                                    const double y) :
-    LineSearch(query, vbuffer, numSeachPoints, x, y) {}
-
-
-// ------------------------------------------------------------------------------------------------
-size_t
-geomodelgrids::apps::LineSearchDown::search(const double zTop,
-                                            const double zBot,
-                                            const double dz,
-                                            const double vTarget,
-                                            const size_t iValue) {
-    size_t iTop = 0;
-    for (size_t iPt = 1; iPt < _numSearchPoints; ++iPt) {
-        const double z = zTop - iPt*dz;
-        _query->query(&_vbuffer[0], _x, _y, z);
-        const double v = _vbuffer[iValue];
-        if (v >= vTarget) {
-            iTop = iPt - 1;
-            break;
-        } // if
-
-    } // for
-    return iTop;
-}
-
-
-// ------------------------------------------------------------------------------------------------
-geomodelgrids::apps::LineSearchUp::LineSearchUp(geomodelgrids::serial::Query* query,
-                                                std::vector<double>&vbuffer,
-                                                const size_t numSeachPoints,
-                                                const double x,
-                                                const double y) :
-    LineSearch(query, vbuffer, numSeachPoints, x, y) {}
-
-
-// ------------------------------------------------------------------------------------------------
-size_t
-geomodelgrids::apps::LineSearchUp::search(const double zTop,
-                                          const double zBot,
-                                          const double dz,
-                                          const double vTarget,
-                                          const size_t iValue) {
-    size_t iTop = 0;
-    for (size_t iPt = 1; iPt < _numSearchPoints; ++iPt) {
-        const double z = zBot + iPt * dz;
-        _query->query(&_vbuffer[0], _x, _y, z);
-        const double v = _vbuffer[iValue];
-        if (v < vTarget) {
-            iTop = _numSearchPoints - iPt - 1;
-            break;
-        } // if
-
-    } // for
-    return iTop;
+    if (!_isSharedQuery) {
+        _context = nullptr;
+        _query->finalize();
+    } // if
 }
 
 
@@ -38,6 +38,10 @@ public:
      *   --output=FILE_OUTPUT
      *   --prefer-deep
      *   --bbox-coordsys=PROJ|EPSG|WKT
+     *   --io-profile=PROFILE
+     *   --threads=NUM_THREADS
+     *   --tile-size=SIZE
+     *   --cloud-optimized
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -77,6 +81,7 @@ private:
     std::string _bboxCRS;
     std::string _outputFilename;
     std::string _logFilename;
+    std::string _ioProfile;
     double _minX;
     double _maxX;
     double _minY;
@@ -85,8 +90,11 @@ private:
     double _vertRes;
     double _maxDepth;
     int _numSearchPoints;
+    size_t _numThreads;
+    size_t _tileSize;
     geomodelgrids::serial::Query::SquashingEnum _depthSurface;
     bool _preferShallow;
+    bool _cloudOptimized;
     bool _showHelp;
 
     // NOT IMPLEMENTED /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,648 @@
+#include <portinfo>
+
+#include "PointsReader.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5::getMutex()
+
+#include <hdf5.h> // USES H5Fopen(), H5Dread()
+#include <mutex> // USES std::lock_guard
+
+#include <cstdio> // USES FILE, fopen(), fread()
+#include <cstdlib> // USES strtod()
+#include <cstring> // USES memcpy()
+#include <cstdint> // USES uint8_t, uint16_t, uint32_t
+#include <cctype> // USES isspace()
+#include <algorithm> // USES std::min(), std::reverse()
+#include <vector> // USES std::vector
+#include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::runtime_error
+#include <cassert> // USES assert()
+
+#include <charconv> // USES std::from_chars()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace apps {
+        namespace _PointsReader {
+            static const size_t bufferSize = 1 << 20; ///< Size of buffer for reading text (bytes).
+
+            /** Open file for reading.
+             *
+             * @param[in] filename Name of file ('-' for stdin).
+             * @param[in] mode Mode for fopen().
+             * @returns File (stdin if filename is '-').
+             */
+            FILE* openFile(const std::string& filename,
+                           const char* mode);
+
+            /** Is the byte order of the host little-endian?
+             *
+             * @returns True if the host is little-endian, false otherwise.
+             */
+            bool isLittleEndian(void);
+
+            /** Reverse byte order of float64 values.
+             *
+             * @param[inout] values Array of values.
+             * @param[in] numValues Number of values.
+             */
+            void swapBytes(double* const values,
+                           const size_t numValues);
+
+            class TextReader;
+            class RawReader;
+            class NpyReader;
+            class HDF5Reader;
+        } // _PointsReader
+    } // apps
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Reader for whitespace separated coordinates.
+class geomodelgrids::apps::_PointsReader::TextReader : public geomodelgrids::apps::PointsReader {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file ('-' for stdin).
+     */
+    TextReader(const std::string& filename);
+
+    /// Destructor.
+    ~TextReader(void);
+
+    /** Read next batch of points.
+     *
+     * @param[out] points Array of point coordinates [maxPoints*3].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of input).
+     */
+    size_t read(double* const points,
+                const size_t maxPoints);
+
+private:
+
+    /** Parse next value.
+     *
+     * @param[out] value Value.
+     * @returns True if a value was parsed, false at end of input or if next token is not a number.
+     */
+    bool _parseValue(double* value);
+
+    /** Move unparsed characters to start of buffer and fill remainder of buffer.
+     *
+     * @returns True if any characters were read, false otherwise.
+     */
+    bool _fill(void);
+
+    FILE* _file; ///< Input file.
+    std::vector<char> _buffer; ///< Buffer with characters read from file (null terminated).
+    size_t _pos; ///< Index of next character to parse.
+    size_t _end; ///< Index after last character read.
+    bool _endOfInput; ///< True if no more points can be parsed.
+}; // TextReader
+
+// ------------------------------------------------------------------------------------------------
+// Reader for little-endian float64 coordinates.
+class geomodelgrids::apps::_PointsReader::RawReader : public geomodelgrids::apps::PointsReader {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file ('-' for stdin).
+     */
+    RawReader(const std::string& filename);
+
+    /// Destructor.
+    ~RawReader(void);
+
+    /** Read next batch of points.
+     *
+     * @param[out] points Array of point coordinates [maxPoints*3].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of input).
+     */
+    size_t read(double* const points,
+                const size_t maxPoints);
+
+protected:
+
+    /** Read bytes until count is reached or end of input.
+     *
+     * @param[out] buffer Buffer for bytes.
+     * @param[in] numBytes Number of bytes to read.
+     * @returns Number of bytes read.
+     */
+    size_t _readBytes(void* buffer,
+                      const size_t numBytes);
+
+    FILE* _file; ///< Input file.
+    size_t _numRemaining; ///< Maximum number of points remaining in input.
+    bool _isLittleEndian; ///< True if values are little-endian.
+}; // RawReader
+
+// ------------------------------------------------------------------------------------------------
+// Reader for NumPy array.
+class geomodelgrids::apps::_PointsReader::NpyReader : public geomodelgrids::apps::_PointsReader::RawReader {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file ('-' for stdin).
+     */
+    NpyReader(const std::string& filename);
+
+    /// Destructor.
+    ~NpyReader(void);
+
+private:
+
+    /** Get value of key in NumPy header.
+     *
+     * @param[in] header NumPy header (Python dictionary literal).
+     * @param[in] key Name of key.
+     * @returns Value of key as text.
+     */
+    static
+    std::string _getHeaderValue(const std::string& header,
+                                const std::string& key);
+
+}; // NpyReader
+
+// ------------------------------------------------------------------------------------------------
+// Reader for HDF5 dataset.
+class geomodelgrids::apps::_PointsReader::HDF5Reader : public geomodelgrids::apps::PointsReader {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of HDF5 file.
+     * @param[in] dataset Path of dataset in file.
+     */
+    HDF5Reader(const std::string& filename,
+               const std::string& dataset);
+
+    /// Destructor.
+    ~HDF5Reader(void);
+
+    /** Read next batch of points.
+     *
+     * @param[out] points Array of point coordinates [maxPoints*3].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of input).
+     */
+    size_t read(double* const points,
+                const size_t maxPoints);
+
+private:
+
+    /// Close HDF5 objects (caller holds HDF5 mutex).
+    void _close(void);
+
+    hid_t _file; ///< HDF5 file.
+    hid_t _dataset; ///< HDF5 dataset.
+    hid_t _dataspace; ///< Dataspace of dataset.
+    hsize_t _numPoints; ///< Number of points in dataset.
+    hsize_t _offset; ///< Index of next point to read.
+}; // HDF5Reader
+
+// ------------------------------------------------------------------------------------------------
+// Create reader and open input.
+geomodelgrids::apps::PointsReader*
+geomodelgrids::apps::PointsReader::create(const std::string& format,
+                                          const std::string& filename,
+                                          const std::string& dataset) {
+    if (format == "text") {
+        return new _PointsReader::TextReader(filename);
+    } else if (format == "raw") {
+        return new _PointsReader::RawReader(filename);
+    } else if (format == "npy") {
+        return new _PointsReader::NpyReader(filename);
+    } else if (format == "hdf5") {
+        return new _PointsReader::HDF5Reader(filename, dataset);
+    } // if/else
+
+    std::ostringstream msg;
+    msg << "Unknown format '" << format << "' for points. Use 'text', 'raw', 'npy', or 'hdf5'.";
+    throw std::runtime_error(msg.str());
+} // create
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::PointsReader::PointsReader(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::PointsReader::~PointsReader(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsReader::TextReader::TextReader(const std::string& filename) :
+    _file(openFile(filename, "r")),
+    _buffer(bufferSize+1),
+    _pos(0),
+    _end(0),
+    _endOfInput(false) {
+    _buffer[0] = '\0';
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsReader::TextReader::~TextReader(void) {
+    if (_file && (_file != stdin)) {
+        fclose(_file);
+    } // if
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Read next batch of points.
+size_t
+geomodelgrids::apps::_PointsReader::TextReader::read(double* const points,
+                                                     const size_t maxPoints) {
+    assert(points || !maxPoints);
+
+    size_t numPoints = 0;
+    while (numPoints < maxPoints && !_endOfInput) {
+        double* xyz = &points[3*numPoints];
+        if (_parseValue(&xyz[0]) && _parseValue(&xyz[1]) && _parseValue(&xyz[2])) {
+            ++numPoints;
+        } else {
+            _endOfInput = true;
+        } // if/else
+    } // while
+
+    return numPoints;
+} // read
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse next value.
+bool
+geomodelgrids::apps::_PointsReader::TextReader::_parseValue(double* value) {
+    assert(value);
+
+    // Skip whitespace.
+    while (true) {
+        if (_pos == _end) {
+            if (!_fill()) { return false; }
+        } else if (isspace(static_cast<unsigned char>(_buffer[_pos]))) {
+            ++_pos;
+        } else {
+            break;
+        } // if/else
+    } // while
+
+    // Make sure entire token is in the buffer.
+    size_t tokenEnd = _pos;
+    while (true) {
+        while (tokenEnd < _end && !isspace(static_cast<unsigned char>(_buffer[tokenEnd]))) {
+            ++tokenEnd;
+        } // while
+        if (tokenEnd < _end) { break; }
+        const size_t tokenLength = tokenEnd - _pos;
+        if (!_fill()) { break; }
+        tokenEnd = _pos + tokenLength;
+    } // while
+
+    const char* first = &_buffer[_pos];
+    const char* last = &_buffer[0] + tokenEnd;
+    if ((*first == '+') && (last - first > 1)) {
+        ++first;
+    } // if
+    // Standard libraries without floating point std::from_chars() (for example, GCC before 11) use strtod().
+#if defined(__cpp_lib_to_chars)
+    const std::from_chars_result result = std::from_chars(first, last, *value);
+    const bool isValid = (result.ec == std::errc()) && (result.ptr == last);
+#else
+    char* parseEnd = nullptr;
+    *value = strtod(first, &parseEnd);
+    const bool isValid = (parseEnd == last);
+#endif
+    _pos = tokenEnd;
+
+    return isValid;
+} // _parseValue
+
+
+// ------------------------------------------------------------------------------------------------
+// Move unparsed characters to start of buffer and fill remainder of buffer.
+bool
+geomodelgrids::apps::_PointsReader::TextReader::_fill(void) {
+    if (_pos > 0) {
+        std::copy(_buffer.begin()+_pos, _buffer.begin()+_end, _buffer.begin());
+        _end -= _pos;
+        _pos = 0;
+    } // if
+    if (_end == bufferSize) {
+        throw std::runtime_error("Token in text input for points exceeds size of buffer.");
+    } // if
+
+    const size_t numRead = fread(&_buffer[_end], sizeof(char), bufferSize-_end, _file);
+    if (ferror(_file)) {
+        throw std::runtime_error("Error reading text input for points.");
+    } // if
+    _end += numRead;
+    _buffer[_end] = '\0';
+
+    return numRead > 0;
+} // _fill
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsReader::RawReader::RawReader(const std::string& filename) :
+    _file(openFile(filename, "rb")),
+    _numRemaining(size_t(-1)),
+    _isLittleEndian(true) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsReader::RawReader::~RawReader(void) {
+    if (_file && (_file != stdin)) {
+        fclose(_file);
+    } // if
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Read next batch of points.
+size_t
+geomodelgrids::apps::_PointsReader::RawReader::read(double* const points,
+                                                    const size_t maxPoints) {
+    assert(points || !maxPoints);
+
+    const size_t pointSize = 3*sizeof(double);
+    const size_t numBytes = _readBytes(points, std::min(maxPoints, _numRemaining)*pointSize);
+    if (numBytes % pointSize) {
+        throw std::runtime_error("Binary input for points ends with an incomplete point.");
+    } // if
+    const size_t numPoints = numBytes / pointSize;
+    if (_isLittleEndian != isLittleEndian()) {
+        swapBytes(points, 3*numPoints);
+    } // if
+    _numRemaining -= numPoints;
+
+    return numPoints;
+} // read
+
+
+// ------------------------------------------------------------------------------------------------
+// Read bytes until count is reached or end of input.
+size_t
+geomodelgrids::apps::_PointsReader::RawReader::_readBytes(void* buffer,
+                                                          const size_t numBytes) {
+    char* bytes = static_cast<char*>(buffer);
+    size_t numRead = 0;
+    while (numRead < numBytes) {
+        const size_t count = fread(bytes+numRead, sizeof(char), numBytes-numRead, _file);
+        if (ferror(_file)) {
+            throw std::runtime_error("Error reading binary input for points.");
+        } // if
+        if (!count) { break; }
+        numRead += count;
+    } // while
+
+    return numRead;
+} // _readBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsReader::NpyReader::NpyReader(const std::string& filename) :
+    RawReader(filename) {
+    // Magic string and version.
+    unsigned char preamble[8];
+    if ((_readBytes(preamble, 8) != 8) || (memcmp(preamble, "\x93NUMPY", 6) != 0)) {
+        std::ostringstream msg;
+        msg << "Points file '" << filename << "' is not a NumPy file.";
+        throw std::runtime_error(msg.str());
+    } // if
+    const unsigned char versionMajor = preamble[6];
+    if ((versionMajor < 1) || (versionMajor > 3)) {
+        std::ostringstream msg;
+        msg << "Unsupported version " << int(versionMajor) << " of NumPy file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    // Length of header is uint16 in version 1 and uint32 in later versions (little-endian).
+    const size_t lengthSize = (1 == versionMajor) ? 2 : 4;
+    unsigned char lengthBytes[4] = { 0, 0, 0, 0 };
+    if (_readBytes(lengthBytes, lengthSize) != lengthSize) {
+        throw std::runtime_error("Could not read header of NumPy file.");
+    } // if
+    const size_t headerLength = size_t(lengthBytes[0]) | (size_t(lengthBytes[1]) << 8) |
+                                (size_t(lengthBytes[2]) << 16) | (size_t(lengthBytes[3]) << 24);
+
+    std::string header(headerLength, ' ');
+    if (_readBytes(&header[0], headerLength) != headerLength) {
+        throw std::runtime_error("Could not read header of NumPy file.");
+    } // if
+
+    const std::string& descr = _getHeaderValue(header, "descr");
+    if ((descr == "'<f8'") || (descr == "\"<f8\"")) {
+        _isLittleEndian = true;
+    } else if ((descr == "'>f8'") || (descr == "\">f8\"")) {
+        _isLittleEndian = false;
+    } else {
+        std::ostringstream msg;
+        msg << "NumPy array in '" << filename << "' has type " << descr << ". Points must be float64.";
+        throw std::runtime_error(msg.str());
+    } // if/else
+    if (_getHeaderValue(header, "fortran_order") != "False") {
+        std::ostringstream msg;
+        msg << "NumPy array in '" << filename << "' must be in C (row-major) order.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    const std::string& shape = _getHeaderValue(header, "shape");
+    unsigned long long numRows = 0;
+    unsigned long long numCols = 0;
+    char trailing = '\0';
+    if ((sscanf(shape.c_str(), "(%llu , %llu %c", &numRows, &numCols, &trailing) != 3) || (numCols != 3) ||
+        (trailing != ')')) {
+        std::ostringstream msg;
+        msg << "NumPy array in '" << filename << "' has shape " << shape << ". Points must have shape (numPoints, 3).";
+        throw std::runtime_error(msg.str());
+    } // if
+    _numRemaining = size_t(numRows);
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsReader::NpyReader::~NpyReader(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Get value of key in NumPy header.
+std::string
+geomodelgrids::apps::_PointsReader::NpyReader::_getHeaderValue(const std::string& header,
+                                                               const std::string& key) {
+    size_t pos = header.find("'" + key + "'");
+    if (pos == std::string::npos) {
+        pos = header.find("\"" + key + "\"");
+    } // if
+    if (pos == std::string::npos) {
+        return "";
+    } // if
+    pos = header.find(':', pos);
+    if (pos == std::string::npos) {
+        return "";
+    } // if
+    pos = header.find_first_not_of(" ", pos+1);
+    if (pos == std::string::npos) {
+        return "";
+    } // if
+
+    const size_t end = (header[pos] == '(') ? header.find(')', pos)+1 : header.find_first_of(",}", pos);
+    std::string value = header.substr(pos, end-pos);
+    value.erase(value.find_last_not_of(" ")+1);
+    return value;
+} // _getHeaderValue
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsReader::HDF5Reader::HDF5Reader(const std::string& filename,
+                                                           const std::string& dataset) :
+    _file(-1),
+    _dataset(-1),
+    _dataspace(-1),
+    _numPoints(0),
+    _offset(0) {
+    if (filename == "-") {
+        throw std::runtime_error("Points in HDF5 format cannot be read from stdin.");
+    } // if
+
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    std::ostringstream msg;
+    _file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (_file < 0) {
+        msg << "Could not open points file '" << filename << "' for reading.";
+        throw std::runtime_error(msg.str());
+    } // if
+    _dataset = H5Dopen2(_file, dataset.c_str(), H5P_DEFAULT);
+    if (_dataset < 0) {
+        _close();
+        msg << "Could not open dataset '" << dataset << "' in points file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    _dataspace = H5Dget_space(_dataset);
+    hsize_t dims[2] = { 0, 0 };
+    if ((_dataspace < 0) || (H5Sget_simple_extent_ndims(_dataspace) != 2) ||
+        (H5Sget_simple_extent_dims(_dataspace, dims, nullptr) < 0) || (dims[1] != 3)) {
+        _close();
+        msg << "Dataset '" << dataset << "' in points file '" << filename << "' must have shape (numPoints, 3).";
+        throw std::runtime_error(msg.str());
+    } // if
+    _numPoints = dims[0];
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsReader::HDF5Reader::~HDF5Reader(void) {
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    _close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Read next batch of points.
+size_t
+geomodelgrids::apps::_PointsReader::HDF5Reader::read(double* const points,
+                                                     const size_t maxPoints) {
+    assert(points || !maxPoints);
+
+    const hsize_t numPoints = std::min(hsize_t(maxPoints), _numPoints-_offset);
+    if (!numPoints) {
+        return 0;
+    } // if
+
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    const hsize_t offset[2] = { _offset, 0 };
+    const hsize_t count[2] = { numPoints, 3 };
+    hid_t memspace = H5Screate_simple(2, count, nullptr);
+    herr_t err = (memspace < 0) ? -1 : H5Sselect_hyperslab(_dataspace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+    if (err >= 0) {
+        err = H5Dread(_dataset, H5T_NATIVE_DOUBLE, memspace, _dataspace, H5P_DEFAULT, points);
+    } // if
+    if (memspace >= 0) {
+        H5Sclose(memspace);
+    } // if
+    if (err < 0) {
+        throw std::runtime_error("Error reading points from HDF5 dataset.");
+    } // if
+    _offset += numPoints;
+
+    return size_t(numPoints);
+} // read
+
+
+// ------------------------------------------------------------------------------------------------
+// Close HDF5 objects (caller holds HDF5 mutex).
+void
+geomodelgrids::apps::_PointsReader::HDF5Reader::_close(void) {
+    if (_dataspace >= 0) {
+        H5Sclose(_dataspace);_dataspace = -1;
+    } // if
+    if (_dataset >= 0) {
+        H5Dclose(_dataset);_dataset = -1;
+    } // if
+    if (_file >= 0) {
+        H5Fclose(_file);_file = -1;
+    } // if
+} // _close
+
+
+// ------------------------------------------------------------------------------------------------
+// Open file for reading.
+FILE*
+geomodelgrids::apps::_PointsReader::openFile(const std::string& filename,
+                                             const char* mode) {
+    if (filename == "-") {
+        return stdin;
+    } // if
+
+    FILE* file = fopen(filename.c_str(), mode);
+    if (!file) {
+        std::ostringstream msg;
+        msg << "Could not open points file '" << filename << "' for reading.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    return file;
+} // openFile
+
+
+// ------------------------------------------------------------------------------------------------
+// Is the byte order of the host little-endian?
+bool
+geomodelgrids::apps::_PointsReader::isLittleEndian(void) {
+    const uint16_t value = 1;
+    uint8_t firstByte = 0;
+    memcpy(&firstByte, &value, 1);
+    return 1 == firstByte;
+} // isLittleEndian
+
+
+// ------------------------------------------------------------------------------------------------
+// Reverse byte order of float64 values.
+void
+geomodelgrids::apps::_PointsReader::swapBytes(double* const values,
+                                              const size_t numValues) {
+    assert(values || !numValues);
+    for (size_t i = 0; i < numValues; ++i) {
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(&values[i]);
+        std::reverse(bytes, bytes+sizeof(double));
+    } // for
+} // swapBytes
+
+
+// End of file
@@ -0,0 +1,63 @@
+/** Reader for streams of points in the input of query applications.
+ *
+ * Supported formats:
+ *   - text: whitespace separated coordinates, one point per line.
+ *   - raw: little-endian float64 coordinates, (x, y, z) for each point.
+ *   - npy: NumPy array of little-endian float64 with shape (numPoints, 3).
+ *   - hdf5: HDF5 dataset of float64 with shape (numPoints, 3).
+ *
+ * Points in text, raw, and npy formats can be read from stdin (filename '-').
+ */
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include <string> // USES std::string
+#include <cstddef> // USES size_t
+
+class geomodelgrids::apps::PointsReader {
+    friend class TestPointsIO; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /** Create reader and open input.
+     *
+     * @param[in] format Format of points ('text', 'raw', 'npy', 'hdf5').
+     * @param[in] filename Name of file with points ('-' for stdin).
+     * @param[in] dataset Path of dataset in HDF5 file (hdf5 format only).
+     * @returns Reader for points (caller is responsible for deleting it).
+     */
+    static
+    PointsReader* create(const std::string& format,
+                         const std::string& filename,
+                         const std::string& dataset="/points");
+
+    /// Destructor
+    virtual ~PointsReader(void);
+
+    /** Read next batch of points.
+     *
+     * @param[out] points Array of point coordinates [maxPoints*3].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of input).
+     */
+    virtual
+    size_t read(double* const points,
+                const size_t maxPoints) = 0;
+
+    // PROTECTED METHODS //////////////////////////////////////////////////////////////////////////
+protected:
+
+    /// Constructor
+    PointsReader(void);
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    PointsReader(const PointsReader&); ///< Not implemented
+    const PointsReader& operator=(const PointsReader&); ///< Not implemented
+
+}; // PointsReader
+
+// End of file
@@ -0,0 +1,661 @@
+#include <portinfo>
+
+#include "PointsWriter.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5::getMutex()
+
+#include <hdf5.h> // USES H5Fcreate(), H5Dwrite()
+#include <mutex> // USES std::lock_guard
+
+#include <cstdio> // USES FILE, fopen(), fwrite(), snprintf()
+#include <cstring> // USES memcpy(), memset()
+#include <cstdint> // USES uint8_t, uint16_t
+#include <algorithm> // USES std::copy(), std::reverse()
+#include <vector> // USES std::vector
+#include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::runtime_error
+#include <cassert> // USES assert()
+
+#include <charconv> // USES std::to_chars()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace apps {
+        namespace _PointsWriter {
+            static const int cwidth = 14; ///< Width of columns in text output.
+            static const int precision = 6; ///< Precision of values in text output.
+            static const size_t bufferSize = 1 << 20; ///< Size of buffer for writing text (bytes).
+            static const size_t npyHeaderSize = 128; ///< Size of NumPy preamble and header (bytes).
+            static const hsize_t chunkSize = 4096; ///< Number of rows in HDF5 chunks.
+
+            /** Open file for writing.
+             *
+             * @param[in] filename Name of file ('-' for stdout).
+             * @param[in] mode Mode for fopen().
+             * @returns File (stdout if filename is '-').
+             */
+            FILE* openFile(const std::string& filename,
+                           const char* mode);
+
+            /** Close file (only flushes stdout).
+             *
+             * @param[inout] file File to close.
+             * @returns True if buffered output was written successfully, false otherwise.
+             */
+            bool closeFile(FILE** file);
+
+            /** Is the byte order of the host little-endian?
+             *
+             * @returns True if the host is little-endian, false otherwise.
+             */
+            bool isLittleEndian(void);
+
+            class TextWriter;
+            class RawWriter;
+            class NpyWriter;
+            class HDF5Writer;
+        } // _PointsWriter
+    } // apps
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Writer for fixed-width text output.
+class geomodelgrids::apps::_PointsWriter::TextWriter : public geomodelgrids::apps::PointsWriter {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file ('-' for stdout).
+     * @param[in] numValues Number of values for each point.
+     */
+    TextWriter(const std::string& filename,
+               const size_t numValues);
+
+    /// Destructor.
+    ~TextWriter(void);
+
+    /** Write header.
+     *
+     * @param[in] header Header as text.
+     */
+    void writeHeader(const std::string& header);
+
+    /** Write batch of points and values.
+     *
+     * @param[in] points Array of point coordinates [numPoints*3].
+     * @param[in] values Array of values [numPoints*numValues].
+     * @param[in] numPoints Number of points.
+     */
+    void write(const double* const points,
+               const double* const values,
+               const size_t numPoints);
+
+    /// Flush output and close file.
+    void close(void);
+
+private:
+
+    /** Append value to buffer in scientific notation right aligned in column.
+     *
+     * @param[in] value Value to append.
+     */
+    void _append(const double value);
+
+    /// Write contents of buffer to file.
+    void _flush(void);
+
+    FILE* _file; ///< Output file.
+    std::vector<char> _buffer; ///< Buffer for formatted text.
+    size_t _size; ///< Number of characters in buffer.
+}; // TextWriter
+
+// ------------------------------------------------------------------------------------------------
+// Writer for little-endian float64 rows.
+class geomodelgrids::apps::_PointsWriter::RawWriter : public geomodelgrids::apps::PointsWriter {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file ('-' for stdout).
+     * @param[in] numValues Number of values for each point.
+     */
+    RawWriter(const std::string& filename,
+              const size_t numValues);
+
+    /// Destructor.
+    ~RawWriter(void);
+
+    /** Write batch of points and values.
+     *
+     * @param[in] points Array of point coordinates [numPoints*3].
+     * @param[in] values Array of values [numPoints*numValues].
+     * @param[in] numPoints Number of points.
+     */
+    void write(const double* const points,
+               const double* const values,
+               const size_t numPoints);
+
+    /// Flush output and close file.
+    void close(void);
+
+protected:
+
+    /** Constructor for subclasses that open the file themselves.
+     *
+     * @param[in] numValues Number of values for each point.
+     */
+    RawWriter(const size_t numValues);
+
+    FILE* _file; ///< Output file.
+    std::vector<double> _rows; ///< Rows of points and values.
+    size_t _numRows; ///< Number of rows written.
+}; // RawWriter
+
+// ------------------------------------------------------------------------------------------------
+// Writer for NumPy array.
+class geomodelgrids::apps::_PointsWriter::NpyWriter : public geomodelgrids::apps::_PointsWriter::RawWriter {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of file.
+     * @param[in] numValues Number of values for each point.
+     */
+    NpyWriter(const std::string& filename,
+              const size_t numValues);
+
+    /// Destructor.
+    ~NpyWriter(void);
+
+    /// Update shape in header and close file.
+    void close(void);
+
+private:
+
+    /// Write preamble and header with current number of rows.
+    void _writeHeader(void);
+
+}; // NpyWriter
+
+// ------------------------------------------------------------------------------------------------
+// Writer for HDF5 dataset.
+class geomodelgrids::apps::_PointsWriter::HDF5Writer : public geomodelgrids::apps::PointsWriter {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] filename Name of HDF5 file.
+     * @param[in] numValues Number of values for each point.
+     * @param[in] dataset Path of dataset in file.
+     */
+    HDF5Writer(const std::string& filename,
+               const size_t numValues,
+               const std::string& dataset);
+
+    /// Destructor.
+    ~HDF5Writer(void);
+
+    /** Write batch of points and values.
+     *
+     * @param[in] points Array of point coordinates [numPoints*3].
+     * @param[in] values Array of values [numPoints*numValues].
+     * @param[in] numPoints Number of points.
+     */
+    void write(const double* const points,
+               const double* const values,
+               const size_t numPoints);
+
+    /// Close file.
+    void close(void);
+
+private:
+
+    /// Close HDF5 objects (caller holds HDF5 mutex).
+    void _close(void);
+
+    hid_t _file; ///< HDF5 file.
+    hid_t _dataset; ///< HDF5 dataset.
+    std::vector<double> _rows; ///< Rows of points and values.
+    hsize_t _numRows; ///< Number of rows written.
+}; // HDF5Writer
+
+// ------------------------------------------------------------------------------------------------
+// Create writer and open output.
+geomodelgrids::apps::PointsWriter*
+geomodelgrids::apps::PointsWriter::create(const std::string& format,
+                                          const std::string& filename,
+                                          const size_t numValues,
+                                          const std::string& dataset) {
+    if (format == "text") {
+        return new _PointsWriter::TextWriter(filename, numValues);
+    } else if (format == "raw") {
+        return new _PointsWriter::RawWriter(filename, numValues);
+    } else if (format == "npy") {
+        return new _PointsWriter::NpyWriter(filename, numValues);
+    } else if (format == "hdf5") {
+        return new _PointsWriter::HDF5Writer(filename, numValues, dataset);
+    } // if/else
+
+    std::ostringstream msg;
+    msg << "Unknown format '" << format << "' for output. Use 'text', 'raw', 'npy', or 'hdf5'.";
+    throw std::runtime_error(msg.str());
+} // create
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::PointsWriter::PointsWriter(const size_t numValues) :
+    _numValues(numValues) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::PointsWriter::~PointsWriter(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Write header (default is no header).
+void
+geomodelgrids::apps::PointsWriter::writeHeader(const std::string&) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsWriter::TextWriter::TextWriter(const std::string& filename,
+                                                           const size_t numValues) :
+    PointsWriter(numValues),
+    _file(openFile(filename, "w")),
+    _buffer(bufferSize),
+    _size(0) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsWriter::TextWriter::~TextWriter(void) {
+    closeFile(&_file);
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Write header.
+void
+geomodelgrids::apps::_PointsWriter::TextWriter::writeHeader(const std::string& header) {
+    _flush();
+    fwrite(header.c_str(), sizeof(char), header.length(), _file);
+} // writeHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Write batch of points and values.
+void
+geomodelgrids::apps::_PointsWriter::TextWriter::write(const double* const points,
+                                                      const double* const values,
+                                                      const size_t numPoints) {
+    assert(points || !numPoints);
+    assert(values || !numPoints || !_numValues);
+
+    // Each value uses at most 24 characters.
+    const size_t maxRowSize = 24*(3+_numValues) + 1;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        if (_size + maxRowSize > _buffer.size()) {
+            _flush();
+            if (maxRowSize > _buffer.size()) {
+                _buffer.resize(maxRowSize);
+            } // if
+        } // if
+        const double* xyz = &points[3*iPoint];
+        _append(xyz[0]);
+        _append(xyz[1]);
+        _append(xyz[2]);
+        const double* pointValues = &values[iPoint*_numValues];
+        for (size_t i = 0; i < _numValues; ++i) {
+            _append(pointValues[i]);
+        } // for
+        _buffer[_size++] = '\n';
+    } // for
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Flush output and close file.
+void
+geomodelgrids::apps::_PointsWriter::TextWriter::close(void) {
+    _flush();
+    if (!closeFile(&_file)) {
+        throw std::runtime_error("Error writing text output.");
+    } // if
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Append value to buffer in scientific notation right aligned in column.
+void
+geomodelgrids::apps::_PointsWriter::TextWriter::_append(const double value) {
+    char* dest = &_buffer[_size];
+    // Standard libraries without floating point std::to_chars() (for example, GCC before 11) use snprintf().
+#if defined(__cpp_lib_to_chars)
+    char field[32];
+    const std::to_chars_result result = std::to_chars(field, field+sizeof(field), value, std::chars_format::scientific,
+                                                      precision);
+    const size_t length = result.ptr - field;
+    const size_t padding = (length < size_t(cwidth)) ? cwidth - length : 0;
+    memset(dest, ' ', padding);
+    memcpy(dest+padding, field, length);
+    _size += padding + length;
+#else
+    _size += snprintf(dest, _buffer.size()-_size, "%*.*e", cwidth, precision, value);
+#endif
+} // _append
+
+
+// ------------------------------------------------------------------------------------------------
+// Write contents of buffer to file.
+void
+geomodelgrids::apps::_PointsWriter::TextWriter::_flush(void) {
+    if (!_file) {
+        throw std::runtime_error("Cannot write to closed output file.");
+    } // if
+    if (_size && (fwrite(&_buffer[0], sizeof(char), _size, _file) != _size)) {
+        throw std::runtime_error("Error writing text output.");
+    } // if
+    _size = 0;
+} // _flush
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsWriter::RawWriter::RawWriter(const std::string& filename,
+                                                         const size_t numValues) :
+    PointsWriter(numValues),
+    _file(openFile(filename, "wb")),
+    _numRows(0) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor for subclasses that open the file themselves.
+geomodelgrids::apps::_PointsWriter::RawWriter::RawWriter(const size_t numValues) :
+    PointsWriter(numValues),
+    _file(nullptr),
+    _numRows(0) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsWriter::RawWriter::~RawWriter(void) {
+    closeFile(&_file);
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Write batch of points and values.
+void
+geomodelgrids::apps::_PointsWriter::RawWriter::write(const double* const points,
+                                                     const double* const values,
+                                                     const size_t numPoints) {
+    assert(points || !numPoints);
+    assert(values || !numPoints || !_numValues);
+    if (!_file) {
+        throw std::runtime_error("Cannot write to closed output file.");
+    } // if
+
+    const size_t rowSize = 3 + _numValues;
+    _rows.resize(numPoints*rowSize);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double* row = &_rows[iPoint*rowSize];
+        std::copy(&points[3*iPoint], &points[3*iPoint+3], row);
+        std::copy(&values[iPoint*_numValues], &values[iPoint*_numValues+_numValues], row+3);
+    } // for
+    if (!isLittleEndian()) {
+        for (size_t i = 0; i < _rows.size(); ++i) {
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(&_rows[i]);
+            std::reverse(bytes, bytes+sizeof(double));
+        } // for
+    } // if
+
+    if (fwrite(_rows.data(), sizeof(double), _rows.size(), _file) != _rows.size()) {
+        throw std::runtime_error("Error writing binary output.");
+    } // if
+    _numRows += numPoints;
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Flush output and close file.
+void
+geomodelgrids::apps::_PointsWriter::RawWriter::close(void) {
+    if (!closeFile(&_file)) {
+        throw std::runtime_error("Error writing binary output.");
+    } // if
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsWriter::NpyWriter::NpyWriter(const std::string& filename,
+                                                         const size_t numValues) :
+    RawWriter(numValues) {
+    if (filename == "-") {
+        throw std::runtime_error("Output in NumPy format cannot be written to stdout.");
+    } // if
+    _file = openFile(filename, "wb");
+    _writeHeader();
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsWriter::NpyWriter::~NpyWriter(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Update shape in header and close file.
+void
+geomodelgrids::apps::_PointsWriter::NpyWriter::close(void) {
+    if (_file) {
+        if (fseek(_file, 0, SEEK_SET) != 0) {
+            throw std::runtime_error("Could not update header of NumPy output.");
+        } // if
+        _writeHeader();
+    } // if
+    if (!closeFile(&_file)) {
+        throw std::runtime_error("Error writing NumPy output.");
+    } // if
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Write preamble and header with current number of rows.
+void
+geomodelgrids::apps::_PointsWriter::NpyWriter::_writeHeader(void) {
+    assert(_file);
+
+    // Version 1.0 header padded with spaces so the data starts at a fixed offset for any number of rows.
+    std::ostringstream dict;
+    dict << "{'descr': '<f8', 'fortran_order': False, 'shape': (" << _numRows << ", " << 3+_numValues << "), }";
+    std::string header = dict.str();
+    const size_t preambleSize = 10;
+    if (header.length() + 1 > npyHeaderSize - preambleSize) {
+        throw std::runtime_error("Header of NumPy output exceeds reserved size.");
+    } // if
+    header.append(npyHeaderSize - preambleSize - header.length() - 1, ' ');
+    header += '\n';
+
+    const uint16_t headerLength = uint16_t(header.length());
+    const unsigned char preamble[preambleSize] = {
+        0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+        static_cast<unsigned char>(headerLength & 0xff), static_cast<unsigned char>(headerLength >> 8),
+    };
+    if ((fwrite(preamble, sizeof(char), preambleSize, _file) != preambleSize) ||
+        (fwrite(header.c_str(), sizeof(char), header.length(), _file) != header.length())) {
+        throw std::runtime_error("Error writing header of NumPy output.");
+    } // if
+} // _writeHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::apps::_PointsWriter::HDF5Writer::HDF5Writer(const std::string& filename,
+                                                           const size_t numValues,
+                                                           const std::string& dataset) :
+    PointsWriter(numValues),
+    _file(-1),
+    _dataset(-1),
+    _numRows(0) {
+    if (filename == "-") {
+        throw std::runtime_error("Output in HDF5 format cannot be written to stdout.");
+    } // if
+
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    std::ostringstream msg;
+    _file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (_file < 0) {
+        msg << "Could not open output file '" << filename << "' for writing.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    const hsize_t dims[2] = { 0, 3+numValues };
+    const hsize_t maxDims[2] = { H5S_UNLIMITED, 3+numValues };
+    const hsize_t chunk[2] = { chunkSize, 3+numValues };
+    hid_t dataspace = H5Screate_simple(2, dims, maxDims);
+    hid_t linkProperties = H5Pcreate(H5P_LINK_CREATE);
+    hid_t datasetProperties = H5Pcreate(H5P_DATASET_CREATE);
+    if ((dataspace >= 0) && (linkProperties >= 0) && (datasetProperties >= 0) &&
+        (H5Pset_create_intermediate_group(linkProperties, 1) >= 0) &&
+        (H5Pset_chunk(datasetProperties, 2, chunk) >= 0)) {
+        _dataset = H5Dcreate2(_file, dataset.c_str(), H5T_IEEE_F64LE, dataspace, linkProperties, datasetProperties,
+                              H5P_DEFAULT);
+    } // if
+    if (datasetProperties >= 0) { H5Pclose(datasetProperties); }
+    if (linkProperties >= 0) { H5Pclose(linkProperties); }
+    if (dataspace >= 0) { H5Sclose(dataspace); }
+    if (_dataset < 0) {
+        _close();
+        msg << "Could not create dataset '" << dataset << "' in output file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::apps::_PointsWriter::HDF5Writer::~HDF5Writer(void) {
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    _close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Write batch of points and values.
+void
+geomodelgrids::apps::_PointsWriter::HDF5Writer::write(const double* const points,
+                                                      const double* const values,
+                                                      const size_t numPoints) {
+    assert(points || !numPoints);
+    assert(values || !numPoints || !_numValues);
+    if (_dataset < 0) {
+        throw std::runtime_error("Cannot write to closed output file.");
+    } // if
+    if (!numPoints) {
+        return;
+    } // if
+
+    const size_t rowSize = 3 + _numValues;
+    _rows.resize(numPoints*rowSize);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double* row = &_rows[iPoint*rowSize];
+        std::copy(&points[3*iPoint], &points[3*iPoint+3], row);
+        std::copy(&values[iPoint*_numValues], &values[iPoint*_numValues+_numValues], row+3);
+    } // for
+
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    const hsize_t dims[2] = { _numRows+numPoints, rowSize };
+    const hsize_t offset[2] = { _numRows, 0 };
+    const hsize_t count[2] = { numPoints, rowSize };
+    herr_t err = H5Dset_extent(_dataset, dims);
+    hid_t filespace = (err < 0) ? -1 : H5Dget_space(_dataset);
+    hid_t memspace = H5Screate_simple(2, count, nullptr);
+    if ((filespace < 0) || (memspace < 0) ||
+        (H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, nullptr, count, nullptr) < 0)) {
+        err = -1;
+    } else {
+        err = H5Dwrite(_dataset, H5T_NATIVE_DOUBLE, memspace, filespace, H5P_DEFAULT, _rows.data());
+    } // if/else
+    if (memspace >= 0) { H5Sclose(memspace); }
+    if (filespace >= 0) { H5Sclose(filespace); }
+    if (err < 0) {
+        throw std::runtime_error("Error writing values to HDF5 dataset.");
+    } // if
+    _numRows += numPoints;
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Close file.
+void
+geomodelgrids::apps::_PointsWriter::HDF5Writer::close(void) {
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    _close();
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Close HDF5 objects (caller holds HDF5 mutex).
+void
+geomodelgrids::apps::_PointsWriter::HDF5Writer::_close(void) {
+    if (_dataset >= 0) {
+        H5Dclose(_dataset);_dataset = -1;
+    } // if
+    if (_file >= 0) {
+        H5Fclose(_file);_file = -1;
+    } // if
+} // _close
+
+
+// ------------------------------------------------------------------------------------------------
+// Open file for writing.
+FILE*
+geomodelgrids::apps::_PointsWriter::openFile(const std::string& filename,
+                                             const char* mode) {
+    if (filename == "-") {
+        return stdout;
+    } // if
+
+    FILE* file = fopen(filename.c_str(), mode);
+    if (!file) {
+        std::ostringstream msg;
+        msg << "Could not open output file '" << filename << "' for writing.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    return file;
+} // openFile
+
+
+// ------------------------------------------------------------------------------------------------
+// Close file (only flushes stdout).
+bool
+geomodelgrids::apps::_PointsWriter::closeFile(FILE** file) {
+    assert(file);
+
+    if (!*file) {
+        return true;
+    } // if
+    const int err = (*file == stdout) ? fflush(stdout) : fclose(*file);
+    *file = nullptr;
+
+    return 0 == err;
+} // closeFile
+
+
+// ------------------------------------------------------------------------------------------------
+// Is the byte order of the host little-endian?
+bool
+geomodelgrids::apps::_PointsWriter::isLittleEndian(void) {
+    const uint16_t value = 1;
+    uint8_t firstByte = 0;
+    memcpy(&firstByte, &value, 1);
+    return 1 == firstByte;
+} // isLittleEndian
+
+
+// End of file
@@ -0,0 +1,87 @@
+/** Writer for streams of points and values in the output of query applications.
+ *
+ * Each row holds the point coordinates (x, y, z) followed by the query values.
+ *
+ * Supported formats:
+ *   - text: header followed by one row per line in fixed-width scientific notation.
+ *   - raw: little-endian float64 rows without a header.
+ *   - npy: NumPy array of little-endian float64 with shape (numPoints, 3+numValues).
+ *   - hdf5: HDF5 dataset of float64 with shape (numPoints, 3+numValues).
+ *
+ * Rows in text and raw formats can be written to stdout (filename '-').
+ */
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include <string> // USES std::string
+#include <cstddef> // USES size_t
+
+class geomodelgrids::apps::PointsWriter {
+    friend class TestPointsIO; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /** Create writer and open output.
+     *
+     * @param[in] format Format of output ('text', 'raw', 'npy', 'hdf5').
+     * @param[in] filename Name of output file ('-' for stdout).
+     * @param[in] numValues Number of values for each point.
+     * @param[in] dataset Path of dataset in HDF5 file (hdf5 format only).
+     * @returns Writer for points and values (caller is responsible for deleting it).
+     */
+    static
+    PointsWriter* create(const std::string& format,
+                         const std::string& filename,
+                         const size_t numValues,
+                         const std::string& dataset="/values");
+
+    /// Destructor
+    virtual ~PointsWriter(void);
+
+    /** Write header (text format only).
+     *
+     * @param[in] header Header as text.
+     */
+    virtual
+    void writeHeader(const std::string& header);
+
+    /** Write batch of points and values.
+     *
+     * @param[in] points Array of point coordinates [numPoints*3].
+     * @param[in] values Array of values [numPoints*numValues].
+     * @param[in] numPoints Number of points.
+     */
+    virtual
+    void write(const double* const points,
+               const double* const values,
+               const size_t numPoints) = 0;
+
+    /// Flush output and close file.
+    virtual
+    void close(void) = 0;
+
+    // PROTECTED METHODS //////////////////////////////////////////////////////////////////////////
+protected:
+
+    /** Constructor
+     *
+     * @param[in] numValues Number of values for each point.
+     */
+    PointsWriter(const size_t numValues);
+
+    // PROTECTED MEMBERS //////////////////////////////////////////////////////////////////////////
+protected:
+
+    size_t _numValues; ///< Number of values for each point.
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    PointsWriter(const PointsWriter&); ///< Not implemented
+    const PointsWriter& operator=(const PointsWriter&); ///< Not implemented
+
+}; // PointsWriter
+
+// End of file
@@ -2,12 +2,23 @@
 
 #include "Query.hh" // implementation of class methods
 
+#include "PointsReader.hh" // USES PointsReader
+#include "PointsWriter.hh" // USES PointsWriter
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryContext.hh" // USES QueryContext
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include <getopt.h> // USES getopt_long()
 #include <iomanip>
-#include <fstream> // USES std::ifstream, std::ofstream
+#include <memory> // USES std::unique_ptr
+#include <thread> // USES std::thread
+#include <mutex> // USES std::mutex, std::unique_lock
+#include <condition_variable> // USES std::condition_variable
+#include <atomic> // USES std::atomic
+#include <exception> // USES std::exception_ptr
+#include <deque> // USES std::deque
+#include <map> // USES std::map
 #include <sstream> // USES std::ostringstream, std::istringstream
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
@@ -16,20 +27,101 @@ namespace geomodelgrids {
     namespace apps {
         namespace _Query {
             static const int cwidth = 14;
-            static const int precision = 6;
+            static const size_t batchSize = 4096; ///< Number of points in each batch query.
+            static const size_t batchesPerThread = 4; ///< Number of batches in pipeline for each worker thread.
+
+            /// Batch of points and values passed between stages of pipeline.
+            struct Batch {
+                size_t index; ///< Index of batch in input.
+                size_t numPoints; ///< Number of points in batch.
+                std::vector<double> points; ///< Coordinates of points [batchSize*3].
+                std::vector<double> values; ///< Values at points [batchSize*numValues].
+            };
+
+            class BatchQueue;
         } // _Query
     } // apps
 } // geomodelgrids
 
+// ------------------------------------------------------------------------------------------------
+// Queue with fixed capacity connecting stages of pipeline.
+class geomodelgrids::apps::_Query::BatchQueue {
+public:
+
+    /** Constructor.
+     *
+     * @param[in] capacity Maximum number of batches in queue.
+     */
+    BatchQueue(const size_t capacity) :
+        _capacity(capacity),
+        _isClosed(false) {}
+
+    /** Add batch to end of queue, waiting while queue is full.
+     *
+     * @param[in] batch Batch to add.
+     * @returns False if queue is closed, true otherwise.
+     */
+    bool push(Batch* batch) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this]() { return _isClosed || _batches.size() < _capacity; });
+        if (_isClosed) {
+            return false;
+        } // if
+        _batches.push_back(batch);
+        _notEmpty.notify_one();
+        return true;
+    } // push
+
+    /** Remove batch from front of queue, waiting while queue is empty.
+     *
+     * @param[out] batch Batch removed from queue.
+     * @returns False if queue is closed and empty, true otherwise.
+     */
+    bool pop(Batch** batch) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this]() { return _isClosed || !_batches.empty(); });
+        if (_batches.empty()) {
+            return false;
+        } // if
+        *batch = _batches.front();
+        _batches.pop_front();
+        _notFull.notify_one();
+        return true;
+    } // pop
+
+    /// Close queue. Batches already in the queue can still be removed.
+    void close(void) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isClosed = true;
+        _notFull.notify_all();
+        _notEmpty.notify_all();
+    } // close
+
+private:
+
+    std::deque<Batch*> _batches; ///< Batches in queue.
+    const size_t _capacity; ///< Maximum number of batches in queue.
+    bool _isClosed; ///< True if queue is closed.
+    std::mutex _mutex; ///< Mutex protecting queue.
+    std::condition_variable _notFull; ///< Signaled when a batch is removed or queue is closed.
+    std::condition_variable _notEmpty; ///< Signaled when a batch is added or queue is closed.
+}; // BatchQueue
+
 // ------------------------------------------------------------------------------------------------
 // Constructor
 geomodelgrids::apps::Query::Query() :
     _pointsFilename(""),
+    _pointsFormat("text"),
+    _pointsDataset("/points"),
     _pointsCRS("EPSG:4326"),
     _outputFilename(""),
+    _outputFormat("text"),
+    _outputDataset("/values"),
     _logFilename(""),
+    _ioProfile(""),
     _squashMinElev(-10.0e+3),
     _squash(geomodelgrids::serial::Query::SQUASH_NONE),
+    _numThreads(1),
     _showHelp(false) {}
 
 
@@ -56,47 +148,37 @@ geomodelgrids::apps::Query::run(int argc,
         errorHandler->setLogFilename(_logFilename.c_str());
         errorHandler->setLoggingOn(true);
     } // if
+    if (!_ioProfile.empty()) {
+        query.setIOProfile(geomodelgrids::serial::IOProfile::fromString(_ioProfile.c_str()));
+    } // if
     query.initialize(_modelFilenames, _valueNames, _pointsCRS);
     if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
         query.setSquashing(_squash);
         query.setSquashMinElev(_squashMinElev);
     } // if
 
-    std::ifstream sin(_pointsFilename);
-    if (!sin.is_open() && !sin.good()) {
-        std::ostringstream msg;
-        msg << "Could not open points file '" << _pointsFilename << "' for reading.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-
-    std::ofstream sout(_outputFilename);
-    if (!sout.is_open() && !sout.good()) {
-        std::ostringstream msg;
-        msg << "Could not open output file '" << _outputFilename << "' for writing.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-
-    sout << _createOutputHeader(argc, argv);
+    std::unique_ptr<PointsReader> reader(PointsReader::create(_pointsFormat, _pointsFilename, _pointsDataset));
     const size_t numQueryValues = _valueNames.size();
-    std::vector<double> values(numQueryValues);
-    sout << std::scientific << std::setprecision(_Query::precision);
-    while (true) {
-        double srcX, srcY, srcZ;
-        sin >> srcX >> srcY >> srcZ;
-        if (sin.eof() || !sin.good()) {
-            break;
-        } // if
+    std::unique_ptr<PointsWriter> writer(PointsWriter::create(_outputFormat, _outputFilename, numQueryValues,
+                                                              _outputDataset));
 
-        query.query(&values[0], srcX, srcY, srcZ);
+    writer->writeHeader(_createOutputHeader(argc, argv));
+    if (_numThreads > 1) {
+        _runPipeline(query, reader.get(), writer.get());
+    } else {
+        std::vector<double> points(3*_Query::batchSize);
+        std::vector<double> values(_Query::batchSize*numQueryValues);
+        while (true) {
+            const size_t numPoints = reader->read(&points[0], _Query::batchSize);
+            if (!numPoints) {
+                break;
+            } // if
 
-        sout << std::setw(_Query::cwidth) << srcX
-             << std::setw(_Query::cwidth) << srcY
-             << std::setw(_Query::cwidth) << srcZ;
-        for (size_t i = 0; i < numQueryValues; ++i) {
-            sout << std::setw(_Query::cwidth) << values[i];
-        } // for
-        sout << "\n";
-    } // while
+            query.queryMany(&values[0], nullptr, &points[0], numPoints);
+            writer->write(&points[0], &values[0], numPoints);
+        } // while
+    } // if/else
+    writer->close();
 
     query.finalize();
 
@@ -109,22 +191,28 @@ geomodelgrids::apps::Query::run(int argc,
 void
 geomodelgrids::apps::Query::_parseArgs(int argc,
                                        char* argv[]) {
-    static struct option options[10] = {
+    static struct option options[16] = {
         {"help", no_argument, nullptr, 'h'},
         {"values", required_argument, nullptr, 'v'},
         {"squash-min-elev", required_argument, nullptr, 's'},
         {"squash-surface", required_argument, nullptr, 'r'},
         {"points", required_argument, nullptr, 'p'},
+        {"points-format", required_argument, nullptr, 'f'},
+        {"points-dataset", required_argument, nullptr, 'd'},
         {"points-coordsys", required_argument, nullptr, 'c'},
         {"output", required_argument, nullptr, 'o'},
+        {"output-format", required_argument, nullptr, 'F'},
+        {"output-dataset", required_argument, nullptr, 'D'},
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
+        {"io-profile", required_argument, nullptr, 'i'},
+        {"threads", required_argument, nullptr, 't'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:r:p:f:d:c:o:F:D:l:m:i:t:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -161,6 +249,14 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             _pointsFilename = optarg;
             break;
         } // 'p'
+        case 'f': {
+            _pointsFormat = optarg;
+            break;
+        } // 'f'
+        case 'd': {
+            _pointsDataset = optarg;
+            break;
+        } // 'd'
         case 'c': {
             _pointsCRS = optarg;
             break;
@@ -169,6 +265,14 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             _outputFilename = optarg;
             break;
         } // 'o'
+        case 'F': {
+            _outputFormat = optarg;
+            break;
+        } // 'F'
+        case 'D': {
+            _outputDataset = optarg;
+            break;
+        } // 'D'
         case 'l': {
             _logFilename = optarg;
             break;
@@ -182,6 +286,24 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             } // while
             break;
         } // 'm'
+        case 'i': {
+            _ioProfile = optarg;
+            break;
+        } // 'i'
+        case 't': {
+            size_t numChars = 0;
+            int numThreads = 0;
+            try {
+                numThreads = std::stoi(optarg, &numChars);
+            } catch (const std::exception&) {
+                numChars = 0;
+            } // try/catch
+            if (!numChars || optarg[numChars] || (numThreads <= 0)) {
+                throw std::invalid_argument(std::string("Number of threads for --threads must be a positive integer. Got '") + optarg + "'.");
+            } // if
+            _numThreads = size_t(numThreads);
+            break;
+        } // 't'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -229,21 +351,142 @@ void
 geomodelgrids::apps::Query::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_query "
               << "[--help]  [--log=FILE_LOG] --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
-              << "--points=FILE_POINTS  --output=FILE_OUTPUT [--squash-min-elev=ELEV] "
-              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "--points=FILE_POINTS  --output=FILE_OUTPUT [--points-format=FORMAT] [--points-dataset=PATH] "
+              << "[--output-format=FORMAT] [--output-dataset=PATH] [--squash-min-elev=ELEV] "
+              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT] "
+              << "[--io-profile=PROFILE] [--threads=NUM_THREADS]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in query.\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
-              << "    --points=FILE_POINTS             Read input points from FILE_POINTS.\n"
-              << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
+              << "    --points=FILE_POINTS             Read input points from FILE_POINTS ('-' for stdin).\n"
+              << "    --points-format=FORMAT           Format of input points text|raw|npy|hdf5 (default=text).\n"
+              << "    --points-dataset=PATH            Dataset with input points in HDF5 file (default=/points).\n"
+              << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT ('-' for stdout).\n"
+              << "    --output-format=FORMAT           Format of output text|raw|npy|hdf5 (default=text).\n"
+              << "    --output-dataset=PATH            Dataset with output in HDF5 file (default=/values).\n"
               << "    --squash-min-elev=ELEV           Top of the model is squashed/stretched to z=0 with the model below z=ELEV held fixed (default=-10.0e+3).\n"
               << "    --squash-surface=none|top_surface|topography_bathymetry    Surface reference for squashing/stretching (default=none).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --io-profile=PROFILE             Parameters for reading models (preset default|borehole|grid "
+              << "and/or KEY=VALUE,...).\n"
+              << "    --threads=NUM_THREADS            Number of threads querying points (default=1)."
               << std::endl;
 } // _printHelp
 
 
+// ------------------------------------------------------------------------------------------------
+// Query points using a pipeline of threads.
+void
+geomodelgrids::apps::Query::_runPipeline(const geomodelgrids::serial::Query& query,
+                                         geomodelgrids::apps::PointsReader* reader,
+                                         geomodelgrids::apps::PointsWriter* writer) {
+    assert(reader);
+    assert(writer);
+    assert(_numThreads > 0);
+
+    const size_t numBatches = _Query::batchesPerThread * _numThreads;
+    std::vector<_Query::Batch> batches(numBatches);
+    _Query::BatchQueue freeBatches(numBatches);
+    _Query::BatchQueue inputBatches(numBatches);
+    _Query::BatchQueue outputBatches(numBatches);
+    for (size_t i = 0; i < numBatches; ++i) {
+        batches[i].points.resize(3*_Query::batchSize);
+        batches[i].values.resize(_Query::batchSize*_valueNames.size());
+        freeBatches.push(&batches[i]);
+    } // for
+
+    // Keep the first error and close all queues, so every stage stops.
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto abort = [&](std::exception_ptr stageError) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+            error = stageError;
+        } // if
+        freeBatches.close();
+        inputBatches.close();
+        outputBatches.close();
+    };
+
+    // Create the query context for each worker before starting any threads, because creating a
+    // context reads model metadata.
+    std::vector<std::unique_ptr<geomodelgrids::serial::QueryContext> > contexts;
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        contexts.push_back(std::unique_ptr<geomodelgrids::serial::QueryContext>(
+                               new geomodelgrids::serial::QueryContext(query)));
+    } // for
+
+    std::thread readerThread([&]() {
+        try {
+            _Query::Batch* batch = nullptr;
+            for (size_t index = 0; freeBatches.pop(&batch); ++index) {
+                batch->index = index;
+                batch->numPoints = reader->read(&batch->points[0], _Query::batchSize);
+                if (!batch->numPoints || !inputBatches.push(batch)) {
+                    break;
+                } // if
+            } // for
+            inputBatches.close();
+        } catch (...) {
+            abort(std::current_exception());
+        } // try/catch
+    });
+
+    std::atomic<size_t> numActiveWorkers(_numThreads);
+    std::vector<std::thread> workerThreads;
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        workerThreads.push_back(std::thread([&, iThread]() {
+            try {
+                geomodelgrids::serial::QueryContext* const context = contexts[iThread].get();
+                _Query::Batch* batch = nullptr;
+                while (inputBatches.pop(&batch)) {
+                    const int err = query.queryMany(&batch->values[0], nullptr, &batch->points[0], batch->numPoints,
+                                                    context);
+                    if (geomodelgrids::utils::ErrorHandler::ERROR == err) {
+                        throw std::runtime_error(context->getErrorHandler()->getMessage());
+                    } // if
+                    if (!outputBatches.push(batch)) {
+                        break;
+                    } // if
+                } // while
+            } catch (...) {
+                abort(std::current_exception());
+            } // try/catch
+            if (0 == --numActiveWorkers) {
+                outputBatches.close();
+            } // if
+        }));
+    } // for
+
+    // Batches may finish out of order; hold them until all preceding batches are written.
+    try {
+        std::map<size_t, _Query::Batch*> pending;
+        size_t nextIndex = 0;
+        _Query::Batch* batch = nullptr;
+        while (outputBatches.pop(&batch)) {
+            pending[batch->index] = batch;
+            for (auto iter = pending.find(nextIndex); iter != pending.end(); iter = pending.find(++nextIndex)) {
+                _Query::Batch* next = iter->second;
+                pending.erase(iter);
+                writer->write(&next->points[0], &next->values[0], next->numPoints);
+                freeBatches.push(next);
+            } // for
+        } // while
+    } catch (...) {
+        abort(std::current_exception());
+    } // try/catch
+
+    readerThread.join();
+    for (size_t iThread = 0; iThread < workerThreads.size(); ++iThread) {
+        workerThreads[iThread].join();
+    } // for
+    if (error) {
+        std::rethrow_exception(error);
+    } // if
+} // _runPipeline
+
+
 // ------------------------------------------------------------------------------------------------
 // Create header for output.
 std::string
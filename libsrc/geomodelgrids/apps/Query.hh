@@ -30,9 +30,15 @@ public:
      *   --squash-surface=top_surface|topography_bathymetry
      *   --models=FILE_0,...,FILE_M
      *   --points=FILE_POINTS
+     *   --points-format=text|raw|npy|hdf5
+     *   --points-dataset=PATH
      *   --output=FILE_OUTPUT
+     *   --output-format=text|raw|npy|hdf5
+     *   --output-dataset=PATH
      *   --log=FILE_LOG
      *   --points-coordsys=PROJ|EPSG|WKT
+     *   --io-profile=PROFILE
+     *   --threads=NUM_THREADS
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -56,6 +62,20 @@ private:
     /// Print help information.
     void _printHelp(void);
 
+    /** Query points using a pipeline of threads.
+     *
+     * A reader thread fills batches of points, worker threads query the batches with their own query
+     * contexts, and the calling thread writes the batches in input order. A fixed pool of batches
+     * is passed between the stages through bounded queues, which limits memory use.
+     *
+     * @param query[in] Initialized query.
+     * @param reader[in] Reader for input points.
+     * @param writer[in] Writer for output.
+     */
+    void _runPipeline(const geomodelgrids::serial::Query& query,
+                      geomodelgrids::apps::PointsReader* reader,
+                      geomodelgrids::apps::PointsWriter* writer);
+
     /** Create header for output file.
      *
      * @param argc[in] Number of arguments passed.
@@ -70,11 +90,17 @@ private:
     std::vector<std::string> _modelFilenames;
     std::vector<std::string> _valueNames;
     std::string _pointsFilename;
+    std::string _pointsFormat;
+    std::string _pointsDataset;
     std::string _pointsCRS;
     std::string _outputFilename;
+    std::string _outputFormat;
+    std::string _outputDataset;
     std::string _logFilename;
+    std::string _ioProfile;
     double _squashMinElev;
     geomodelgrids::serial::Query::SquashingEnum _squash;
+    size_t _numThreads;
     bool _showHelp;
 
     // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
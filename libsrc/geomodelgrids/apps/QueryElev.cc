@@ -3,6 +3,7 @@
 #include "QueryElev.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include <getopt.h> // USES getopt_long()
@@ -27,6 +28,7 @@ geomodelgrids::apps::QueryElev::QueryElev() :
     _pointsCRS("EPSG:4326"),
     _outputFilename(""),
     _logFilename(""),
+    _ioProfile(""),
     _useTopoBathy(false),
     _showHelp(false) {}
 
@@ -54,6 +56,9 @@ geomodelgrids::apps::QueryElev::run(int argc,
         errorHandler->setLogFilename(_logFilename.c_str());
         errorHandler->setLoggingOn(true);
     } // if
+    if (!_ioProfile.empty()) {
+        query.setIOProfile(geomodelgrids::serial::IOProfile::fromString(_ioProfile.c_str()));
+    } // if
     std::vector<std::string> valueNames;
     query.initialize(_modelFilenames, valueNames, _pointsCRS);
 
@@ -99,7 +104,7 @@ geomodelgrids::apps::QueryElev::run(int argc,
 void
 geomodelgrids::apps::QueryElev::_parseArgs(int argc,
                                            char* argv[]) {
-    static struct option options[10] = {
+    static struct option options[11] = {
         {"help", no_argument, nullptr, 'h'},
         {"points", required_argument, nullptr, 'p'},
         {"points-coordsys", required_argument, nullptr, 'c'},
@@ -107,12 +112,13 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
         {"surface", required_argument, nullptr, 's'},
+        {"io-profile", required_argument, nullptr, 'i'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:i:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -151,6 +157,10 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
             } // if
             break;
         } // 'm'
+        case 'i': {
+            _ioProfile = optarg;
+            break;
+        } // 'i'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -194,14 +204,16 @@ void
 geomodelgrids::apps::QueryElev::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_queryelev "
               << "[--help] [--log=FILE_LOG] --models=FILE_0,...,FILE_M --points=FILE_POINTS --output=FILE_OUTPUT "
-              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry]\n\n"
+              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry] [--io-profile=PROFILE]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --points=FILE_POINTS             Read input points from FILE_POINTS.\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
-              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface)."
+              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface).\n"
+              << "    --io-profile=PROFILE             Parameters for reading models (preset default|borehole|grid "
+              << "and/or KEY=VALUE,...)."
               << std::endl;
 } // _printHelp
 
@@ -7,6 +7,8 @@ namespace geomodelgrids {
         class QueryElev;
         class Borehole;
         class Isosurface;
+        class PointsReader;
+        class PointsWriter;
     } // apps
 } // geomodelgrids
 
@@ -28,11 +28,17 @@ geomodelgrids::serial::Block::Block(const char* name) :
     _indexingY(nullptr),
     _indexingZ(nullptr),
     _values(nullptr),
-    _numValues(0) {
+    _numValues(0),
+    _cacheSize(0),
+    _singlePrecision(false) {
     _dims[0] = 0;
     _dims[1] = 0;
     _dims[2] = 0;
 
+    for (size_t i = 0; i < 4; ++i) {
+        _chunkDims[i] = 0;
+    } // for
+
     _hyperslabDims[0] = 64;
     _hyperslabDims[1] = 64;
     _hyperslabDims[2] = 0;
@@ -135,6 +141,13 @@ geomodelgrids::serial::Block::loadMetadata(geomodelgrids::serial::HDF5* const h5
     } // if
 
     _numValues = hdims[3];
+    _useInterpolation.assign(_numValues, 1);
+    delete[] hdims;hdims = nullptr;
+
+    h5->getDatasetChunkDims(&hdims, &ndims, blockPath.c_str());
+    for (int i = 0; i < 4; ++i) {
+        _chunkDims[i] = (4 == ndims) ? hdims[i] : 0;
+    } // for
     delete[] hdims;hdims = nullptr;
 
     // Check to make sure dimensions of block match coordinates (if provided).
@@ -268,6 +281,14 @@ geomodelgrids::serial::Block::getDims(void) const {
 } // getDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of chunks in HDF5 dataset of block.
+const size_t*
+geomodelgrids::serial::Block::getChunkDims(void) const {
+    return _chunkDims;
+} // getChunkDims
+
+
 // ------------------------------------------------------------------------------------------------
 // Get number of values stored at each grid point.
 size_t
@@ -276,6 +297,23 @@ geomodelgrids::serial::Block::getNumValues(void) const {
 } // getNumValues
 
 
+// ------------------------------------------------------------------------------------------------
+// Set whether each value is interpolated or uses the value at the nearest point.
+void
+geomodelgrids::serial::Block::setInterpolation(const std::vector<std::size_t>& unitsBoolean) {
+    if (unitsBoolean.size() != _numValues) {
+        std::ostringstream msg;
+        msg << "Expected array of length " << _numValues << " for interpolation flags of block '" << _name
+            << "', got array of length " << unitsBoolean.size() << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+
+    for (size_t iValue = 0; iValue < _numValues; ++iValue) {
+        _useInterpolation[iValue] = (1 == unitsBoolean[iValue]) ? 1 : 0;
+    } // for
+} // setInterpolation
+
+
 // ------------------------------------------------------------------------------------------------
 // Set hyperslab size.
 void
@@ -297,16 +335,101 @@ geomodelgrids::serial::Block::setHyperslabDims(const size_t dims[],
 
 
 // ------------------------------------------------------------------------------------------------
-// Prepare for querying.
+// Set maximum size of hyperslab tile cache.
 void
-geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5) {
+geomodelgrids::serial::Block::setCacheSize(const size_t numBytes) {
+    _cacheSize = numBytes;
+    if (_hyperslab && _cacheSize) {
+        _hyperslab->setCacheSize(_cacheSize);
+    } // if
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get hyperslab tile cache statistics.
+void
+geomodelgrids::serial::Block::getCacheStats(size_t* numHits,
+                                            size_t* numMisses) const {
+    if (_hyperslab) {
+        _hyperslab->getCacheStats(numHits, numMisses);
+    } else {
+        if (numHits) { *numHits = 0; }
+        if (numMisses) { *numMisses = 0; }
+    } // if/else
+} // getCacheStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether values are stored in single precision.
+void
+geomodelgrids::serial::Block::setSinglePrecision(const bool value) {
+    _singlePrecision = value;
+} // setSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Create hyperslab for querying block.
+geomodelgrids::serial::Hyperslab*
+geomodelgrids::serial::Block::createHyperslab(geomodelgrids::serial::HDF5* const h5) const {
     const size_t ndims = 4;
     hsize_t dims[ndims];
     for (size_t i = 0; i < ndims; ++i) {
         dims[i] = _hyperslabDims[i];
     } // for
     const std::string blockPath(std::string("/blocks/") + _name);
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, blockPath.c_str(), dims, ndims);
+    geomodelgrids::serial::Hyperslab* hyperslab = new geomodelgrids::serial::Hyperslab(h5, blockPath.c_str(), dims, ndims);
+    if (_cacheSize) {
+        hyperslab->setCacheSize(_cacheSize);
+    } // if
+    if (_residentValues) {
+        hyperslab->setResident(_residentValues);
+    } else if (_residentValuesFloat) {
+        hyperslab->setResident(_residentValuesFloat);
+    } else if (_singlePrecision) {
+        hyperslab->setSinglePrecision(true);
+    } // if/else
+
+    return hyperslab;
+} // createHyperslab
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of values in block.
+size_t
+geomodelgrids::serial::Block::getValuesSize(void) const {
+    return _dims[0]*_dims[1]*_dims[2]*_numValues * (_singlePrecision ? sizeof(float) : sizeof(double));
+} // getValuesSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values of entire block into memory.
+void
+geomodelgrids::serial::Block::loadResident(geomodelgrids::serial::HDF5* const h5) {
+    assert(h5);
+    const std::string& blockPath = std::string("/blocks/") + _name;
+    _residentValues.reset();
+    _residentValuesFloat.reset();
+    if (_singlePrecision) {
+        _residentValuesFloat = geomodelgrids::serial::Hyperslab::readResidentFloat(h5, blockPath.c_str());
+    } else {
+        _residentValues = geomodelgrids::serial::Hyperslab::readResident(h5, blockPath.c_str());
+    } // if/else
+} // loadResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Are values of entire block resident in memory?
+bool
+geomodelgrids::serial::Block::isResident(void) const {
+    return _residentValues || _residentValuesFloat;
+} // isResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Prepare for querying.
+void
+geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5) {
+    delete _hyperslab;_hyperslab = createHyperslab(h5);
 
     delete[] _values;_values = (_numValues > 0) ? new double[_numValues] : nullptr;
 } // openQuery
@@ -317,47 +440,47 @@ geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5) {
 const double*
 geomodelgrids::serial::Block::query(const double x,
                                     const double y,
-                                    const double z,
-				    const std::vector<std::size_t>& unitsBoolean) { 
-    assert(x >= 0.0);
-    assert(y >= 0.0);
-    assert(z <= 0.0);
+                                    const double z) {
+    assert( (_numValues > 0 && _values) || (!_numValues && !_values) );
+    query(_values, _hyperslab, x, y, z);
 
-    assert(_indexingX);
-    assert(_indexingY);
-    assert(_indexingZ);
+    return _values;
+} // query
 
-    double index[3];
-    index[0] = _indexingX->getIndex(x);
-    index[1] = _indexingY->getIndex(y);
-    index[2] = _indexingZ->getIndex(_zTop - z);
 
+// ------------------------------------------------------------------------------------------------
+// Query for values at a point using bilinear interpolation.
+const double*
+geomodelgrids::serial::Block::query(const double x,
+                                    const double y,
+                                    const double z,
+                                    const std::vector<std::size_t>& unitsBoolean) {
     assert( (_numValues > 0 && _values) || (!_numValues && !_values) );
-
+    assert(unitsBoolean.size() == _numValues);
     assert(_hyperslab);
 
-if(0) {
-    _hyperslab->interpolate(_values, index);
-}
-if(1) {
-    double *_values_interpolate = new double[_numValues];
-    double *_values_nearest = new double[_numValues];
+    double index[3];
+    _getIndex(index, x, y, z);
+    _hyperslab->query(_values, index, unitsBoolean.data());
 
-    _hyperslab->interpolate(_values_interpolate, index);
-    _hyperslab->nearest(_values_nearest, index);
+    return _values;
+} // query
 
-    for (hsize_t iValue = 0; iValue < _numValues; ++iValue) {
-      if (unitsBoolean[iValue] == 1) {
-        _values[iValue] = _values_interpolate[iValue];
-        } else {
-          _values[iValue] = _values_nearest[iValue];
-      }
-    }
-    delete[] _values_interpolate;
-    delete[] _values_nearest;
-}
 
-    return _values;
+// ------------------------------------------------------------------------------------------------
+// Query for values at a point using bilinear interpolation with given hyperslab.
+void
+geomodelgrids::serial::Block::query(double* const values,
+                                    geomodelgrids::serial::Hyperslab* const hyperslab,
+                                    const double x,
+                                    const double y,
+                                    const double z) const {
+    assert(hyperslab);
+    assert(_useInterpolation.size() == _numValues);
+
+    double index[3];
+    _getIndex(index, x, y, z);
+    hyperslab->query(values, index, _useInterpolation.data());
 } // query
 
 
@@ -366,10 +489,40 @@ if(1) {
 void
 geomodelgrids::serial::Block::closeQuery(void) {
     delete _hyperslab;_hyperslab = nullptr;
+    _residentValues.reset();
+    _residentValuesFloat.reset();
     delete[] _values;_values = nullptr;
 } // closeQuery
 
 
+// ------------------------------------------------------------------------------------------------
+// Get floating point index of point in block.
+void
+geomodelgrids::serial::Block::_getIndex(double index[],
+                                        const double x,
+                                        const double y,
+                                        const double z) const {
+    assert(x >= 0.0);
+    assert(y >= 0.0);
+    assert(z <= 0.0);
+
+    assert(_indexingX);
+    assert(_indexingY);
+    assert(_indexingZ);
+
+    // Axis type is fixed per block, so dispatch statically and let the lookup inline.
+    index[0] = (_coordinatesX) ?
+               static_cast<const geomodelgrids::utils::IndexingVariable*>(_indexingX)->getIndex(x) :
+               static_cast<const geomodelgrids::utils::IndexingUniform*>(_indexingX)->getIndex(x);
+    index[1] = (_coordinatesY) ?
+               static_cast<const geomodelgrids::utils::IndexingVariable*>(_indexingY)->getIndex(y) :
+               static_cast<const geomodelgrids::utils::IndexingUniform*>(_indexingY)->getIndex(y);
+    index[2] = (_coordinatesZ) ?
+               static_cast<const geomodelgrids::utils::IndexingVariable*>(_indexingZ)->getIndex(_zTop - z) :
+               static_cast<const geomodelgrids::utils::IndexingUniform*>(_indexingZ)->getIndex(_zTop - z);
+} // _getIndex
+
+
 // ------------------------------------------------------------------------------------------------
 // Compare order of blocks by z_top (descending order).
 bool
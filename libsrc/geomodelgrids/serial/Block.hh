@@ -91,12 +91,28 @@ public:
      */
     const size_t* getDims(void) const;
 
+    /** Get dimensions of chunks in HDF5 dataset of block.
+     *
+     * Hyperslab tiles are aligned with the chunks.
+     *
+     * @returns Dimensions of chunks [x, y, z, values] (all zero if the dataset is not chunked).
+     */
+    const size_t* getChunkDims(void) const;
+
     /** Get number of values stored at each grid point.
      *
      * @returns Number of values stored at each grid point.
      */
     size_t getNumValues(void) const;
 
+    /** Set whether each value is interpolated or uses the value at the nearest point.
+     *
+     * By default, all values are interpolated.
+     *
+     * @param[in] unitsBoolean Array with flag for each value (1 for interpolation, 0 for nearest point).
+     */
+    void setInterpolation(const std::vector<std::size_t>& unitsBoolean);
+
     /** Set hyperslab size.
      *
      * @param[in] dims Dimensions of hyperslab.
@@ -105,12 +121,76 @@ public:
     void setHyperslabDims(const size_t dims[],
                           const size_t ndims);
 
+    /** Set maximum size of hyperslab tile cache.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get hyperslab tile cache statistics.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from the HDF5 file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    /** Set whether values are stored in single precision (float) in hyperslabs and resident values.
+     *
+     * Applies to hyperslabs created and values loaded after this call.
+     *
+     * @param[in] value True to store values in single precision, false for double precision.
+     */
+    void setSinglePrecision(const bool value);
+
+    /** Create hyperslab for querying block.
+     *
+     * Each query context uses its own hyperslab, so blocks can be queried concurrently.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @returns Hyperslab for block (caller takes ownership).
+     */
+    geomodelgrids::serial::Hyperslab* createHyperslab(geomodelgrids::serial::HDF5* const h5) const;
+
+    /** Get size of values in block.
+     *
+     * @returns Size (in bytes) of values in block at the storage precision.
+     */
+    size_t getValuesSize(void) const;
+
+    /** Load values of entire block into memory, so queries do not read from the HDF5 file.
+     *
+     * The resident values are shared by hyperslabs created after this call.
+     *
+     * @param[in] h5 HDF5 with model.
+     */
+    void loadResident(geomodelgrids::serial::HDF5* const h5);
+
+    /** Are values of entire block resident in memory?
+     *
+     * @returns True if values are resident, false otherwise.
+     */
+    bool isResident(void) const;
+
     /** Prepare for querying.
      *
      * @param[in] h5 HDF5 with model.
      */
     void openQuery(geomodelgrids::serial::HDF5* const h5);
 
+    /** Query for values at a point using bilinear interpolation.
+     *
+     * Values are interpolated or use the nearest point as set by setInterpolation().
+     *
+     * @param[in] x X coordinate of point in model coordinate system.
+     * @param[in] y Y coordinate of point in model coordinate system.
+     * @param[in] z Z coordinate of point in model coordinate system.
+     * @returns Value of model at specified point.
+     */
+    const double* query(const double x,
+                        const double y,
+                        const double z);
+
     /** Query for values at a point using bilinear interpolation.
      *
      * @param[in] x X coordinate of point in model coordinate system.
@@ -122,7 +202,24 @@ public:
     const double* query(const double x,
                         const double y,
                         const double z,
-			const std::vector<std::size_t>& unitsBoolean);
+                        const std::vector<std::size_t>& unitsBoolean);
+
+    /** Query for values at a point using bilinear interpolation with given hyperslab.
+     *
+     * Values are interpolated or use the nearest point as set by setInterpolation(). No memory is
+     * allocated.
+     *
+     * @param[out] values Array of values at point (preallocated).
+     * @param[inout] hyperslab Hyperslab for block (from createHyperslab()).
+     * @param[in] x X coordinate of point in model coordinate system.
+     * @param[in] y Y coordinate of point in model coordinate system.
+     * @param[in] z Z coordinate of point in model coordinate system.
+     */
+    void query(double* const values,
+               geomodelgrids::serial::Hyperslab* const hyperslab,
+               const double x,
+               const double y,
+               const double z) const;
 
     // Cleanup after querying.
     void closeQuery(void);
@@ -137,6 +234,21 @@ public:
     bool compare(const std::shared_ptr<Block>& a,
                  const std::shared_ptr<Block>& b);
 
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Get floating point index of point in block.
+     *
+     * @param[out] index Floating point index of point [3].
+     * @param[in] x X coordinate of point in model coordinate system.
+     * @param[in] y Y coordinate of point in model coordinate system.
+     * @param[in] z Z coordinate of point in model coordinate system.
+     */
+    void _getIndex(double index[],
+                   const double x,
+                   const double y,
+                   const double z) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -157,8 +269,14 @@ private:
 
     double* _values;
     size_t _numValues; ///< Number of values stored at each grid point.
+    std::vector<std::size_t> _useInterpolation; ///< Interpolation flag for each value (1 for interpolation, 0 for nearest).
     size_t _dims[3]; ///< Number of points along grid in each coordinate dimension [x, y, z].
+    size_t _chunkDims[4]; ///< Dimensions of chunks in HDF5 dataset (all zero if not chunked).
     size_t _hyperslabDims[4]; ///< Dimensions of hyperslab.
+    size_t _cacheSize; ///< Maximum size (in bytes) of hyperslab tile cache (0 for default).
+    std::shared_ptr<const std::vector<double> > _residentValues; ///< Values of entire block (if resident).
+    std::shared_ptr<const std::vector<float> > _residentValuesFloat; ///< Values of entire block (if resident in single precision).
+    bool _singlePrecision; ///< True if values are stored in single precision.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
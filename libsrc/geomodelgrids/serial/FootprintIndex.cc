@@ -0,0 +1,224 @@
+#include <portinfo>
+
+#include "FootprintIndex.hh" // implementation of class methods
+
+#include <algorithm> // USES std::min(), std::max()
+#include <cmath> // USES std::isfinite(), floor()
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::FootprintIndex::FootprintIndex(void) :
+    _numModels(0) {
+    _origin[0] = 0.0;
+    _origin[1] = 0.0;
+    _cellSize[0] = 0.0;
+    _cellSize[1] = 0.0;
+    _numCells[0] = 0;
+    _numCells[1] = 0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::FootprintIndex::~FootprintIndex(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Build index.
+void
+geomodelgrids::serial::FootprintIndex::initialize(const std::vector<std::vector<double> >& footprints,
+                                                  const std::vector<double>& margins,
+                                                  const size_t numCells) {
+    assert(numCells > 0);
+    assert(margins.size() == footprints.size());
+
+    _numModels = footprints.size();
+
+    // Footprints with fewer than 3 vertices, non-finite coordinates, or without a valid margin are unknown.
+    std::vector<bool> isKnown(_numModels, false);
+    double bbox[4] = { 0.0, 0.0, 0.0, 0.0 }; // xmin, xmax, ymin, ymax
+    bool haveBBox = false;
+    for (size_t iModel = 0; iModel < _numModels; ++iModel) {
+        const std::vector<double>& polygon = footprints[iModel];
+        const size_t numVertices = polygon.size() / 2;
+        if ((numVertices < 3) || !std::isfinite(margins[iModel]) || (margins[iModel] < 0.0)) { continue; }
+
+        double modelBBox[4] = { polygon[0], polygon[0], polygon[1], polygon[1] };
+        bool isFinite = true;
+        for (size_t iVertex = 0; iVertex < numVertices; ++iVertex) {
+            const double x = polygon[2*iVertex+0];
+            const double y = polygon[2*iVertex+1];
+            if (!std::isfinite(x) || !std::isfinite(y)) {
+                isFinite = false;
+                break;
+            } // if
+            modelBBox[0] = std::min(modelBBox[0], x);
+            modelBBox[1] = std::max(modelBBox[1], x);
+            modelBBox[2] = std::min(modelBBox[2], y);
+            modelBBox[3] = std::max(modelBBox[3], y);
+        } // for
+        if (!isFinite) { continue; }
+
+        // Padded footprint must have a nonzero extent along both dimensions.
+        if (std::min(modelBBox[1]-modelBBox[0], modelBBox[3]-modelBBox[2]) + margins[iModel] <= 0.0) { continue; }
+        isKnown[iModel] = true;
+
+        modelBBox[0] -= margins[iModel];
+        modelBBox[1] += margins[iModel];
+        modelBBox[2] -= margins[iModel];
+        modelBBox[3] += margins[iModel];
+        if (!haveBBox) {
+            std::copy(modelBBox, modelBBox+4, bbox);
+            haveBBox = true;
+        } else {
+            bbox[0] = std::min(bbox[0], modelBBox[0]);
+            bbox[1] = std::max(bbox[1], modelBBox[1]);
+            bbox[2] = std::min(bbox[2], modelBBox[2]);
+            bbox[3] = std::max(bbox[3], modelBBox[3]);
+        } // if/else
+    } // for
+
+    _numCells[0] = haveBBox ? numCells : 0;
+    _numCells[1] = haveBBox ? numCells : 0;
+    _origin[0] = bbox[0];
+    _origin[1] = bbox[2];
+    _cellSize[0] = haveBBox ? (bbox[1] - bbox[0]) / numCells : 0.0;
+    _cellSize[1] = haveBBox ? (bbox[3] - bbox[2]) / numCells : 0.0;
+
+    const size_t numGridCells = _numCells[0] * _numCells[1];
+    _cellModels.assign((numGridCells+1)*_numModels, false);
+    for (size_t iModel = 0; iModel < _numModels; ++iModel) {
+        if (!isKnown[iModel]) {
+            for (size_t iCell = 0; iCell <= numGridCells; ++iCell) {
+                _cellModels[iCell*_numModels+iModel] = true;
+            } // for
+            continue;
+        } // if
+
+        const std::vector<double>& polygon = footprints[iModel];
+        for (size_t iy = 0; iy < _numCells[1]; ++iy) {
+            const double yMin = _origin[1] + iy*_cellSize[1] - margins[iModel];
+            const double yMax = _origin[1] + (iy+1)*_cellSize[1] + margins[iModel];
+            for (size_t ix = 0; ix < _numCells[0]; ++ix) {
+                const double xMin = _origin[0] + ix*_cellSize[0] - margins[iModel];
+                const double xMax = _origin[0] + (ix+1)*_cellSize[0] + margins[iModel];
+                const size_t iCell = iy*_numCells[0] + ix;
+                _cellModels[iCell*_numModels+iModel] = _intersects(polygon, xMin, xMax, yMin, yMax);
+            } // for
+        } // for
+    } // for
+} // initialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of models in index.
+size_t
+geomodelgrids::serial::FootprintIndex::getNumModels(void) const {
+    return _numModels;
+} // getNumModels
+
+
+// ------------------------------------------------------------------------------------------------
+// Get cell containing point.
+size_t
+geomodelgrids::serial::FootprintIndex::findCell(const double x,
+                                                const double y) const {
+    const size_t numGridCells = _numCells[0] * _numCells[1];
+    if (!numGridCells) {
+        return numGridCells;
+    } // if
+
+    const double xRel = (x - _origin[0]) / _cellSize[0];
+    const double yRel = (y - _origin[1]) / _cellSize[1];
+    if (!(xRel >= 0.0) || !(yRel >= 0.0) || (xRel > double(_numCells[0])) || (yRel > double(_numCells[1]))) {
+        return numGridCells;
+    } // if
+    const size_t ix = std::min(size_t(floor(xRel)), _numCells[0]-1);
+    const size_t iy = std::min(size_t(floor(yRel)), _numCells[1]-1);
+
+    return iy*_numCells[0] + ix;
+} // findCell
+
+
+// ------------------------------------------------------------------------------------------------
+// Can model contain points in cell?
+bool
+geomodelgrids::serial::FootprintIndex::isCandidate(const size_t iCell,
+                                                   const size_t iModel) const {
+    assert(iModel < _numModels);
+    assert(iCell*_numModels+iModel < _cellModels.size());
+    return _cellModels[iCell*_numModels+iModel];
+} // isCandidate
+
+
+// ------------------------------------------------------------------------------------------------
+// Can model contain point?
+bool
+geomodelgrids::serial::FootprintIndex::isCandidate(const size_t iModel,
+                                                   const double x,
+                                                   const double y) const {
+    return isCandidate(findCell(x, y), iModel);
+} // isCandidate
+
+
+// ------------------------------------------------------------------------------------------------
+// Does rectangle intersect polygon?
+bool
+geomodelgrids::serial::FootprintIndex::_intersects(const std::vector<double>& polygon,
+                                                   const double xMin,
+                                                   const double xMax,
+                                                   const double yMin,
+                                                   const double yMax) {
+    const size_t numVertices = polygon.size() / 2;
+
+    // Clip each edge against rectangle (Liang-Barsky).
+    for (size_t iVertex = 0; iVertex < numVertices; ++iVertex) {
+        const size_t iNext = (iVertex + 1) % numVertices;
+        const double x0 = polygon[2*iVertex+0];
+        const double y0 = polygon[2*iVertex+1];
+        const double dx = polygon[2*iNext+0] - x0;
+        const double dy = polygon[2*iNext+1] - y0;
+
+        const double p[4] = { -dx, dx, -dy, dy };
+        const double q[4] = { x0 - xMin, xMax - x0, y0 - yMin, yMax - y0 };
+        double t0 = 0.0;
+        double t1 = 1.0;
+        bool isOutside = false;
+        for (size_t i = 0; i < 4 && !isOutside; ++i) {
+            if (p[i] == 0.0) {
+                isOutside = q[i] < 0.0;
+            } else {
+                const double t = q[i] / p[i];
+                if (p[i] < 0.0) {
+                    t0 = std::max(t0, t);
+                } else {
+                    t1 = std::min(t1, t);
+                } // if/else
+                isOutside = t0 > t1;
+            } // if/else
+        } // for
+        if (!isOutside) {
+            return true;
+        } // if
+    } // for
+
+    // No edges intersect rectangle, so rectangle is either entirely inside or outside polygon.
+    const double xCenter = 0.5 * (xMin + xMax);
+    const double yCenter = 0.5 * (yMin + yMax);
+    bool isInside = false;
+    for (size_t iVertex = 0, iPrev = numVertices-1; iVertex < numVertices; iPrev = iVertex++) {
+        const double xi = polygon[2*iVertex+0];
+        const double yi = polygon[2*iVertex+1];
+        const double xj = polygon[2*iPrev+0];
+        const double yj = polygon[2*iPrev+1];
+        if (((yi > yCenter) != (yj > yCenter)) && (xCenter < (xj - xi) * (yCenter - yi) / (yj - yi) + xi)) {
+            isInside = !isInside;
+        } // if
+    } // for
+
+    return isInside;
+} // _intersects
+
+
+// End of file
@@ -0,0 +1,106 @@
+/** Grid index over horizontal footprints of models in the input CRS.
+ *
+ * Each footprint is a polygon approximating the horizontal extent of a model. The bounding box of
+ * all footprints is divided into a uniform grid, and each cell flags the models whose footprint
+ * (padded by the margin of the footprint) overlaps the cell. The index is conservative: a point inside a model is
+ * always in a cell flagged for that model, but a flagged cell may contain points outside the model.
+ * Models without a footprint (empty polygon or invalid margin) are flagged in every cell and outside
+ * the grid.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <cstddef> // USES size_t
+
+class geomodelgrids::serial::FootprintIndex {
+    friend class TestFootprintIndex; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    FootprintIndex(void);
+
+    /// Destructor
+    ~FootprintIndex(void);
+
+    /** Build index.
+     *
+     * @param[in] footprints Array of footprint polygons, one per model in priority order. Each
+     *   polygon is an array of vertex coordinates [numVertices*2] (empty if footprint is unknown).
+     * @param[in] margins Distance to pad each footprint, so that the padded polygon contains the model
+     *   (footprint is unknown if the margin is negative or not finite).
+     * @param[in] numCells Number of cells along each dimension of grid.
+     */
+    void initialize(const std::vector<std::vector<double> >& footprints,
+                    const std::vector<double>& margins,
+                    const size_t numCells=64);
+
+    /** Get number of models in index.
+     *
+     * @returns Number of models.
+     */
+    size_t getNumModels(void) const;
+
+    /** Get cell containing point.
+     *
+     * @param[in] x X coordinate of point (input CRS).
+     * @param[in] y Y coordinate of point (input CRS).
+     * @returns Index of cell (cell for points outside grid if point is outside the grid).
+     */
+    size_t findCell(const double x,
+                    const double y) const;
+
+    /** Can model contain points in cell?
+     *
+     * @param[in] iCell Index of cell from findCell().
+     * @param[in] iModel Index of model.
+     * @returns True if model may contain points in cell, false if it cannot.
+     */
+    bool isCandidate(const size_t iCell,
+                     const size_t iModel) const;
+
+    /** Can model contain point?
+     *
+     * @param[in] iModel Index of model.
+     * @param[in] x X coordinate of point (input CRS).
+     * @param[in] y Y coordinate of point (input CRS).
+     * @returns True if model may contain point, false if it cannot.
+     */
+    bool isCandidate(const size_t iModel,
+                     const double x,
+                     const double y) const;
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Does rectangle intersect polygon?
+     *
+     * @param[in] polygon Array of vertex coordinates [numVertices*2].
+     * @param[in] xMin Minimum x coordinate of rectangle.
+     * @param[in] xMax Maximum x coordinate of rectangle.
+     * @param[in] yMin Minimum y coordinate of rectangle.
+     * @param[in] yMax Maximum y coordinate of rectangle.
+     * @returns True if rectangle and polygon intersect, false otherwise.
+     */
+    static
+    bool _intersects(const std::vector<double>& polygon,
+                     const double xMin,
+                     const double xMax,
+                     const double yMin,
+                     const double yMax);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<bool> _cellModels; ///< Candidate flags [(numCells+1)*numModels]; last cell is outside grid.
+    double _origin[2]; ///< Minimum coordinates of grid.
+    double _cellSize[2]; ///< Size of cells along each dimension of grid.
+    size_t _numCells[2]; ///< Number of cells along each dimension of grid.
+    size_t _numModels; ///< Number of models.
+
+}; // FootprintIndex
+
+// End of file
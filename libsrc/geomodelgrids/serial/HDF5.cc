@@ -2,10 +2,13 @@
 
 #include "HDF5.hh" // implementation of class methods
 
+#include "HDF5Dataset.hh" // USES HDF5Dataset
+
 #include <cstring> // USES strlen()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
+#include <mutex> // USES std::mutex
 
 #if H5_VERSION_GE(1,12,0)
 #define GEOMODELGRIDS_HDF5_USE_API_112
@@ -57,7 +60,10 @@ geomodelgrids::serial::HDF5::HDF5(void) :
     _file(H5_NULL),
     _cacheSize(128*1048576),
     _cacheNumSlots(63997),
-    _cachePreemption(0.75) {}
+    _cachePreemption(0.75),
+    _datasetCacheSize(0),
+    _datasetCacheNumSlots(521),
+    _datasetCachePreemption(0.75) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -76,7 +82,19 @@ geomodelgrids::serial::HDF5::setCache(const size_t cacheSize,
     _cacheSize = cacheSize;
     _cacheNumSlots = nslots;
     _cachePreemption = std::max(0.0, std::min(1.0, preemption));
-} // setDatasetCache
+} // setCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Set chunk cache of each dataset opened for hyperslab reads.
+void
+geomodelgrids::serial::HDF5::setDatasetChunkCache(const size_t cacheSize,
+                                                  const size_t nslots,
+                                                  const double preemption) {
+    _datasetCacheSize = cacheSize;
+    _datasetCacheNumSlots = nslots;
+    _datasetCachePreemption = std::max(0.0, std::min(1.0, preemption));
+} // setDatasetChunkCache
 
 
 // ------------------------------------------------------------------------------------------------
@@ -86,6 +104,8 @@ geomodelgrids::serial::HDF5::open(const char* filename,
                                   hid_t mode) {
     assert(filename);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     if (_file >= 0) {
         throw std::runtime_error("HDF5 file already open.");
     } // if
@@ -120,6 +140,8 @@ geomodelgrids::serial::HDF5::open(const char* filename,
 // Close HDF5 file.
 void
 geomodelgrids::serial::HDF5::close(void) {
+    std::lock_guard<std::mutex> lock(getMutex());
+
     if (_file >= 0) {
         herr_t err = H5Fclose(_file);
         if (err < 0) {
@@ -145,6 +167,8 @@ geomodelgrids::serial::HDF5::hasGroup(const char* name) {
     assert(isOpen());
     assert(name);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -172,6 +196,8 @@ geomodelgrids::serial::HDF5::hasDataset(const char* name) {
     assert(isOpen());
     assert(name);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -203,6 +229,8 @@ geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
     assert(path);
     assert(isOpen());
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     try {
         _HDF5Access h5access;
 
@@ -227,6 +255,57 @@ geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
 } // getDatasetDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of chunks in dataset.
+void
+geomodelgrids::serial::HDF5::getDatasetChunkDims(hsize_t** dims,
+                                                 int* ndims,
+                                                 const char* path) {
+    assert(dims);
+    assert(ndims);
+    assert(path);
+    assert(isOpen());
+
+    std::lock_guard<std::mutex> lock(getMutex());
+
+    hid_t plist = H5_NULL;
+    try {
+        _HDF5Access h5access;
+
+        // Open the dataset
+        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        h5access.dataspace = H5Dget_space(h5access.dataset);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
+
+        plist = H5Dget_create_plist(h5access.dataset);
+        if (plist < 0) { throw std::runtime_error("Could not get dataset creation property list."); }
+
+        delete[] *dims;*dims = nullptr;
+        *ndims = 0;
+        if (H5D_CHUNKED == H5Pget_layout(plist)) {
+            const int ndimsAll = H5Sget_simple_extent_ndims(h5access.dataspace);
+            *dims = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
+            *ndims = H5Pget_chunk(plist, ndimsAll, *dims);
+            if (*ndims != ndimsAll) { throw std::runtime_error("Could not get chunk dimensions."); }
+        } // if
+
+        H5Pclose(plist);plist = H5_NULL;
+    } catch (const std::exception& err) {
+        if (plist >= 0) { H5Pclose(plist);plist = H5_NULL; }
+        delete[] *dims;*dims = nullptr;
+        *ndims = 0;
+
+        std::ostringstream msg;
+        msg << "Error occurred while reading dataset '"
+            << path << "':\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // getDatasetChunkDims
+
+
 // ------------------------------------------------------------------------------------------------
 // Get names of datasets in group.
 void
@@ -235,6 +314,8 @@ geomodelgrids::serial::HDF5::getGroupDatasets(std::vector<std::string>* names,
     assert(names);
     assert(isOpen());
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     try {
         _HDF5Access h5access;
 
@@ -277,6 +358,8 @@ geomodelgrids::serial::HDF5::hasAttribute(const char* path,
     assert(path);
     assert(name);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     htri_t exists = H5Aexists_by_name(_file, path, name, H5P_DEFAULT);
     return exists > 0;
 } // hasAttribute
@@ -293,6 +376,8 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(name);
     assert(value);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     try {
         _HDF5Access h5access;
 
@@ -323,6 +408,8 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(values);
     assert(valuesSize);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     try {
         _HDF5Access h5access;
 
@@ -361,6 +448,8 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(path);
     assert(name);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     std::string value;
 
     try {
@@ -415,6 +504,8 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
     assert(name);
     assert(values);
 
+    std::lock_guard<std::mutex> lock(getMutex());
+
     try {
         _HDF5Access h5access;
 
@@ -492,67 +583,18 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
     assert(dims);
     assert(_file > 0);
 
-    try {
-        _HDF5Access h5access;
-
-        // Open the dataset
-        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
-        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
-
-        h5access.dataspace = H5Dget_space(h5access.dataset);
-        if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
-
-        const int ndimsAll = H5Sget_simple_extent_ndims(h5access.dataspace);
-        hsize_t* dimsAll = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
-        H5Sget_simple_extent_dims(h5access.dataspace, dimsAll, nullptr);
-
-        // Validate arguments.
-        if (ndims != ndimsAll) {
-            std::ostringstream msg;
-            msg << "Rank of hyperslab origin and dimension (" << ndims
-                << ") does not match rank of dataset (" << ndimsAll << ").";
-            delete[] dimsAll;dimsAll = nullptr;
-            throw std::length_error(msg.str());
-        } // if
-        for (int i = 0; i < ndimsAll; ++i) {
-            if (origin[i] + dims[i] > dimsAll[i]) {
-                std::ostringstream msg;
-                msg << "Hyperslab extent in dimension " << i
-                    << " (origin:" << origin[i] << ", dim: " << dims[i] << ") "
-                    << "exceeds dataset dimension " << dimsAll[i] << ".";
-                delete[] dimsAll;dimsAll = nullptr;
-                throw std::length_error(msg.str());
-            } // if
-        } // for
-        delete[] dimsAll;dimsAll = nullptr;
-
-        // Stride and count are 1 for contiguous slab.
-        hsize_t* stride = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
-        hsize_t* count = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
-        for (int i = 0; i < ndimsAll; ++i) {
-            stride[i] = 1;
-            count[i] = 1;
-        } // for
-
-        hid_t memspace = H5Screate_simple(ndims, dims, dims);
-        if (memspace < 0) { throw std::runtime_error("Could not create memory space."); }
+    HDF5Dataset dataset(this, path);
+    dataset.readHyperslab(values, origin, dims, ndims, datatype);
+} // readDatasetHyperslab
 
-        herr_t err = H5Sselect_hyperslab(h5access.dataspace, H5S_SELECT_SET, origin, stride, count, dims);
-        delete[] stride;stride = nullptr;
-        delete[] count;count = nullptr;
-        if (err < 0) { throw std::runtime_error("Could not select hyperslab."); }
-        err = H5Dread(h5access.dataset, datatype, memspace, h5access.dataspace, H5P_DEFAULT, values);
-        if (err < 0) { throw std::runtime_error("Could not read hyperslab."); }
 
-        H5Sclose(memspace);memspace = H5_NULL;
-    } catch (const std::exception& err) {
-        std::ostringstream msg;
-        msg << "Error occurred while reading dataset '"
-            << path << "':\n"
-            << err.what();
-        throw std::runtime_error(msg.str());
-    } // try/catch
-} // readDatasetHyperslab
+// ------------------------------------------------------------------------------------------------
+// Get mutex serializing access to the HDF5 library.
+std::mutex&
+geomodelgrids::serial::HDF5::getMutex(void) {
+    static std::mutex libraryMutex;
+    return libraryMutex;
+} // getMutex
 
 
 // End of file
@@ -5,11 +5,13 @@
 #include "serialfwd.hh" // forward declarations
 
 #include <hdf5.h> // USES hid_t
+#include <mutex> // USES std::mutex
 #include <vector> // USES std::std::vector
 #include <string> // USGS std::string
 
 class geomodelgrids::serial::HDF5 {
     friend class TestHDF5; // Unit testing
+    friend class HDF5Dataset; // Uses open file
 
     // PUBLIC CONSTANTS ---------------------------------------------------------------------------
 public:
@@ -48,6 +50,21 @@ public:
                   const size_t nslots,
                   const double preemption=0.75);
 
+    /** Set chunk cache of each dataset opened for hyperslab reads.
+     *
+     * Applies to datasets opened after this call (see HDF5Dataset). Each open dataset has its own
+     * chunk cache. A cache size of 0 uses the chunk cache of the HDF5 file (see setCache()).
+     *
+     * See https://portal.hdfgroup.org/display/HDF5/H5P_SET_CHUNK_CACHE for more information.
+     *
+     * @param[in] cacheSize Dataset chunk cache size in bytes.
+     * @param[in] nslots Number of chunk slots.
+     * @param[in] preemption Preemption policy value.
+     */
+    void setDatasetChunkCache(const size_t cacheSize,
+                              const size_t nslots,
+                              const double preemption=0.75);
+
     /** Open HDF5.
      *
      * @param[in] filename Name of HDF5 file
@@ -89,6 +106,16 @@ public:
                         int* ndims,
                         const char* path);
 
+    /** Get dimensions of chunks in dataset.
+     *
+     * @param[out] dims Array of chunk dimensions (nullptr if dataset is not chunked).
+     * @param[out] ndims Number of dimensions (0 if dataset is not chunked).
+     * @param[in] path Full path to dataset.
+     */
+    void getDatasetChunkDims(hsize_t** dims,
+                             int* ndims,
+                             const char* path);
+
     /** Get names of datasets in group.
      *
      * @param[out[names Names of datasets.
@@ -152,7 +179,12 @@ public:
 
     /** Read hyperslab (subset of values) from dataset.
      *
-     * @param[out values Values of hyperslab.
+     * Reads are serialized, so this method may be called from concurrent query contexts.
+     *
+     * The dataset is opened and closed on every call; use HDF5Dataset for repeated reads from the
+     * same dataset.
+     *
+     * @param[out] values Values of hyperslab.
      * @param[in] path Full path to dataset.
      * @param[in] origin Origin of hyperslab in dataset.
      * @param[in] dims Dimensions of hyperslab.
@@ -166,6 +198,17 @@ public:
                               int ndims,
                               hid_t datatype);
 
+    /** Get mutex serializing access to the HDF5 library.
+     *
+     * The HDF5 library may not be built thread-safe. All HDF5 and HDF5Dataset methods hold this
+     * mutex while calling the HDF5 library. Code calling the HDF5 library directly while queries may
+     * be running in other threads must also hold it, but must not call HDF5 or HDF5Dataset methods
+     * while holding it.
+     *
+     * @returns Mutex shared by all HDF5 files and datasets.
+     */
+    static std::mutex& getMutex(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -173,6 +216,9 @@ private:
     size_t _cacheSize; ///< Dataset cache size (in bytes).
     size_t _cacheNumSlots; ///< Number of chunk slots in dataset cache.
     double _cachePreemption; ///< Preemption policy value for cache.
+    size_t _datasetCacheSize; ///< Chunk cache size (in bytes) of each dataset (0 for file cache).
+    size_t _datasetCacheNumSlots; ///< Number of chunk slots in chunk cache of each dataset.
+    double _datasetCachePreemption; ///< Preemption policy value for chunk cache of each dataset.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
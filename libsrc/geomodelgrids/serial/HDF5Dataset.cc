@@ -0,0 +1,149 @@
+#include <portinfo>
+
+#include "HDF5Dataset.hh" // implementation of class methods
+
+#include "HDF5.hh" // USES HDF5
+
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+#include <algorithm> // USES std::equal()
+#include <mutex> // USES std::lock_guard
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::HDF5Dataset::HDF5Dataset(geomodelgrids::serial::HDF5* const h5,
+                                                const char* path) :
+    _path(path),
+    _dataset(HDF5::H5_NULL),
+    _dataspace(HDF5::H5_NULL),
+    _memspace(HDF5::H5_NULL) {
+    assert(h5);
+    assert(path);
+    assert(h5->_file > 0);
+
+    try {
+        std::lock_guard<std::mutex> lock(HDF5::getMutex());
+
+        hid_t datasetAccess = H5P_DEFAULT;
+        if (h5->_datasetCacheSize > 0) {
+            datasetAccess = H5Pcreate(H5P_DATASET_ACCESS);
+            if (datasetAccess < 0) { throw std::runtime_error("Could not create dataset access property list."); }
+            const herr_t err = H5Pset_chunk_cache(datasetAccess, h5->_datasetCacheNumSlots, h5->_datasetCacheSize,
+                                                  h5->_datasetCachePreemption);
+            if (err < 0) {
+                H5Pclose(datasetAccess);
+                throw std::runtime_error("Could not set dataset chunk cache properties.");
+            } // if
+        } // if
+
+        _dataset = H5Dopen2(h5->_file, path, datasetAccess);
+        if (datasetAccess != H5P_DEFAULT) { H5Pclose(datasetAccess); }
+        if (_dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        _dataspace = H5Dget_space(_dataset);
+        if (_dataspace < 0) {
+            H5Dclose(_dataset);_dataset = HDF5::H5_NULL;
+            throw std::runtime_error("Could not get dataspace.");
+        } // if
+
+        const int ndims = H5Sget_simple_extent_ndims(_dataspace);
+        _dims.resize(ndims > 0 ? ndims : 0);
+        H5Sget_simple_extent_dims(_dataspace, _dims.data(), nullptr);
+        _ones.resize(_dims.size(), 1);
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while reading dataset '"
+            << path << "':\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::HDF5Dataset::~HDF5Dataset(void) {
+    std::lock_guard<std::mutex> lock(HDF5::getMutex());
+
+    if (_memspace >= 0) { H5Sclose(_memspace);_memspace = HDF5::H5_NULL; }
+    if (_dataspace >= 0) { H5Sclose(_dataspace);_dataspace = HDF5::H5_NULL; }
+    if (_dataset >= 0) { H5Dclose(_dataset);_dataset = HDF5::H5_NULL; }
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get full path to dataset.
+const std::string&
+geomodelgrids::serial::HDF5Dataset::getPath(void) const {
+    return _path;
+} // getPath
+
+
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of dataset.
+const std::vector<hsize_t>&
+geomodelgrids::serial::HDF5Dataset::getDims(void) const {
+    return _dims;
+} // getDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Read hyperslab from dataset.
+void
+geomodelgrids::serial::HDF5Dataset::readHyperslab(void* values,
+                                                  const hsize_t* const origin,
+                                                  const hsize_t* const dims,
+                                                  const int ndims,
+                                                  hid_t datatype) {
+    assert(values);
+    assert(origin);
+    assert(dims);
+    assert(_dataset >= 0);
+
+    try {
+        // Validate arguments.
+        const int ndimsAll = int(_dims.size());
+        if (ndims != ndimsAll) {
+            std::ostringstream msg;
+            msg << "Rank of hyperslab origin and dimension (" << ndims
+                << ") does not match rank of dataset (" << ndimsAll << ").";
+            throw std::length_error(msg.str());
+        } // if
+        for (int i = 0; i < ndimsAll; ++i) {
+            if (origin[i] + dims[i] > _dims[i]) {
+                std::ostringstream msg;
+                msg << "Hyperslab extent in dimension " << i
+                    << " (origin:" << origin[i] << ", dim: " << dims[i] << ") "
+                    << "exceeds dataset dimension " << _dims[i] << ".";
+                throw std::length_error(msg.str());
+            } // if
+        } // for
+
+        // The HDF5 library may not be built thread-safe.
+        std::lock_guard<std::mutex> lock(HDF5::getMutex());
+
+        // Reuse memory dataspace if the hyperslab dimensions are unchanged.
+        if ((_memspace < 0) || !std::equal(_memspaceDims.begin(), _memspaceDims.end(), dims)) {
+            if (_memspace >= 0) { H5Sclose(_memspace);_memspace = HDF5::H5_NULL; }
+            _memspace = H5Screate_simple(ndims, dims, dims);
+            if (_memspace < 0) { throw std::runtime_error("Could not create memory space."); }
+            _memspaceDims.assign(dims, dims+ndims);
+        } // if
+
+        // Stride and count are 1 for contiguous slab.
+        herr_t err = H5Sselect_hyperslab(_dataspace, H5S_SELECT_SET, origin, _ones.data(), _ones.data(), dims);
+        if (err < 0) { throw std::runtime_error("Could not select hyperslab."); }
+        err = H5Dread(_dataset, datatype, _memspace, _dataspace, H5P_DEFAULT, values);
+        if (err < 0) { throw std::runtime_error("Could not read hyperslab."); }
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while reading dataset '"
+            << _path << "':\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // readHyperslab
+
+
+// End of file
@@ -0,0 +1,81 @@
+/** Open dataset in an HDF5 file for repeated hyperslab reads.
+ *
+ * The dataset, its dataspace, and the memory dataspace for the most recent hyperslab dimensions stay
+ * open for the lifetime of the object, so repeated reads do not look up the dataset by path or
+ * query its extent.
+ *
+ * Destroy the dataset before closing the HDF5 file.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <hdf5.h> // USES hid_t, hsize_t
+#include <string> // HASA std::string
+#include <vector> // HASA std::vector
+
+class geomodelgrids::serial::HDF5Dataset {
+    friend class TestHDF5Dataset; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor.
+     *
+     * @param[in] h5 Open HDF5 file.
+     * @param[in] path Full path to dataset.
+     */
+    HDF5Dataset(geomodelgrids::serial::HDF5* const h5,
+                const char* path);
+
+    /// Destructor
+    ~HDF5Dataset(void);
+
+    /** Get full path to dataset.
+     *
+     * @returns Full path to dataset.
+     */
+    const std::string& getPath(void) const;
+
+    /** Get dimensions of dataset.
+     *
+     * @returns Array of dimensions.
+     */
+    const std::vector<hsize_t>& getDims(void) const;
+
+    /** Read hyperslab (subset of values) from dataset.
+     *
+     * Reads are serialized, so this method may be called from concurrent query contexts.
+     *
+     * @param[out] values Values of hyperslab.
+     * @param[in] origin Origin of hyperslab in dataset.
+     * @param[in] dims Dimensions of hyperslab.
+     * @param[in] ndims Number of dimensions of hyperslab.
+     * @param[in] datatype Type of data in dataset.
+     */
+    void readHyperslab(void* values,
+                       const hsize_t* const origin,
+                       const hsize_t* const dims,
+                       int ndims,
+                       hid_t datatype);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::string _path; ///< Full path to dataset.
+    hid_t _dataset; ///< HDF5 dataset.
+    hid_t _dataspace; ///< HDF5 dataspace of dataset.
+    hid_t _memspace; ///< HDF5 dataspace of hyperslab in memory.
+    std::vector<hsize_t> _dims; ///< Dimensions of dataset.
+    std::vector<hsize_t> _memspaceDims; ///< Dimensions of hyperslab in memory dataspace.
+    std::vector<hsize_t> _ones; ///< Stride and count for contiguous hyperslab.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    HDF5Dataset(const HDF5Dataset&); ///< Not implemented
+    const HDF5Dataset& operator=(const HDF5Dataset&); ///< Not implemented
+
+}; // HDF5Dataset
+
+// End of file
@@ -3,6 +3,8 @@
 #include "Hyperslab.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/HDF5Dataset.hh" // USES HDF5Dataset
+#include "geomodelgrids/serial/HyperslabKernels.hh" // USES HyperslabKernels
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include <stdexcept> // USES std::runtime_error
@@ -10,6 +12,10 @@
 #include <cassert> // USES assert()
 #include <cmath> // USES floor()
 #include <algorithm> // USES std::min(), std::max()
+#include <iterator> // USES std::prev()
+#include <list> // USES std::list
+#include <unordered_map> // USES std::unordered_map
+#include <vector> // USES std::vector
 
 #if !defined(CALL_MEMBER_FN)
 #define CALL_MEMBER_FN(object,ptrToMember)  ((object).*(ptrToMember))
@@ -30,12 +36,31 @@ public:
 
     /** Get values for hyperslab containing target point.
      *
-     * Use current hyperslab if possible.
+     * Use current tile if possible, then resident tiles, and read the tile from the HDF5 file otherwise.
      *
      * @param[in] indexFloat Floating point index of target point.
      */
     void getSlab(const double indexFloat[]);
 
+    /** Evict least recently used tiles until cache holds no more than the given number of tiles.
+     *
+     * @param[in] maxTiles Maximum number of resident tiles (at least 1 is always kept).
+     */
+    void evict(const size_t maxTiles);
+
+    /** Read values of entire dataset.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] path Full path to dataset.
+     * @param[in] datatype Native HDF5 type matching T.
+     * @returns Values of entire dataset.
+     */
+    template<typename T>
+    static
+    std::shared_ptr<const std::vector<T> > readDataset(geomodelgrids::serial::HDF5* const h5,
+                                                       const char* path,
+                                                       hid_t datatype);
+
     /** Compute values at point using bilinear interpolation.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -44,6 +69,18 @@ public:
     void interpolate(double* const values,
                      const double indexFloat[]);
 
+    /** Compute values at multiple points using bilinear interpolation.
+     *
+     * Consecutive points in the same slab are interpolated together with one slab lookup.
+     *
+     * @param[out] values Preallocated array for interpolated values (numPoints x numValues).
+     * @param[in] indexFloat Floating point indices of target points (numPoints x spaceDim).
+     * @param[in] numPoints Number of target points.
+     */
+    void interpolateMany(double* const values,
+                         const double indexFloat[],
+                         const size_t numPoints);
+
     /** Get values at nearest point.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -52,32 +89,118 @@ public:
     void nearest(double* const values,
                  const double indexFloat[]);
 
+    /** Compute values at point using bilinear interpolation or nearest point for each value.
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] indexFloat Floating point index of target point.
+     * @param[in] useInterpolation Array with interpolation flag for each value.
+     */
+    void query(double* const values,
+               const double indexFloat[],
+               const size_t useInterpolation[]);
+
 private:
 
+    /// Tile of dataset resident in memory.
+    struct Tile {
+        size_t key; ///< Index of tile in tile grid.
+        std::vector<hsize_t> origin; ///< Origin of tile relative to dataset.
+        std::vector<hsize_t> dims; ///< Dimensions of tile (smaller than hyperslab at end of chunked dataset).
+        std::vector<double> values; ///< Values in tile (double precision).
+        std::vector<float> valuesFloat; ///< Values in tile (single precision).
+    };
+    typedef std::list<Tile> tile_list_type;
+
     typedef void (_Hyperslab::*interpolate_fn_type)(double* const values,
                                                     const double indexFloat[]);
+    typedef void (_Hyperslab::*query_fn_type)(double* const values,
+                                              const double indexFloat[],
+                                              const size_t useInterpolation[]);
+    typedef void (_Hyperslab::*interpolate_many_fn_type)(double* const values,
+                                                         const double indexFloat[],
+                                                         const size_t numPoints);
+
+    /** Does current slab contain target point?
+     *
+     * @param[in] indexFloat Floating point index of target point.
+     * @returns True if current slab contains target point, false otherwise.
+     */
+    bool _inSlab(const double indexFloat[]) const;
+
+    /** Get origin and dimension of tile along a spatial dimension.
+     *
+     * @param[out] origin Origin of tile along dimension.
+     * @param[out] dim Dimension of tile along dimension.
+     * @param[in] tileIndex Index of tile along dimension.
+     * @param[in] iDim Spatial dimension.
+     */
+    void _getTileExtent(hsize_t* origin,
+                        hsize_t* dim,
+                        const size_t tileIndex,
+                        const size_t iDim) const;
+
+    /** Get tile from cache, reading it from the HDF5 file if it is not resident.
+     *
+     * @param[in] tileIndex Index of tile along each spatial dimension.
+     * @returns Resident tile.
+     */
+    Tile& _getTile(const size_t tileIndex[]);
+
+    /** Gather values at corners of cell spanning adjacent tiles into current slab.
+     *
+     * @param[in] indexFloat Floating point index of target point.
+     */
+    void _getCell(const double indexFloat[]);
 
     /** Compute values at point using bilinear interpolation in 2-D.
+     *
+     * Type of stored values is given by template parameter T.
      *
      * @param[out] values Preallocated array for interpolated values.
      * @param[in] indexFloat Floating point index of target point.
      */
+    template<typename T>
     void _interpolate2D(double* const values,
                         const double indexFloat[]);
 
     /** Compute values at point using bilinear interpolation in 3-D.
+     *
+     * Type of stored values is given by template parameter T.
      *
      * @param[out] values Preallocated array for interpolated values.
      * @param[in] indexFloat Floating point index of target point.
      */
+    template<typename T>
     void _interpolate3D(double* const values,
                         const double indexFloat[]);
 
+    /** Compute values at multiple points in current slab using bilinear (2-D) or trilinear (3-D)
+     * interpolation.
+     *
+     * The strides and corner offsets of the slab are computed once for all of the points.
+     *
+     * @param[out] values Preallocated array for interpolated values (numPoints x numValues).
+     * @param[in] indexFloat Floating point indices of target points (numPoints x spaceDim).
+     * @param[in] numPoints Number of target points.
+     */
+    template<typename T, size_t spaceDim>
+    void _interpolateSlab(double* const values,
+                          const double indexFloat[],
+                          const size_t numPoints);
+
+    /** Get kernel for values of type T.
+     *
+     * @returns Kernel for interpolation from values at cell corners.
+     */
+    template<typename T>
+    typename HyperslabKernels::Kernel<T>::fn_type _getKernel(void) const;
+
     /** Get nearest values in 2-D.
      *
      * @param[out] values Preallocated array for interpolated values.
      * @param[in] indexFloat Floating point index of target point.
      */
+    template<typename T>
     void _nearest2D(double* const values,
                     const double indexFloat[]);
 
@@ -86,12 +209,74 @@ private:
      * @param[out] values Preallocated array for interpolated values.
      * @param[in] indexFloat Floating point index of target point.
      */
+    template<typename T>
     void _nearest3D(double* const values,
                     const double indexFloat[]);
 
+    /** Compute values using bilinear interpolation or nearest point for each value in 2-D.
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] indexFloat Floating point index of target point.
+     * @param[in] useInterpolation Array with interpolation flag for each value.
+     */
+    template<typename T>
+    void _query2D(double* const values,
+                  const double indexFloat[],
+                  const size_t useInterpolation[]);
+
+    /** Compute values using bilinear interpolation or nearest point for each value in 3-D.
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] indexFloat Floating point index of target point.
+     * @param[in] useInterpolation Array with interpolation flag for each value.
+     */
+    template<typename T>
+    void _query3D(double* const values,
+                  const double indexFloat[],
+                  const size_t useInterpolation[]);
+
+    /** Get cell corners, interpolation weights, and nearest point for target point in 2-D.
+     *
+     * @param[out] corners Array of 4 offsets of values at cell corners.
+     * @param[out] wts Array of 4 interpolation weights.
+     * @param[out] nearest Offset of values at nearest point.
+     * @param[in] indexFloat Floating point index of target point.
+     */
+    void _cell2D(size_t corners[],
+                 double wts[],
+                 size_t* nearest,
+                 const double indexFloat[]) const;
+
+    /** Get cell corners, interpolation weights, and nearest point for target point in 3-D.
+     *
+     * @param[out] corners Array of 8 offsets of values at cell corners.
+     * @param[out] wts Array of 8 interpolation weights.
+     * @param[out] nearest Offset of values at nearest point.
+     * @param[in] indexFloat Floating point index of target point.
+     */
+    void _cell3D(size_t corners[],
+                 double wts[],
+                 size_t* nearest,
+                 const double indexFloat[]) const;
+
     geomodelgrids::serial::Hyperslab& _hyperslab; ///< Reference to hyperslab.
     interpolate_fn_type _interpolate; ///< Function for interpolation.
     interpolate_fn_type _nearest; ///< Function for nearest.
+    query_fn_type _query; ///< Function for interpolation or nearest for each value.
+    interpolate_many_fn_type _interpolateMany; ///< Function for interpolation at points in current slab.
+    HyperslabKernels::Kernel<double>::fn_type _kernel; ///< Kernel for values in double precision.
+    HyperslabKernels::Kernel<float>::fn_type _kernelFloat; ///< Kernel for values in single precision.
+
+    tile_list_type _tiles; ///< Resident tiles, most recently used first.
+    std::unordered_map<size_t, tile_list_type::iterator> _tileMap; ///< Map from tile key to resident tile.
+    std::vector<hsize_t> _strides; ///< Spacing of tile origins along each spatial dimension.
+    std::vector<size_t> _numTiles; ///< Number of tiles along each spatial dimension.
+    size_t _tileSize; ///< Number of values in a tile.
+    std::vector<hsize_t> _residentOrigin; ///< Origin of resident dataset (all zeros).
+    std::vector<hsize_t> _cellOrigin; ///< Origin of cell spanning adjacent tiles.
+    std::vector<hsize_t> _cellDims; ///< Dimensions of cell spanning adjacent tiles.
+    std::vector<double> _cellValues; ///< Values at corners of cell spanning adjacent tiles (double precision).
+    std::vector<float> _cellValuesFloat; ///< Values at corners of cell spanning adjacent tiles (single precision).
 
 }; // _Hyperslab
 
@@ -103,11 +288,19 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
                                             const size_t ndims) :
     _h5(h5),
     _datasetPath(path),
+    _dataset(nullptr),
     _ndims(ndims),
     _origin(nullptr),
     _dims(_ndims > 0 ? new hsize_t[_ndims] : nullptr),
     _dimsAll(nullptr),
+    _chunkDims(nullptr),
+    _currentDims(nullptr),
     _values(nullptr),
+    _singlePrecision(false),
+    _cacheSize(32*1024*1024),
+    _numHits(0),
+    _numMisses(0),
+    _numChunksRead(0),
     _hyperslab(nullptr) {
     assert(_h5);
     int ndimsAll = 0;
@@ -123,12 +316,23 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
         throw std::length_error(msg.str());
     } // if
 
-    hsize_t totalSize = 1;
     for (size_t i = 0; i < ndims; ++i) {
         _dims[i] = std::min(dims[i], _dimsAll[i]);
-        totalSize *= _dims[i];
     } // for
-    _values = (totalSize > 0) ? new double[totalSize] : nullptr;
+
+    // Align tiles with chunks along spatial dimensions (last dimension is values).
+    int nchunkDims = 0;
+    h5->getDatasetChunkDims(&_chunkDims, &nchunkDims, path);
+    if (_ndims == size_t(nchunkDims)) {
+        for (size_t i = 0; i < _ndims-1; ++i) {
+            if (_dims[i] < _dimsAll[i]) {
+                const hsize_t numChunks = std::max(hsize_t(1), (_dims[i] + _chunkDims[i]/2) / _chunkDims[i]);
+                _dims[i] = std::min(numChunks*_chunkDims[i], _dimsAll[i]);
+            } // if
+        } // for
+    } else {
+        delete[] _chunkDims;_chunkDims = nullptr;
+    } // if/else
 
     delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
 } // constructor
@@ -137,15 +341,193 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
 // ------------------------------------------------------------------------------------------------
 // Destructor
 geomodelgrids::serial::Hyperslab::~Hyperslab(void) {
-    delete[] _origin;_origin = nullptr;
     delete[] _dims;_dims = nullptr;
     delete[] _dimsAll;_dimsAll = nullptr;
-    delete[] _values;_values = nullptr;
+    delete[] _chunkDims;_chunkDims = nullptr;
 
+    // Tile origin and values are owned by the tile cache.
+    _origin = nullptr;
+    _values = nullptr;
     delete _hyperslab;_hyperslab = nullptr;
+    delete _dataset;_dataset = nullptr;
 } // destructor
 
 
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of tile cache.
+void
+geomodelgrids::serial::Hyperslab::setCacheSize(const size_t numBytes) {
+    _cacheSize = numBytes;
+
+    assert(_hyperslab);
+    _hyperslab->evict(getCacheCapacity());
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum size of tile cache.
+size_t
+geomodelgrids::serial::Hyperslab::getCacheSize(void) const {
+    return _cacheSize;
+} // getCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum number of resident tiles.
+size_t
+geomodelgrids::serial::Hyperslab::getCacheCapacity(void) const {
+    size_t tileBytes = (_singlePrecision) ? sizeof(float) : sizeof(double);
+    for (size_t i = 0; i < _ndims; ++i) {
+        tileBytes *= _dims[i];
+    } // for
+
+    return (tileBytes > 0) ? std::max(size_t(1), _cacheSize / tileBytes) : 1;
+} // getCacheCapacity
+
+
+// ------------------------------------------------------------------------------------------------
+// Get tile cache statistics.
+void
+geomodelgrids::serial::Hyperslab::getCacheStats(size_t* numHits,
+                                                size_t* numMisses) const {
+    if (numHits) { *numHits = _numHits; }
+    if (numMisses) { *numMisses = _numMisses; }
+} // getCacheStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of dataset chunks read.
+size_t
+geomodelgrids::serial::Hyperslab::getNumChunksRead(void) const {
+    return _numChunksRead;
+} // getNumChunksRead
+
+
+// ------------------------------------------------------------------------------------------------
+// Reset tile cache statistics.
+void
+geomodelgrids::serial::Hyperslab::resetCacheStats(void) {
+    _numHits = 0;
+    _numMisses = 0;
+    _numChunksRead = 0;
+} // resetCacheStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether values are stored in single precision.
+void
+geomodelgrids::serial::Hyperslab::setSinglePrecision(const bool value) {
+    if (value == _singlePrecision) {
+        return;
+    } // if
+    if (isResident()) {
+        std::ostringstream msg;
+        msg << "Cannot change precision of values for dataset '" << _datasetPath << "' resident in memory.";
+        throw std::logic_error(msg.str());
+    } // if
+
+    _singlePrecision = value;
+
+    // Tiles in cache have the previous precision.
+    _origin = nullptr;
+    _values = nullptr;
+    delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
+} // setSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Are values stored in single precision?
+bool
+geomodelgrids::serial::Hyperslab::isSinglePrecision(void) const {
+    return _singlePrecision;
+} // isSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Use values of entire dataset resident in memory.
+void
+geomodelgrids::serial::Hyperslab::setResident(const std::shared_ptr<const std::vector<double> >& values) {
+    assert(values);
+    _checkResidentSize(values->size());
+
+    _resident = values;
+    _residentFloat.reset();
+    _singlePrecision = false;
+    for (size_t i = 0; i < _ndims; ++i) {
+        _dims[i] = _dimsAll[i];
+    } // for
+
+    // Resident dataset replaces tile cache.
+    _origin = nullptr;
+    _values = nullptr;
+    delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
+} // setResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Use values of entire dataset resident in memory in single precision.
+void
+geomodelgrids::serial::Hyperslab::setResident(const std::shared_ptr<const std::vector<float> >& values) {
+    assert(values);
+    _checkResidentSize(values->size());
+
+    _resident.reset();
+    _residentFloat = values;
+    _singlePrecision = true;
+    for (size_t i = 0; i < _ndims; ++i) {
+        _dims[i] = _dimsAll[i];
+    } // for
+
+    // Resident dataset replaces tile cache.
+    _origin = nullptr;
+    _values = nullptr;
+    delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
+} // setResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Is entire dataset resident in memory?
+bool
+geomodelgrids::serial::Hyperslab::isResident(void) const {
+    return _resident || _residentFloat;
+} // isResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values of entire dataset into memory.
+std::shared_ptr<const std::vector<double> >
+geomodelgrids::serial::Hyperslab::readResident(geomodelgrids::serial::HDF5* const h5,
+                                               const char* path) {
+    return _Hyperslab::readDataset<double>(h5, path, H5T_NATIVE_DOUBLE);
+} // readResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values of entire dataset into memory in single precision.
+std::shared_ptr<const std::vector<float> >
+geomodelgrids::serial::Hyperslab::readResidentFloat(geomodelgrids::serial::HDF5* const h5,
+                                                    const char* path) {
+    return _Hyperslab::readDataset<float>(h5, path, H5T_NATIVE_FLOAT);
+} // readResidentFloat
+
+
+// ------------------------------------------------------------------------------------------------
+// Check size of resident values against size of dataset.
+void
+geomodelgrids::serial::Hyperslab::_checkResidentSize(const size_t numValues) const {
+    size_t size = 1;
+    for (size_t i = 0; i < _ndims; ++i) {
+        size *= _dimsAll[i];
+    } // for
+    if (numValues != size) {
+        std::ostringstream msg;
+        msg << "Size of resident values (" << numValues << ") for dataset '" << _datasetPath
+            << "' does not match size of dataset (" << size << ").";
+        throw std::length_error(msg.str());
+    } // if
+} // _checkResidentSize
+
+
 // ------------------------------------------------------------------------------------------------
 // Compute values at point using bilinear interpolation.
 void
@@ -157,6 +539,18 @@ geomodelgrids::serial::Hyperslab::interpolate(double* const values,
 } // interpolate
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute values at multiple points using bilinear interpolation.
+void
+geomodelgrids::serial::Hyperslab::interpolateMany(double* const values,
+                                                  const double indexFloat[],
+                                                  const size_t numPoints) {
+    assert(_hyperslab);
+    assert(!numPoints || (values && indexFloat));
+    _hyperslab->interpolateMany(values, indexFloat, numPoints);
+} // interpolateMany
+
+
 // ------------------------------------------------------------------------------------------------
 // Get values at nearest point.
 void
@@ -168,21 +562,99 @@ geomodelgrids::serial::Hyperslab::nearest(double* const values,
 } // nearest
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute values at point using bilinear interpolation or nearest point for each value.
+void
+geomodelgrids::serial::Hyperslab::query(double* const values,
+                                        const double indexFloat[],
+                                        const size_t useInterpolation[]) {
+    assert(_hyperslab);
+    _hyperslab->getSlab(indexFloat);
+    _hyperslab->query(values, indexFloat, useInterpolation);
+} // query
+
+
 // ------------------------------------------------------------------------------------------------
 // Constructor.
 geomodelgrids::serial::_Hyperslab::_Hyperslab(geomodelgrids::serial::Hyperslab& hyperslab) :
-    _hyperslab(hyperslab) {
-    if (3 == hyperslab._ndims-1) {
-        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate3D;
-        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest3D;
+    _hyperslab(hyperslab),
+    _kernel(nullptr),
+    _kernelFloat(nullptr),
+    _tileSize(1) {
+    // Kernels use widest instruction set supported by the processor. Values with NODATA_VALUE are
+    // only checked in 3-D.
+    const HyperslabKernels::InstructionSetEnum instructionSet = HyperslabKernels::getInstructionSet();
+    if ((3 == hyperslab._ndims-1) && hyperslab._singlePrecision) {
+        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate3D<float>;
+        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest3D<float>;
+        _query = &geomodelgrids::serial::_Hyperslab::_query3D<float>;
+        _interpolateMany = &geomodelgrids::serial::_Hyperslab::_interpolateSlab<float, 3>;
+        _kernelFloat = HyperslabKernels::getKernel<float>(instructionSet, 8, true);
+    } else if (3 == hyperslab._ndims-1) {
+        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate3D<double>;
+        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest3D<double>;
+        _query = &geomodelgrids::serial::_Hyperslab::_query3D<double>;
+        _interpolateMany = &geomodelgrids::serial::_Hyperslab::_interpolateSlab<double, 3>;
+        _kernel = HyperslabKernels::getKernel<double>(instructionSet, 8, true);
+    } else if ((2 == hyperslab._ndims-1) && hyperslab._singlePrecision) {
+        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate2D<float>;
+        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest2D<float>;
+        _query = &geomodelgrids::serial::_Hyperslab::_query2D<float>;
+        _interpolateMany = &geomodelgrids::serial::_Hyperslab::_interpolateSlab<float, 2>;
+        _kernelFloat = HyperslabKernels::getKernel<float>(instructionSet, 4, false);
     } else if (2 == hyperslab._ndims-1) {
-        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate2D;
-        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest2D;
+        _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate2D<double>;
+        _nearest = &geomodelgrids::serial::_Hyperslab::_nearest2D<double>;
+        _query = &geomodelgrids::serial::_Hyperslab::_query2D<double>;
+        _interpolateMany = &geomodelgrids::serial::_Hyperslab::_interpolateSlab<double, 2>;
+        _kernel = HyperslabKernels::getKernel<double>(instructionSet, 4, false);
     } else {
         std::ostringstream msg;
         msg << "Expect ndims (" << hyperslab._ndims << ") to be 2 or 3 in geomodelgrids::serial::Hyperslab.";
         throw std::domain_error(msg.str());
     } // if/else
+
+    // Tile grid: chunk-aligned tiles do not overlap; otherwise adjacent tiles overlap by one point so
+    // that each cell lies entirely within a tile.
+    const size_t spaceDim = hyperslab._ndims - 1; // last dimension is values
+    const hsize_t* dims = hyperslab._dims;
+    const hsize_t* dimsAll = hyperslab._dimsAll;
+    _strides.resize(spaceDim);
+    _numTiles.resize(spaceDim);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (hyperslab._chunkDims) {
+            _strides[i] = dims[i];
+            _numTiles[i] = (dimsAll[i] + dims[i] - 1) / dims[i];
+        } else {
+            _strides[i] = (dims[i] > 1) ? dims[i] - 1 : 1;
+            _numTiles[i] = (dimsAll[i] > dims[i]) ? 1 + (dimsAll[i] - dims[i] + _strides[i] - 1) / _strides[i] : 1;
+        } // if/else
+    } // for
+    for (size_t i = 0; i < hyperslab._ndims; ++i) {
+        _tileSize *= dims[i];
+    } // for
+    hyperslab._currentDims = dims;
+
+    // Cell spanning adjacent tiles has at most 2 points along each spatial dimension.
+    _cellOrigin.resize(hyperslab._ndims, 0);
+    _cellDims.resize(hyperslab._ndims, 1);
+    const size_t numCellValues = (1 << spaceDim) * dims[spaceDim];
+    if (hyperslab._singlePrecision) {
+        _cellValuesFloat.resize(numCellValues);
+    } else {
+        _cellValues.resize(numCellValues);
+    } // if/else
+
+    // Resident dataset is a single tile that is always current.
+    if (hyperslab.isResident()) {
+        _residentOrigin.resize(hyperslab._ndims, 0);
+        hyperslab._origin = _residentOrigin.data();
+        if (hyperslab._resident) {
+            hyperslab._values = hyperslab._resident->data();
+        } else {
+            hyperslab._values = hyperslab._residentFloat->data();
+        } // if/else
+    } // if
 } // constructor
 
 
@@ -194,39 +666,287 @@ geomodelgrids::serial::_Hyperslab::~_Hyperslab(void) {}
 // Get values for hyperslab containing target point.
 void
 geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
-    const size_t ndims = _hyperslab._ndims;
-    hsize_t* origin = _hyperslab._origin;
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+
+    if (_hyperslab.isResident()) {
+        ++_hyperslab._numHits;
+        return;
+    } // if
+
+    // Use current tile if it contains the target point.
+    if (_inSlab(indexFloat)) {
+        ++_hyperslab._numHits;
+        return;
+    } // if
+
+    // Find tile in tile grid containing target point.
+    size_t tileIndex[3];
+    bool cellInTile = true;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        const double kFloat = std::floor(indexFloat[i] / double(_strides[i]));
+        tileIndex[i] = (kFloat > 0.0) ? std::min(size_t(kFloat), _numTiles[i]-1) : 0;
+
+        hsize_t tileOrigin = 0;
+        hsize_t tileDim = 0;
+        _getTileExtent(&tileOrigin, &tileDim, tileIndex[i], i);
+        cellInTile = cellInTile && (indexFloat[i] <= double(tileOrigin+tileDim-1)) &&
+                     ((tileDim > 1) || (_hyperslab._dimsAll[i] < 2));
+    } // for
+
+    // Cell at the far edge of a chunk-aligned tile (or in a tile one point wide at the end of the
+    // dataset) spans adjacent tiles.
+    if (!cellInTile) {
+        _getCell(indexFloat);
+        return;
+    } // if
+
+    Tile& tile = _getTile(tileIndex);
+    _hyperslab._origin = tile.origin.data();
+    _hyperslab._currentDims = tile.dims.data();
+    if (_hyperslab._singlePrecision) {
+        _hyperslab._values = tile.valuesFloat.data();
+    } else {
+        _hyperslab._values = tile.values.data();
+    } // if/else
+} // getSlab
+
+
+// ------------------------------------------------------------------------------------------------
+// Does current slab contain target point?
+bool
+geomodelgrids::serial::_Hyperslab::_inSlab(const double indexFloat[]) const {
+    const hsize_t* origin = _hyperslab._origin;
+    if (!origin) {
+        return false;
+    } // if
+
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+    const hsize_t* dims = _hyperslab._currentDims;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (( indexFloat[i] < double(origin[i])) ||
+            ( indexFloat[i] > double(origin[i]+dims[i]-1)) ) {
+            return false;
+        } // if
+    } // for
+
+    return true;
+} // _inSlab
+
+
+// ------------------------------------------------------------------------------------------------
+// Get origin and dimension of tile along a spatial dimension.
+void
+geomodelgrids::serial::_Hyperslab::_getTileExtent(hsize_t* origin,
+                                                  hsize_t* dim,
+                                                  const size_t tileIndex,
+                                                  const size_t iDim) const {
+    assert(origin);
+    assert(dim);
+
     const hsize_t* dims = _hyperslab._dims;
     const hsize_t* dimsAll = _hyperslab._dimsAll;
+    if (_hyperslab._chunkDims) {
+        *origin = hsize_t(tileIndex * _strides[iDim]);
+        *dim = std::min(dims[iDim], dimsAll[iDim] - *origin);
+    } else {
+        *origin = std::min(hsize_t(tileIndex * _strides[iDim]), dimsAll[iDim]-dims[iDim]);
+        *dim = dims[iDim];
+    } // if/else
+} // _getTileExtent
+
 
-    bool needsNewSlab = false;
+// ------------------------------------------------------------------------------------------------
+// Get tile from cache, reading it from the HDF5 file if it is not resident.
+geomodelgrids::serial::_Hyperslab::Tile&
+geomodelgrids::serial::_Hyperslab::_getTile(const size_t tileIndex[]) {
+    const size_t ndims = _hyperslab._ndims;
     const size_t spaceDim = ndims - 1; // last dimension is values
-    if (origin) {
+
+    size_t key = 0;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        key = key * _numTiles[i] + tileIndex[i];
+    } // for
+
+    tile_list_type::iterator tile;
+    std::unordered_map<size_t, tile_list_type::iterator>::iterator iter = _tileMap.find(key);
+    if (iter != _tileMap.end()) {
+        ++_hyperslab._numHits;
+        tile = iter->second;
+        _tiles.splice(_tiles.begin(), _tiles, tile);
+    } else {
+        ++_hyperslab._numMisses;
+        if (_tiles.size() >= _hyperslab.getCacheCapacity()) {
+            // Reuse least recently used tile.
+            tile = std::prev(_tiles.end());
+            _tileMap.erase(tile->key);
+            _tiles.splice(_tiles.begin(), _tiles, tile);
+        } else {
+            _tiles.push_front(Tile());
+            tile = _tiles.begin();
+            tile->origin.resize(ndims);
+            tile->dims.resize(ndims);
+            if (_hyperslab._singlePrecision) {
+                tile->valuesFloat.resize(_tileSize);
+            } else {
+                tile->values.resize(_tileSize);
+            } // if/else
+        } // if/else
         for (size_t i = 0; i < spaceDim; ++i) {
-            if (( indexFloat[i] - double(origin[i]) < 0.0) ||
-                ( indexFloat[i] >= double(origin[i]+dims[i]-1)) ) {
-                needsNewSlab = true;
-                break;
-            } // if
+            _getTileExtent(&tile->origin[i], &tile->dims[i], tileIndex[i], i);
         } // for
-    } else {
-        origin = _hyperslab._origin = (ndims > 0) ? new hsize_t[ndims] : nullptr;
-        std::fill(&origin[0], &origin[ndims], 0);
-        needsNewSlab = true;
+        tile->origin[spaceDim] = 0;
+        tile->dims[spaceDim] = _hyperslab._dims[spaceDim];
+
+        _hyperslab._origin = nullptr;
+        _hyperslab._values = nullptr;
+        try {
+            if (!_hyperslab._dataset) {
+                _hyperslab._dataset = new HDF5Dataset(_hyperslab._h5, _hyperslab._datasetPath.c_str());
+            } // if
+            if (_hyperslab._singlePrecision) {
+                _hyperslab._dataset->readHyperslab(tile->valuesFloat.data(), tile->origin.data(), tile->dims.data(),
+                                                   ndims, H5T_NATIVE_FLOAT);
+            } else {
+                _hyperslab._dataset->readHyperslab(tile->values.data(), tile->origin.data(), tile->dims.data(),
+                                                   ndims, H5T_NATIVE_DOUBLE);
+            } // if/else
+        } catch (...) {
+            _tiles.erase(tile);
+            throw;
+        } // try/catch
+        tile->key = key;
+        _tileMap[key] = tile;
+
+        const hsize_t* chunkDims = _hyperslab._chunkDims;
+        if (chunkDims) {
+            size_t numChunks = 1;
+            for (size_t i = 0; i < ndims; ++i) {
+                numChunks *= (tile->origin[i] + tile->dims[i] - 1) / chunkDims[i] - tile->origin[i] / chunkDims[i] + 1;
+            } // for
+            _hyperslab._numChunksRead += numChunks;
+        } // if
     } // if/else
 
-    if (needsNewSlab) {
-        // Get hyperslab with target point in the center.
+    return *tile;
+} // _getTile
+
+
+// ------------------------------------------------------------------------------------------------
+// Gather values at corners of cell spanning adjacent tiles into current slab.
+void
+geomodelgrids::serial::_Hyperslab::_getCell(const double indexFloat[]) {
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+    const hsize_t* dimsAll = _hyperslab._dimsAll;
+    const size_t numValues = _hyperslab._dims[spaceDim];
+
+    // Cell containing target point.
+    size_t numCorners = 1;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        const double dfloor = std::max(0.0, std::floor(indexFloat[i]));
+        _cellDims[i] = std::min(hsize_t(2), dimsAll[i]);
+        _cellOrigin[i] = std::min(hsize_t(dfloor), dimsAll[i]-_cellDims[i]);
+        numCorners *= _cellDims[i];
+    } // for
+    _cellOrigin[spaceDim] = 0;
+    _cellDims[spaceDim] = numValues;
+
+    // Point and tile for each corner in the order of values in the cell.
+    hsize_t cornerPoints[8*3];
+    size_t cornerTiles[8*3];
+    size_t cornerKeys[8];
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        size_t remainder = iCorner;
+        for (size_t i = spaceDim; i > 0; --i) {
+            const hsize_t point = _cellOrigin[i-1] + remainder % _cellDims[i-1];
+            remainder /= _cellDims[i-1];
+            cornerPoints[iCorner*spaceDim+i-1] = point;
+            cornerTiles[iCorner*spaceDim+i-1] = std::min(size_t(point / _strides[i-1]), _numTiles[i-1]-1);
+        } // for
+        cornerKeys[iCorner] = 0;
         for (size_t i = 0; i < spaceDim; ++i) {
-            hsize_t index = (indexFloat[i] >= dims[i]-1) ? hsize_t(std::floor(indexFloat[i] - (dims[i]-1)/ 2)) : 0;
-            index = std::min(index, dimsAll[i]-dims[i]);
-            origin[i] = index;
+            cornerKeys[iCorner] = cornerKeys[iCorner] * _numTiles[i] + cornerTiles[iCorner*spaceDim+i];
         } // for
+    } // for
+
+    // Copy values at corners, looking up each tile once.
+    bool isCopied[8] = { false, false, false, false, false, false, false, false };
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        if (isCopied[iCorner]) {
+            continue;
+        } // if
+        const Tile& tile = _getTile(&cornerTiles[iCorner*spaceDim]);
+        for (size_t jCorner = iCorner; jCorner < numCorners; ++jCorner) {
+            if (cornerKeys[jCorner] != cornerKeys[iCorner]) {
+                continue;
+            } // if
+            size_t offset = 0;
+            for (size_t i = 0; i < spaceDim; ++i) {
+                offset = offset * tile.dims[i] + (cornerPoints[jCorner*spaceDim+i] - tile.origin[i]);
+            } // for
+            offset *= numValues;
+            if (_hyperslab._singlePrecision) {
+                std::copy(&tile.valuesFloat[offset], &tile.valuesFloat[offset+numValues],
+                          &_cellValuesFloat[jCorner*numValues]);
+            } else {
+                std::copy(&tile.values[offset], &tile.values[offset+numValues], &_cellValues[jCorner*numValues]);
+            } // if/else
+            isCopied[jCorner] = true;
+        } // for
+    } // for
+
+    _hyperslab._origin = _cellOrigin.data();
+    _hyperslab._currentDims = _cellDims.data();
+    if (_hyperslab._singlePrecision) {
+        _hyperslab._values = _cellValuesFloat.data();
+    } else {
+        _hyperslab._values = _cellValues.data();
+    } // if/else
+} // _getCell
 
-        _hyperslab._h5->readDatasetHyperslab(_hyperslab._values, _hyperslab._datasetPath.c_str(), origin, dims, ndims,
-                                             H5T_NATIVE_DOUBLE);
-    } // if
-} // getSlab
+
+// ------------------------------------------------------------------------------------------------
+// Evict least recently used tiles.
+void
+geomodelgrids::serial::_Hyperslab::evict(const size_t maxTiles) {
+    const size_t numKeep = std::max(size_t(1), maxTiles);
+    while (_tiles.size() > numKeep) {
+        _tileMap.erase(_tiles.back().key);
+        _tiles.pop_back();
+    } // while
+} // evict
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values of entire dataset.
+template<typename T>
+std::shared_ptr<const std::vector<T> >
+geomodelgrids::serial::_Hyperslab::readDataset(geomodelgrids::serial::HDF5* const h5,
+                                               const char* path,
+                                               hid_t datatype) {
+    assert(h5);
+    assert(path);
+
+    hsize_t* dims = nullptr;
+    int ndims = 0;
+    h5->getDatasetDims(&dims, &ndims, path);
+    assert(ndims > 0);
+    std::vector<hsize_t> origin(ndims, 0);
+    size_t size = 1;
+    for (int i = 0; i < ndims; ++i) {
+        size *= dims[i];
+    } // for
+
+    std::shared_ptr<std::vector<T> > values = std::make_shared<std::vector<T> >(size);
+    try {
+        h5->readDatasetHyperslab(values->data(), path, origin.data(), dims, ndims, datatype);
+    } catch (...) {
+        delete[] dims;dims = nullptr;
+        throw;
+    } // try/catch
+    delete[] dims;dims = nullptr;
+
+    return values;
+} // readDataset
 
 
 // ------------------------------------------------------------------------------------------------
@@ -238,6 +958,31 @@ geomodelgrids::serial::_Hyperslab::interpolate(double* const values,
 } // interpolate
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute values at multiple points using bilinear interpolation.
+void
+geomodelgrids::serial::_Hyperslab::interpolateMany(double* const values,
+                                                   const double indexFloat[],
+                                                   const size_t numPoints) {
+    assert(_interpolateMany);
+
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+    const size_t numValues = _hyperslab._dims[spaceDim];
+    size_t iPoint = 0;
+    while (iPoint < numPoints) {
+        getSlab(&indexFloat[iPoint*spaceDim]);
+
+        // Run of consecutive points in the current slab.
+        size_t numRun = 1;
+        while (iPoint + numRun < numPoints && _inSlab(&indexFloat[(iPoint+numRun)*spaceDim])) {
+            ++numRun;
+        } // while
+        CALL_MEMBER_FN(*this, _interpolateMany)(&values[iPoint*numValues], &indexFloat[iPoint*spaceDim], numRun);
+        iPoint += numRun;
+    } // while
+} // interpolateMany
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::serial::_Hyperslab::nearest(double* const values,
@@ -249,9 +994,24 @@ geomodelgrids::serial::_Hyperslab::nearest(double* const values,
 
 // ------------------------------------------------------------------------------------------------
 void
-geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
-                                                  const double indexFloat[]) {
-    assert(values);
+geomodelgrids::serial::_Hyperslab::query(double* const values,
+                                         const double indexFloat[],
+                                         const size_t useInterpolation[]) {
+    assert(_query);
+    CALL_MEMBER_FN(*this, _query)(values, indexFloat, useInterpolation);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Get cell corners, weights, and nearest point for target point in 2-D.
+void
+geomodelgrids::serial::_Hyperslab::_cell2D(size_t corners[],
+                                           double wts[],
+                                           size_t* nearest,
+                                           const double indexFloat[]) const {
+    assert(corners);
+    assert(wts);
+    assert(nearest);
     assert(indexFloat);
     assert(_hyperslab._values);
     assert(_hyperslab._origin);
@@ -263,8 +1023,8 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
         indexFloat[0] - _hyperslab._origin[0],
         indexFloat[1] - _hyperslab._origin[1],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._currentDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._currentDims[1]-1);
 
     // Coordinate of "lower" point (corner of cell with lowest indices containing target point).
     const double tolerance = 1.0e-12;
@@ -273,13 +1033,19 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
         std::max(0.0, std::floor(indexSlab[1]-tolerance)),
     };
 
-    // Index of "lower" point
+    // Index of "lower" point and nearest point.
     const hsize_t ifloor[spaceDim] = {
         hsize_t(dfloor[0]),
         hsize_t(dfloor[1]),
     };
-    assert(ifloor[0] < _hyperslab._dims[0]);
-    assert(ifloor[1] < _hyperslab._dims[1]);
+    const hsize_t inearest[spaceDim] = {
+        hsize_t(std::round(indexSlab[0])),
+        hsize_t(std::round(indexSlab[1])),
+    };
+    assert(ifloor[0] < _hyperslab._currentDims[0]);
+    assert(ifloor[1] < _hyperslab._currentDims[1]);
+    assert(inearest[0] < _hyperslab._currentDims[0]);
+    assert(inearest[1] < _hyperslab._currentDims[1]);
 
     // Coordinates within cell relative to "lower" point.
     const double xRef[spaceDim] = {
@@ -287,49 +1053,39 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
         indexSlab[1] - dfloor[1],
     };
 
-    const double wts[2][2] = {
-        {
-            (1.0 - xRef[0]) * (1.0 - xRef[1]),
-            (1.0 - xRef[0]) * xRef[1],
-        },{
-            xRef[0] * (1.0 - xRef[1]),
-            xRef[0] * xRef[1],
-        },
-    };
+    // Weights and values at cell corners in order (i, j) = (0,0), (0,1), (1,0), (1,1).
+    wts[0] = (1.0 - xRef[0]) * (1.0 - xRef[1]);
+    wts[1] = (1.0 - xRef[0]) * xRef[1];
+    wts[2] = xRef[0] * (1.0 - xRef[1]);
+    wts[3] = xRef[0] * xRef[1];
 
-    // Indices into hyperslab values for cell corners
-    const hsize_t* dims = _hyperslab._dims;
-    const hsize_t ii[2][2] = {
-        {
-            (ifloor[0]+0)*(dims[1]*dims[2]) + (ifloor[1]+0)*(dims[2]),
-            (ifloor[0]+0)*(dims[1]*dims[2]) + (ifloor[1]+1)*(dims[2]),
-        },{
-            (ifloor[0]+1)*(dims[1]*dims[2]) + (ifloor[1]+0)*(dims[2]),
-            (ifloor[0]+1)*(dims[1]*dims[2]) + (ifloor[1]+1)*(dims[2]),
-        },
+    const hsize_t* dims = _hyperslab._currentDims;
+    const hsize_t strides[spaceDim] = {
+        dims[1]*dims[2],
+        dims[2],
     };
+    const size_t origin = ifloor[0]*strides[0] + ifloor[1]*strides[1];
+    corners[0] = origin;
+    corners[1] = origin + strides[1];
+    corners[2] = origin + strides[0];
+    corners[3] = origin + strides[0] + strides[1];
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
-        for (hsize_t iDim = 0; iDim < 2; ++iDim) {
-            for (hsize_t jDim = 0; jDim < 2; ++jDim) {
-                values[iValue] += wts[iDim][jDim] * _hyperslab._values[ii[iDim][jDim] + iValue];
-            } // for
-        } // for
-    } // for
-
-} // interpolate2D
+    *nearest = inearest[0]*strides[0] + inearest[1]*strides[1];
+} // _cell2D
 
 
 // ------------------------------------------------------------------------------------------------
+// Get cell corners, weights, and nearest point for target point in 3-D.
 void
-geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
-                                                  const double indexFloat[]) {
-    assert(values);
+geomodelgrids::serial::_Hyperslab::_cell3D(size_t corners[],
+                                           double wts[],
+                                           size_t* nearest,
+                                           const double indexFloat[]) const {
+    assert(corners);
+    assert(wts);
+    assert(nearest);
     assert(indexFloat);
     assert(_hyperslab._values);
-    assert(_hyperslab._dimsAll);
     assert(_hyperslab._origin);
 
     const size_t spaceDim = 3;
@@ -340,9 +1096,9 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
         indexFloat[1] - _hyperslab._origin[1],
         indexFloat[2] - _hyperslab._origin[2],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
-    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._dims[2]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._currentDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._currentDims[1]-1);
+    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._currentDims[2]-1);
 
     // Coordinate of "lower" point (corner of cell with lowest indices containing target point).
     const double tolerance = 1.0e-12;
@@ -352,15 +1108,23 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
         std::max(0.0, std::floor(indexSlab[2]-tolerance)),
     };
 
-    // Index of "lower" point
+    // Index of "lower" point and nearest point.
     const hsize_t ifloor[spaceDim] = {
         hsize_t(dfloor[0]),
         hsize_t(dfloor[1]),
         hsize_t(dfloor[2]),
     };
-    assert(ifloor[0] < _hyperslab._dims[0]);
-    assert(ifloor[1] < _hyperslab._dims[1]);
-    assert(ifloor[2] < _hyperslab._dims[2]);
+    const hsize_t inearest[spaceDim] = {
+        hsize_t(std::round(indexSlab[0])),
+        hsize_t(std::round(indexSlab[1])),
+        hsize_t(std::round(indexSlab[2])),
+    };
+    assert(ifloor[0] < _hyperslab._currentDims[0]);
+    assert(ifloor[1] < _hyperslab._currentDims[1]);
+    assert(ifloor[2] < _hyperslab._currentDims[2]);
+    assert(inearest[0] < _hyperslab._currentDims[0]);
+    assert(inearest[1] < _hyperslab._currentDims[1]);
+    assert(inearest[2] < _hyperslab._currentDims[2]);
 
     // Coordinates within cell relative to "lower" point.
     const double xRef[spaceDim] = {
@@ -369,75 +1133,158 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
         indexSlab[2] - dfloor[2],
     };
 
-    const double wts[2][2][2] = {
-        {
-            {
-                (1.0 - xRef[0]) * (1.0 - xRef[1]) * (1.0 - xRef[2]),
-                (1.0 - xRef[0]) * (1.0 - xRef[1]) * xRef[2],
-            },{
-                (1.0 - xRef[0]) * xRef[1] * (1.0 - xRef[2]),
-                (1.0 - xRef[0]) * xRef[1] * xRef[2],
-            },
-        },{
-            {
-                xRef[0] * (1.0 - xRef[1]) * (1.0 - xRef[2]),
-                xRef[0] * (1.0 - xRef[1]) * xRef[2],
-            },{
-                xRef[0] * xRef[1] * (1.0 - xRef[2]),
-                xRef[0] * xRef[1] * xRef[2],
-            },
-        },
+    // Weights and values at cell corners in order (i, j, k) = (0,0,0), (0,0,1), (0,1,0), ..., (1,1,1).
+    wts[0] = (1.0 - xRef[0]) * (1.0 - xRef[1]) * (1.0 - xRef[2]);
+    wts[1] = (1.0 - xRef[0]) * (1.0 - xRef[1]) * xRef[2];
+    wts[2] = (1.0 - xRef[0]) * xRef[1] * (1.0 - xRef[2]);
+    wts[3] = (1.0 - xRef[0]) * xRef[1] * xRef[2];
+    wts[4] = xRef[0] * (1.0 - xRef[1]) * (1.0 - xRef[2]);
+    wts[5] = xRef[0] * (1.0 - xRef[1]) * xRef[2];
+    wts[6] = xRef[0] * xRef[1] * (1.0 - xRef[2]);
+    wts[7] = xRef[0] * xRef[1] * xRef[2];
+
+    const hsize_t* dims = _hyperslab._currentDims;
+    const hsize_t strides[spaceDim] = {
+        dims[1]*dims[2]*dims[3],
+        dims[2]*dims[3],
+        dims[3],
     };
+    const size_t origin = ifloor[0]*strides[0] + ifloor[1]*strides[1] + ifloor[2]*strides[2];
+    corners[0] = origin;
+    corners[1] = origin + strides[2];
+    corners[2] = origin + strides[1];
+    corners[3] = origin + strides[1] + strides[2];
+    corners[4] = origin + strides[0];
+    corners[5] = origin + strides[0] + strides[2];
+    corners[6] = origin + strides[0] + strides[1];
+    corners[7] = origin + strides[0] + strides[1] + strides[2];
 
-    // Indices into hyperslab values for cell corners
-    const hsize_t* dims = _hyperslab._dims;
-    const hsize_t ii[2][2][2] = {
-        {
-            {
-                (ifloor[0]+0)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+0)*(dims[2]*dims[3]) + (ifloor[2]+0)*(dims[3]),
-                (ifloor[0]+0)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+0)*(dims[2]*dims[3]) + (ifloor[2]+1)*(dims[3]),
-            },{
-                (ifloor[0]+0)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+1)*(dims[2]*dims[3]) + (ifloor[2]+0)*(dims[3]),
-                (ifloor[0]+0)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+1)*(dims[2]*dims[3]) + (ifloor[2]+1)*(dims[3]),
-            },
-        },{
-            {
-                (ifloor[0]+1)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+0)*(dims[2]*dims[3]) + (ifloor[2]+0)*(dims[3]),
-                (ifloor[0]+1)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+0)*(dims[2]*dims[3]) + (ifloor[2]+1)*(dims[3]),
-            },{
-                (ifloor[0]+1)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+1)*(dims[2]*dims[3]) + (ifloor[2]+0)*(dims[3]),
-                (ifloor[0]+1)*(dims[1]*dims[2]*dims[3]) + (ifloor[1]+1)*(dims[2]*dims[3]) + (ifloor[2]+1)*(dims[3]),
-            },
-        },
-    };
+    *nearest = inearest[0]*strides[0] + inearest[1]*strides[1] + inearest[2]*strides[2];
+} // _cell3D
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
-        bool hasNoDataValue = false;
-
-        for (hsize_t iDim = 0; iDim < 2; ++iDim) {
-            for (hsize_t jDim = 0; jDim < 2; ++jDim) {
-                for (hsize_t kDim = 0; kDim < 2; ++kDim) {
-                    const double interpolateValue = _hyperslab._values[ii[iDim][jDim][kDim] + iValue];
-                    if (fabs(1.0 - interpolateValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
-                        hasNoDataValue = true;
-                    } // if
-                    values[iValue] += wts[iDim][jDim][kDim] * interpolateValue;
-                } // for
+
+// ------------------------------------------------------------------------------------------------
+// Get kernel for values in double precision.
+template<>
+geomodelgrids::serial::HyperslabKernels::Kernel<double>::fn_type
+geomodelgrids::serial::_Hyperslab::_getKernel<double>(void) const {
+    assert(_kernel);
+    return _kernel;
+} // _getKernel
+
+
+// ------------------------------------------------------------------------------------------------
+// Get kernel for values in single precision.
+template<>
+geomodelgrids::serial::HyperslabKernels::Kernel<float>::fn_type
+geomodelgrids::serial::_Hyperslab::_getKernel<float>(void) const {
+    assert(_kernelFloat);
+    return _kernelFloat;
+} // _getKernel
+
+
+// ------------------------------------------------------------------------------------------------
+template<typename T>
+void
+geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
+                                                  const double indexFloat[]) {
+    assert(values);
+
+    size_t corners[4];
+    double wts[4];
+    size_t nearest = 0;
+    _cell2D(corners, wts, &nearest, indexFloat);
+
+    const size_t spaceDim = 2;
+    const T* data = static_cast<const T*>(_hyperslab._values);
+    _getKernel<T>()(values, data, corners, wts, 0, nullptr, _hyperslab._currentDims[spaceDim]);
+} // interpolate2D
+
+
+// ------------------------------------------------------------------------------------------------
+template<typename T>
+void
+geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
+                                                  const double indexFloat[]) {
+    assert(values);
+
+    size_t corners[8];
+    double wts[8];
+    size_t nearest = 0;
+    _cell3D(corners, wts, &nearest, indexFloat);
+
+    const size_t spaceDim = 3;
+    const T* data = static_cast<const T*>(_hyperslab._values);
+    _getKernel<T>()(values, data, corners, wts, 0, nullptr, _hyperslab._currentDims[spaceDim]);
+} // _interpolate3D
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute values at multiple points in current slab.
+template<typename T, size_t spaceDim>
+void
+geomodelgrids::serial::_Hyperslab::_interpolateSlab(double* const values,
+                                                    const double indexFloat[],
+                                                    const size_t numPoints) {
+    assert(values);
+    assert(indexFloat);
+    assert(_hyperslab._values);
+    assert(_hyperslab._origin);
+
+    const size_t numCorners = 1 << spaceDim;
+    const hsize_t* origin = _hyperslab._origin;
+    const hsize_t* dims = _hyperslab._currentDims;
+    const size_t numValues = dims[spaceDim];
+    const T* data = static_cast<const T*>(_hyperslab._values);
+    const typename HyperslabKernels::Kernel<T>::fn_type kernel = _getKernel<T>();
+
+    // Strides and offsets of cell corners relative to "lower" point are the same for all points in the
+    // slab. Corners are in the same order as in _cell2D() and _cell3D().
+    hsize_t strides[spaceDim];
+    strides[spaceDim-1] = dims[spaceDim];
+    for (size_t i = spaceDim-1; i > 0; --i) {
+        strides[i-1] = strides[i] * dims[i];
+    } // for
+    size_t cornerSteps[numCorners];
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        cornerSteps[iCorner] = 0;
+        for (size_t i = 0; i < spaceDim; ++i) {
+            cornerSteps[iCorner] += ((iCorner >> (spaceDim-1-i)) & 1) * strides[i];
+        } // for
+    } // for
+
+    const double tolerance = 1.0e-12;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double* pointIndex = &indexFloat[iPoint*spaceDim];
+
+        // Coordinates of target point within cell relative to "lower" point.
+        double xRef[spaceDim];
+        size_t lowerOffset = 0;
+        for (size_t i = 0; i < spaceDim; ++i) {
+            const double indexSlab = pointIndex[i] - origin[i];
+            assert(indexSlab >= 0.0 && indexSlab <= dims[i]-1);
+            const double dfloor = std::max(0.0, std::floor(indexSlab-tolerance));
+            xRef[i] = indexSlab - dfloor;
+            lowerOffset += hsize_t(dfloor) * strides[i];
+        } // for
+
+        size_t corners[numCorners];
+        double wts[numCorners];
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            corners[iCorner] = lowerOffset + cornerSteps[iCorner];
+            wts[iCorner] = 1.0;
+            for (size_t i = 0; i < spaceDim; ++i) {
+                wts[iCorner] *= ((iCorner >> (spaceDim-1-i)) & 1) ? xRef[i] : 1.0 - xRef[i];
             } // for
         } // for
 
-        if (hasNoDataValue) {
-            // Set value to NODATA_VALUE if any values used in interpolation are NODATA_VALUE.
-            values[iValue] = geomodelgrids::NODATA_VALUE;
-        } // if
+        kernel(&values[iPoint*numValues], data, corners, wts, 0, nullptr, numValues);
     } // for
-
-} // _interpolate3D
+} // _interpolateSlab
 
 
 // ------------------------------------------------------------------------------------------------
+template<typename T>
 void
 geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
                                               const double indexFloat[]) {
@@ -454,8 +1301,8 @@ geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
         indexFloat[0] - _hyperslab._origin[0],
         indexFloat[1] - _hyperslab._origin[1],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._currentDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._currentDims[1]-1);
 
     // Coordinate of nearest point to target point.
     const double dnearest[spaceDim] = {
@@ -468,17 +1315,17 @@ geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
         hsize_t(dnearest[0]),
         hsize_t(dnearest[1]),
     };
-    assert(inearest[0] < _hyperslab._dims[0]);
-    assert(inearest[1] < _hyperslab._dims[1]);
+    assert(inearest[0] < _hyperslab._currentDims[0]);
+    assert(inearest[1] < _hyperslab._currentDims[1]);
 
     // Indices into hyperslab values for nearest point.
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _hyperslab._currentDims;
     const hsize_t ii = inearest[0]*(dims[1]*dims[2]) + inearest[1]*(dims[2]);
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
+    const hsize_t numValues = _hyperslab._currentDims[spaceDim];
     for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
         values[iValue] = 0;
-        const double nearestValue = _hyperslab._values[ii + iValue];
+        const double nearestValue = static_cast<const T*>(_hyperslab._values)[ii + iValue];
         if (fabs(1.0 - nearestValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
             values[iValue] = geomodelgrids::NODATA_VALUE;
             } else {
@@ -490,6 +1337,7 @@ geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
 
 
 // ------------------------------------------------------------------------------------------------
+template<typename T>
 void
 geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
                                               const double indexFloat[]) {
@@ -507,9 +1355,9 @@ geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
         indexFloat[1] - _hyperslab._origin[1],
         indexFloat[2] - _hyperslab._origin[2],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
-    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._dims[2]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._currentDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._currentDims[1]-1);
+    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._currentDims[2]-1);
 
     // Coordinate of nearest point to target point.
     const double dnearest[spaceDim] = {
@@ -524,19 +1372,19 @@ geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
         hsize_t(dnearest[1]),
         hsize_t(dnearest[2]),
     };
-    assert(inearest[0] < _hyperslab._dims[0]);
-    assert(inearest[1] < _hyperslab._dims[1]);
-    assert(inearest[2] < _hyperslab._dims[2]);
+    assert(inearest[0] < _hyperslab._currentDims[0]);
+    assert(inearest[1] < _hyperslab._currentDims[1]);
+    assert(inearest[2] < _hyperslab._currentDims[2]);
 
     // Indices into hyperslab values for nearest point.
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _hyperslab._currentDims;
     const hsize_t ii =
         inearest[0]*(dims[1]*dims[2]*dims[3]) + inearest[1]*(dims[2]*dims[3]) + inearest[2]*(dims[3]);
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
+    const hsize_t numValues = _hyperslab._currentDims[spaceDim];
     for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
         values[iValue] = 0;
-        const double nearestValue = _hyperslab._values[ii + iValue];
+        const double nearestValue = static_cast<const T*>(_hyperslab._values)[ii + iValue];
         if (fabs(1.0 - nearestValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
             values[iValue] = geomodelgrids::NODATA_VALUE;
             } else {
@@ -548,4 +1396,45 @@ geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
 } // _nearest3D
 
 
+// ------------------------------------------------------------------------------------------------
+template<typename T>
+void
+geomodelgrids::serial::_Hyperslab::_query2D(double* const values,
+                                            const double indexFloat[],
+                                            const size_t useInterpolation[]) {
+    assert(values);
+    assert(useInterpolation);
+
+    size_t corners[4];
+    double wts[4];
+    size_t nearest = 0;
+    _cell2D(corners, wts, &nearest, indexFloat);
+
+    const size_t spaceDim = 2;
+    const T* data = static_cast<const T*>(_hyperslab._values);
+    _getKernel<T>()(values, data, corners, wts, nearest, useInterpolation, _hyperslab._currentDims[spaceDim]);
+} // _query2D
+
+
+// ------------------------------------------------------------------------------------------------
+template<typename T>
+void
+geomodelgrids::serial::_Hyperslab::_query3D(double* const values,
+                                            const double indexFloat[],
+                                            const size_t useInterpolation[]) {
+    assert(values);
+    assert(useInterpolation);
+
+    size_t corners[8];
+    double wts[8];
+    size_t nearest = 0;
+    _cell3D(corners, wts, &nearest, indexFloat);
+
+    const size_t spaceDim = 3;
+    const T* data = static_cast<const T*>(_hyperslab._values);
+    _getKernel<T>()(values, data, corners, wts, nearest, useInterpolation, _hyperslab._currentDims[spaceDim]);
+} // _query3D
+
+
+
 // End of file
@@ -1,6 +1,21 @@
 /** Hyperslab for a chunk of data in an HDF5 file.
  *
  * The hyperslab always contains all of the values at a point and that dimension is not given in the constructor.
+ *
+ * Tiles of the dataset are aligned to a fixed grid. Recently used tiles are kept in a least-recently-used
+ * cache limited by a memory budget.
+ *
+ * If the dataset is chunked, each tile spatial dimension is a whole number of chunks and tiles do not
+ * overlap, so a tile read decompresses only the chunks in the tile. A cell that spans adjacent tiles is
+ * gathered from the resident tiles. If the dataset is not chunked, adjacent tiles overlap by one point
+ * so that every cell lies entirely within a tile.
+ *
+ * Alternatively, the entire dataset can be resident in memory (shared by hyperslabs in all query contexts),
+ * in which case values are indexed directly without any reads from the HDF5 file.
+ *
+ * Values can be stored in single precision, which halves the memory used by tiles and resident values.
+ * Interpolation always accumulates in double precision, using the kernels in HyperslabKernels for the widest
+ * instruction set supported by the processor.
  */
 #pragma once
 
@@ -9,6 +24,8 @@
 #include <cstdlib> // USES size_t
 #include <hdf5.h> // USES hsize_t
 #include <string> // USES std::string
+#include <memory> // HASA std::shared_ptr
+#include <vector> // USES std::vector
 
 // Forward declarations of helper classes.
 namespace geomodelgrids {
@@ -25,6 +42,9 @@ class geomodelgrids::serial::Hyperslab {
 public:
 
     /** Constructor.
+     *
+     * The hyperslab dimensions are limited to the dataset dimensions and, for chunked datasets, rounded to
+     * a whole number of chunks.
      *
      * @param[in] h5 HDF5 with model.
      * @param[in] path Full path to dataset.
@@ -39,6 +59,97 @@ public:
     /// Destructor
     ~Hyperslab(void);
 
+    /** Set maximum size of tile cache.
+     *
+     * At least one tile is always kept, regardless of the cache size.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles.
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get maximum size of tile cache.
+     *
+     * @returns Maximum size (in bytes) of resident tiles.
+     */
+    size_t getCacheSize(void) const;
+
+    /** Get maximum number of resident tiles.
+     *
+     * @returns Maximum number of tiles in cache.
+     */
+    size_t getCacheCapacity(void) const;
+
+    /** Get tile cache statistics.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from the HDF5 file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    /** Get number of dataset chunks read.
+     *
+     * Each tile read from the HDF5 file contributes the number of chunks it intersects.
+     *
+     * @returns Number of chunks intersected by tile reads.
+     */
+    size_t getNumChunksRead(void) const;
+
+    /// Reset tile cache statistics and number of chunks read.
+    void resetCacheStats(void);
+
+    /** Set whether values are stored in single precision (float) instead of double precision.
+     *
+     * Changing the precision discards any tiles in the cache.
+     *
+     * @param[in] value True to store values in single precision, false for double precision.
+     */
+    void setSinglePrecision(const bool value);
+
+    /** Are values stored in single precision?
+     *
+     * @returns True if values are stored in single precision, false otherwise.
+     */
+    bool isSinglePrecision(void) const;
+
+    /** Use values of entire dataset resident in memory instead of reading tiles from the HDF5 file.
+     *
+     * @param[in] values Values of entire dataset (from readResident()).
+     */
+    void setResident(const std::shared_ptr<const std::vector<double> >& values);
+
+    /** Use values of entire dataset resident in memory in single precision.
+     *
+     * @param[in] values Values of entire dataset (from readResidentFloat()).
+     */
+    void setResident(const std::shared_ptr<const std::vector<float> >& values);
+
+    /** Is entire dataset resident in memory?
+     *
+     * @returns True if entire dataset is resident, false otherwise.
+     */
+    bool isResident(void) const;
+
+    /** Read values of entire dataset into memory.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] path Full path to dataset.
+     * @returns Values of entire dataset.
+     */
+    static
+    std::shared_ptr<const std::vector<double> > readResident(geomodelgrids::serial::HDF5* const h5,
+                                                             const char* path);
+
+    /** Read values of entire dataset into memory in single precision.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] path Full path to dataset.
+     * @returns Values of entire dataset.
+     */
+    static
+    std::shared_ptr<const std::vector<float> > readResidentFloat(geomodelgrids::serial::HDF5* const h5,
+                                                                 const char* path);
+
     /** Compute values at point using bilinear interpolation.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -47,6 +158,18 @@ public:
     void interpolate(double* const values,
                      const double indexFloat[]);
 
+    /** Compute values at multiple points using bilinear interpolation.
+     *
+     * Consecutive points in the same tile are interpolated together with one tile lookup.
+     *
+     * @param[out] values Preallocated array for interpolated values (numPoints x numValues).
+     * @param[in] indexFloat Indices of target points as floating point values (numPoints x spaceDim).
+     * @param[in] numPoints Number of target points.
+     */
+    void interpolateMany(double* const values,
+                         const double indexFloat[],
+                         const size_t numPoints);
+
     /** Get values at nearest point.
      *
      * @param[out] values Preallocated array for values.
@@ -55,17 +178,49 @@ public:
     void nearest(double* const values,
                  const double indexFloat[]);
 
+    /** Compute values at point in a single pass, using bilinear interpolation or the nearest point
+     * for each value.
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] indexFloat Index of target point as floating point values.
+     * @param[in] useInterpolation Array with interpolation flag for each value (1 for interpolation, 0 for
+     *   nearest point).
+     */
+    void query(double* const values,
+               const double indexFloat[],
+               const size_t useInterpolation[]);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Check size of resident values against size of dataset.
+     *
+     * @param[in] numValues Number of resident values.
+     */
+    void _checkResidentSize(const size_t numValues) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
     geomodelgrids::serial::HDF5* const _h5; ///< HDF5 data.
     const std::string _datasetPath; ///< Full path to dataset.
+    geomodelgrids::serial::HDF5Dataset* _dataset; ///< Open dataset for tile reads (created on first read).
 
     const size_t _ndims; ///< Number of dimensions in hyperslab.
-    hsize_t* _origin; ///< Origin of hyperslab relative to dataset.
-    hsize_t* _dims; ///< Dimensions of hyperslab.
+    hsize_t* _origin; ///< Origin of current tile relative to dataset (owned by cache).
+    hsize_t* _dims; ///< Dimensions of hyperslab (tile).
     hsize_t* _dimsAll; ///< Dimensions of entire dataset.
-    double* _values; ///< Hyperslab values.
+    hsize_t* _chunkDims; ///< Dimensions of dataset chunks (null if dataset is not chunked).
+    const hsize_t* _currentDims; ///< Dimensions of current tile (or of cell spanning adjacent tiles).
+    const void* _values; ///< Values (double or float) of current tile (owned by cache or resident values).
+    std::shared_ptr<const std::vector<double> > _resident; ///< Values of entire dataset (if resident).
+    std::shared_ptr<const std::vector<float> > _residentFloat; ///< Values of entire dataset (if resident in single precision).
+    bool _singlePrecision; ///< True if values are stored in single precision.
+
+    size_t _cacheSize; ///< Maximum size (in bytes) of resident tiles.
+    size_t _numHits; ///< Number of lookups satisfied by a resident tile.
+    size_t _numMisses; ///< Number of lookups requiring a read.
+    size_t _numChunksRead; ///< Number of chunks intersected by tile reads.
 
     geomodelgrids::serial::_Hyperslab* _hyperslab; ///< Helper object.
 
@@ -0,0 +1,408 @@
+#include <portinfo>
+
+#include "HyperslabKernels.hh" // implementation of class methods
+
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include <stdexcept> // USES std::logic_error
+#include <sstream> // USES std::ostringstream
+#include <cmath> // USES fabs()
+
+// Vector kernels use function target attributes and runtime detection of the processor features.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define GEOMODELGRIDS_X86_KERNELS
+#include <immintrin.h> // USES SSE2, AVX2, and AVX-512 intrinsics
+#endif
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        namespace _HyperslabKernels {
+            /** Scalar (reference) kernel.
+             *
+             * See HyperslabKernels::Kernel for a description of the arguments.
+             */
+            template<typename T, size_t numCorners, bool checkNoData>
+            void scalar(double* const values,
+                        const T* const data,
+                        const size_t cornerOffsets[],
+                        const double wts[],
+                        const size_t nearestOffset,
+                        const size_t useInterpolation[],
+                        const size_t numValues) {
+                for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                    double value = 0.0;
+                    bool hasNoDataValue = false;
+                    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                        const double cornerValue = data[cornerOffsets[iCorner]+iValue];
+                        if (checkNoData && (fabs(1.0 - cornerValue/geomodelgrids::NODATA_VALUE) < 1.0e-3)) {
+                            hasNoDataValue = true;
+                        } // if
+                        value += wts[iCorner] * cornerValue;
+                    } // for
+
+                    // Set value to NODATA_VALUE if any values used in interpolation are NODATA_VALUE.
+                    if (hasNoDataValue) {
+                        value = geomodelgrids::NODATA_VALUE;
+                    } // if
+
+                    if (useInterpolation && !useInterpolation[iValue]) {
+                        const double nearestValue = data[nearestOffset+iValue];
+                        if (fabs(1.0 - nearestValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
+                            value = geomodelgrids::NODATA_VALUE;
+                        } else {
+                            value = nearestValue;
+                        } // if/else
+                    } // if
+                    values[iValue] = value;
+                } // for
+            } // scalar
+
+#if defined(GEOMODELGRIDS_X86_KERNELS)
+            // SSE2 (2 values at a time) ----------------------------------------------------------
+
+            __attribute__((target("sse2")))
+            inline __m128d load2(const double* const data) {
+                return _mm_loadu_pd(data);
+            } // load2
+
+            __attribute__((target("sse2")))
+            inline __m128d load2(const float* const data) {
+                return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))));
+            } // load2
+
+            __attribute__((target("sse2")))
+            inline __m128d isNoData2(const __m128d value) {
+                const __m128d ratio = _mm_div_pd(value, _mm_set1_pd(geomodelgrids::NODATA_VALUE));
+                const __m128d misfit = _mm_andnot_pd(_mm_set1_pd(-0.0), _mm_sub_pd(_mm_set1_pd(1.0), ratio));
+                return _mm_cmplt_pd(misfit, _mm_set1_pd(1.0e-3));
+            } // isNoData2
+
+            __attribute__((target("sse2")))
+            inline __m128d blend2(const __m128d a,
+                                  const __m128d b,
+                                  const __m128d mask) {
+                return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+            } // blend2
+
+            /** SSE2 kernel.
+             *
+             * See HyperslabKernels::Kernel for a description of the arguments.
+             */
+            template<typename T, size_t numCorners, bool checkNoData>
+            __attribute__((target("sse2")))
+            void sse2(double* const values,
+                      const T* const data,
+                      const size_t cornerOffsets[],
+                      const double wts[],
+                      const size_t nearestOffset,
+                      const size_t useInterpolation[],
+                      const size_t numValues) {
+                const size_t width = 2;
+                const __m128d noDataValue = _mm_set1_pd(geomodelgrids::NODATA_VALUE);
+                __m128d wtsV[numCorners];
+                for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                    wtsV[iCorner] = _mm_set1_pd(wts[iCorner]);
+                } // for
+
+                size_t iValue = 0;
+                for (; iValue + width <= numValues; iValue += width) {
+                    __m128d value = _mm_setzero_pd();
+                    __m128d hasNoDataValue = _mm_setzero_pd();
+                    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                        const __m128d cornerValue = load2(data + cornerOffsets[iCorner] + iValue);
+                        if (checkNoData) {
+                            hasNoDataValue = _mm_or_pd(hasNoDataValue, isNoData2(cornerValue));
+                        } // if
+                        value = _mm_add_pd(value, _mm_mul_pd(wtsV[iCorner], cornerValue));
+                    } // for
+                    if (checkNoData) {
+                        value = blend2(value, noDataValue, hasNoDataValue);
+                    } // if
+
+                    if (useInterpolation) {
+                        __m128d nearestValue = load2(data + nearestOffset + iValue);
+                        nearestValue = blend2(nearestValue, noDataValue, isNoData2(nearestValue));
+
+                        // No 64-bit integer compare in SSE2, so combine compares of 32-bit halves.
+                        const __m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(useInterpolation + iValue));
+                        const __m128i isZeroHalf = _mm_cmpeq_epi32(flags, _mm_setzero_si128());
+                        const __m128i isZero = _mm_and_si128(isZeroHalf, _mm_shuffle_epi32(isZeroHalf, _MM_SHUFFLE(2, 3, 0, 1)));
+                        value = blend2(value, nearestValue, _mm_castsi128_pd(isZero));
+                    } // if
+                    _mm_storeu_pd(values + iValue, value);
+                } // for
+
+                // Remaining values.
+                scalar<T, numCorners, checkNoData>(values + iValue, data + iValue, cornerOffsets, wts, nearestOffset,
+                                                   useInterpolation ? useInterpolation + iValue : nullptr,
+                                                   numValues - iValue);
+            } // sse2
+
+            // AVX2 (4 values at a time) ----------------------------------------------------------
+
+            __attribute__((target("avx2")))
+            inline __m256d load4(const double* const data) {
+                return _mm256_loadu_pd(data);
+            } // load4
+
+            __attribute__((target("avx2")))
+            inline __m256d load4(const float* const data) {
+                return _mm256_cvtps_pd(_mm_loadu_ps(data));
+            } // load4
+
+            __attribute__((target("avx2")))
+            inline __m256d isNoData4(const __m256d value) {
+                const __m256d ratio = _mm256_div_pd(value, _mm256_set1_pd(geomodelgrids::NODATA_VALUE));
+                const __m256d misfit = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(_mm256_set1_pd(1.0), ratio));
+                return _mm256_cmp_pd(misfit, _mm256_set1_pd(1.0e-3), _CMP_LT_OQ);
+            } // isNoData4
+
+            /** AVX2 kernel.
+             *
+             * See HyperslabKernels::Kernel for a description of the arguments.
+             */
+            template<typename T, size_t numCorners, bool checkNoData>
+            __attribute__((target("avx2")))
+            void avx2(double* const values,
+                      const T* const data,
+                      const size_t cornerOffsets[],
+                      const double wts[],
+                      const size_t nearestOffset,
+                      const size_t useInterpolation[],
+                      const size_t numValues) {
+                const size_t width = 4;
+                const __m256d noDataValue = _mm256_set1_pd(geomodelgrids::NODATA_VALUE);
+                __m256d wtsV[numCorners];
+                for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                    wtsV[iCorner] = _mm256_set1_pd(wts[iCorner]);
+                } // for
+
+                size_t iValue = 0;
+                for (; iValue + width <= numValues; iValue += width) {
+                    __m256d value = _mm256_setzero_pd();
+                    __m256d hasNoDataValue = _mm256_setzero_pd();
+                    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                        const __m256d cornerValue = load4(data + cornerOffsets[iCorner] + iValue);
+                        if (checkNoData) {
+                            hasNoDataValue = _mm256_or_pd(hasNoDataValue, isNoData4(cornerValue));
+                        } // if
+                        value = _mm256_add_pd(value, _mm256_mul_pd(wtsV[iCorner], cornerValue));
+                    } // for
+                    if (checkNoData) {
+                        value = _mm256_blendv_pd(value, noDataValue, hasNoDataValue);
+                    } // if
+
+                    if (useInterpolation) {
+                        __m256d nearestValue = load4(data + nearestOffset + iValue);
+                        nearestValue = _mm256_blendv_pd(nearestValue, noDataValue, isNoData4(nearestValue));
+
+                        const __m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(useInterpolation + iValue));
+                        const __m256i isZero = _mm256_cmpeq_epi64(flags, _mm256_setzero_si256());
+                        value = _mm256_blendv_pd(value, nearestValue, _mm256_castsi256_pd(isZero));
+                    } // if
+                    _mm256_storeu_pd(values + iValue, value);
+                } // for
+
+                // Remaining values.
+                scalar<T, numCorners, checkNoData>(values + iValue, data + iValue, cornerOffsets, wts, nearestOffset,
+                                                   useInterpolation ? useInterpolation + iValue : nullptr,
+                                                   numValues - iValue);
+            } // avx2
+
+            // AVX-512 (8 values at a time) -------------------------------------------------------
+
+            __attribute__((target("avx512f")))
+            inline __m512d load8(const double* const data) {
+                return _mm512_loadu_pd(data);
+            } // load8
+
+            __attribute__((target("avx512f")))
+            inline __m512d load8(const float* const data) {
+                return _mm512_maskz_cvtps_pd(__mmask8(0xff), _mm256_loadu_ps(data));
+            } // load8
+
+            __attribute__((target("avx512f")))
+            inline __mmask8 isNoData8(const __m512d value) {
+                const __m512d ratio = _mm512_div_pd(value, _mm512_set1_pd(geomodelgrids::NODATA_VALUE));
+                const __m512d misfit = _mm512_abs_pd(_mm512_sub_pd(_mm512_set1_pd(1.0), ratio));
+                return _mm512_cmp_pd_mask(misfit, _mm512_set1_pd(1.0e-3), _CMP_LT_OQ);
+            } // isNoData8
+
+            /** AVX-512 kernel.
+             *
+             * See HyperslabKernels::Kernel for a description of the arguments.
+             */
+            template<typename T, size_t numCorners, bool checkNoData>
+            __attribute__((target("avx512f")))
+            void avx512(double* const values,
+                        const T* const data,
+                        const size_t cornerOffsets[],
+                        const double wts[],
+                        const size_t nearestOffset,
+                        const size_t useInterpolation[],
+                        const size_t numValues) {
+                const size_t width = 8;
+                const __m512d noDataValue = _mm512_set1_pd(geomodelgrids::NODATA_VALUE);
+                __m512d wtsV[numCorners];
+                for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                    wtsV[iCorner] = _mm512_set1_pd(wts[iCorner]);
+                } // for
+
+                size_t iValue = 0;
+                for (; iValue + width <= numValues; iValue += width) {
+                    __m512d value = _mm512_setzero_pd();
+                    __mmask8 hasNoDataValue = 0;
+                    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                        const __m512d cornerValue = load8(data + cornerOffsets[iCorner] + iValue);
+                        if (checkNoData) {
+                            hasNoDataValue |= isNoData8(cornerValue);
+                        } // if
+                        value = _mm512_add_pd(value, _mm512_mul_pd(wtsV[iCorner], cornerValue));
+                    } // for
+                    if (checkNoData) {
+                        value = _mm512_mask_blend_pd(hasNoDataValue, value, noDataValue);
+                    } // if
+
+                    if (useInterpolation) {
+                        __m512d nearestValue = load8(data + nearestOffset + iValue);
+                        nearestValue = _mm512_mask_blend_pd(isNoData8(nearestValue), nearestValue, noDataValue);
+
+                        const __m512i flags = _mm512_loadu_si512(useInterpolation + iValue);
+                        const __mmask8 isZero = _mm512_cmpeq_epi64_mask(flags, _mm512_setzero_si512());
+                        value = _mm512_mask_blend_pd(isZero, value, nearestValue);
+                    } // if
+                    _mm512_storeu_pd(values + iValue, value);
+                } // for
+
+                // Remaining values.
+                scalar<T, numCorners, checkNoData>(values + iValue, data + iValue, cornerOffsets, wts, nearestOffset,
+                                                   useInterpolation ? useInterpolation + iValue : nullptr,
+                                                   numValues - iValue);
+            } // avx512
+
+#endif
+
+            /** Get kernel for instruction set.
+             *
+             * @param[in] instructionSet Instruction set.
+             * @returns Kernel function.
+             */
+            template<typename T, size_t numCorners, bool checkNoData>
+            typename HyperslabKernels::Kernel<T>::fn_type
+            select(const HyperslabKernels::InstructionSetEnum instructionSet) {
+                switch (instructionSet) {
+                case HyperslabKernels::INSTRUCTIONS_SCALAR:
+                    return scalar<T, numCorners, checkNoData>;
+#if defined(GEOMODELGRIDS_X86_KERNELS)
+                case HyperslabKernels::INSTRUCTIONS_SSE2:
+                    return sse2<T, numCorners, checkNoData>;
+                case HyperslabKernels::INSTRUCTIONS_AVX2:
+                    return avx2<T, numCorners, checkNoData>;
+                case HyperslabKernels::INSTRUCTIONS_AVX512:
+                    return avx512<T, numCorners, checkNoData>;
+#endif
+                default: {
+                    std::ostringstream msg;
+                    msg << "Kernels for instruction set '" << HyperslabKernels::getName(instructionSet)
+                        << "' are not available.";
+                    throw std::logic_error(msg.str());
+                } // default
+                } // switch
+            } // select
+
+        } // _HyperslabKernels
+    } // serial
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Get widest instruction set supported by the processor.
+geomodelgrids::serial::HyperslabKernels::InstructionSetEnum
+geomodelgrids::serial::HyperslabKernels::getInstructionSet(void) {
+    static const InstructionSetEnum instructionSet =
+        (isSupported(INSTRUCTIONS_AVX512)) ? INSTRUCTIONS_AVX512 :
+        (isSupported(INSTRUCTIONS_AVX2)) ? INSTRUCTIONS_AVX2 :
+        (isSupported(INSTRUCTIONS_SSE2)) ? INSTRUCTIONS_SSE2 :
+        INSTRUCTIONS_SCALAR;
+
+    return instructionSet;
+} // getInstructionSet
+
+
+// ------------------------------------------------------------------------------------------------
+// Is instruction set supported by the processor and the compiler?
+bool
+geomodelgrids::serial::HyperslabKernels::isSupported(const InstructionSetEnum instructionSet) {
+    switch (instructionSet) {
+    case INSTRUCTIONS_SCALAR:
+        return true;
+#if defined(GEOMODELGRIDS_X86_KERNELS)
+    case INSTRUCTIONS_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case INSTRUCTIONS_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    case INSTRUCTIONS_AVX512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    } // switch
+} // isSupported
+
+
+// ------------------------------------------------------------------------------------------------
+// Get name of instruction set.
+const char*
+geomodelgrids::serial::HyperslabKernels::getName(const InstructionSetEnum instructionSet) {
+    switch (instructionSet) {
+    case INSTRUCTIONS_SCALAR:
+        return "scalar";
+    case INSTRUCTIONS_SSE2:
+        return "SSE2";
+    case INSTRUCTIONS_AVX2:
+        return "AVX2";
+    case INSTRUCTIONS_AVX512:
+        return "AVX-512";
+    default:
+        return "unknown";
+    } // switch
+} // getName
+
+
+// ------------------------------------------------------------------------------------------------
+// Get kernel for values stored with type T.
+template<typename T>
+typename geomodelgrids::serial::HyperslabKernels::Kernel<T>::fn_type
+geomodelgrids::serial::HyperslabKernels::getKernel(const InstructionSetEnum instructionSet,
+                                                   const size_t numCorners,
+                                                   const bool checkNoData) {
+    if ((4 == numCorners) && !checkNoData) {
+        return _HyperslabKernels::select<T, 4, false>(instructionSet);
+    } else if (4 == numCorners) {
+        return _HyperslabKernels::select<T, 4, true>(instructionSet);
+    } else if ((8 == numCorners) && !checkNoData) {
+        return _HyperslabKernels::select<T, 8, false>(instructionSet);
+    } else if (8 == numCorners) {
+        return _HyperslabKernels::select<T, 8, true>(instructionSet);
+    } // if/else
+
+    std::ostringstream msg;
+    msg << "Expect number of cell corners (" << numCorners << ") to be 4 or 8 in geomodelgrids::serial::HyperslabKernels.";
+    throw std::domain_error(msg.str());
+} // getKernel
+
+
+// Explicit instantiation for values stored in double and single precision.
+template geomodelgrids::serial::HyperslabKernels::Kernel<double>::fn_type
+geomodelgrids::serial::HyperslabKernels::getKernel<double>(const InstructionSetEnum,
+                                                           const size_t,
+                                                           const bool);
+template geomodelgrids::serial::HyperslabKernels::Kernel<float>::fn_type
+geomodelgrids::serial::HyperslabKernels::getKernel<float>(const InstructionSetEnum,
+                                                          const size_t,
+                                                          const bool);
+
+// End of file
@@ -0,0 +1,110 @@
+/** Kernels computing values at a point from values at the corners of the cell containing the point.
+ *
+ * The scalar kernel is the portable reference implementation. On x86-64 processors, kernels using SSE2,
+ * AVX2, and AVX-512 instructions are compiled with function target attributes, so the library does not
+ * require any special compiler flags, and the kernel for the widest instruction set supported by the
+ * processor is selected at runtime.
+ *
+ * The vector kernels process several values at a point at once. They accumulate in double precision in
+ * the same order as the scalar kernel, so the values match the scalar kernel to within roundoff.
+ */
+#pragma once
+
+#include <cstdlib> // USES size_t
+
+// Forward declarations
+namespace geomodelgrids {
+    namespace serial {
+        class HyperslabKernels;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::HyperslabKernels {
+    // PUBLIC ENUMS -------------------------------------------------------------------------------
+public:
+
+    enum InstructionSetEnum {
+        INSTRUCTIONS_SCALAR=0, ///< Portable scalar kernel (reference).
+        INSTRUCTIONS_SSE2=1, ///< 2 values at a time.
+        INSTRUCTIONS_AVX2=2, ///< 4 values at a time.
+        INSTRUCTIONS_AVX512=3, ///< 8 values at a time.
+    };
+
+    // PUBLIC TYPEDEFS ----------------------------------------------------------------------------
+public:
+
+    /** Kernel for values stored with type T.
+     *
+     * Kernel arguments:
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] data Values of hyperslab.
+     * @param[in] cornerOffsets Array of offsets of values at cell corners.
+     * @param[in] wts Array of interpolation weights for cell corners.
+     * @param[in] nearestOffset Offset of values at nearest point (ignored if useInterpolation is null).
+     * @param[in] useInterpolation Array with interpolation flag for each value (null for interpolation of all values).
+     * @param[in] numValues Number of values.
+     */
+    template<typename T>
+    struct Kernel {
+        typedef void (*fn_type)(double* const values,
+                                const T* const data,
+                                const size_t cornerOffsets[],
+                                const double wts[],
+                                const size_t nearestOffset,
+                                const size_t useInterpolation[],
+                                const size_t numValues);
+    };
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Get widest instruction set supported by the processor.
+     *
+     * @returns Instruction set used by default.
+     */
+    static
+    InstructionSetEnum getInstructionSet(void);
+
+    /** Is instruction set supported by the processor and the compiler?
+     *
+     * @param[in] instructionSet Instruction set.
+     * @returns True if kernels for the instruction set can be used, false otherwise.
+     */
+    static
+    bool isSupported(const InstructionSetEnum instructionSet);
+
+    /** Get name of instruction set.
+     *
+     * @param[in] instructionSet Instruction set.
+     * @returns Name of instruction set.
+     */
+    static
+    const char* getName(const InstructionSetEnum instructionSet);
+
+    /** Get kernel for values stored with type T (double or float).
+     *
+     * Values are set to NODATA_VALUE if checkNoData is true and any value used in the interpolation is
+     * NODATA_VALUE. Values using the nearest point are always checked for NODATA_VALUE.
+     *
+     * @param[in] instructionSet Instruction set (must be supported).
+     * @param[in] numCorners Number of cell corners (4 for 2-D, 8 for 3-D).
+     * @param[in] checkNoData True if interpolated values are checked for NODATA_VALUE.
+     * @returns Kernel function.
+     */
+    template<typename T>
+    static
+    typename Kernel<T>::fn_type getKernel(const InstructionSetEnum instructionSet,
+                                          const size_t numCorners,
+                                          const bool checkNoData);
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    HyperslabKernels(void); ///< Not implemented
+    HyperslabKernels(const HyperslabKernels&); ///< Not implemented
+    const HyperslabKernels& operator=(const HyperslabKernels&); ///< Not implemented
+
+}; // HyperslabKernels
+
+// End of file
@@ -0,0 +1,394 @@
+#include <portinfo>
+
+#include "IOProfile.hh" // implementation of class methods
+
+#include <stdexcept> // USES std::invalid_argument
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <string> // USES std::string
+#include <algorithm> // USES std::min(), std::max()
+#include <cassert> // USES assert()
+#include <cctype> // USES isdigit()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _IOProfile;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_IOProfile {
+public:
+
+    /** Convert string to number of bytes.
+     *
+     * @param[in] key Name of parameter (for error messages).
+     * @param[in] value String with integer and optional K, M, or G suffix.
+     * @returns Number of bytes.
+     */
+    static
+    size_t toBytes(const std::string& key,
+                   const std::string& value);
+
+    /** Convert string to dimensions.
+     *
+     * @param[out] dims Array of dimensions.
+     * @param[in] ndims Number of dimensions.
+     * @param[in] key Name of parameter (for error messages).
+     * @param[in] value String with dimensions separated by 'x'.
+     */
+    static
+    void toDims(size_t dims[],
+                const size_t ndims,
+                const std::string& key,
+                const std::string& value);
+
+    /** Convert string to unsigned integer.
+     *
+     * @param[in] key Name of parameter (for error messages).
+     * @param[in] value String with integer.
+     * @param[out] pos Number of characters processed (nullptr if entire string must be processed).
+     * @returns Integer value.
+     */
+    static
+    size_t toUnsigned(const std::string& key,
+                      const std::string& value,
+                      size_t* pos=nullptr);
+
+    /** Throw exception for bad parameter value.
+     *
+     * @param[in] key Name of parameter.
+     * @param[in] value Value of parameter.
+     */
+    static
+    void badValue(const std::string& key,
+                  const std::string& value);
+
+}; // _IOProfile
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::IOProfile::IOProfile(void) :
+    _chunkCacheSize(0),
+    _chunkCacheNumSlots(521),
+    _chunkCachePreemption(0.75),
+    _tileCacheSize(0) {
+    _blockHyperslabDims[0] = 64;
+    _blockHyperslabDims[1] = 64;
+    _blockHyperslabDims[2] = 0;
+
+    _surfaceHyperslabDims[0] = 128;
+    _surfaceHyperslabDims[1] = 128;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::IOProfile::~IOProfile(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Create profile for borehole queries.
+geomodelgrids::serial::IOProfile
+geomodelgrids::serial::IOProfile::borehole(void) {
+    IOProfile profile;
+
+    const size_t blockDims[3] = { 8, 8, 0 };
+    profile.setBlockHyperslabDims(blockDims, 3);
+    const size_t surfaceDims[2] = { 16, 16 };
+    profile.setSurfaceHyperslabDims(surfaceDims, 2);
+    profile.setChunkCache(1024*1024, 521, 0.75);
+    profile.setTileCacheSize(4*1024*1024);
+
+    return profile;
+} // borehole
+
+
+// ------------------------------------------------------------------------------------------------
+// Create profile for extracting values on dense grids.
+geomodelgrids::serial::IOProfile
+geomodelgrids::serial::IOProfile::grid(void) {
+    IOProfile profile;
+
+    const size_t blockDims[3] = { 128, 128, 0 };
+    profile.setBlockHyperslabDims(blockDims, 3);
+    const size_t surfaceDims[2] = { 256, 256 };
+    profile.setSurfaceHyperslabDims(surfaceDims, 2);
+    // Chunks are read once while sweeping through the model, so evict fully read chunks first.
+    profile.setChunkCache(64*1024*1024, 10007, 1.0);
+    profile.setTileCacheSize(256*1024*1024);
+
+    return profile;
+} // grid
+
+
+// ------------------------------------------------------------------------------------------------
+// Create profile from string.
+geomodelgrids::serial::IOProfile
+geomodelgrids::serial::IOProfile::fromString(const char* value) {
+    assert(value);
+
+    IOProfile profile;
+
+    std::istringstream tokenStream(value);
+    std::string token;
+    bool isFirst = true;
+    while (std::getline(tokenStream, token, ',')) {
+        const size_t posEqual = token.find('=');
+        if (std::string::npos == posEqual) {
+            if (!isFirst) {
+                std::ostringstream msg;
+                msg << "Preset '" << token << "' must be the first entry in I/O profile '" << value << "'.";
+                throw std::invalid_argument(msg.str());
+            } else if (std::string("default") == token) {
+                profile = IOProfile();
+            } else if (std::string("borehole") == token) {
+                profile = borehole();
+            } else if (std::string("grid") == token) {
+                profile = grid();
+            } else {
+                std::ostringstream msg;
+                msg << "Unknown I/O profile preset '" << token << "'. Use 'default', 'borehole', or 'grid'.";
+                throw std::invalid_argument(msg.str());
+            } // if/else
+            isFirst = false;
+            continue;
+        } // if
+        isFirst = false;
+
+        const std::string& key = token.substr(0, posEqual);
+        const std::string& keyValue = token.substr(posEqual+1);
+        if (std::string("chunk_cache_size") == key) {
+            profile._chunkCacheSize = _IOProfile::toBytes(key, keyValue);
+        } else if (std::string("chunk_cache_slots") == key) {
+            profile._chunkCacheNumSlots = _IOProfile::toUnsigned(key, keyValue);
+        } else if (std::string("chunk_cache_preemption") == key) {
+            size_t pos = 0;
+            double preemption = 0.0;
+            try {
+                preemption = std::stod(keyValue, &pos);
+            } catch (const std::exception&) {
+                _IOProfile::badValue(key, keyValue);
+            } // try/catch
+            if ((pos != keyValue.size()) || (preemption < 0.0) || (preemption > 1.0)) {
+                _IOProfile::badValue(key, keyValue);
+            } // if
+            profile._chunkCachePreemption = preemption;
+        } else if (std::string("tile_cache_size") == key) {
+            profile._tileCacheSize = _IOProfile::toBytes(key, keyValue);
+        } else if (std::string("block_hyperslab") == key) {
+            _IOProfile::toDims(profile._blockHyperslabDims, 3, key, keyValue);
+        } else if (std::string("surface_hyperslab") == key) {
+            _IOProfile::toDims(profile._surfaceHyperslabDims, 2, key, keyValue);
+        } else {
+            std::ostringstream msg;
+            msg << "Unknown I/O profile parameter '" << key << "'.";
+            throw std::invalid_argument(msg.str());
+        } // if/else
+    } // while
+
+    return profile;
+} // fromString
+
+
+// ------------------------------------------------------------------------------------------------
+// Set chunk cache for each open dataset.
+void
+geomodelgrids::serial::IOProfile::setChunkCache(const size_t numBytes,
+                                                const size_t numSlots,
+                                                const double preemption) {
+    _chunkCacheSize = numBytes;
+    _chunkCacheNumSlots = numSlots;
+    _chunkCachePreemption = std::max(0.0, std::min(1.0, preemption));
+} // setChunkCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of chunk cache for each open dataset.
+size_t
+geomodelgrids::serial::IOProfile::getChunkCacheSize(void) const {
+    return _chunkCacheSize;
+} // getChunkCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of slots in chunk cache for each open dataset.
+size_t
+geomodelgrids::serial::IOProfile::getChunkCacheNumSlots(void) const {
+    return _chunkCacheNumSlots;
+} // getChunkCacheNumSlots
+
+
+// ------------------------------------------------------------------------------------------------
+// Get preemption policy value of chunk cache for each open dataset.
+double
+geomodelgrids::serial::IOProfile::getChunkCachePreemption(void) const {
+    return _chunkCachePreemption;
+} // getChunkCachePreemption
+
+
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslab tiles for blocks.
+void
+geomodelgrids::serial::IOProfile::setBlockHyperslabDims(const size_t dims[],
+                                                        const size_t ndimsIn) {
+    const size_t ndims = 3;
+    if (ndims != ndimsIn) {
+        std::ostringstream msg;
+        msg << "Expected array of length " << ndims << " for block hyperslab dimensions, got array of length "
+            << ndimsIn << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    for (size_t i = 0; i < ndims; ++i) {
+        _blockHyperslabDims[i] = dims[i];
+    } // for
+} // setBlockHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of hyperslab tiles for blocks.
+const size_t*
+geomodelgrids::serial::IOProfile::getBlockHyperslabDims(void) const {
+    return _blockHyperslabDims;
+} // getBlockHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set dimensions of hyperslab tiles for surfaces.
+void
+geomodelgrids::serial::IOProfile::setSurfaceHyperslabDims(const size_t dims[],
+                                                          const size_t ndimsIn) {
+    const size_t ndims = 2;
+    if (ndims != ndimsIn) {
+        std::ostringstream msg;
+        msg << "Expected array of length " << ndims << " for surface hyperslab dimensions, got array of length "
+            << ndimsIn << ".";
+        throw std::length_error(msg.str().c_str());
+    } // if
+    assert(dims);
+
+    for (size_t i = 0; i < ndims; ++i) {
+        _surfaceHyperslabDims[i] = dims[i];
+    } // for
+} // setSurfaceHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of hyperslab tiles for surfaces.
+const size_t*
+geomodelgrids::serial::IOProfile::getSurfaceHyperslabDims(void) const {
+    return _surfaceHyperslabDims;
+} // getSurfaceHyperslabDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of hyperslab tile cache for each block and surface.
+void
+geomodelgrids::serial::IOProfile::setTileCacheSize(const size_t numBytes) {
+    _tileCacheSize = numBytes;
+} // setTileCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum size of hyperslab tile cache for each block and surface.
+size_t
+geomodelgrids::serial::IOProfile::getTileCacheSize(void) const {
+    return _tileCacheSize;
+} // getTileCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert string to number of bytes.
+size_t
+geomodelgrids::serial::_IOProfile::toBytes(const std::string& key,
+                                           const std::string& value) {
+    size_t pos = 0;
+    const size_t number = toUnsigned(key, value, &pos);
+
+    size_t scale = 1;
+    const std::string& suffix = value.substr(pos);
+    if (suffix.empty()) {
+        scale = 1;
+    } else if (std::string("K") == suffix) {
+        scale = 1024;
+    } else if (std::string("M") == suffix) {
+        scale = 1024*1024;
+    } else if (std::string("G") == suffix) {
+        scale = 1024*1024*1024;
+    } else {
+        badValue(key, value);
+    } // if/else
+
+    return number * scale;
+} // toBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert string to dimensions.
+void
+geomodelgrids::serial::_IOProfile::toDims(size_t dims[],
+                                          const size_t ndims,
+                                          const std::string& key,
+                                          const std::string& value) {
+    assert(dims);
+
+    std::istringstream dimStream(value);
+    std::string dim;
+    size_t count = 0;
+    size_t dimsTmp[3];
+    while (std::getline(dimStream, dim, 'x')) {
+        if (count >= ndims) {
+            badValue(key, value);
+        } // if
+        dimsTmp[count++] = toUnsigned(key, dim);
+    } // while
+    if (count != ndims) {
+        badValue(key, value);
+    } // if
+
+    for (size_t i = 0; i < ndims; ++i) {
+        dims[i] = dimsTmp[i];
+    } // for
+} // toDims
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert string to unsigned integer.
+size_t
+geomodelgrids::serial::_IOProfile::toUnsigned(const std::string& key,
+                                              const std::string& value,
+                                              size_t* pos) {
+    if (value.empty() || !isdigit(value[0])) {
+        badValue(key, value);
+    } // if
+
+    size_t number = 0;
+    size_t numChars = 0;
+    try {
+        number = std::stoul(value, &numChars);
+    } catch (const std::exception&) {
+        badValue(key, value);
+    } // try/catch
+    if (pos) {
+        *pos = numChars;
+    } else if (numChars != value.size()) {
+        badValue(key, value);
+    } // if/else
+
+    return number;
+} // toUnsigned
+
+
+// ------------------------------------------------------------------------------------------------
+// Throw exception for bad parameter value.
+void
+geomodelgrids::serial::_IOProfile::badValue(const std::string& key,
+                                            const std::string& value) {
+    std::ostringstream msg;
+    msg << "Bad value '" << value << "' for I/O profile parameter '" << key << "'.";
+    throw std::invalid_argument(msg.str());
+} // badValue
+
+
+// End of file
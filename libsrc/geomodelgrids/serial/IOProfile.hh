@@ -0,0 +1,153 @@
+/** Read-tuning parameters for querying models.
+ *
+ * The profile collects the parameters that control how model data is read from the HDF5 file:
+ *   - chunk cache of each open dataset (H5Pset_chunk_cache),
+ *   - dimensions of hyperslab tiles for blocks and surfaces, and
+ *   - memory budget of the hyperslab tile cache for each block and surface.
+ *
+ * Presets are provided for borehole queries (scattered vertical profiles) and for extracting values
+ * on dense grids. A profile can also be created from a string, which is how the command line
+ * applications, C API, and Python API select a profile:
+ *
+ *   PRESET[,KEY=VALUE,...]  or  KEY=VALUE[,KEY=VALUE,...]
+ *
+ * where PRESET is one of 'default', 'borehole', or 'grid' and KEY is one of
+ *   - chunk_cache_size (bytes, with optional K, M, or G suffix),
+ *   - chunk_cache_slots,
+ *   - chunk_cache_preemption,
+ *   - tile_cache_size (bytes, with optional K, M, or G suffix),
+ *   - block_hyperslab (NXxNYxNZ), and
+ *   - surface_hyperslab (NXxNY).
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <cstddef> // USES size_t
+
+class geomodelgrids::serial::IOProfile {
+    friend class TestIOProfile; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor with default read parameters.
+    IOProfile(void);
+
+    /// Destructor
+    ~IOProfile(void);
+
+    /** Create profile for borehole queries.
+     *
+     * Small tiles spanning the entire depth of each block and small caches suit scattered vertical
+     * profiles, where few values are read around each (x, y) location.
+     *
+     * @returns Profile for borehole queries.
+     */
+    static
+    IOProfile borehole(void);
+
+    /** Create profile for extracting values on dense grids.
+     *
+     * Large tiles and large caches suit sweeping through most of the model.
+     *
+     * @returns Profile for dense grid extraction.
+     */
+    static
+    IOProfile grid(void);
+
+    /** Create profile from string.
+     *
+     * @param[in] value Preset name and/or comma separated KEY=VALUE parameters.
+     * @returns Profile.
+     */
+    static
+    IOProfile fromString(const char* value);
+
+    /** Set chunk cache for each open dataset.
+     *
+     * A cache size of 0 uses the chunk cache of the HDF5 file.
+     *
+     * @param[in] numBytes Size (in bytes) of chunk cache for each dataset.
+     * @param[in] numSlots Number of chunk slots (should be a prime number).
+     * @param[in] preemption Preemption policy value (between 0 and 1).
+     */
+    void setChunkCache(const size_t numBytes,
+                       const size_t numSlots,
+                       const double preemption=0.75);
+
+    /** Get size of chunk cache for each open dataset.
+     *
+     * @returns Size (in bytes) of chunk cache (0 to use the chunk cache of the HDF5 file).
+     */
+    size_t getChunkCacheSize(void) const;
+
+    /** Get number of slots in chunk cache for each open dataset.
+     *
+     * @returns Number of chunk slots.
+     */
+    size_t getChunkCacheNumSlots(void) const;
+
+    /** Get preemption policy value of chunk cache for each open dataset.
+     *
+     * @returns Preemption policy value.
+     */
+    double getChunkCachePreemption(void) const;
+
+    /** Set dimensions of hyperslab tiles for blocks.
+     *
+     * A dimension of 0 uses the entire extent of the block along that dimension.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y, z].
+     * @param[in] ndims Number of dimensions (must be 3).
+     */
+    void setBlockHyperslabDims(const size_t dims[],
+                               const size_t ndims);
+
+    /** Get dimensions of hyperslab tiles for blocks.
+     *
+     * @returns Dimensions of hyperslab [x, y, z].
+     */
+    const size_t* getBlockHyperslabDims(void) const;
+
+    /** Set dimensions of hyperslab tiles for surfaces.
+     *
+     * A dimension of 0 uses the entire extent of the surface along that dimension.
+     *
+     * @param[in] dims Dimensions of hyperslab [x, y].
+     * @param[in] ndims Number of dimensions (must be 2).
+     */
+    void setSurfaceHyperslabDims(const size_t dims[],
+                                 const size_t ndims);
+
+    /** Get dimensions of hyperslab tiles for surfaces.
+     *
+     * @returns Dimensions of hyperslab [x, y].
+     */
+    const size_t* getSurfaceHyperslabDims(void) const;
+
+    /** Set maximum size of hyperslab tile cache for each block and surface.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of tile cache (0 for default).
+     */
+    void setTileCacheSize(const size_t numBytes);
+
+    /** Get maximum size of hyperslab tile cache for each block and surface.
+     *
+     * @returns Maximum size (in bytes) of tile cache (0 for default).
+     */
+    size_t getTileCacheSize(void) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    size_t _chunkCacheSize; ///< Size (in bytes) of chunk cache for each dataset (0 for file cache).
+    size_t _chunkCacheNumSlots; ///< Number of slots in chunk cache for each dataset.
+    double _chunkCachePreemption; ///< Preemption policy value for chunk cache of each dataset.
+    size_t _blockHyperslabDims[3]; ///< Dimensions of hyperslab tiles for blocks.
+    size_t _surfaceHyperslabDims[2]; ///< Dimensions of hyperslab tiles for surfaces.
+    size_t _tileCacheSize; ///< Maximum size (in bytes) of tile cache (0 for default).
+
+}; // IOProfile
+
+// End of file
@@ -3,19 +3,22 @@
 #include "Model.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/ModelContext.hh" // USES ModelContext
 #include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
+#include "geomodelgrids/utils/CRSInterpolator.hh" // USES CRSInterpolator
 #include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
 
 #include <cstring> // USES strlen()
 #include <strings.h> // USES strcasecmp()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
-#include <algorithm> // USES std::fill()
+#include <algorithm> // USES std::fill(), std::min(), std::max()
 #include <cassert> // USES assert()
-#include <cmath> // USES M_PI, cos(), sin()
+#include <cmath> // USES M_PI, cos(), sin(), sqrt()
 
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
@@ -23,12 +26,24 @@ geomodelgrids::serial::Model::Model(void) :
     _layout(VERTEX),
     _modelCRSString(""),
     _inputCRSString("EPSG:4326"),
-    _yazimuth(0.0) {
+    _yazimuth(0.0),
+    _cosYAzimuth(1.0),
+    _sinYAzimuth(0.0),
+    _isAffine(false),
+    _isAffineZ(false),
+    _cacheSize(0),
+    _residentBudget(0),
+    _singlePrecision(false),
+    _transformTolerance(0.0),
+    _ioProfile(std::make_unique<geomodelgrids::serial::IOProfile>()) {
     _origin[0] = 0.0;
     _origin[1] = 0.0;
     _dims[0] = 0.0;
     _dims[1] = 0.0;
     _dims[2] = 0.0;
+    std::fill(_affineXY, _affineXY+6, 0.0);
+    _affineZ[0] = 0.0;
+    _affineZ[1] = 0.0;
 } // constructor
 
 
@@ -47,6 +62,25 @@ geomodelgrids::serial::Model::setInputCRS(const std::string& value) {
 } // setInputCRS
 
 
+// ------------------------------------------------------------------------------------------------
+// Set tolerance for approximating the CRS transformation of query points.
+void
+geomodelgrids::serial::Model::setTransformTolerance(const double value) {
+    _transformTolerance = value;
+} // setTransformTolerance
+
+
+// ------------------------------------------------------------------------------------------------
+// Set parameters for reading data from the model file.
+void
+geomodelgrids::serial::Model::setIOProfile(const geomodelgrids::serial::IOProfile& profile) {
+    assert(_ioProfile);
+    *_ioProfile = profile;
+    _applyIOProfile();
+    setCacheSize(_ioProfile->getTileCacheSize());
+} // setIOProfile
+
+
 // ------------------------------------------------------------------------------------------------
 // Open Model file.
 void
@@ -74,13 +108,92 @@ geomodelgrids::serial::Model::open(const char* filename,
     } // switch
 
     _h5->open(filename, h5Mode);
+    _applyIOProfile();
 } // open
 
 
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of tile cache for each block and surface.
+void
+geomodelgrids::serial::Model::setCacheSize(const size_t numBytes) {
+    _cacheSize = numBytes;
+
+    // Cache size is used for hyperslabs in query contexts created later.
+    if (_surfaceTop) {
+        _surfaceTop->setCacheSize(_cacheSize);
+    } // if
+    if (_surfaceTopoBathy) {
+        _surfaceTopoBathy->setCacheSize(_cacheSize);
+    } // if
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        if (_blocks[i]) {
+            _blocks[i]->setCacheSize(_cacheSize);
+        } // if
+    } // for
+
+    if (_context) {
+        _context->setCacheSize(_cacheSize);
+    } // if
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get tile cache statistics summed over blocks and surfaces.
+void
+geomodelgrids::serial::Model::getCacheStats(size_t* numHits,
+                                            size_t* numMisses) const {
+    if (_context) {
+        _context->getCacheStats(numHits, numMisses);
+    } else {
+        if (numHits) { *numHits = 0; }
+        if (numMisses) { *numMisses = 0; }
+    } // if/else
+} // getCacheStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for resident surfaces and blocks.
+void
+geomodelgrids::serial::Model::setResidentBudget(const size_t numBytes) {
+    _residentBudget = numBytes;
+} // setResidentBudget
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of surfaces and blocks resident in memory.
+size_t
+geomodelgrids::serial::Model::getResidentSize(void) const {
+    size_t numBytes = 0;
+    if (_surfaceTop && _surfaceTop->isResident()) {
+        numBytes += _surfaceTop->getValuesSize();
+    } // if
+    if (_surfaceTopoBathy && _surfaceTopoBathy->isResident()) {
+        numBytes += _surfaceTopoBathy->getValuesSize();
+    } // if
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        if (_blocks[i] && _blocks[i]->isResident()) {
+            numBytes += _blocks[i]->getValuesSize();
+        } // if
+    } // for
+
+    return numBytes;
+} // getResidentSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether surface and block values are stored in single precision.
+void
+geomodelgrids::serial::Model::setSinglePrecision(const bool value) {
+    _singlePrecision = value;
+} // setSinglePrecision
+
+
 // ------------------------------------------------------------------------------------------------
 // Close Model file.
 void
 geomodelgrids::serial::Model::close(void) {
+    _context.reset();
+
     if (_surfaceTop) {
         _surfaceTop->closeQuery();
     } // if
@@ -245,6 +358,8 @@ geomodelgrids::serial::Model::loadMetadata(void) {
     std::sort(_blocks.begin(), _blocks.end(), Block::compare);
 
     if (missingAttributes) { throw std::runtime_error(msg.str().c_str()); }
+
+    _applyIOProfile();
 } // loadMetadata
 
 
@@ -257,17 +372,32 @@ geomodelgrids::serial::Model::initialize(void) {
     _crsTransformer->setSrc(_inputCRSString.c_str());
     _crsTransformer->setDest(_modelCRSString.c_str());
     _crsTransformer->initialize();
+    _initAffine();
 
     if (_surfaceTop) {
-        _surfaceTop->openQuery(_h5.get());
+        _surfaceTop->setCacheSize(_cacheSize);
+        _surfaceTop->setSinglePrecision(_singlePrecision);
     } // if
     if (_surfaceTopoBathy) {
-        _surfaceTopoBathy->openQuery(_h5.get());
+        _surfaceTopoBathy->setCacheSize(_cacheSize);
+        _surfaceTopoBathy->setSinglePrecision(_singlePrecision);
     } // if
     size_t numBlocks = _blocks.size();
     for (size_t i = 0; i < numBlocks; ++i) {
-        _blocks[i]->openQuery(_h5.get());
+        _blocks[i]->setCacheSize(_cacheSize);
+        _blocks[i]->setSinglePrecision(_singlePrecision);
+        if (!_unitsBoolean.empty()) {
+            _blocks[i]->setInterpolation(_unitsBoolean);
+        } // if
     } // for
+    _loadResident();
+
+    _context.reset(new geomodelgrids::serial::ModelContext(*this));
+
+    _crsInterpolator.reset();
+    if (!_isAffine && (_transformTolerance > 0.0)) {
+        _initInterpolator();
+    } // if
 } // initialize
 
 
@@ -368,17 +498,44 @@ geomodelgrids::serial::Model::getBlocks(void) const {
 } // getBlocks
 
 
+// ------------------------------------------------------------------------------------------------
+// Get default query context.
+geomodelgrids::serial::ModelContext*
+geomodelgrids::serial::Model::getContext(void) const {
+    return _context.get();
+} // getContext
+
+
 // ------------------------------------------------------------------------------------------------
 // Does model
 bool
 geomodelgrids::serial::Model::contains(const double x,
                                        const double y,
                                        const double z) const {
-    double xModel = 0.0;
-    double yModel = 0.0;
-    double zModel = 0.0;
-    _toModelXYZ(&xModel, &yModel, &zModel, x, y, z);
+    return contains(x, y, z, _context.get());
+} // contains
+
+
+// ------------------------------------------------------------------------------------------------
+// Does model contain point?
+bool
+geomodelgrids::serial::Model::contains(const double x,
+                                       const double y,
+                                       const double z,
+                                       geomodelgrids::serial::ModelContext* const context) const {
+    Location location;
+    locate(&location, x, y, z, context);
 
+    return location.inModel;
+} // contains
+
+
+// ------------------------------------------------------------------------------------------------
+// Does model contain point in model coordinate system?
+bool
+geomodelgrids::serial::Model::containsModelXYZ(const double xModel,
+                                               const double yModel,
+                                               const double zModel) const {
     bool inModel = false;
     if (( xModel >= 0.0) && ( xModel <= _dims[0]) &&
         ( yModel >= 0.0) && ( yModel <= _dims[1]) &&
@@ -387,16 +544,27 @@ geomodelgrids::serial::Model::contains(const double x,
     } // if
 
     return inModel;
-} // contains
+} // containsModelXYZ
+
 
+// ------------------------------------------------------------------------------------------------
 bool
 geomodelgrids::serial::Model::containsIn(const double x,
-                                       const double y) const {
+                                         const double y) const {
+    return containsIn(x, y, _context.get());
+} // containsIn
+
+
+// ------------------------------------------------------------------------------------------------
+bool
+geomodelgrids::serial::Model::containsIn(const double x,
+                                         const double y,
+                                         geomodelgrids::serial::ModelContext* const context) const {
     double xModel = 0.0;
     double yModel = 0.0;
     bool inModel = false;
 
-    _toModelXYZ(&xModel, &yModel, nullptr, x, y, 0.0);
+    _toModelXYZ(&xModel, &yModel, nullptr, x, y, 0.0, context);
     if (( xModel >= 0.0) && ( xModel <= _dims[0]) &&
        ( yModel >= 0.0) && ( yModel <= _dims[1])) {
         inModel = true;
@@ -406,30 +574,151 @@ geomodelgrids::serial::Model::containsIn(const double x,
 } // contains
 
 
+// ------------------------------------------------------------------------------------------------
+// Get footprint of model in input CRS.
+void
+geomodelgrids::serial::Model::getFootprint(std::vector<double>* xy,
+                                           double* margin,
+                                           const size_t numEdgePoints) const {
+    assert(xy);
+    assert(numEdgePoints > 0);
+    assert(_context);
+    assert(_context->_crsTransformer);
+
+    const size_t numVertices = 4*numEdgePoints;
+    xy->resize(2*numVertices);
+    if (margin) { *margin = 0.0; }
+
+    const double corners[5][2] = {
+        { 0.0, 0.0 },
+        { _dims[0], 0.0 },
+        { _dims[0], _dims[1] },
+        { 0.0, _dims[1] },
+        { 0.0, 0.0 },
+    };
+    const double tolerance = 1.0e-6 * std::max(_dims[0], _dims[1]) + ((_crsInterpolator) ? _transformTolerance : 0.0);
+    double bbox[4] = { 0.0, 0.0, 0.0, 0.0 };
+    std::vector<double> midpoints(2*numVertices);
+    for (size_t iSide = 0, iVertex = 0; iSide < 4; ++iSide) {
+        for (size_t iPoint = 0; iPoint < numEdgePoints; ++iPoint, ++iVertex) {
+            // Vertex followed by midpoint of boundary between vertex and next vertex.
+            for (size_t iSample = 0; iSample < 2; ++iSample) {
+                const double t = (double(iPoint) + 0.5*iSample) / double(numEdgePoints);
+                const double xModel = (1.0-t)*corners[iSide][0] + t*corners[iSide+1][0];
+                const double yModel = (1.0-t)*corners[iSide][1] + t*corners[iSide+1][1];
+                double xModelCRS = 0.0;
+                double yModelCRS = 0.0;
+                _toModelCRS(&xModelCRS, &yModelCRS, xModel, yModel);
+
+                double xIn = 0.0;
+                double yIn = 0.0;
+                _context->_crsTransformer->inverse_transform(&xIn, &yIn, nullptr, xModelCRS, yModelCRS, 0.0);
+                if (!std::isfinite(xIn) || !std::isfinite(yIn)) {
+                    xy->clear();
+                    return;
+                } // if
+
+                // Reject footprints where the inverse transform does not round trip.
+                double xCheck = 0.0;
+                double yCheck = 0.0;
+                _toModelXYZ(&xCheck, &yCheck, nullptr, xIn, yIn, 0.0, _context.get());
+                if ((fabs(xCheck-xModel) > tolerance) || (fabs(yCheck-yModel) > tolerance)) {
+                    xy->clear();
+                    return;
+                } // if
+
+                std::vector<double>& samples = (iSample) ? midpoints : *xy;
+                samples[2*iVertex+0] = xIn;
+                samples[2*iVertex+1] = yIn;
+            } // for
+
+            const double xIn = (*xy)[2*iVertex+0];
+            const double yIn = (*xy)[2*iVertex+1];
+            if (!iVertex) {
+                bbox[0] = bbox[1] = xIn;
+                bbox[2] = bbox[3] = yIn;
+            } else {
+                bbox[0] = std::min(bbox[0], xIn);
+                bbox[1] = std::max(bbox[1], xIn);
+                bbox[2] = std::min(bbox[2], yIn);
+                bbox[3] = std::max(bbox[3], yIn);
+            } // if/else
+        } // for
+    } // for
+
+    // Deviation of boundary from chord between consecutive vertices, measured at the midpoint of the
+    // boundary between the vertices. The footprint is unknown if the chords do not resolve the
+    // curvature of the boundary. The midpoint is also far from the middle of the chord if the
+    // boundary wraps around in the input CRS.
+    double maxDeviation = 0.0;
+    for (size_t iVertex = 0; iVertex < numVertices; ++iVertex) {
+        const size_t iNext = (iVertex+1) % numVertices;
+        const double x0 = (*xy)[2*iVertex+0];
+        const double y0 = (*xy)[2*iVertex+1];
+        const double dx = (*xy)[2*iNext+0] - x0;
+        const double dy = (*xy)[2*iNext+1] - y0;
+        const double xMid = midpoints[2*iVertex+0];
+        const double yMid = midpoints[2*iVertex+1];
+
+        // Distance from midpoint to closest point on chord.
+        const double chordLength = sqrt(dx*dx + dy*dy);
+        const double tChord = (chordLength > 0.0) ? ((xMid-x0)*dx + (yMid-y0)*dy) / (chordLength*chordLength) : 0.0;
+        const double tClosest = std::min(1.0, std::max(0.0, tChord));
+        const double xOffset = xMid - (x0 + tClosest*dx);
+        const double yOffset = yMid - (y0 + tClosest*dy);
+        const double deviation = sqrt(xOffset*xOffset + yOffset*yOffset);
+        if ((deviation > 0.25*chordLength) || (tChord < 0.25) || (tChord > 0.75)) {
+            xy->clear();
+            return;
+        } // if
+        maxDeviation = std::max(maxDeviation, deviation);
+    } // for
+
+    // Pad footprint by twice the deviation to cover variations in curvature along each chord, plus the
+    // tolerance of the transformation (converted to input CRS) so that points the model contains are
+    // always inside the padded footprint.
+    if (margin) {
+        const double scale = std::max(bbox[1]-bbox[0], bbox[3]-bbox[2]) / std::max(_dims[0], _dims[1]);
+        *margin = 2.0*maxDeviation + tolerance*scale;
+    } // if
+} // getFootprint
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for elevation of top of model at point using bilinear interpolation.
 double
 geomodelgrids::serial::Model::queryTopElevation(const double x,
                                                 const double y) {
-    double elevation = 0.0;
+    return queryTopElevation(x, y, _context.get());
+} // queryTopElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at point using bilinear interpolation.
+double
+geomodelgrids::serial::Model::queryTopElevation(const double x,
+                                                const double y,
+                                                geomodelgrids::serial::ModelContext* const context) const {
+    if (!_surfaceTop) {
+        return 0.0;
+    } // if
+
+    Location location;
+    locate(&location, x, y, 0.0, context);
+
+    return queryTopElevation(location, context);
+} // queryTopElevation
 
-    if (_surfaceTop) {
-        double xModel = 0.0;
-        double yModel = 0.0;
-        _toModelXYZ(&xModel, &yModel, nullptr, x, y, 0.0);
-        const double zModelCRS = _surfaceTop->query(xModel, yModel);
 
-        const double yazimuthRad = _yazimuth * M_PI / 180.0;
-        const double cosAz = cos(yazimuthRad);
-        const double sinAz = sin(yazimuthRad);
-        const double xRel = +xModel*cosAz + yModel*sinAz;
-        const double yRel = -xModel*sinAz + yModel*cosAz;
-        const double xModelCRS = xRel + _origin[0];
-        const double yModelCRS = yRel + _origin[1];
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at resolved location.
+double
+geomodelgrids::serial::Model::queryTopElevation(const Location& location,
+                                                geomodelgrids::serial::ModelContext* const context) const {
+    double elevation = 0.0;
 
-        double xIn = 0.0;
-        double yIn = 0.0;
-        _crsTransformer->inverse_transform(&xIn, &yIn, &elevation, xModelCRS, yModelCRS, zModelCRS);
+    if (_surfaceTop) {
+        elevation = _toInputElevation(location, location.zTopCRS, context);
     } // if
 
     return elevation;
@@ -441,47 +730,232 @@ geomodelgrids::serial::Model::queryTopElevation(const double x,
 double
 geomodelgrids::serial::Model::queryTopoBathyElevation(const double x,
                                                       const double y) {
-    double elevation = 0.0;
-
-    if (_surfaceTopoBathy || _surfaceTop) {
-        double xModel = 0.0;
-        double yModel = 0.0;
-        _toModelXYZ(&xModel, &yModel, nullptr, x, y, 0.0);
-        const double zModelCRS = (_surfaceTopoBathy) ? _surfaceTopoBathy->query(xModel, yModel) : _surfaceTop->query(xModel, yModel);
+    return queryTopoBathyElevation(x, y, _context.get());
+} // queryTopoBathyElevation
 
-        const double yazimuthRad = _yazimuth * M_PI / 180.0;
-        const double cosAz = cos(yazimuthRad);
-        const double sinAz = sin(yazimuthRad);
-        const double xRel = +xModel*cosAz + yModel*sinAz;
-        const double yRel = -xModel*sinAz + yModel*cosAz;
-        const double xModelCRS = xRel + _origin[0];
-        const double yModelCRS = yRel + _origin[1];
 
-        double xIn = 0.0;
-        double yIn = 0.0;
-        _crsTransformer->inverse_transform(&xIn, &yIn, &elevation, xModelCRS, yModelCRS, zModelCRS);
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at point using bilinear interpolation.
+double
+geomodelgrids::serial::Model::queryTopoBathyElevation(const double x,
+                                                      const double y,
+                                                      geomodelgrids::serial::ModelContext* const context) const {
+    if (!_surfaceTopoBathy && !_surfaceTop) {
+        return 0.0;
     } // if
 
+    Location location;
+    locate(&location, x, y, 0.0, context);
+
+    return queryTopoBathyElevation(location, context);
+} // queryTopoBathyElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at resolved location.
+double
+geomodelgrids::serial::Model::queryTopoBathyElevation(const Location& location,
+                                                      geomodelgrids::serial::ModelContext* const context) const {
+    double elevation = 0.0;
+
+    if (_surfaceTopoBathy) {
+        assert(context);
+        const double zModelCRS = _surfaceTopoBathy->query(context->_surfaceTopoBathy.get(), location.xModel, location.yModel);
+        elevation = _toInputElevation(location, zModelCRS, context);
+    } else if (_surfaceTop) {
+        elevation = _toInputElevation(location, location.zTopCRS, context);
+    } // if/else
+
     return elevation;
 } // queryTopoBathyElevation
 
 
 // ------------------------------------------------------------------------------------------------
-// Get model description.
+// Query for model values at point.
 const double*
 geomodelgrids::serial::Model::query(const double x,
                                     const double y,
                                     const double z) {
+    return query(x, y, z, _context.get());
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at point.
+const double*
+geomodelgrids::serial::Model::query(const double x,
+                                    const double y,
+                                    const double z,
+                                    geomodelgrids::serial::ModelContext* const context) const {
+    Location location;
+    locate(&location, x, y, z, context);
+
+    return query(location, context);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at resolved location.
+const double*
+geomodelgrids::serial::Model::query(const Location& location,
+                                    geomodelgrids::serial::ModelContext* const context) const {
+    assert(location.inModel);
+    assert(location.iBlock < _blocks.size());
+    assert(context);
+
+    double* values = context->_values.data();
+    _blocks[location.iBlock]->query(values, context->_blocks[location.iBlock].get(),
+                                    location.xModel, location.yModel, location.zModel);
+
+    return values;
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at point in model coordinate system.
+const double*
+geomodelgrids::serial::Model::queryModelXYZ(const double xModel,
+                                            const double yModel,
+                                            const double zModel) {
+    return queryModelXYZ(xModel, yModel, zModel, _context.get());
+} // queryModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at point in model coordinate system.
+const double*
+geomodelgrids::serial::Model::queryModelXYZ(const double xModel,
+                                            const double yModel,
+                                            const double zModel,
+                                            geomodelgrids::serial::ModelContext* const context) const {
+    assert(containsModelXYZ(xModel, yModel, zModel));
+    assert(context);
+
+    const size_t iBlock = _findBlockIndex(zModel);assert(iBlock < _blocks.size());
+    double* values = context->_values.data();
+    _blocks[iBlock]->query(values, context->_blocks[iBlock].get(), xModel, yModel, zModel);
+
+    return values;
+} // queryModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Resolve location of point in the model.
+void
+geomodelgrids::serial::Model::locate(Location* location,
+                                     const double x,
+                                     const double y,
+                                     const double z,
+                                     geomodelgrids::serial::ModelContext* const context) const {
+    assert(location);
+    assert(context);
+    assert(context->_crsTransformer);
+
+    double zModelCRS = 0.0;
+    _toModelXY(&location->xModel, &location->yModel, &zModelCRS, x, y, z, context);
+    location->zTopCRS = (_surfaceTop) ?
+                        _surfaceTop->query(context->_surfaceTop.get(), location->xModel, location->yModel) : 0.0;
+
+    _locateZ(location, zModelCRS);
+} // locate
+
+
+// ------------------------------------------------------------------------------------------------
+// Update location of point for a new elevation at the same horizontal position.
+void
+geomodelgrids::serial::Model::relocate(Location* location,
+                                       const double x,
+                                       const double y,
+                                       const double z,
+                                       geomodelgrids::serial::ModelContext* const context) const {
+    assert(location);
+    assert(context);
+    assert(context->_crsTransformer);
+
+    if (_isAffineZ) {
+        // Horizontal position in model is unchanged, so only transform elevation.
+        _locateZ(location, _affineZ[0] + _affineZ[1]*z);
+        return;
+    } // if
+
     double xModel = 0.0;
     double yModel = 0.0;
-    double zModel = 0.0;
-    _toModelXYZ(&xModel, &yModel, &zModel, x, y, z);
-    assert(contains(x, y, z));
+    double zModelCRS = 0.0;
+    _toModelXY(&xModel, &yModel, &zModelCRS, x, y, z, context);
+    if ((xModel != location->xModel) || (yModel != location->yModel)) {
+        location->xModel = xModel;
+        location->yModel = yModel;
+        location->zTopCRS = (_surfaceTop) ?
+                            _surfaceTop->query(context->_surfaceTop.get(), xModel, yModel) : 0.0;
+    } // if
 
-    std::shared_ptr<geomodelgrids::serial::Block> block = _findBlock(xModel, yModel, zModel);assert(block);
-    return block->query(xModel, yModel, zModel, _unitsBoolean);
+    _locateZ(location, zModelCRS);
+} // relocate
 
-} // query
+
+// ------------------------------------------------------------------------------------------------
+// Convert array of points in input CRS to model coordinates.
+void
+geomodelgrids::serial::Model::toModelXYZ(double* const xyzModel,
+                                         const double* const xyz,
+                                         const size_t numPoints) const {
+    toModelXYZ(xyzModel, xyz, numPoints, _context.get());
+} // toModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+// Convert array of points in input CRS to model coordinates.
+void
+geomodelgrids::serial::Model::toModelXYZ(double* const xyzModel,
+                                         const double* const xyz,
+                                         const size_t numPoints,
+                                         geomodelgrids::serial::ModelContext* const context) const {
+    if (!numPoints) { return; }
+    assert(xyzModel);
+    assert(xyz);
+    assert(context);
+    assert(context->_crsTransformer);
+
+    if (_crsInterpolator && !_isAffine) {
+        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+            const double xIn = xyz[3*iPoint+0];
+            const double yIn = xyz[3*iPoint+1];
+            const double zIn = xyz[3*iPoint+2];
+            double* xyzPt = &xyzModel[3*iPoint];
+            if (!_crsInterpolator->transform(&xyzPt[0], &xyzPt[1], &xyzPt[2], xIn, yIn, zIn)) {
+                context->_crsTransformer->transform(&xyzPt[0], &xyzPt[1], &xyzPt[2], xIn, yIn, zIn);
+            } // if
+        } // for
+    } else if (!_isAffine) {
+        context->_crsTransformer->transformMany(xyzModel, xyz, numPoints);
+    } // if/else
+
+    const double zBottom = -_dims[2];
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double* xyzPt = &xyzModel[3*iPoint];
+        double zModelCRS = 0.0;
+        if (_isAffine) {
+            const double xIn = xyz[3*iPoint+0];
+            const double yIn = xyz[3*iPoint+1];
+            zModelCRS = _affineZ[0] + _affineZ[1]*xyz[3*iPoint+2];
+            xyzPt[0] = _affineXY[0] + _affineXY[1]*xIn + _affineXY[2]*yIn;
+            xyzPt[1] = _affineXY[3] + _affineXY[4]*xIn + _affineXY[5]*yIn;
+        } else {
+            const double xRel = xyzPt[0] - _origin[0];
+            const double yRel = xyzPt[1] - _origin[1];
+            zModelCRS = (_isAffineZ) ? _affineZ[0] + _affineZ[1]*xyz[3*iPoint+2] : xyzPt[2];
+            xyzPt[0] = xRel*_cosYAzimuth - yRel*_sinYAzimuth;
+            xyzPt[1] = xRel*_sinYAzimuth + yRel*_cosYAzimuth;
+        } // if/else
+
+        const double zGroundSurf = (_surfaceTop) ?
+                                   _surfaceTop->query(context->_surfaceTop.get(), xyzPt[0], xyzPt[1]) : 0.0;
+        xyzPt[2] = zBottom * (zGroundSurf - zModelCRS) / (zGroundSurf - zBottom);
+        if ((xyzPt[2] > 0.0) && (xyzPt[2] < TOLERANCE)) {
+            xyzPt[2] = 0.0;
+        } // if
+    } // for
+} // toModelXYZ
 
 
 // ------------------------------------------------------------------------------------------------
@@ -492,26 +966,31 @@ geomodelgrids::serial::Model::_toModelXYZ(double* xModel,
                                           const double x,
                                           const double y,
                                           const double z) const {
+    _toModelXYZ(xModel, yModel, zModel, x, y, z, _context.get());
+} // _toModelXYZ
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_toModelXYZ(double* xModel,
+                                          double* yModel,
+                                          double* zModel,
+                                          const double x,
+                                          const double y,
+                                          const double z,
+                                          geomodelgrids::serial::ModelContext* const context) const {
     assert(xModel);
     assert(yModel);
-    assert(_crsTransformer);
+    assert(context);
+    assert(context->_crsTransformer);
 
-    double xModelCRS = 0.0;
-    double yModelCRS = 0.0;
     double zModelCRS = 0.0;
-    _crsTransformer->transform(&xModelCRS, &yModelCRS, &zModelCRS, x, y, z);
-    const double yazimuthRad = _yazimuth * M_PI / 180.0;
-    const double cosAz = cos(yazimuthRad);
-    const double sinAz = sin(yazimuthRad);
-    const double xRel = xModelCRS - _origin[0];
-    const double yRel = yModelCRS - _origin[1];
-    *xModel = xRel*cosAz - yRel*sinAz;
-    *yModel = xRel*sinAz + yRel*cosAz;
+    _toModelXY(xModel, yModel, &zModelCRS, x, y, z, context);
 
     if (zModel) {
         double zGroundSurf = 0.0;
         if (_surfaceTop) {
-            zGroundSurf = _surfaceTop->query(*xModel, *yModel);
+            zGroundSurf = _surfaceTop->query(context->_surfaceTop.get(), *xModel, *yModel);
         } // if
         const double zBottom = -_dims[2];
         *zModel = zBottom * (zGroundSurf - zModelCRS) / (zGroundSurf - zBottom);
@@ -522,21 +1001,220 @@ geomodelgrids::serial::Model::_toModelXYZ(double* xModel,
 } // _toModelXYZ
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_toModelXY(double* xModel,
+                                         double* yModel,
+                                         double* zModelCRS,
+                                         const double x,
+                                         const double y,
+                                         const double z,
+                                         geomodelgrids::serial::ModelContext* const context) const {
+    assert(xModel);
+    assert(yModel);
+    assert(zModelCRS);
+
+    if (_isAffine) {
+        *xModel = _affineXY[0] + _affineXY[1]*x + _affineXY[2]*y;
+        *yModel = _affineXY[3] + _affineXY[4]*x + _affineXY[5]*y;
+        *zModelCRS = _affineZ[0] + _affineZ[1]*z;
+        return;
+    } // if
+
+    double xModelCRS = 0.0;
+    double yModelCRS = 0.0;
+    if (!_crsInterpolator || !_crsInterpolator->transform(&xModelCRS, &yModelCRS, zModelCRS, x, y, z)) {
+        assert(context);
+        assert(context->_crsTransformer);
+        context->_crsTransformer->transform(&xModelCRS, &yModelCRS, zModelCRS, x, y, z);
+    } // if
+    if (_isAffineZ) {
+        *zModelCRS = _affineZ[0] + _affineZ[1]*z;
+    } // if
+    const double xRel = xModelCRS - _origin[0];
+    const double yRel = yModelCRS - _origin[1];
+    *xModel = xRel*_cosYAzimuth - yRel*_sinYAzimuth;
+    *yModel = xRel*_sinYAzimuth + yRel*_cosYAzimuth;
+} // _toModelXY
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_initAffine(void) {
+    assert(_crsTransformer);
+
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    _cosYAzimuth = cos(yazimuthRad);
+    _sinYAzimuth = sin(yazimuthRad);
+
+    // Bounding box of model domain in model CRS, allowing for topography above the origin.
+    double domain[6] = { 0.0, 0.0, 0.0, 0.0, -_dims[2], _dims[2] };
+    const double cornersModel[4][2] = {
+        { 0.0, 0.0 },
+        { _dims[0], 0.0 },
+        { 0.0, _dims[1] },
+        { _dims[0], _dims[1] },
+    };
+    for (size_t i = 0; i < 4; ++i) {
+        double xModelCRS = 0.0;
+        double yModelCRS = 0.0;
+        _toModelCRS(&xModelCRS, &yModelCRS, cornersModel[i][0], cornersModel[i][1]);
+        domain[0] = (i) ? std::min(domain[0], xModelCRS) : xModelCRS;
+        domain[1] = (i) ? std::max(domain[1], xModelCRS) : xModelCRS;
+        domain[2] = (i) ? std::min(domain[2], yModelCRS) : yModelCRS;
+        domain[3] = (i) ? std::max(domain[3], yModelCRS) : yModelCRS;
+    } // for
+
+    double coefsXY[6];
+    double coefsZ[2];
+    _isAffine = _crsTransformer->computeAffine(coefsXY, coefsZ, domain) && (coefsZ[1] != 0.0);
+    if (!_isAffine) {
+        // Horizontal transformation may still be independent of elevation, so points along a
+        // vertical profile only need the elevation transformed.
+        _isAffineZ = _crsTransformer->computeAffineZ(coefsZ, domain) && (coefsZ[1] != 0.0);
+        if (_isAffineZ) {
+            _affineZ[0] = coefsZ[0];
+            _affineZ[1] = coefsZ[1];
+        } // if
+        return;
+    } // if
+    _isAffineZ = true;
+
+    // Compose affine transformation to model CRS with translation and rotation to model coordinates.
+    const double xOffset = coefsXY[0] - _origin[0];
+    const double yOffset = coefsXY[3] - _origin[1];
+    _affineXY[0] = xOffset*_cosYAzimuth - yOffset*_sinYAzimuth;
+    _affineXY[1] = coefsXY[1]*_cosYAzimuth - coefsXY[4]*_sinYAzimuth;
+    _affineXY[2] = coefsXY[2]*_cosYAzimuth - coefsXY[5]*_sinYAzimuth;
+    _affineXY[3] = xOffset*_sinYAzimuth + yOffset*_cosYAzimuth;
+    _affineXY[4] = coefsXY[1]*_sinYAzimuth + coefsXY[4]*_cosYAzimuth;
+    _affineXY[5] = coefsXY[2]*_sinYAzimuth + coefsXY[5]*_cosYAzimuth;
+    _affineZ[0] = coefsZ[0];
+    _affineZ[1] = coefsZ[1];
+} // _initAffine
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_initInterpolator(void) {
+    assert(_crsTransformer);
+
+    std::vector<double> footprint;
+    getFootprint(&footprint, nullptr);
+    const size_t numVertices = footprint.size() / 2;
+    if (!numVertices) {
+        return;
+    } // if
+
+    // Bounding box of footprint in input CRS, padded so points on the boundary are inside the grid.
+    double domain[6] = { footprint[0], footprint[0], footprint[1], footprint[1], -_dims[2], _dims[2] };
+    for (size_t iVertex = 1; iVertex < numVertices; ++iVertex) {
+        domain[0] = std::min(domain[0], footprint[2*iVertex+0]);
+        domain[1] = std::max(domain[1], footprint[2*iVertex+0]);
+        domain[2] = std::min(domain[2], footprint[2*iVertex+1]);
+        domain[3] = std::max(domain[3], footprint[2*iVertex+1]);
+    } // for
+    const double margin[2] = { 0.01*(domain[1]-domain[0]), 0.01*(domain[3]-domain[2]) };
+    domain[0] -= margin[0];
+    domain[1] += margin[0];
+    domain[2] -= margin[1];
+    domain[3] += margin[1];
+
+    std::unique_ptr<geomodelgrids::utils::CRSInterpolator> interpolator(new geomodelgrids::utils::CRSInterpolator());
+    if (interpolator->initialize(_crsTransformer.get(), domain, _transformTolerance)) {
+        _crsInterpolator = std::move(interpolator);
+    } // if
+} // _initInterpolator
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_locateZ(Location* location,
+                                       const double zModelCRS) const {
+    assert(location);
+
+    const double zTop = location->zTopCRS;
+    const double zBottom = -_dims[2];
+    double zModel = zBottom * (zTop - zModelCRS) / (zTop - zBottom);
+    if ((zModel > 0.0) && (zModel < TOLERANCE)) {
+        zModel = 0.0;
+    } // if
+    location->zModel = zModel;
+    location->inModel = containsModelXYZ(location->xModel, location->yModel, zModel);
+    location->iBlock = (location->inModel) ?
+                       _findBlockIndex(zModel) : _blocks.size();
+} // _locateZ
+
+
+// ------------------------------------------------------------------------------------------------
+double
+geomodelgrids::serial::Model::_toInputElevation(const Location& location,
+                                                const double zModelCRS,
+                                                geomodelgrids::serial::ModelContext* const context) const {
+    assert(context);
+    assert(context->_crsTransformer);
+
+    if (_isAffine) {
+        return (zModelCRS - _affineZ[0]) / _affineZ[1];
+    } // if
+
+    double xModelCRS = 0.0;
+    double yModelCRS = 0.0;
+    _toModelCRS(&xModelCRS, &yModelCRS, location.xModel, location.yModel);
+
+    double xIn = 0.0;
+    double yIn = 0.0;
+    double elevation = 0.0;
+    context->_crsTransformer->inverse_transform(&xIn, &yIn, &elevation, xModelCRS, yModelCRS, zModelCRS);
+
+    return elevation;
+} // _toInputElevation
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::Model::_toModelCRS(double* xModelCRS,
+                                          double* yModelCRS,
+                                          const double xModel,
+                                          const double yModel) const {
+    assert(xModelCRS);
+    assert(yModelCRS);
+
+    const double xRel = +xModel*_cosYAzimuth + yModel*_sinYAzimuth;
+    const double yRel = -xModel*_sinYAzimuth + yModel*_cosYAzimuth;
+    *xModelCRS = xRel + _origin[0];
+    *yModelCRS = yRel + _origin[1];
+} // _toModelCRS
+
+
 // ------------------------------------------------------------------------------------------------
 std::shared_ptr<geomodelgrids::serial::Block>
 geomodelgrids::serial::Model::_findBlock(const double x,
                                          const double y,
                                          const double z) const {
-    for (auto block : _blocks) {
-        if (( z <= block->getZTop()) && ( z >= block->getZBottom()) ) {
-            return block;
-        } // if
-    } // for
+    const size_t iBlock = _findBlockIndex(z);
+    if (iBlock < _blocks.size()) {
+        return _blocks[iBlock];
+    } // if
     static std::shared_ptr<geomodelgrids::serial::Block> empty;
     return empty;
 } // _findBlock
 
 
+// ------------------------------------------------------------------------------------------------
+size_t
+geomodelgrids::serial::Model::_findBlockIndex(const double z) const {
+    const size_t numBlocks = _blocks.size();
+    for (size_t i = 0; i < numBlocks; ++i) {
+        if (( z <= _blocks[i]->getZTop()) && ( z >= _blocks[i]->getZBottom()) ) {
+            return i;
+        } // if
+    } // for
+
+    return numBlocks;
+} // _findBlockIndex
+
+
 // ------------------------------------------------------------------------------------------------
 std::vector<std::size_t>
 geomodelgrids::serial::Model::_toUnitsBoolean(const std::vector<std::string>& strings) const {
@@ -552,4 +1230,71 @@ geomodelgrids::serial::Model::_toUnitsBoolean(const std::vector<std::string>& st
     return stringsBoolean;
 } // _toUnitsBoolean
 
+
+// ------------------------------------------------------------------------------------------------
+// Load surfaces and blocks that fit in the resident memory budget.
+void
+geomodelgrids::serial::Model::_loadResident(void) {
+    if (!_residentBudget) {
+        return;
+    } // if
+    assert(_h5);
+
+    // Surfaces are used for every point, so they take priority over blocks. Blocks are ordered from the
+    // top down, which favors the blocks queried most often.
+    size_t numBytesFree = _residentBudget;
+    if (_surfaceTop && (_surfaceTop->getValuesSize() <= numBytesFree)) {
+        _surfaceTop->loadResident(_h5.get());
+        numBytesFree -= _surfaceTop->getValuesSize();
+    } // if
+    if (_surfaceTopoBathy && (_surfaceTopoBathy->getValuesSize() <= numBytesFree)) {
+        _surfaceTopoBathy->loadResident(_h5.get());
+        numBytesFree -= _surfaceTopoBathy->getValuesSize();
+    } // if
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        assert(_blocks[i]);
+        if (_blocks[i]->getValuesSize() <= numBytesFree) {
+            _blocks[i]->loadResident(_h5.get());
+            numBytesFree -= _blocks[i]->getValuesSize();
+        } // if
+    } // for
+} // _loadResident
+
+// ------------------------------------------------------------------------------------------------
+// Apply chunk cache and hyperslab dimensions of I/O profile to model file, surfaces, and blocks.
+void
+geomodelgrids::serial::Model::_applyIOProfile(void) {
+    assert(_ioProfile);
+    if (_h5) {
+        _h5->setDatasetChunkCache(_ioProfile->getChunkCacheSize(), _ioProfile->getChunkCacheNumSlots(),
+                                  _ioProfile->getChunkCachePreemption());
+    } // if
+
+    // Hyperslab dimensions of 0 use the entire extent along that dimension.
+    const size_t* surfaceDimsProfile = _ioProfile->getSurfaceHyperslabDims();
+    const size_t numSurfaces = 2;
+    geomodelgrids::serial::Surface* surfaces[numSurfaces] = { _surfaceTop.get(), _surfaceTopoBathy.get() };
+    for (size_t iSurface = 0; iSurface < numSurfaces; ++iSurface) {
+        if (!surfaces[iSurface]) { continue; }
+        const size_t* surfaceDims = surfaces[iSurface]->getDims();
+        size_t dims[2];
+        for (size_t i = 0; i < 2; ++i) {
+            dims[i] = (surfaceDimsProfile[i] > 0) ? surfaceDimsProfile[i] : surfaceDims[i];
+        } // for
+        surfaces[iSurface]->setHyperslabDims(dims, 2);
+    } // for
+
+    const size_t* blockDimsProfile = _ioProfile->getBlockHyperslabDims();
+    for (size_t iBlock = 0; iBlock < _blocks.size(); ++iBlock) {
+        if (!_blocks[iBlock]) { continue; }
+        const size_t* blockDims = _blocks[iBlock]->getDims();
+        size_t dims[3];
+        for (size_t i = 0; i < 3; ++i) {
+            dims[i] = (blockDimsProfile[i] > 0) ? blockDimsProfile[i] : blockDims[i];
+        } // for
+        _blocks[iBlock]->setHyperslabDims(dims, 3);
+    } // for
+} // _applyIOProfile
+
+
 // End of file
@@ -3,13 +3,14 @@
 #pragma once
 
 #include "serialfwd.hh" // forward declarations
-#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA CRSTransformer
+#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA CRSTransformer, CRSInterpolator
 
 #include <memory> // HASA std::std::shared_ptr
 #include <vector> // HASA std::std::vector
 #include <string> // HASA std::string
 
 class geomodelgrids::serial::Model {
+    friend class ModelContext; // Per-thread query state
     friend class TestModel; // Unit testing
 
     // PUBLIC ENUMS -------------------------------------------------------------------------------
@@ -26,6 +27,20 @@ public:
         CELL=1,
     }; // DataLayout
 
+    // PUBLIC STRUCTS -----------------------------------------------------------------------------
+public:
+
+    /// Location of a point in the model, resolved once and reused for containment, squashing, and
+    /// interpolation.
+    struct Location {
+        double xModel; ///< Model x coordinate of point.
+        double yModel; ///< Model y coordinate of point.
+        double zModel; ///< Model z coordinate of point.
+        double zTopCRS; ///< Elevation of top surface at point (model CRS).
+        size_t iBlock; ///< Index of block containing point (number of blocks if none).
+        bool inModel; ///< True if model contains point, false otherwise.
+    }; // Location
+
     // PUBLIC METHODS -----------------------------------------------------------------------------
 public:
 
@@ -41,6 +56,65 @@ public:
      */
     void setInputCRS(const std::string& value);
 
+    /** Set maximum size of tile cache for each block and surface.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles per dataset (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get tile cache statistics summed over blocks and surfaces.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from the HDF5 file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    /** Set memory budget for holding surfaces and blocks entirely in memory.
+     *
+     * Must be called before initialize(). Surfaces and then blocks (from the top down) that fit in the
+     * remaining budget are loaded into memory by initialize(); the others are queried using the
+     * hyperslab tile cache.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident surfaces and blocks (0 to disable).
+     */
+    void setResidentBudget(const size_t numBytes);
+
+    /** Get size of surfaces and blocks resident in memory.
+     *
+     * @returns Size (in bytes) of resident surfaces and blocks.
+     */
+    size_t getResidentSize(void) const;
+
+    /** Set whether surface and block values are stored in single precision (float).
+     *
+     * Must be called before initialize(). Single precision halves the memory used by the tile cache and
+     * resident values; interpolation still accumulates in double precision.
+     *
+     * @param[in] value True to store values in single precision, false for double precision.
+     */
+    void setSinglePrecision(const bool value);
+
+    /** Set tolerance for approximating the CRS transformation of query points.
+     *
+     * Must be called before initialize(). If the tolerance is positive and the transformation from
+     * the input CRS to the model CRS is not affine, initialize() builds a grid over the footprint of
+     * the model that interpolates the transformation to within the tolerance. Points outside the grid
+     * use the exact transformation.
+     *
+     * @param[in] value Maximum error (model CRS units) of approximate transformation (0 for exact).
+     */
+    void setTransformTolerance(const double value);
+
+    /** Set parameters for reading data from the model file.
+     *
+     * Sets the chunk cache of each dataset, hyperslab dimensions of surfaces and blocks, and size of
+     * the tile cache. Applies to query contexts created later.
+     *
+     * @param[in] profile Read-tuning parameters.
+     */
+    void setIOProfile(const geomodelgrids::serial::IOProfile& profile);
+
     /** Open Model.
      *
      * @param[in] filename Name of Model file
@@ -143,6 +217,19 @@ public:
                   const double y,
                   const double z) const;
 
+    /** Does model contain given point? (thread-safe with one context per thread)
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns True if model contains given point, false otherwise.
+     */
+    bool contains(const double x,
+                  const double y,
+                  const double z,
+                  geomodelgrids::serial::ModelContext* const context) const;
+
     /** Does model contain given latlon?
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -152,6 +239,35 @@ public:
     bool containsIn(const double x,
                     const double y) const;
 
+    /** Does model contain given latlon?
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns True if model contains given latlon, false otherwise.
+     */
+    bool containsIn(const double x,
+                    const double y,
+                    geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Get footprint of model in input CRS.
+     *
+     * The footprint is a polygon with vertices sampled along the boundary of the horizontal extent
+     * of the model. The footprint is empty if the boundary cannot be transformed to the input CRS
+     * without discontinuities (for example, across the antimeridian) or if the vertices do not resolve
+     * the curvature of the boundary in the input CRS.
+     *
+     * The margin covers the deviation of the boundary from the edges of the polygon, which is measured
+     * at the midpoint of the boundary between each pair of vertices.
+     *
+     * @param[out] xy Array of vertex coordinates (in input CRS) [numVertices*2].
+     * @param[out] margin Distance (in input CRS) to pad the polygon so it contains the model (may be null).
+     * @param[in] numEdgePoints Number of vertices along each side of the model.
+     */
+    void getFootprint(std::vector<double>* xy,
+                      double* margin,
+                      const size_t numEdgePoints=32) const;
+
     /** Query for elevation of top of model at point using bilinear interpolation.
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -161,6 +277,17 @@ public:
     double queryTopElevation(const double x,
                              const double y);
 
+    /** Query for elevation of top of model at point using bilinear interpolation.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of top of model at point.
+     */
+    double queryTopElevation(const double x,
+                             const double y,
+                             geomodelgrids::serial::ModelContext* const context) const;
+
     /** Query for elevation of topography/bathymetry at point using bilinear interpolation.
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -170,6 +297,17 @@ public:
     double queryTopoBathyElevation(const double x,
                                    const double y);
 
+    /** Query for elevation of topography/bathymetry at point using bilinear interpolation.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of solid surface at point.
+     */
+    double queryTopoBathyElevation(const double x,
+                                   const double y,
+                                   geomodelgrids::serial::ModelContext* const context) const;
+
     /** Query for model values at point using bilinear interpolation.
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -181,6 +319,148 @@ public:
                         const double y,
                         const double z);
 
+    /** Query for model values at point using bilinear interpolation.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns Array of model values at point (owned by context).
+     */
+    const double* query(const double x,
+                        const double y,
+                        const double z,
+                        geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Resolve location of point in the model.
+     *
+     * The CRS transformation, top surface lookup, and block search are done once; use the location
+     * with contains(), queryTopElevation(), queryTopoBathyElevation(), and query().
+     *
+     * @param[out] location Location of point in the model.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     */
+    void locate(Location* location,
+                const double x,
+                const double y,
+                const double z,
+                geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Update location of point for a new elevation at the same horizontal position.
+     *
+     * The horizontal coordinates must match those used to resolve the location. The top surface
+     * lookup is reused when the horizontal position in the model is unchanged. When the horizontal
+     * transformation from the input CRS does not depend on elevation, only the elevation is
+     * transformed.
+     *
+     * @param[inout] location Location of point in the model.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z New z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     */
+    void relocate(Location* location,
+                  const double x,
+                  const double y,
+                  const double z,
+                  geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Query for elevation of top of model at resolved location.
+     *
+     * @param[in] location Location of point in the model.
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of top of model at point (in input CRS).
+     */
+    double queryTopElevation(const Location& location,
+                             geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Query for elevation of topography/bathymetry at resolved location.
+     *
+     * @param[in] location Location of point in the model.
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of solid surface at point (in input CRS).
+     */
+    double queryTopoBathyElevation(const Location& location,
+                                   geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Query for model values at resolved location using trilinear interpolation.
+     *
+     * @param[in] location Location of point in the model (must be in model).
+     * @param[inout] context Query context.
+     * @returns Array of model values at point (owned by context).
+     */
+    const double* query(const Location& location,
+                        geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Convert array of points in input CRS to model coordinates.
+     *
+     * Points are stored in row-major order with coordinates (x, y, z) for each point. The CRS
+     * transformation is done for all points in a single call.
+     *
+     * @param[out] xyzModel Array of points in model coordinate system [numPoints*3].
+     * @param[in] xyz Array of points in input CRS [numPoints*3].
+     * @param[in] numPoints Number of points.
+     */
+    void toModelXYZ(double* const xyzModel,
+                    const double* const xyz,
+                    const size_t numPoints) const;
+
+    /** Convert array of points in input CRS to model coordinates.
+     *
+     * @param[out] xyzModel Array of points in model coordinate system [numPoints*3].
+     * @param[in] xyz Array of points in input CRS [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @param[inout] context Query context.
+     */
+    void toModelXYZ(double* const xyzModel,
+                    const double* const xyz,
+                    const size_t numPoints,
+                    geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Does model contain given point in model coordinate system?
+     *
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     * @param[in] zModel Model z coordinate of point.
+     * @returns True if model contains given point, false otherwise.
+     */
+    bool containsModelXYZ(const double xModel,
+                          const double yModel,
+                          const double zModel) const;
+
+    /** Query for model values at point in model coordinate system using bilinear interpolation.
+     *
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     * @param[in] zModel Model z coordinate of point.
+     * @returns Array of model values at point.
+     */
+    const double* queryModelXYZ(const double xModel,
+                                const double yModel,
+                                const double zModel);
+
+    /** Query for model values at point in model coordinate system using bilinear interpolation.
+     *
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     * @param[in] zModel Model z coordinate of point.
+     * @param[inout] context Query context.
+     * @returns Array of model values at point (owned by context).
+     */
+    const double* queryModelXYZ(const double xModel,
+                                const double yModel,
+                                const double zModel,
+                                geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Get default query context used by methods without a context argument.
+     *
+     * @returns Default query context (nullptr if model is not initialized).
+     */
+    geomodelgrids::serial::ModelContext* getContext(void) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -200,6 +480,82 @@ private:
                      const double y,
                      const double z) const;
 
+    /** Convert xyz in input CRS to xyz in model CRS.
+     *
+     * @param[out] xModel Model x coordinate of point.
+     * @param[out] yModel Model y coordinate of point.
+     * @param[out] zModel Model z coordinate of point.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     */
+    void _toModelXYZ(double* xModel,
+                     double* yModel,
+                     double* zModel,
+                     const double x,
+                     const double y,
+                     const double z,
+                     geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Convert xyz in input CRS to model xy and elevation in model CRS.
+     *
+     * Uses the precomputed affine transformation if the input CRS to model CRS transformation is
+     * affine; otherwise uses the CRS transformer of the query context.
+     *
+     * @param[out] xModel Model x coordinate of point.
+     * @param[out] yModel Model y coordinate of point.
+     * @param[out] zModelCRS Elevation of point in model CRS.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     */
+    void _toModelXY(double* xModel,
+                    double* yModel,
+                    double* zModelCRS,
+                    const double x,
+                    const double y,
+                    const double z,
+                    geomodelgrids::serial::ModelContext* const context) const;
+
+    /// Compile input CRS to model coordinate transformation into an affine transformation if possible.
+    void _initAffine(void);
+
+    /// Build grid interpolating input CRS to model CRS transformation over footprint of model.
+    void _initInterpolator(void);
+
+    /** Compute model z coordinate, block, and containment for location from elevation in model CRS.
+     *
+     * @param[inout] location Location of point in the model (horizontal position and top surface set).
+     * @param[in] zModelCRS Elevation of point in model CRS.
+     */
+    void _locateZ(Location* location,
+                  const double zModelCRS) const;
+
+    /** Transform elevation of surface at location from model CRS to input CRS.
+     *
+     * @param[in] location Location of point in the model.
+     * @param[in] zModelCRS Elevation of surface in model CRS.
+     * @param[inout] context Query context.
+     * @returns Elevation of surface in input CRS.
+     */
+    double _toInputElevation(const Location& location,
+                             const double zModelCRS,
+                             geomodelgrids::serial::ModelContext* const context) const;
+
+    /** Convert xy in model coordinates to xy in model CRS.
+     *
+     * @param[out] xModelCRS X coordinate of point in model CRS.
+     * @param[out] yModelCRS Y coordinate of point in model CRS.
+     * @param[in] xModel Model x coordinate of point.
+     * @param[in] yModel Model y coordinate of point.
+     */
+    void _toModelCRS(double* xModelCRS,
+                     double* yModelCRS,
+                     const double xModel,
+                     const double yModel) const;
+
     /** Find block containing point.
      *
      * @param[in] x Model x coordinate of point.
@@ -211,6 +567,15 @@ private:
                                                              const double y,
                                                              const double z) const;
 
+    /** Find index of block containing point.
+     *
+     * Blocks span the entire horizontal extent of the model, so only the z coordinate is needed.
+     *
+     * @param[in] z Model z coordinate of point.
+     * @returns Index of block containing point (number of blocks if no block contains point).
+     */
+    size_t _findBlockIndex(const double z) const;
+
     /** Transform array of Units strings to booleans ("none" = 0, others = 1)
      *
      * @param[in] strings Array of strings.
@@ -218,6 +583,12 @@ private:
      */
     std::vector<std::size_t> _toUnitsBoolean(const std::vector<std::string>& strings) const;
 
+    /// Load surfaces and blocks that fit in the resident memory budget.
+    void _loadResident(void);
+
+    /// Apply chunk cache and hyperslab dimensions of I/O profile to model file, surfaces, and blocks.
+    void _applyIOProfile(void);
+
 
     // PRIVATE METHODS ----------------------------------------------------------------------------
 private:
@@ -230,14 +601,27 @@ private:
     std::string _inputCRSString; ///< CRS as string (PROJ, EPSG, WKT for input points).
     double _origin[2]; ///< x and y coordinates of model origin.
     double _yazimuth; ///< Azimuth of y coordinate axis.
+    double _cosYAzimuth; ///< Cosine of azimuth of y coordinate axis.
+    double _sinYAzimuth; ///< Sine of azimuth of y coordinate axis.
+    double _affineXY[6]; ///< Affine transformation from input CRS xy to model xy.
+    double _affineZ[2]; ///< Affine transformation from input CRS z to model CRS z.
+    bool _isAffine; ///< True if input CRS to model coordinate transformation is affine.
+    bool _isAffineZ; ///< True if horizontal transformation is independent of z and z transformation is affine.
     double _dims[3]; ///< Dimensions of model along coordinate axes.
+    size_t _cacheSize; ///< Maximum size (in bytes) of tile cache per dataset (0 for default).
+    size_t _residentBudget; ///< Maximum size (in bytes) of resident surfaces and blocks (0 to disable).
+    bool _singlePrecision; ///< True if surface and block values are stored in single precision.
+    double _transformTolerance; ///< Maximum error of approximate CRS transformation (0 for exact).
 
+    std::unique_ptr<geomodelgrids::serial::IOProfile> _ioProfile; ///< Parameters for reading data from model file.
     std::unique_ptr<geomodelgrids::serial::HDF5> _h5; ///< Model file.
     std::shared_ptr<geomodelgrids::serial::ModelInfo> _info; ///< Model description information.
     std::shared_ptr<geomodelgrids::serial::Surface> _surfaceTop; ///< Top surface of model.
     std::shared_ptr<geomodelgrids::serial::Surface> _surfaceTopoBathy; ///< Model topography/bathymetry.
     std::shared_ptr<geomodelgrids::utils::CRSTransformer> _crsTransformer; ///< Coordinate system transformer.
+    std::unique_ptr<geomodelgrids::utils::CRSInterpolator> _crsInterpolator; ///< Approximate CRS transformation.
     std::vector<std::shared_ptr<geomodelgrids::serial::Block> > _blocks; ///< Model blocks.
+    std::unique_ptr<geomodelgrids::serial::ModelContext> _context; ///< Default query context.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
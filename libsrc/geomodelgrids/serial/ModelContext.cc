@@ -0,0 +1,95 @@
+#include <portinfo>
+
+#include "ModelContext.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
+#include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
+
+#include <stdexcept> // USES std::logic_error
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::ModelContext::ModelContext(const geomodelgrids::serial::Model& model) {
+    if (!model._crsTransformer || !model._h5) {
+        throw std::logic_error("Model not initialized. Call initialize() before creating a query context.");
+    } // if
+    geomodelgrids::serial::HDF5* const h5 = model._h5.get();
+
+    _crsTransformer.reset(model._crsTransformer->clone());
+    if (model._surfaceTop) {
+        _surfaceTop.reset(model._surfaceTop->createHyperslab(h5));
+    } // if
+    if (model._surfaceTopoBathy) {
+        _surfaceTopoBathy.reset(model._surfaceTopoBathy->createHyperslab(h5));
+    } // if
+    const size_t numBlocks = model._blocks.size();
+    _blocks.resize(numBlocks);
+    for (size_t i = 0; i < numBlocks; ++i) {
+        assert(model._blocks[i]);
+        _blocks[i].reset(model._blocks[i]->createHyperslab(h5));
+    } // for
+    _values.resize(model._valueNames.size());
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::ModelContext::~ModelContext(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of tile cache for each block and surface.
+void
+geomodelgrids::serial::ModelContext::setCacheSize(const size_t numBytes) {
+    if (!numBytes) { return; }
+
+    if (_surfaceTop) {
+        _surfaceTop->setCacheSize(numBytes);
+    } // if
+    if (_surfaceTopoBathy) {
+        _surfaceTopoBathy->setCacheSize(numBytes);
+    } // if
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        assert(_blocks[i]);
+        _blocks[i]->setCacheSize(numBytes);
+    } // for
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get tile cache statistics summed over blocks and surfaces.
+void
+geomodelgrids::serial::ModelContext::getCacheStats(size_t* numHits,
+                                                   size_t* numMisses) const {
+    size_t hitsTotal = 0;
+    size_t missesTotal = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    if (_surfaceTop) {
+        _surfaceTop->getCacheStats(&hits, &misses);
+        hitsTotal += hits;
+        missesTotal += misses;
+    } // if
+    if (_surfaceTopoBathy) {
+        _surfaceTopoBathy->getCacheStats(&hits, &misses);
+        hitsTotal += hits;
+        missesTotal += misses;
+    } // if
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        assert(_blocks[i]);
+        _blocks[i]->getCacheStats(&hits, &misses);
+        hitsTotal += hits;
+        missesTotal += misses;
+    } // for
+
+    if (numHits) { *numHits = hitsTotal; }
+    if (numMisses) { *numMisses = missesTotal; }
+} // getCacheStats
+
+
+// End of file
@@ -0,0 +1,63 @@
+/** Per-thread state for querying a model.
+ *
+ * The model holds metadata that does not change during queries (dimensions, indexing, CRS strings),
+ * and the context holds the state that does (CRS transformer, hyperslab tile caches, and values at a
+ * point). Multiple threads can query a single model concurrently, each with its own context.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA CRSTransformer
+
+#include <cstdlib> // USES size_t
+#include <memory> // HASA std::unique_ptr
+#include <vector> // HASA std::vector
+
+class geomodelgrids::serial::ModelContext {
+    friend class Model; // Access to context state
+    friend class TestModel; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor.
+     *
+     * @param[in] model Initialized model.
+     */
+    ModelContext(const geomodelgrids::serial::Model& model);
+
+    /// Destructor
+    ~ModelContext(void);
+
+    /** Set maximum size of tile cache for each block and surface.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles per dataset (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get tile cache statistics summed over blocks and surfaces.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from the HDF5 file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::unique_ptr<geomodelgrids::utils::CRSTransformer> _crsTransformer; ///< Coordinate system transformer.
+    std::unique_ptr<geomodelgrids::serial::Hyperslab> _surfaceTop; ///< Hyperslab for top surface.
+    std::unique_ptr<geomodelgrids::serial::Hyperslab> _surfaceTopoBathy; ///< Hyperslab for topography/bathymetry.
+    std::vector<std::unique_ptr<geomodelgrids::serial::Hyperslab> > _blocks; ///< Hyperslabs for model blocks.
+    std::vector<double> _values; ///< Model values at point.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    ModelContext(const ModelContext&); ///< Not implemented
+    const ModelContext& operator=(const ModelContext&); ///< Not implemented
+
+}; // ModelContext
+
+// End of file
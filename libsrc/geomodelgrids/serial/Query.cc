@@ -3,16 +3,26 @@
 #include "Query.hh" // implementation of class methods
 
 #include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Block.hh" // USES Block
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/ModelContext.hh" // USES ModelContext
+#include "geomodelgrids/serial/QueryContext.hh" // USES QueryContext
+#include "geomodelgrids/serial/FootprintIndex.hh" // USES FootprintIndex
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5::getMutex()
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
+#include <hdf5.h> // USES H5Fcreate(), H5Dwrite()
+
 #include <getopt.h> // USES getopt_long()
-#include <algorithm> // USES std::transform
+#include <algorithm> // USES std::transform, std::sort
 #include <cctype> // USES std::lower
 #include <cassert> // USES assert()
+#include <cmath> // USES std::isfinite()
+#include <cstdint> // USES uint64_t
+#include <mutex> // USES std::lock_guard
 #include <sstream> // USES std::ostringstream, std::istringstream
 
 // ------------------------------------------------------------------------------------------------
@@ -58,19 +68,62 @@ public:
     static
     unsigned char tolower(unsigned char c);
 
+    /** Sort points along Morton (Z-order) space-filling curve.
+     *
+     * Coordinates are quantized to 21 bits over the bounding box of the points.
+     *
+     * @param[out] order Array of Morton key and index of point, sorted by key.
+     * @param[in] xyz Array of point coordinates [numPoints*3].
+     * @param[in] numPoints Number of points.
+     */
+    static
+    void sortMorton(std::vector<std::pair<uint64_t, size_t> >* order,
+                    const double* xyz,
+                    const size_t numPoints);
+
+    /** Spread lower 21 bits of integer so there are two zero bits between each bit.
+     *
+     * @param[in] value Integer value.
+     * @returns Integer with bits spread.
+     */
+    static
+    uint64_t spreadBits(uint64_t value);
+
+    /** Compute chunk dimensions for dataset written by Query::queryGridHDF5().
+     *
+     * Chunks span one slab of constant x, which is written in a single call, and are limited to
+     * maxChunkBytes by splitting the slab along y (and then z).
+     *
+     * @param[out] chunk Chunk dimensions [4].
+     * @param[in] dims Dataset dimensions (all positive) [4].
+     */
+    static
+    void computeGridChunk(hsize_t chunk[4],
+                          const hsize_t dims[4]);
+
+    static const size_t maxChunkBytes; ///< Maximum size of chunks (matches default HDF5 chunk cache).
+
 }; // _Query
+const size_t geomodelgrids::serial::_Query::maxChunkBytes = 1024*1024;
 
 // ------------------------------------------------------------------------------------------------
 // Constructor
 geomodelgrids::serial::Query::Query() :
     _squashMinElev(0.0),
     _errorHandler(std::make_shared<geomodelgrids::utils::ErrorHandler>()),
-    _squash(SQUASH_NONE) {}
+    _squash(SQUASH_NONE),
+    _ioProfile(std::make_unique<geomodelgrids::serial::IOProfile>()),
+    _residentBudget(0),
+    _singlePrecision(false),
+    _transformTolerance(0.0),
+    _spatialOrdering(false),
+    _footprintIndex(std::make_unique<geomodelgrids::serial::FootprintIndex>()) {}
 
 
 // ------------------------------------------------------------------------------------------------
 // Destructor
 geomodelgrids::serial::Query::~Query(void) {
+    _context.reset();
     for (size_t i = 0; i < _models.size(); ++i) {
         _models[i].reset();
     } // for
@@ -93,6 +146,7 @@ geomodelgrids::serial::Query::initialize(const std::vector<std::string>& modelFi
                                          const std::string& inputCRSString) {
     _valuesLowercase = _Query::toLower(valueNames);
 
+    _context.reset();
     for (size_t i = 0; i < _models.size(); ++i) {
         _models[i].reset();
     } // for
@@ -101,12 +155,18 @@ geomodelgrids::serial::Query::initialize(const std::vector<std::string>& modelFi
     _models.resize(numModels);
     _valuesIndex.resize(numModels);
     std::map<size_t, std::string> valueUnits;
+    size_t residentFree = _residentBudget;
     for (size_t iModel = 0; iModel < numModels; ++iModel) {
         _models[iModel] = std::make_unique<geomodelgrids::serial::Model>();assert(_models[iModel]);
         _models[iModel]->setInputCRS(inputCRSString);
         _models[iModel]->open(modelFilenames[iModel].c_str(), geomodelgrids::serial::Model::READ);
         _models[iModel]->loadMetadata();
+        _models[iModel]->setIOProfile(*_ioProfile);
+        _models[iModel]->setResidentBudget(residentFree);
+        _models[iModel]->setSinglePrecision(_singlePrecision);
+        _models[iModel]->setTransformTolerance(_transformTolerance);
         _models[iModel]->initialize();
+        residentFree -= _models[iModel]->getResidentSize();
 
         _valuesIndex[iModel] = _Query::createModelValuesIndex(*_models[iModel], _valuesLowercase);
 
@@ -114,6 +174,17 @@ geomodelgrids::serial::Query::initialize(const std::vector<std::string>& modelFi
         const std::vector<std::string>& modelUnitsLower = _Query::toLower(_models[iModel]->getValueUnits());
         _Query::checkUnits(&valueUnits, _valuesIndex[iModel], modelValues, modelUnitsLower);
     } // for
+
+    // Points test only models whose footprint in the input CRS may contain them.
+    std::vector<std::vector<double> > footprints(numModels);
+    std::vector<double> margins(numModels);
+    for (size_t iModel = 0; iModel < numModels; ++iModel) {
+        _models[iModel]->getFootprint(&footprints[iModel], &margins[iModel]);
+    } // for
+    assert(_footprintIndex);
+    _footprintIndex->initialize(footprints, margins);
+
+    _context.reset(new geomodelgrids::serial::QueryContext(*this, _errorHandler));
 } // initialize
 
 
@@ -136,6 +207,99 @@ geomodelgrids::serial::Query::setSquashing(const SquashingEnum value) {
 } // setSquashing
 
 
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of tile cache.
+void
+geomodelgrids::serial::Query::setCacheSize(const size_t numBytes) {
+    assert(_ioProfile);
+    _ioProfile->setTileCacheSize(numBytes);
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        _models[i]->setCacheSize(numBytes);
+    } // for
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Set parameters for reading data from model files.
+void
+geomodelgrids::serial::Query::setIOProfile(const geomodelgrids::serial::IOProfile& profile) {
+    assert(_ioProfile);
+    *_ioProfile = profile;
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        _models[i]->setIOProfile(*_ioProfile);
+    } // for
+} // setIOProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Set memory budget for resident surfaces and blocks.
+void
+geomodelgrids::serial::Query::setResidentBudget(const size_t numBytes) {
+    _residentBudget = numBytes;
+} // setResidentBudget
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether batched queries visit points in spatial order.
+void
+geomodelgrids::serial::Query::setSpatialOrdering(const bool value) {
+    _spatialOrdering = value;
+} // setSpatialOrdering
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether model values are stored in single precision.
+void
+geomodelgrids::serial::Query::setSinglePrecision(const bool value) {
+    _singlePrecision = value;
+} // setSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Set tolerance for approximating the CRS transformation of query points.
+void
+geomodelgrids::serial::Query::setTransformTolerance(const double value) {
+    _transformTolerance = value;
+} // setTransformTolerance
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of model surfaces and blocks resident in memory.
+size_t
+geomodelgrids::serial::Query::getResidentSize(void) const {
+    size_t numBytes = 0;
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        numBytes += _models[i]->getResidentSize();
+    } // for
+
+    return numBytes;
+} // getResidentSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get tile cache statistics summed over all models.
+void
+geomodelgrids::serial::Query::getCacheStats(size_t* numHits,
+                                            size_t* numMisses) const {
+    size_t hitsTotal = 0;
+    size_t missesTotal = 0;
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        size_t hits = 0;
+        size_t misses = 0;
+        _models[i]->getCacheStats(&hits, &misses);
+        hitsTotal += hits;
+        missesTotal += misses;
+    } // for
+
+    if (numHits) { *numHits = hitsTotal; }
+    if (numMisses) { *numMisses = missesTotal; }
+} // getCacheStats
+
+
 // ------------------------------------------------------------------------------------------------
 // Get names of values in model.
 const std::vector<std::string>&
@@ -144,17 +308,42 @@ geomodelgrids::serial::Query::getValueNames(void) const {
 } // getValueNames
 
 
+// ------------------------------------------------------------------------------------------------
+// Get default query context.
+geomodelgrids::serial::QueryContext*
+geomodelgrids::serial::Query::getContext(void) const {
+    return _context.get();
+} // getContext
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for elevation of top of model at point.
 double
 geomodelgrids::serial::Query::queryTopElevation(const double x,
                                                 const double y) {
+    return queryTopElevation(x, y, _context.get());
+} // queryTopElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at point.
+double
+geomodelgrids::serial::Query::queryTopElevation(const double x,
+                                                const double y,
+                                                geomodelgrids::serial::QueryContext* const context) const {
     double elevation = NODATA_VALUE;
     const double zOffset = -1.0e-3;
+    const size_t iCell = _footprintIndex->findCell(x, y);
     for (size_t i = 0; i < _models.size(); ++i) {
         assert(_models[i]);
-        const double elevationTmp = _models[i]->queryTopElevation(x, y);
-        if (_models[i]->contains(x, y, elevationTmp+zOffset)) {
+        assert(context);
+        if (!_footprintIndex->isCandidate(iCell, i)) { continue; }
+        geomodelgrids::serial::ModelContext* modelContext = context->_modelContexts[i];
+        geomodelgrids::serial::Model::Location location;
+        _models[i]->locate(&location, x, y, 0.0, modelContext);
+        const double elevationTmp = _models[i]->queryTopElevation(location, modelContext);
+        _models[i]->relocate(&location, x, y, elevationTmp+zOffset, modelContext);
+        if (location.inModel) {
             elevation = elevationTmp;
             break;
         } // if
@@ -169,12 +358,29 @@ geomodelgrids::serial::Query::queryTopElevation(const double x,
 double
 geomodelgrids::serial::Query::queryTopoBathyElevation(const double x,
                                                       const double y) {
+    return queryTopoBathyElevation(x, y, _context.get());
+} // queryTopoBathyElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at point.
+double
+geomodelgrids::serial::Query::queryTopoBathyElevation(const double x,
+                                                      const double y,
+                                                      geomodelgrids::serial::QueryContext* const context) const {
     double elevation = NODATA_VALUE;
     const double zOffset = -1.0e-3;
+    const size_t iCell = _footprintIndex->findCell(x, y);
     for (size_t i = 0; i < _models.size(); ++i) {
         assert(_models[i]);
-        const double elevationTmp = _models[i]->queryTopoBathyElevation(x, y);
-        if (_models[i]->contains(x, y, elevationTmp+zOffset)) {
+        assert(context);
+        if (!_footprintIndex->isCandidate(iCell, i)) { continue; }
+        geomodelgrids::serial::ModelContext* modelContext = context->_modelContexts[i];
+        geomodelgrids::serial::Model::Location location;
+        _models[i]->locate(&location, x, y, 0.0, modelContext);
+        const double elevationTmp = _models[i]->queryTopoBathyElevation(location, modelContext);
+        _models[i]->relocate(&location, x, y, elevationTmp+zOffset, modelContext);
+        if (location.inModel) {
             elevation = elevationTmp;
             break;
         } // if
@@ -189,9 +395,22 @@ geomodelgrids::serial::Query::queryTopoBathyElevation(const double x,
 int
 geomodelgrids::serial::Query::queryModelContains(const double x,
                                                  const double y) {
+    return queryModelContains(x, y, _context.get());
+} // queryModelContains
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model index of containing model at given point.
+int
+geomodelgrids::serial::Query::queryModelContains(const double x,
+                                                 const double y,
+                                                 geomodelgrids::serial::QueryContext* const context) const {
+    const size_t iCell = _footprintIndex->findCell(x, y);
     for (size_t i = 0; i < _models.size(); ++i) {
         assert(_models[i]);
-        if (_models[i]->containsIn(x, y)) {
+        assert(context);
+        if (!_footprintIndex->isCandidate(iCell, i)) { continue; }
+        if (_models[i]->containsIn(x, y, context->_modelContexts[i])) {
           return i;
         } // if
     } // for
@@ -207,46 +426,75 @@ geomodelgrids::serial::Query::query(double* const values,
                                     const double x,
                                     const double y,
                                     const double z) {
-    if (!values) {
+    if (!_context) {
         assert(_errorHandler);
-        _errorHandler->setError("geomodelgrids::serial::Query::query() passed nullptr for values argument.");
+        _errorHandler->setError("geomodelgrids::serial::Query::query() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return query(values, x, y, z, _context.get());
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at point.
+int
+geomodelgrids::serial::Query::query(double* const values,
+                                    const double x,
+                                    const double y,
+                                    const double z,
+                                    geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    if (!values) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::query() passed nullptr for values argument.");
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
     if (!_valuesLowercase.size()) {
-        assert(_errorHandler);
-        _errorHandler->setError("geomodelgrids::serial::Query::query() not initialized.");
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::query() not initialized.");
         return geomodelgrids::utils::ErrorHandler::ERROR;
     } // if
 
     const size_t numQueryValues = _valuesLowercase.size();
     std::fill(values, values+numQueryValues, NODATA_VALUE);
     bool found = false;
+    const size_t iCell = _footprintIndex->findCell(x, y);
     for (size_t i = 0; i < _models.size(); ++i) {
         assert(_models[i]);
-        double zSquash = z;
+        if (!_footprintIndex->isCandidate(iCell, i)) { continue; }
+        geomodelgrids::serial::ModelContext* modelContext = context->_modelContexts[i];
+
+        // Resolve location once and reuse it for squashing, containment, and interpolation. Squashed
+        // points use the surface at zero elevation, consistent with queryTopElevation().
+        const bool isSquashed = (_squash != SQUASH_NONE) && (z > _squashMinElev);
+        geomodelgrids::serial::Model::Location location;
+        _models[i]->locate(&location, x, y, isSquashed ? 0.0 : z, modelContext);
         switch (_squash) {
         case SQUASH_NONE:
             break;
         case SQUASH_TOP_SURFACE:
             if (z > _squashMinElev) {
-                const double topElev = _models[i]->queryTopElevation(x, y);
-                zSquash = topElev + z * (_squashMinElev - topElev) / _squashMinElev;
+                const double topElev = _models[i]->queryTopElevation(location, modelContext);
+                const double zSquash = topElev + z * (_squashMinElev - topElev) / _squashMinElev;
+                _models[i]->relocate(&location, x, y, zSquash, modelContext);
             } // if
             break;
         case SQUASH_TOPOGRAPHY_BATHYMETRY:
             if (z > _squashMinElev) {
-                const double groundElev = _models[i]->queryTopoBathyElevation(x, y);
-                zSquash = groundElev + z * (_squashMinElev - groundElev) / _squashMinElev;
+                const double groundElev = _models[i]->queryTopoBathyElevation(location, modelContext);
+                const double zSquash = groundElev + z * (_squashMinElev - groundElev) / _squashMinElev;
+                _models[i]->relocate(&location, x, y, zSquash, modelContext);
             } // if
             break;
         default:
             throw std::logic_error("Unknown squashing type.");
         } // switch
-        if (_models[i]->contains(x, y, zSquash)) {
-            const double* modelValues = _models[i]->query(x, y, zSquash);
-            values_map_type& modelMap = _valuesIndex[i];
+        if (location.inModel) {
+            const double* modelValues = _models[i]->query(location, modelContext);
+            const values_map_type& modelMap = _valuesIndex[i];
             for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
-                values[iValue] = modelValues[modelMap[iValue]];
+                values[iValue] = modelValues[modelMap.at(iValue)];
             } // for
 
             found = true;
@@ -258,10 +506,606 @@ geomodelgrids::serial::Query::query(double* const values,
 } // query
 
 
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points.
+int
+geomodelgrids::serial::Query::queryMany(double* const values,
+                                        int* const status,
+                                        const double* const points,
+                                        const size_t numPoints) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryMany() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryMany(values, status, points, numPoints, _context.get());
+} // queryMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points.
+int
+geomodelgrids::serial::Query::queryMany(double* const values,
+                                        int* const status,
+                                        const double* const points,
+                                        const size_t numPoints,
+                                        geomodelgrids::serial::QueryContext* const context) const {
+    return _queryMany(values, status, points, numPoints, context);
+} // queryMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at points along vertical profile.
+int
+geomodelgrids::serial::Query::queryProfile(double* const values,
+                                           int* const status,
+                                           const double x,
+                                           const double y,
+                                           const double* const z,
+                                           const size_t numPoints) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryProfile() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryProfile(values, status, x, y, z, numPoints, _context.get());
+} // queryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at points along vertical profile.
+int
+geomodelgrids::serial::Query::queryProfile(double* const values,
+                                           int* const status,
+                                           const double x,
+                                           const double y,
+                                           const double* const z,
+                                           const size_t numPoints,
+                                           geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    if (!numPoints) {
+        return geomodelgrids::utils::ErrorHandler::OK;
+    } // if
+    if (!values || !z) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryProfile() passed nullptr for values or z argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryProfile() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = _valuesLowercase.size();
+    std::fill(values, values+numPoints*numQueryValues, NODATA_VALUE);
+    if (status) {
+        std::fill(status, status+numPoints, int(geomodelgrids::utils::ErrorHandler::WARNING));
+    } // if
+
+    // Indices of points not yet found in a model.
+    std::vector<size_t>& pending = context->_pending;
+    pending.resize(numPoints);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        pending[iPoint] = iPoint;
+    } // for
+
+    std::vector<size_t>& modelMap = context->_modelMap;
+    modelMap.resize(numQueryValues);
+    const size_t iCell = _footprintIndex->findCell(x, y);
+    for (size_t i = 0; i < _models.size() && pending.size() > 0; ++i) {
+        assert(_models[i]);
+        if (!_footprintIndex->isCandidate(iCell, i)) { continue; }
+        const geomodelgrids::serial::Model& model = *_models[i];
+        geomodelgrids::serial::ModelContext* modelContext = context->_modelContexts[i];
+
+        // Resolve horizontal location, top surface, and squashing surface once for the profile.
+        // Squashing uses the surface at zero elevation, consistent with query().
+        geomodelgrids::serial::Model::Location location;
+        model.locate(&location, x, y, 0.0, modelContext);
+        double surfaceElev = 0.0;
+        switch (_squash) {
+        case SQUASH_NONE:
+            break;
+        case SQUASH_TOP_SURFACE:
+            surfaceElev = model.queryTopElevation(location, modelContext);
+            break;
+        case SQUASH_TOPOGRAPHY_BATHYMETRY:
+            surfaceElev = model.queryTopoBathyElevation(location, modelContext);
+            break;
+        default:
+            throw std::logic_error("Unknown squashing type.");
+        } // switch
+
+        const values_map_type& valuesIndex = _valuesIndex[i];
+        for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+            modelMap[iValue] = valuesIndex.at(iValue);
+        } // for
+
+        std::vector<size_t>& remaining = context->_remaining;
+        remaining.clear();
+        for (size_t iPending = 0; iPending < pending.size(); ++iPending) {
+            const size_t iPoint = pending[iPending];
+            double zPoint = z[iPoint];
+            if ((_squash != SQUASH_NONE) && (zPoint > _squashMinElev)) {
+                zPoint = surfaceElev + zPoint * (_squashMinElev - surfaceElev) / _squashMinElev;
+            } // if
+            model.relocate(&location, x, y, zPoint, modelContext);
+            if (location.inModel) {
+                const double* modelValues = model.query(location, modelContext);
+                double* pointValues = &values[iPoint*numQueryValues];
+                for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                    pointValues[iValue] = modelValues[modelMap[iValue]];
+                } // for
+                if (status) {
+                    status[iPoint] = geomodelgrids::utils::ErrorHandler::OK;
+                } // if
+            } else {
+                remaining.push_back(iPoint);
+            } // if/else
+        } // for
+        pending.swap(remaining);
+    } // for
+
+    return pending.empty() ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // queryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at depths along vertical profile.
+int
+geomodelgrids::serial::Query::queryProfileDepth(double* const values,
+                                                int* const status,
+                                                const double x,
+                                                const double y,
+                                                const double* const depth,
+                                                const size_t numPoints,
+                                                const SquashingEnum depthSurface) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryProfileDepth() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryProfileDepth(values, status, x, y, depth, numPoints, depthSurface, _context.get());
+} // queryProfileDepth
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at depths along vertical profile.
+int
+geomodelgrids::serial::Query::queryProfileDepth(double* const values,
+                                                int* const status,
+                                                const double x,
+                                                const double y,
+                                                const double* const depth,
+                                                const size_t numPoints,
+                                                const SquashingEnum depthSurface,
+                                                geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    if (!numPoints) {
+        return geomodelgrids::utils::ErrorHandler::OK;
+    } // if
+    if (!values || !depth) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryProfileDepth() passed nullptr for values or depth argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryProfileDepth() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    double surfaceElev = 0.0;
+    switch (depthSurface) {
+    case SQUASH_NONE:
+        break;
+    case SQUASH_TOP_SURFACE:
+        surfaceElev = queryTopElevation(x, y, context);
+        break;
+    case SQUASH_TOPOGRAPHY_BATHYMETRY:
+        surfaceElev = queryTopoBathyElevation(x, y, context);
+        break;
+    default:
+        throw std::logic_error("Unknown depth surface type.");
+    } // switch
+    if (surfaceElev == NODATA_VALUE) {
+        std::fill(values, values+numPoints*_valuesLowercase.size(), NODATA_VALUE);
+        if (status) {
+            std::fill(status, status+numPoints, int(geomodelgrids::utils::ErrorHandler::WARNING));
+        } // if
+        return geomodelgrids::utils::ErrorHandler::WARNING;
+    } // if
+
+    std::vector<double>& zProfile = context->_profileZ;
+    zProfile.resize(numPoints);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        zProfile[iPoint] = surfaceElev - depth[iPoint];
+    } // for
+
+    return queryProfile(values, status, x, y, zProfile.data(), numPoints, context);
+} // queryProfileDepth
+
+
+// ------------------------------------------------------------------------------------------------
+// Query on regular grid.
+int
+geomodelgrids::serial::Query::queryGrid(double* const values,
+                                        int* const status,
+                                        const double origin[3],
+                                        const double spacing[3],
+                                        const size_t dims[3]) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryGrid() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryGrid(values, status, origin, spacing, dims, _context.get());
+} // queryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Query on regular grid.
+int
+geomodelgrids::serial::Query::queryGrid(double* const values,
+                                        int* const status,
+                                        const double origin[3],
+                                        const double spacing[3],
+                                        const size_t dims[3],
+                                        geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    if (!origin || !spacing || !dims) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryGrid() passed nullptr for origin, spacing, or dims argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    const size_t numX = dims[0];
+    const size_t numY = dims[1];
+    const size_t numZ = dims[2];
+    if (!numX || !numY || !numZ) {
+        return geomodelgrids::utils::ErrorHandler::OK;
+    } // if
+    if (!values) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryGrid() passed nullptr for values argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryGrid() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    // Every column has the same elevations.
+    std::vector<double>& zGrid = context->_gridZ;
+    zGrid.resize(numZ);
+    for (size_t iZ = 0; iZ < numZ; ++iZ) {
+        zGrid[iZ] = origin[2] + iZ * spacing[2];
+    } // for
+
+    // Query one vertical column at a time; the values for column (iX, iY) fill a contiguous block of
+    // numZ*numValues entries in the values array.
+    const size_t numQueryValues = _valuesLowercase.size();
+    int err = geomodelgrids::utils::ErrorHandler::OK;
+    for (size_t iX = 0, iColumn = 0; iX < numX; ++iX) {
+        const double x = origin[0] + iX * spacing[0];
+        for (size_t iY = 0; iY < numY; ++iY, ++iColumn) {
+            const double y = origin[1] + iY * spacing[1];
+            const int errColumn = queryProfile(&values[iColumn*numZ*numQueryValues],
+                                               (status) ? &status[iColumn*numZ] : nullptr,
+                                               x, y, zGrid.data(), numZ, context);
+            if (errColumn == geomodelgrids::utils::ErrorHandler::ERROR) {
+                return errColumn;
+            } // if
+            err = std::max(err, errColumn);
+        } // for
+    } // for
+
+    return err;
+} // queryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Query on regular grid and write values to HDF5 dataset.
+int
+geomodelgrids::serial::Query::queryGridHDF5(const char* filename,
+                                            const char* dataset,
+                                            const double origin[3],
+                                            const double spacing[3],
+                                            const size_t dims[3],
+                                            const int deflateLevel) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryGridHDF5() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryGridHDF5(filename, dataset, origin, spacing, dims, deflateLevel, _context.get());
+} // queryGridHDF5
+
+
+// ------------------------------------------------------------------------------------------------
+// Query on regular grid and write values to HDF5 dataset.
+int
+geomodelgrids::serial::Query::queryGridHDF5(const char* filename,
+                                            const char* dataset,
+                                            const double origin[3],
+                                            const double spacing[3],
+                                            const size_t dims[3],
+                                            const int deflateLevel,
+                                            geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    assert(context->_errorHandler);
+    if (!filename || !dataset || !origin || !spacing || !dims) {
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryGridHDF5() passed nullptr for filename, dataset, origin, spacing, or dims argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if ((deflateLevel < 0) || (deflateLevel > 9)) {
+        std::ostringstream msg;
+        msg << "geomodelgrids::serial::Query::queryGridHDF5() passed invalid deflate level (" << deflateLevel
+            << "). Deflate level must be in [0, 9].";
+        context->_errorHandler->setError(msg.str().c_str());
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryGridHDF5() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = _valuesLowercase.size();
+    const hsize_t dimsH5[4] = { dims[0], dims[1], dims[2], numQueryValues };
+    hid_t h5File = -1;
+    hid_t h5Dataset = -1;
+    { // Create dataset.
+        std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+        h5File = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        hid_t dataspace = H5Screate_simple(4, dimsH5, nullptr);
+        hid_t linkProperties = H5Pcreate(H5P_LINK_CREATE);
+        hid_t datasetProperties = H5Pcreate(H5P_DATASET_CREATE);
+        bool haveProperties = (datasetProperties >= 0);
+        if (haveProperties && dimsH5[0] && dimsH5[1] && dimsH5[2] && dimsH5[3]) {
+            // Each slab of constant x fills whole chunks, so chunks are written (and compressed) once.
+            hsize_t chunk[4];
+            _Query::computeGridChunk(chunk, dimsH5);
+            haveProperties = (H5Pset_chunk(datasetProperties, 4, chunk) >= 0) &&
+                             ((0 == deflateLevel) || (H5Pset_deflate(datasetProperties, unsigned(deflateLevel)) >= 0));
+        } // if
+        if ((h5File >= 0) && (dataspace >= 0) && (linkProperties >= 0) && haveProperties &&
+            (H5Pset_create_intermediate_group(linkProperties, 1) >= 0)) {
+            h5Dataset = H5Dcreate2(h5File, dataset, H5T_IEEE_F64LE, dataspace, linkProperties, datasetProperties,
+                                   H5P_DEFAULT);
+        } // if
+        if (datasetProperties >= 0) { H5Pclose(datasetProperties); }
+        if (linkProperties >= 0) { H5Pclose(linkProperties); }
+        if (dataspace >= 0) { H5Sclose(dataspace); }
+        if (h5Dataset < 0) {
+            if (h5File >= 0) { H5Fclose(h5File); }
+            std::ostringstream msg;
+            msg << "Could not create dataset '" << dataset << "' in HDF5 file '" << filename << "'.";
+            context->_errorHandler->setError(msg.str().c_str());
+            return geomodelgrids::utils::ErrorHandler::ERROR;
+        } // if
+    } // Create dataset.
+
+    // Query and write one slab of constant x at a time.
+    const size_t slabDims[3] = { 1, dims[1], dims[2] };
+    std::vector<double>& slabValues = context->_gridValues;
+    slabValues.resize(dims[1]*dims[2]*numQueryValues);
+    int err = geomodelgrids::utils::ErrorHandler::OK;
+    for (size_t iX = 0; iX < dims[0]; ++iX) {
+        const double slabOrigin[3] = { origin[0] + iX * spacing[0], origin[1], origin[2] };
+        const int errSlab = queryGrid(slabValues.data(), nullptr, slabOrigin, spacing, slabDims, context);
+        if (errSlab == geomodelgrids::utils::ErrorHandler::ERROR) {
+            err = errSlab;
+            break;
+        } // if
+        err = std::max(err, errSlab);
+
+        std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+        const hsize_t offset[4] = { iX, 0, 0, 0 };
+        const hsize_t count[4] = { 1, dimsH5[1], dimsH5[2], dimsH5[3] };
+        hid_t filespace = H5Dget_space(h5Dataset);
+        hid_t memspace = H5Screate_simple(4, count, nullptr);
+        herr_t errH5 = -1;
+        if ((filespace >= 0) && (memspace >= 0) &&
+            (H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, nullptr, count, nullptr) >= 0)) {
+            errH5 = H5Dwrite(h5Dataset, H5T_NATIVE_DOUBLE, memspace, filespace, H5P_DEFAULT, slabValues.data());
+        } // if
+        if (memspace >= 0) { H5Sclose(memspace); }
+        if (filespace >= 0) { H5Sclose(filespace); }
+        if (errH5 < 0) {
+            std::ostringstream msg;
+            msg << "Error writing values to dataset '" << dataset << "' in HDF5 file '" << filename << "'.";
+            context->_errorHandler->setError(msg.str().c_str());
+            err = geomodelgrids::utils::ErrorHandler::ERROR;
+            break;
+        } // if
+    } // for
+
+    std::lock_guard<std::mutex> lock(geomodelgrids::serial::HDF5::getMutex());
+    H5Dclose(h5Dataset);
+    if ((H5Fclose(h5File) < 0) && (err != geomodelgrids::utils::ErrorHandler::ERROR)) {
+        std::ostringstream msg;
+        msg << "Error closing HDF5 file '" << filename << "'.";
+        context->_errorHandler->setError(msg.str().c_str());
+        err = geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return err;
+} // queryGridHDF5
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points with values returned in single precision.
+int
+geomodelgrids::serial::Query::queryManyFloat(float* const values,
+                                             int* const status,
+                                             const double* const points,
+                                             const size_t numPoints) {
+    if (!_context) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryManyFloat() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return queryManyFloat(values, status, points, numPoints, _context.get());
+} // queryManyFloat
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points with values returned in single precision.
+int
+geomodelgrids::serial::Query::queryManyFloat(float* const values,
+                                             int* const status,
+                                             const double* const points,
+                                             const size_t numPoints,
+                                             geomodelgrids::serial::QueryContext* const context) const {
+    return _queryMany(values, status, points, numPoints, context);
+} // queryManyFloat
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points with values of type T.
+template<typename T>
+int
+geomodelgrids::serial::Query::_queryMany(T* const values,
+                                         int* const status,
+                                         const double* const points,
+                                         const size_t numPoints,
+                                         geomodelgrids::serial::QueryContext* const context) const {
+    assert(context);
+    if (!numPoints) {
+        return geomodelgrids::utils::ErrorHandler::OK;
+    } // if
+    if (!values || !points) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryMany() passed nullptr for values or points argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(context->_errorHandler);
+        context->_errorHandler->setError("geomodelgrids::serial::Query::queryMany() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = _valuesLowercase.size();
+    std::fill(values, values+numPoints*numQueryValues, T(NODATA_VALUE));
+    if (status) {
+        std::fill(status, status+numPoints, int(geomodelgrids::utils::ErrorHandler::WARNING));
+    } // if
+
+    // Indices of points not yet found in a model.
+    std::vector<size_t>& pending = context->_pending;
+    pending.resize(numPoints);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        pending[iPoint] = iPoint;
+    } // for
+
+    std::vector<double>& xyz = context->_xyz;
+    std::vector<double>& xyzModel = context->_xyzModel;
+    std::vector<size_t>& modelMap = context->_modelMap;
+    modelMap.resize(numQueryValues);
+    for (size_t i = 0; i < _models.size() && pending.size() > 0; ++i) {
+        assert(_models[i]);
+        const geomodelgrids::serial::Model& model = *_models[i];
+        geomodelgrids::serial::ModelContext* modelContext = context->_modelContexts[i];
+
+        // Points outside the footprint of the model skip the transformation.
+        std::vector<size_t>& remaining = context->_remaining;
+        remaining.clear();
+        size_t numCandidates = 0;
+        for (size_t iPending = 0; iPending < pending.size(); ++iPending) {
+            const size_t iPoint = pending[iPending];
+            if (_footprintIndex->isCandidate(i, points[3*iPoint+0], points[3*iPoint+1])) {
+                pending[numCandidates++] = iPoint;
+            } else {
+                remaining.push_back(iPoint);
+            } // if/else
+        } // for
+        pending.resize(numCandidates);
+        const size_t numPending = pending.size();
+        if (!numPending) {
+            pending.swap(remaining);
+            continue;
+        } // if
+
+        // Gather points not yet found (with squashing) for transformation as a batch.
+        xyz.resize(3*numPending);
+        xyzModel.resize(3*numPending);
+        for (size_t iPending = 0; iPending < numPending; ++iPending) {
+            const double* xyzPt = &points[3*pending[iPending]];
+            const double x = xyzPt[0];
+            const double y = xyzPt[1];
+            const double z = xyzPt[2];
+            double zSquash = z;
+            switch (_squash) {
+            case SQUASH_NONE:
+                break;
+            case SQUASH_TOP_SURFACE:
+                if (z > _squashMinElev) {
+                    const double topElev = model.queryTopElevation(x, y, modelContext);
+                    zSquash = topElev + z * (_squashMinElev - topElev) / _squashMinElev;
+                } // if
+                break;
+            case SQUASH_TOPOGRAPHY_BATHYMETRY:
+                if (z > _squashMinElev) {
+                    const double groundElev = model.queryTopoBathyElevation(x, y, modelContext);
+                    zSquash = groundElev + z * (_squashMinElev - groundElev) / _squashMinElev;
+                } // if
+                break;
+            default:
+                throw std::logic_error("Unknown squashing type.");
+            } // switch
+            xyz[3*iPending+0] = x;
+            xyz[3*iPending+1] = y;
+            xyz[3*iPending+2] = zSquash;
+        } // for
+        model.toModelXYZ(&xyzModel[0], &xyz[0], numPending, modelContext);
+
+        const values_map_type& valuesIndex = _valuesIndex[i];
+        for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+            modelMap[iValue] = valuesIndex.at(iValue);
+        } // for
+
+        // Visit points along space-filling curve, so consecutive points use the same hyperslab tiles.
+        std::vector<std::pair<uint64_t, size_t> >& order = context->_order;
+        if (_spatialOrdering) {
+            _Query::sortMorton(&order, &xyzModel[0], numPending);
+        } // if
+
+        for (size_t iOrder = 0; iOrder < numPending; ++iOrder) {
+            const size_t iPending = (_spatialOrdering) ? order[iOrder].second : iOrder;
+            const size_t iPoint = pending[iPending];
+            const double* xyzPt = &xyzModel[3*iPending];
+            if (model.containsModelXYZ(xyzPt[0], xyzPt[1], xyzPt[2])) {
+                const double* modelValues = model.queryModelXYZ(xyzPt[0], xyzPt[1], xyzPt[2], modelContext);
+                T* pointValues = &values[iPoint*numQueryValues];
+                for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                    pointValues[iValue] = T(modelValues[modelMap[iValue]]);
+                } // for
+                if (status) {
+                    status[iPoint] = geomodelgrids::utils::ErrorHandler::OK;
+                } // if
+            } else {
+                remaining.push_back(iPoint);
+            } // if/else
+        } // for
+        pending.swap(remaining);
+    } // for
+
+    return pending.empty() ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // _queryMany
+
+
 // ------------------------------------------------------------------------------------------------
 // Cleanup after querying.
 void
 geomodelgrids::serial::Query::finalize(void) {
+    _context.reset();
     for (size_t i = 0; i < _models.size(); ++i) {
         if (_models[i]) {
             _models[i]->close();
@@ -291,6 +1135,80 @@ geomodelgrids::serial::_Query::tolower(unsigned char c) {
 } // tolower
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::_Query::sortMorton(std::vector<std::pair<uint64_t, size_t> >* order,
+                                          const double* xyz,
+                                          const size_t numPoints) {
+    assert(order);
+    assert(!numPoints || xyz);
+
+    const size_t spaceDim = 3;
+    double xyzMin[spaceDim] = { 0.0, 0.0, 0.0 };
+    double xyzMax[spaceDim] = { 0.0, 0.0, 0.0 };
+    bool hasBounds = false;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double* xyzPt = &xyz[iPoint*spaceDim];
+        if (!std::isfinite(xyzPt[0]) || !std::isfinite(xyzPt[1]) || !std::isfinite(xyzPt[2])) {
+            continue;
+        } // if
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            xyzMin[iDim] = (hasBounds) ? std::min(xyzMin[iDim], xyzPt[iDim]) : xyzPt[iDim];
+            xyzMax[iDim] = (hasBounds) ? std::max(xyzMax[iDim], xyzPt[iDim]) : xyzPt[iDim];
+        } // for
+        hasBounds = true;
+    } // for
+
+    const double maxIndex = double((1 << 21) - 1);
+    double scale[spaceDim];
+    for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+        scale[iDim] = (xyzMax[iDim] > xyzMin[iDim]) ? maxIndex / (xyzMax[iDim] - xyzMin[iDim]) : 0.0;
+    } // for
+
+    order->resize(numPoints);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double* xyzPt = &xyz[iPoint*spaceDim];
+        uint64_t key = 0;
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            // Points with coordinates that are not finite (NaN fails both comparisons) go to the lower bound.
+            const double indexFloat = (xyzPt[iDim] - xyzMin[iDim]) * scale[iDim];
+            const uint64_t index = (indexFloat > 0.0) ? uint64_t(std::min(indexFloat, maxIndex)) : 0;
+            key |= spreadBits(index) << iDim;
+        } // for
+        (*order)[iPoint] = std::make_pair(key, iPoint);
+    } // for
+    std::sort(order->begin(), order->end());
+} // sortMorton
+
+
+// ------------------------------------------------------------------------------------------------
+uint64_t
+geomodelgrids::serial::_Query::spreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffffULL;
+    value = (value | value << 16) & 0x1f0000ff0000ffULL;
+    value = (value | value << 8) & 0x100f00f00f00f00fULL;
+    value = (value | value << 4) & 0x10c30c30c30c30c3ULL;
+    value = (value | value << 2) & 0x1249249249249249ULL;
+    return value;
+} // spreadBits
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::serial::_Query::computeGridChunk(hsize_t chunk[4],
+                                                const hsize_t dims[4]) {
+    assert(dims[0] && dims[1] && dims[2] && dims[3]);
+    const hsize_t maxChunkValues = std::max(size_t(1), maxChunkBytes / sizeof(double));
+    const hsize_t columnValues = dims[2] * dims[3];
+
+    chunk[0] = 1;
+    chunk[1] = std::max(hsize_t(1), std::min(dims[1], maxChunkValues / columnValues));
+    chunk[2] = (columnValues <= maxChunkValues) ? dims[2] : std::max(hsize_t(1), maxChunkValues / dims[3]);
+    chunk[3] = dims[3];
+} // computeGridChunk
+
+
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::serial::Query::values_map_type
 geomodelgrids::serial::_Query::createModelValuesIndex(const geomodelgrids::serial::Model& model,
@@ -14,6 +14,7 @@ class geomodelgrids::serial::Query {
     friend class TestQuery; // unit testing
     friend class TestCQuery; // unit testing
     friend class _Query; // Helper class
+    friend class QueryContext; // Per-thread query state
 
     // PUBLIC ENUMS -------------------------------------------------------------------------------
 public:
@@ -63,6 +64,78 @@ public:
      */
     void setSquashing(const SquashingEnum value);
 
+    /** Set maximum size of tile cache for each block and surface in each model.
+     *
+     * Applies to models already initialized and models initialized later.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles per dataset (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Set parameters for reading data from model files.
+     *
+     * Sets the chunk cache of each dataset, hyperslab dimensions of surfaces and blocks, and size of
+     * the tile cache (replacing any value from setCacheSize()). Applies to models initialized later
+     * and to query contexts created later for models already initialized.
+     *
+     * @param[in] profile Read-tuning parameters.
+     */
+    void setIOProfile(const geomodelgrids::serial::IOProfile& profile);
+
+    /** Get tile cache statistics summed over all models.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from a model file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    /** Set memory budget for holding model surfaces and blocks entirely in memory.
+     *
+     * Must be called before initialize(). The budget is shared by all models, in the order they are
+     * given; surfaces and blocks that do not fit are queried using the hyperslab tile cache.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident surfaces and blocks (0 to disable).
+     */
+    void setResidentBudget(const size_t numBytes);
+
+    /** Get size of model surfaces and blocks resident in memory.
+     *
+     * @returns Size (in bytes) of resident surfaces and blocks in all models.
+     */
+    size_t getResidentSize(void) const;
+
+    /** Set whether batched queries visit points in spatial order.
+     *
+     * When enabled, queryMany() sorts the points in each model along a space-filling (Morton) curve,
+     * so consecutive points fall in the same hyperslab tiles. Values are still returned in the
+     * order of the input points. This greatly reduces reads for unordered points, such as nodes of an
+     * unstructured mesh.
+     *
+     * @param[in] value True to visit points in spatial order, false to visit points in input order.
+     */
+    void setSpatialOrdering(const bool value);
+
+    /** Set whether model values are stored in single precision (float).
+     *
+     * Must be called before initialize(). Single precision halves the memory used by the tile cache and
+     * resident surfaces and blocks; interpolation still accumulates in double precision.
+     *
+     * @param[in] value True to store values in single precision, false for double precision.
+     */
+    void setSinglePrecision(const bool value);
+
+    /** Set tolerance for approximating the CRS transformation of query points.
+     *
+     * Must be called before initialize(). For models whose CRS transformation from the input CRS is
+     * not affine, initialize() builds a grid over the model footprint that interpolates the
+     * transformation to within the tolerance (the error measured at sample points in every grid cell
+     * is within half of the tolerance); points outside the grid use the exact transformation.
+     *
+     * @param[in] value Maximum error (model CRS units) of approximate transformation (0 for exact).
+     */
+    void setTransformTolerance(const double value);
+
     /** Get names of values returned in queries.
      *
      * @returns Array of names of values in queries queries.
@@ -78,6 +151,19 @@ public:
     double queryTopElevation(const double x,
                              const double y);
 
+    /** Query for elevation of top of model at point.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of top of model at point.
+     */
+    double queryTopElevation(const double x,
+                             const double y,
+                             geomodelgrids::serial::QueryContext* const context) const;
+
     /** Query for elevation of topography/bathymetry at point.
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -87,6 +173,19 @@ public:
     double queryTopoBathyElevation(const double x,
                                    const double y);
 
+    /** Query for elevation of topography/bathymetry at point.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns Elevation (m) of ground surface at point.
+     */
+    double queryTopoBathyElevation(const double x,
+                                   const double y,
+                                   geomodelgrids::serial::QueryContext* const context) const;
+
 
     /** Query for model containing the given point.
      *
@@ -97,6 +196,19 @@ public:
     int queryModelContains(const double x,
                            const double y);
 
+    /** Query for model containing the given point.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns index of the model at point.
+     */
+    int queryModelContains(const double x,
+                           const double y,
+                           geomodelgrids::serial::QueryContext* const context) const;
+
 
 
     /** Query model for values at a point.
@@ -114,6 +226,276 @@ public:
               const double y,
               const double z);
 
+    /** Query model for values at a point.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query.
+     * @param[in] x X coordinate of point (in input CRS).
+     * @param[in] y Y coordinate of point (in input CRS).
+     * @param[in] z Z coordinate of point (in input CRS).
+     * @param[inout] context Query context.
+     * @returns 0 on success, 1 on error.
+     */
+    int query(double* const values,
+              const double x,
+              const double y,
+              const double z,
+              geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values at multiple points.
+     *
+     * Points are stored in row-major order with coordinates (x, y, z) for each point. Values are
+     * returned in row-major order with the query values for each point. Values for points not in any
+     * model are set to NODATA_VALUE. Arrays must be preallocated.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point (ErrorHandler::OK or ErrorHandler::WARNING)
+     * [numPoints] (can be nullptr).
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryMany(double* const values,
+                  int* const status,
+                  const double* const points,
+                  const size_t numPoints);
+
+    /** Query model for values at multiple points.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryMany(double* const values,
+                  int* const status,
+                  const double* const points,
+                  const size_t numPoints,
+                  geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values at points along a vertical profile.
+     *
+     * The models containing the horizontal location are found once for the profile, and the top
+     * surface and surface used for squashing are looked up once for each model rather than at every
+     * point. Values for points not in any model are set to NODATA_VALUE.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @param[in] z Array of z coordinates of points (in input CRS) [numPoints].
+     * @param[in] numPoints Number of points.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryProfile(double* const values,
+                     int* const status,
+                     const double x,
+                     const double y,
+                     const double* const z,
+                     const size_t numPoints);
+
+    /** Query model for values at points along a vertical profile.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @param[in] z Array of z coordinates of points (in input CRS) [numPoints].
+     * @param[in] numPoints Number of points.
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryProfile(double* const values,
+                     int* const status,
+                     const double x,
+                     const double y,
+                     const double* const z,
+                     const size_t numPoints,
+                     geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values at depths along a vertical profile.
+     *
+     * Depths are relative to the elevation of the given surface at the profile location (elevation
+     * of zero for SQUASH_NONE). All values are NODATA_VALUE if the location is outside the models.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @param[in] depth Array of depths of points (positive downward) [numPoints].
+     * @param[in] numPoints Number of points.
+     * @param[in] depthSurface Surface used as reference for depth.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryProfileDepth(double* const values,
+                          int* const status,
+                          const double x,
+                          const double y,
+                          const double* const depth,
+                          const size_t numPoints,
+                          const SquashingEnum depthSurface);
+
+    /** Query model for values at depths along a vertical profile.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @param[in] depth Array of depths of points (positive downward) [numPoints].
+     * @param[in] numPoints Number of points.
+     * @param[in] depthSurface Surface used as reference for depth.
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryProfileDepth(double* const values,
+                          int* const status,
+                          const double x,
+                          const double y,
+                          const double* const depth,
+                          const size_t numPoints,
+                          const SquashingEnum depthSurface,
+                          geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values on a regular grid.
+     *
+     * Grid point (i, j, k) is at (origin[0]+i*spacing[0], origin[1]+j*spacing[1], origin[2]+k*spacing[2])
+     * in the input CRS. Values are returned in row-major order with shape (numX, numY, numZ, numValues),
+     * so each vertical column of the grid is contiguous. Each column is queried as a vertical profile with
+     * the same elevations, so the models containing the column, the top surface, and the surface used for
+     * squashing are found once per column. Values for points not in any model are set to NODATA_VALUE.
+     *
+     * @param[out] values Array of values returned in query [numX*numY*numZ*numValues].
+     * @param[out] status Array of query status for each point [numX*numY*numZ] (can be nullptr).
+     * @param[in] origin Coordinates of first grid point (in input CRS) [3].
+     * @param[in] spacing Spacing of grid points along each axis (in input CRS) [3].
+     * @param[in] dims Number of grid points along each axis [3].
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryGrid(double* const values,
+                  int* const status,
+                  const double origin[3],
+                  const double spacing[3],
+                  const size_t dims[3]);
+
+    /** Query model for values on a regular grid.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query [numX*numY*numZ*numValues].
+     * @param[out] status Array of query status for each point [numX*numY*numZ] (can be nullptr).
+     * @param[in] origin Coordinates of first grid point (in input CRS) [3].
+     * @param[in] spacing Spacing of grid points along each axis (in input CRS) [3].
+     * @param[in] dims Number of grid points along each axis [3].
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryGrid(double* const values,
+                  int* const status,
+                  const double origin[3],
+                  const double spacing[3],
+                  const size_t dims[3],
+                  geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values on a regular grid and write them to an HDF5 dataset.
+     *
+     * The dataset has shape (numX, numY, numZ, numValues) with the same layout as queryGrid(). The grid
+     * is queried and written one slab of constant x at a time, so memory does not depend on the number
+     * of grid points along the x axis. The dataset is chunked with chunks of shape (1, numY, numZ,
+     * numValues), split along y (and then z) to limit chunks to 1 MiB, so each slab fills whole chunks.
+     *
+     * @param[in] filename Name of HDF5 file (overwritten if it exists).
+     * @param[in] dataset Path of dataset in HDF5 file.
+     * @param[in] origin Coordinates of first grid point (in input CRS) [3].
+     * @param[in] spacing Spacing of grid points along each axis (in input CRS) [3].
+     * @param[in] dims Number of grid points along each axis [3].
+     * @param[in] deflateLevel Level of deflate (gzip) compression in [0, 9] (0 for no compression).
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryGridHDF5(const char* filename,
+                      const char* dataset,
+                      const double origin[3],
+                      const double spacing[3],
+                      const size_t dims[3],
+                      const int deflateLevel=0);
+
+    /** Query model for values on a regular grid and write them to an HDF5 dataset.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[in] filename Name of HDF5 file (overwritten if it exists).
+     * @param[in] dataset Path of dataset in HDF5 file.
+     * @param[in] origin Coordinates of first grid point (in input CRS) [3].
+     * @param[in] spacing Spacing of grid points along each axis (in input CRS) [3].
+     * @param[in] dims Number of grid points along each axis [3].
+     * @param[in] deflateLevel Level of deflate (gzip) compression in [0, 9] (0 for no compression).
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryGridHDF5(const char* filename,
+                      const char* dataset,
+                      const double origin[3],
+                      const double spacing[3],
+                      const size_t dims[3],
+                      const int deflateLevel,
+                      geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Query model for values at multiple points with values returned in single precision.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryManyFloat(float* const values,
+                       int* const status,
+                       const double* const points,
+                       const size_t numPoints);
+
+    /** Query model for values at multiple points with values returned in single precision.
+     *
+     * Thread-safe when each thread uses its own context.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    int queryManyFloat(float* const values,
+                       int* const status,
+                       const double* const points,
+                       const size_t numPoints,
+                       geomodelgrids::serial::QueryContext* const context) const;
+
+    /** Get default query context used by methods without a context argument.
+     *
+     * @returns Default query context (nullptr if query is not initialized).
+     */
+    geomodelgrids::serial::QueryContext* getContext(void) const;
+
     /// Cleanup after querying.
     void finalize(void);
 
@@ -122,6 +504,26 @@ private:
 
     typedef std::map<size_t, size_t> values_map_type;
 
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Query model for values at multiple points with values of type T.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints] (can be nullptr).
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @param[inout] context Query context.
+     * @returns ErrorHandler::OK if all points are in a model, ErrorHandler::WARNING if any points are
+     * not in a model, ErrorHandler::ERROR on error.
+     */
+    template<typename T>
+    int _queryMany(T* const values,
+                   int* const status,
+                   const double* const points,
+                   const size_t numPoints,
+                   geomodelgrids::serial::QueryContext* const context) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -131,6 +533,13 @@ private:
     double _squashMinElev;
     std::shared_ptr<geomodelgrids::utils::ErrorHandler> _errorHandler;
     SquashingEnum _squash;
+    std::unique_ptr<geomodelgrids::serial::IOProfile> _ioProfile; ///< Parameters for reading data from model files.
+    size_t _residentBudget; ///< Maximum size (in bytes) of resident surfaces and blocks (0 to disable).
+    bool _singlePrecision; ///< True if model values are stored in single precision.
+    double _transformTolerance; ///< Maximum error of approximate CRS transformation (0 for exact).
+    bool _spatialOrdering; ///< True if batched queries visit points in spatial order.
+    std::unique_ptr<geomodelgrids::serial::FootprintIndex> _footprintIndex; ///< Index of model footprints.
+    std::unique_ptr<geomodelgrids::serial::QueryContext> _context; ///< Default query context.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -0,0 +1,93 @@
+#include <portinfo>
+
+#include "QueryContext.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/ModelContext.hh" // USES ModelContext
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <stdexcept> // USES std::logic_error
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::QueryContext::QueryContext(const geomodelgrids::serial::Query& query) :
+    _errorHandler(std::make_shared<geomodelgrids::utils::ErrorHandler>()) {
+    if (query._models.empty()) {
+        throw std::logic_error("Query not initialized. Call initialize() before creating a query context.");
+    } // if
+    const size_t numModels = query._models.size();
+    _modelContexts.resize(numModels);
+    _modelContextsOwned.resize(numModels);
+    for (size_t i = 0; i < numModels; ++i) {
+        assert(query._models[i]);
+        _modelContextsOwned[i].reset(new geomodelgrids::serial::ModelContext(*query._models[i]));
+        _modelContexts[i] = _modelContextsOwned[i].get();
+    } // for
+    _modelMap.resize(query._valuesLowercase.size());
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor for default context of a query.
+geomodelgrids::serial::QueryContext::QueryContext(const geomodelgrids::serial::Query& query,
+                                                  const std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler) :
+    _errorHandler(errorHandler) {
+    const size_t numModels = query._models.size();
+    _modelContexts.resize(numModels);
+    for (size_t i = 0; i < numModels; ++i) {
+        assert(query._models[i]);
+        _modelContexts[i] = query._models[i]->getContext();
+        assert(_modelContexts[i]);
+    } // for
+    _modelMap.resize(query._valuesLowercase.size());
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::QueryContext::~QueryContext(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Get error handler.
+std::shared_ptr<geomodelgrids::utils::ErrorHandler>&
+geomodelgrids::serial::QueryContext::getErrorHandler(void) {
+    return _errorHandler;
+} // getErrorHandler
+
+
+// ------------------------------------------------------------------------------------------------
+// Set maximum size of tile cache.
+void
+geomodelgrids::serial::QueryContext::setCacheSize(const size_t numBytes) {
+    for (size_t i = 0; i < _modelContexts.size(); ++i) {
+        assert(_modelContexts[i]);
+        _modelContexts[i]->setCacheSize(numBytes);
+    } // for
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get tile cache statistics summed over all models.
+void
+geomodelgrids::serial::QueryContext::getCacheStats(size_t* numHits,
+                                                   size_t* numMisses) const {
+    size_t hitsTotal = 0;
+    size_t missesTotal = 0;
+    for (size_t i = 0; i < _modelContexts.size(); ++i) {
+        assert(_modelContexts[i]);
+        size_t hits = 0;
+        size_t misses = 0;
+        _modelContexts[i]->getCacheStats(&hits, &misses);
+        hitsTotal += hits;
+        missesTotal += misses;
+    } // for
+
+    if (numHits) { *numHits = hitsTotal; }
+    if (numMisses) { *numMisses = missesTotal; }
+} // getCacheStats
+
+
+// End of file
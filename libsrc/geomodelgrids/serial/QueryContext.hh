@@ -0,0 +1,93 @@
+/** Per-thread state for querying models.
+ *
+ * A Query holds the opened models, which are shared and not modified during queries. Each thread
+ * querying the models uses its own context, which holds the CRS transformers, hyperslab tile caches,
+ * scratch buffers, and error handler for that thread.
+ *
+ * Create contexts after the Query is initialized and destroy them before it is finalized.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+#include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA ErrorHandler
+
+#include <cstdlib> // USES size_t
+#include <cstdint> // USES uint64_t
+#include <memory> // HASA std::unique_ptr, std::shared_ptr
+#include <utility> // USES std::pair
+#include <vector> // HASA std::vector
+
+class geomodelgrids::serial::QueryContext {
+    friend class Query; // Access to context state
+    friend class TestQuery; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor.
+     *
+     * @param[in] query Initialized query.
+     */
+    QueryContext(const geomodelgrids::serial::Query& query);
+
+    /// Destructor
+    ~QueryContext(void);
+
+    /** Get error handler.
+     *
+     * @returns Error handler for queries using this context.
+     */
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& getErrorHandler(void);
+
+    /** Set maximum size of tile cache for each block and surface in each model.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles per dataset (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get tile cache statistics summed over all models.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from a model file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Constructor for default context of a query, which uses the default contexts of the models.
+     *
+     * @param[in] query Initialized query.
+     * @param[in] errorHandler Error handler of query.
+     */
+    QueryContext(const geomodelgrids::serial::Query& query,
+                 const std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<geomodelgrids::serial::ModelContext*> _modelContexts; ///< Contexts for models (in query order).
+    std::vector<std::unique_ptr<geomodelgrids::serial::ModelContext> > _modelContextsOwned; ///< Contexts owned by this context.
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler> _errorHandler; ///< Error handler.
+
+    // Scratch buffers for batched queries.
+    std::vector<double> _xyz; ///< Coordinates of points in input CRS.
+    std::vector<double> _xyzModel; ///< Coordinates of points in model coordinate system.
+    std::vector<size_t> _pending; ///< Indices of points not yet found in a model.
+    std::vector<size_t> _remaining; ///< Indices of points not found in current model.
+    std::vector<std::pair<uint64_t, size_t> > _order; ///< Space-filling curve key and index of pending points.
+    std::vector<size_t> _modelMap; ///< Map from index of query value to index of model value.
+    std::vector<double> _profileZ; ///< Elevations of points in profile.
+    std::vector<double> _gridZ; ///< Elevations of points in columns of grid.
+    std::vector<double> _gridValues; ///< Values in slab of grid.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    QueryContext(const QueryContext&); ///< Not implemented
+    const QueryContext& operator=(const QueryContext&); ///< Not implemented
+
+}; // QueryContext
+
+// End of file
@@ -23,10 +23,16 @@ geomodelgrids::serial::Surface::Surface(const char* const name) :
     _coordinatesX(nullptr),
     _coordinatesY(nullptr),
     _indexingX(nullptr),
-    _indexingY(nullptr) {
+    _indexingY(nullptr),
+    _cacheSize(0),
+    _singlePrecision(false) {
     _dims[0] = 0;
     _dims[1] = 0;
 
+    for (size_t i = 0; i < 3; ++i) {
+        _chunkDims[i] = 0;
+    } // for
+
     _hyperslabDims[0] = 128;
     _hyperslabDims[1] = 128;
     _hyperslabDims[2] = 1;
@@ -91,6 +97,12 @@ geomodelgrids::serial::Surface::loadMetadata(geomodelgrids::serial::HDF5* const
     } // for
     delete[] hdims;hdims = nullptr;
 
+    h5->getDatasetChunkDims(&hdims, &ndims, surfacePath.c_str());
+    for (int i = 0; i < 3; ++i) {
+        _chunkDims[i] = (3 == ndims) ? hdims[i] : 0;
+    } // for
+    delete[] hdims;hdims = nullptr;
+
     // Check to make sure dimensions of surface match coordinates (if provided).
     if (_coordinatesX && (dims[0] != _dims[0])) {
         msg << indent << "    x dimension of surface " << surfacePath << " (" << _dims[0]
@@ -162,6 +174,14 @@ geomodelgrids::serial::Surface::getDims(void) const {
 } // getDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Get dimensions of chunks in HDF5 dataset of surface.
+const size_t*
+geomodelgrids::serial::Surface::getChunkDims(void) const {
+    return _chunkDims;
+} // getChunkDims
+
+
 // ------------------------------------------------------------------------------------------------
 // Set hyperslab size.
 void
@@ -183,16 +203,101 @@ geomodelgrids::serial::Surface::setHyperslabDims(const size_t dims[],
 
 
 // ------------------------------------------------------------------------------------------------
-// Prepare for querying.
+// Set maximum size of hyperslab tile cache.
 void
-geomodelgrids::serial::Surface::openQuery(geomodelgrids::serial::HDF5* const h5) {
+geomodelgrids::serial::Surface::setCacheSize(const size_t numBytes) {
+    _cacheSize = numBytes;
+    if (_hyperslab && _cacheSize) {
+        _hyperslab->setCacheSize(_cacheSize);
+    } // if
+} // setCacheSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get hyperslab tile cache statistics.
+void
+geomodelgrids::serial::Surface::getCacheStats(size_t* numHits,
+                                              size_t* numMisses) const {
+    if (_hyperslab) {
+        _hyperslab->getCacheStats(numHits, numMisses);
+    } else {
+        if (numHits) { *numHits = 0; }
+        if (numMisses) { *numMisses = 0; }
+    } // if/else
+} // getCacheStats
+
+
+// ------------------------------------------------------------------------------------------------
+// Set whether values are stored in single precision.
+void
+geomodelgrids::serial::Surface::setSinglePrecision(const bool value) {
+    _singlePrecision = value;
+} // setSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Create hyperslab for querying surface.
+geomodelgrids::serial::Hyperslab*
+geomodelgrids::serial::Surface::createHyperslab(geomodelgrids::serial::HDF5* const h5) const {
     const size_t ndims = 3;
     hsize_t dims[ndims];
-    dims[0] = 128;
-    dims[1] = 128;
-    dims[2] = 1;
+    for (size_t i = 0; i < ndims; ++i) {
+        dims[i] = _hyperslabDims[i];
+    } // for
     const std::string& surfacePath = std::string("surfaces/") + _name;
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, surfacePath.c_str(), dims, ndims);
+    geomodelgrids::serial::Hyperslab* hyperslab = new geomodelgrids::serial::Hyperslab(h5, surfacePath.c_str(), dims, ndims);
+    if (_cacheSize) {
+        hyperslab->setCacheSize(_cacheSize);
+    } // if
+    if (_residentValues) {
+        hyperslab->setResident(_residentValues);
+    } else if (_residentValuesFloat) {
+        hyperslab->setResident(_residentValuesFloat);
+    } else if (_singlePrecision) {
+        hyperslab->setSinglePrecision(true);
+    } // if/else
+
+    return hyperslab;
+} // createHyperslab
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of values in surface.
+size_t
+geomodelgrids::serial::Surface::getValuesSize(void) const {
+    return _dims[0]*_dims[1] * (_singlePrecision ? sizeof(float) : sizeof(double));
+} // getValuesSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values of entire surface into memory.
+void
+geomodelgrids::serial::Surface::loadResident(geomodelgrids::serial::HDF5* const h5) {
+    assert(h5);
+    const std::string& surfacePath = std::string("surfaces/") + _name;
+    _residentValues.reset();
+    _residentValuesFloat.reset();
+    if (_singlePrecision) {
+        _residentValuesFloat = geomodelgrids::serial::Hyperslab::readResidentFloat(h5, surfacePath.c_str());
+    } else {
+        _residentValues = geomodelgrids::serial::Hyperslab::readResident(h5, surfacePath.c_str());
+    } // if/else
+} // loadResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Are values of entire surface resident in memory?
+bool
+geomodelgrids::serial::Surface::isResident(void) const {
+    return _residentValues || _residentValuesFloat;
+} // isResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Prepare for querying.
+void
+geomodelgrids::serial::Surface::openQuery(geomodelgrids::serial::HDF5* const h5) {
+    delete _hyperslab;_hyperslab = createHyperslab(h5);
 } // openQuery
 
 
@@ -201,6 +306,8 @@ geomodelgrids::serial::Surface::openQuery(geomodelgrids::serial::HDF5* const h5)
 void
 geomodelgrids::serial::Surface::closeQuery(void) {
     delete _hyperslab;_hyperslab = nullptr;
+    _residentValues.reset();
+    _residentValuesFloat.reset();
 } // closeQuery
 
 
@@ -209,18 +316,33 @@ geomodelgrids::serial::Surface::closeQuery(void) {
 double
 geomodelgrids::serial::Surface::query(const double x,
                                       const double y) {
+    return query(_hyperslab, x, y);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at a point using bilinear interpolation with given hyperslab.
+double
+geomodelgrids::serial::Surface::query(geomodelgrids::serial::Hyperslab* const hyperslab,
+                                      const double x,
+                                      const double y) const {
     assert(_indexingX);
     assert(_indexingY);
 
+    // Axis type is fixed per surface, so dispatch statically and let the lookup inline.
     double index[2];
-    index[0] = _indexingX->getIndex(x);
-    index[1] = _indexingY->getIndex(y);
+    index[0] = (_coordinatesX) ?
+               static_cast<const geomodelgrids::utils::IndexingVariable*>(_indexingX)->getIndex(x) :
+               static_cast<const geomodelgrids::utils::IndexingUniform*>(_indexingX)->getIndex(x);
+    index[1] = (_coordinatesY) ?
+               static_cast<const geomodelgrids::utils::IndexingVariable*>(_indexingY)->getIndex(y) :
+               static_cast<const geomodelgrids::utils::IndexingUniform*>(_indexingY)->getIndex(y);
 
     double elevation = geomodelgrids::NODATA_VALUE;
     if ((index[0] >= 0) && (index[0] <= double(_dims[0]-1))
         && (index[1] >= 0) && (index[1] <= double(_dims[1]-1))) {
-        assert(_hyperslab);
-        _hyperslab->interpolate(&elevation, index);
+        assert(hyperslab);
+        hyperslab->interpolate(&elevation, index);
     } // if
 
     return elevation;
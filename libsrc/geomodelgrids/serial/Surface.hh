@@ -6,6 +6,8 @@
 #include "geomodelgrids/utils/utilsfwd.hh" // forward declarations
 
 #include <string> // HASA std::string
+#include <memory> // HASA std::shared_ptr
+#include <vector> // HASA std::vector
 
 class geomodelgrids::serial::Surface {
     friend class TestSurface; // Unit testing
@@ -58,6 +60,14 @@ public:
      */
     const size_t* getDims(void) const;
 
+    /** Get dimensions of chunks in HDF5 dataset of surface.
+     *
+     * Hyperslab tiles are aligned with the chunks.
+     *
+     * @returns Dimensions of chunks [x, y, values] (all zero if the dataset is not chunked).
+     */
+    const size_t* getChunkDims(void) const;
+
     /** Set hyperslab size.
      *
      * @param[in] dims Dimensions of hyperslab.
@@ -66,6 +76,57 @@ public:
     void setHyperslabDims(const size_t dims[],
                           const size_t ndims);
 
+    /** Set maximum size of hyperslab tile cache.
+     *
+     * @param[in] numBytes Maximum size (in bytes) of resident tiles (0 for default).
+     */
+    void setCacheSize(const size_t numBytes);
+
+    /** Get hyperslab tile cache statistics.
+     *
+     * @param[out] numHits Number of lookups satisfied by a resident tile.
+     * @param[out] numMisses Number of lookups requiring a read from the HDF5 file.
+     */
+    void getCacheStats(size_t* numHits,
+                       size_t* numMisses) const;
+
+    /** Set whether values are stored in single precision (float) in hyperslabs and resident values.
+     *
+     * Applies to hyperslabs created and values loaded after this call.
+     *
+     * @param[in] value True to store values in single precision, false for double precision.
+     */
+    void setSinglePrecision(const bool value);
+
+    /** Create hyperslab for querying surface.
+     *
+     * Each query context uses its own hyperslab, so surfaces can be queried concurrently.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @returns Hyperslab for surface (caller takes ownership).
+     */
+    geomodelgrids::serial::Hyperslab* createHyperslab(geomodelgrids::serial::HDF5* const h5) const;
+
+    /** Get size of values in surface.
+     *
+     * @returns Size (in bytes) of values in surface at the storage precision.
+     */
+    size_t getValuesSize(void) const;
+
+    /** Load values of entire surface into memory, so queries do not read from the HDF5 file.
+     *
+     * The resident values are shared by hyperslabs created after this call.
+     *
+     * @param[in] h5 HDF5 with model.
+     */
+    void loadResident(geomodelgrids::serial::HDF5* const h5);
+
+    /** Are values of entire surface resident in memory?
+     *
+     * @returns True if values are resident, false otherwise.
+     */
+    bool isResident(void) const;
+
     /** Prepare for querying.
      *
      * @param[in] h5 HDF5 with model.
@@ -84,6 +145,17 @@ public:
     double query(const double x,
                  const double y);
 
+    /** Query for elevation of ground surface at a point using bilinear interpolation with given hyperslab.
+     *
+     * @param[inout] hyperslab Hyperslab for surface (from createHyperslab()).
+     * @param[in] x X coordinate of point in model coordinate system.
+     * @param[in] y Y coordinate of point in model coordinate system.
+     * @returns Elevation of ground surface.
+     */
+    double query(geomodelgrids::serial::Hyperslab* const hyperslab,
+                 const double x,
+                 const double y) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -100,7 +172,12 @@ private:
     geomodelgrids::utils::Indexing* _indexingY; ///< Procedure for finding index along y axis.
 
     size_t _dims[2]; ///< Number of points along grid in each x and y dimension [x, y].
+    size_t _chunkDims[3]; ///< Dimensions of chunks in HDF5 dataset (all zero if not chunked).
     size_t _hyperslabDims[3]; ///< Dimensions of hyperslab.
+    size_t _cacheSize; ///< Maximum size (in bytes) of hyperslab tile cache (0 for default).
+    std::shared_ptr<const std::vector<double> > _residentValues; ///< Values of entire surface (if resident).
+    std::shared_ptr<const std::vector<float> > _residentValuesFloat; ///< Values of entire surface (if resident in single precision).
+    bool _singlePrecision; ///< True if values are stored in single precision.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -5,6 +5,8 @@ extern "C" {
 }
 
 #include "Query.hh" // USES Query
+#include "QueryContext.hh" // USES QueryContext
+#include "IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
@@ -14,6 +16,80 @@ extern "C" {
 #include <sstream> // USES std::ostringstream, std::istringstream
 #include <iomanip> // USES io manipulators
 
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        class _CQuery;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::_CQuery {
+public:
+
+    /// Method of Query for elevation of a surface at a point using a query context.
+    typedef double (geomodelgrids::serial::Query::*elevation_method_type)(const double,
+                                                                         const double,
+                                                                         geomodelgrids::serial::QueryContext* const) const;
+
+    /** Query model for values at multiple points using a query context.
+     *
+     * @param[in] query Query object.
+     * @param[inout] context Query context.
+     * @param[in] numPoints Number of points.
+     * @param[in] points Array of points (in input CRS) [numPoints*3].
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[out] status Array of status for each point [numPoints] (can be NULL).
+     * @returns Status of error handler of context.
+     */
+    template<typename T>
+    static
+    int queryBatch(const geomodelgrids::serial::Query& query,
+                   geomodelgrids::serial::QueryContext* context,
+                   const size_t numPoints,
+                   const double* const points,
+                   T* const values,
+                   int* const status);
+
+    /// Query::queryMany() for values in double precision.
+    static
+    int queryMany(const geomodelgrids::serial::Query& query,
+                  geomodelgrids::serial::QueryContext* context,
+                  const size_t numPoints,
+                  const double* const points,
+                  double* const values,
+                  int* const status);
+
+    /// Query::queryManyFloat() for values in single precision.
+    static
+    int queryMany(const geomodelgrids::serial::Query& query,
+                  geomodelgrids::serial::QueryContext* context,
+                  const size_t numPoints,
+                  const double* const points,
+                  float* const values,
+                  int* const status);
+
+    /** Query for elevation of a surface at multiple points using a query context.
+     *
+     * @param[in] query Query object.
+     * @param[inout] context Query context.
+     * @param[in] numPoints Number of points.
+     * @param[in] points Array of points (in input CRS) [numPoints*2].
+     * @param[out] elevations Array of elevations (m) of surface at points [numPoints].
+     * @param[in] method Method of Query for elevation of surface.
+     * @param[in] surfaceName Name of surface for messages.
+     * @returns Status of error handler of context.
+     */
+    static
+    int queryElevationBatch(const geomodelgrids::serial::Query& query,
+                            geomodelgrids::serial::QueryContext* context,
+                            const size_t numPoints,
+                            const double* const points,
+                            double* const elevations,
+                            elevation_method_type method,
+                            const char* surfaceName);
+
+}; // _CQuery
+
 // ------------------------------------------------------------------------------------------------
 // Create query object.
 void*
@@ -139,6 +215,29 @@ geomodelgrids_squery_setSquashing(void* handle,
 } // setSquashing
 
 
+// ------------------------------------------------------------------------------------------------
+// Set parameters for reading data from model files.
+int
+geomodelgrids_squery_setIOProfile(void* handle,
+                                  const char* const profile) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_setIOProfile().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    try {
+        query->setIOProfile(geomodelgrids::serial::IOProfile::fromString(profile ? profile : ""));
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return query->getErrorHandler()->getStatus();
+} // setIOProfile
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for elevation of top of model at point.
 double
@@ -314,6 +413,281 @@ geomodelgrids_squery_query(void* handle,
 } // query
 
 
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points.
+int
+geomodelgrids_squery_queryBatch(void* handle,
+                                const size_t numPoints,
+                                const double* const points,
+                                double* const values,
+                                int* const status) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_queryBatch().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    if (!query->getContext()) {
+        query->getErrorHandler()->setError("geomodelgrids_squery_queryBatch() called before initialize().");
+        return query->getErrorHandler()->getStatus();
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryBatch(*query, query->getContext(), numPoints, points, values, status);
+} // queryBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Query model for values at multiple points with values returned in single precision.
+int
+geomodelgrids_squery_queryBatchFloat(void* handle,
+                                     const size_t numPoints,
+                                     const double* const points,
+                                     float* const values,
+                                     int* const status) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_queryBatchFloat().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    if (!query->getContext()) {
+        query->getErrorHandler()->setError("geomodelgrids_squery_queryBatchFloat() called before initialize().");
+        return query->getErrorHandler()->getStatus();
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryBatch(*query, query->getContext(), numPoints, points, values, status);
+} // queryBatchFloat
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at multiple points.
+int
+geomodelgrids_squery_queryTopElevationBatch(void* handle,
+                                            const size_t numPoints,
+                                            const double* const points,
+                                            double* const elevations) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_queryTopElevationBatch().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    if (!query->getContext()) {
+        query->getErrorHandler()->setError("geomodelgrids_squery_queryTopElevationBatch() called before initialize().");
+        return query->getErrorHandler()->getStatus();
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryElevationBatch(*query, query->getContext(), numPoints, points, elevations,
+                                                               &geomodelgrids::serial::Query::queryTopElevation,
+                                                               "top of model");
+} // queryTopElevationBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at multiple points.
+int
+geomodelgrids_squery_queryTopoBathyElevationBatch(void* handle,
+                                                  const size_t numPoints,
+                                                  const double* const points,
+                                                  double* const elevations) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_queryTopoBathyElevationBatch().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    if (!query->getContext()) {
+        query->getErrorHandler()->setError("geomodelgrids_squery_queryTopoBathyElevationBatch() called before initialize().");
+        return query->getErrorHandler()->getStatus();
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryElevationBatch(*query, query->getContext(), numPoints, points, elevations,
+                                                               &geomodelgrids::serial::Query::queryTopoBathyElevation,
+                                                               "ground surface");
+} // queryTopoBathyElevationBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Create query context.
+void*
+geomodelgrids_squery_createContext(void* handle) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query object in call to geomodelgrids_squery_createContext().";
+        return NULL;
+    } // if
+
+    assert(query);
+    geomodelgrids::serial::QueryContext* context = NULL;
+    try {
+        context = new geomodelgrids::serial::QueryContext(*query);
+    } catch (const std::exception& err) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
+        errorHandler->setError(err.what());
+    } // try/catch
+
+    return (void*) context;
+} // createContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Destroy query context.
+void
+geomodelgrids_squery_destroyContext(void** context) {
+    geomodelgrids::serial::QueryContext** queryContext = (geomodelgrids::serial::QueryContext**) context;
+    if (queryContext) {
+        delete *queryContext;*queryContext = NULL;
+    } // if
+} // destroyContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Get error handler of query context.
+void*
+geomodelgrids_squery_getContextErrorHandler(void* context) {
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    geomodelgrids::utils::ErrorHandler* errorHandler = NULL;
+    if (queryContext) {
+        errorHandler = queryContext->getErrorHandler().get();
+    } // if
+
+    return errorHandler;
+} // getContextErrorHandler
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at point using query context.
+int
+geomodelgrids_squery_queryWithContext(void* handle,
+                                      void* context,
+                                      double* const values,
+                                      const double x,
+                                      const double y,
+                                      const double z) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    if (!handle || !context) {
+        std::cerr << "NULL handle for query object or query context in call to geomodelgrids_squery_queryWithContext().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(query);
+    assert(queryContext);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = queryContext->getErrorHandler();
+    try {
+        int err = query->query(values, x, y, z, queryContext);
+        if (err == geomodelgrids::utils::ErrorHandler::WARNING) {
+            std::ostringstream warning;
+            warning << "WARNING: Could not find model containing ("
+                    << std::resetiosflags(std::ios::fixed)
+                    << std::setiosflags(std::ios::scientific)
+                    << std::setprecision(6)
+                    << x << ", " << y << ", " << z << ") during query.";
+            errorHandler->setWarning(warning.str().c_str());
+            errorHandler->logMessage(warning.str().c_str());
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying for values at point "
+              << std::resetiosflags(std::ios::fixed)
+              << std::setiosflags(std::ios::scientific)
+              << std::setprecision(6)
+              << x << ", " << y << ", " << z <<"\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // queryWithContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at multiple points using query context.
+int
+geomodelgrids_squery_queryBatchWithContext(void* handle,
+                                           void* context,
+                                           const size_t numPoints,
+                                           const double* const points,
+                                           double* const values,
+                                           int* const status) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    if (!handle || !context) {
+        std::cerr << "NULL handle for query object or query context in call to geomodelgrids_squery_queryBatchWithContext().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryBatch(*query, queryContext, numPoints, points, values, status);
+} // queryBatchWithContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Query model for values at multiple points with values returned in single precision using query
+// context.
+int
+geomodelgrids_squery_queryBatchFloatWithContext(void* handle,
+                                                void* context,
+                                                const size_t numPoints,
+                                                const double* const points,
+                                                float* const values,
+                                                int* const status) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    if (!handle || !context) {
+        std::cerr << "NULL handle for query object or query context in call to geomodelgrids_squery_queryBatchFloatWithContext().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryBatch(*query, queryContext, numPoints, points, values, status);
+} // queryBatchFloatWithContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at multiple points using query context.
+int
+geomodelgrids_squery_queryTopElevationBatchWithContext(void* handle,
+                                                       void* context,
+                                                       const size_t numPoints,
+                                                       const double* const points,
+                                                       double* const elevations) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    if (!handle || !context) {
+        std::cerr << "NULL handle for query object or query context in call to geomodelgrids_squery_queryTopElevationBatchWithContext().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryElevationBatch(*query, queryContext, numPoints, points, elevations,
+                                                               &geomodelgrids::serial::Query::queryTopElevation,
+                                                               "top of model");
+} // queryTopElevationBatchWithContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at multiple points using query context.
+int
+geomodelgrids_squery_queryTopoBathyElevationBatchWithContext(void* handle,
+                                                             void* context,
+                                                             const size_t numPoints,
+                                                             const double* const points,
+                                                             double* const elevations) {
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;
+    geomodelgrids::serial::QueryContext* queryContext = (geomodelgrids::serial::QueryContext*) context;
+    if (!handle || !context) {
+        std::cerr << "NULL handle for query object or query context in call to geomodelgrids_squery_queryTopoBathyElevationBatchWithContext().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    return geomodelgrids::serial::_CQuery::queryElevationBatch(*query, queryContext, numPoints, points, elevations,
+                                                               &geomodelgrids::serial::Query::queryTopoBathyElevation,
+                                                               "ground surface");
+} // queryTopoBathyElevationBatchWithContext
+
+
 // ------------------------------------------------------------------------------------------------
 // Cleanup after querying.
 int
@@ -331,4 +705,118 @@ geomodelgrids_squery_finalize(void* handle) {
 } // finalize
 
 
+// ------------------------------------------------------------------------------------------------
+// Query model for values at multiple points using a query context.
+template<typename T>
+int
+geomodelgrids::serial::_CQuery::queryBatch(const geomodelgrids::serial::Query& query,
+                                           geomodelgrids::serial::QueryContext* context,
+                                           const size_t numPoints,
+                                           const double* const points,
+                                           T* const values,
+                                           int* const status) {
+    assert(context);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = context->getErrorHandler();
+    try {
+        const int err = queryMany(query, context, numPoints, points, values, status);
+        if (err == geomodelgrids::utils::ErrorHandler::WARNING) {
+            std::ostringstream warning;
+            warning << "WARNING: Could not find model containing ";
+            if (status) {
+                size_t numMissing = 0;
+                for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+                    numMissing += (status[iPoint] != geomodelgrids::utils::ErrorHandler::OK) ? 1 : 0;
+                } // for
+                warning << numMissing << " of " << numPoints << " points";
+            } else {
+                warning << "one or more of " << numPoints << " points";
+            } // if/else
+            warning << " during batch query.";
+            errorHandler->setWarning(warning.str().c_str());
+            errorHandler->logMessage(warning.str().c_str());
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying for values at " << numPoints << " points.\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // queryBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Query::queryMany() for values in double precision.
+int
+geomodelgrids::serial::_CQuery::queryMany(const geomodelgrids::serial::Query& query,
+                                          geomodelgrids::serial::QueryContext* context,
+                                          const size_t numPoints,
+                                          const double* const points,
+                                          double* const values,
+                                          int* const status) {
+    return query.queryMany(values, status, points, numPoints, context);
+} // queryMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Query::queryManyFloat() for values in single precision.
+int
+geomodelgrids::serial::_CQuery::queryMany(const geomodelgrids::serial::Query& query,
+                                          geomodelgrids::serial::QueryContext* context,
+                                          const size_t numPoints,
+                                          const double* const points,
+                                          float* const values,
+                                          int* const status) {
+    return query.queryManyFloat(values, status, points, numPoints, context);
+} // queryMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of a surface at multiple points using a query context.
+int
+geomodelgrids::serial::_CQuery::queryElevationBatch(const geomodelgrids::serial::Query& query,
+                                                    geomodelgrids::serial::QueryContext* context,
+                                                    const size_t numPoints,
+                                                    const double* const points,
+                                                    double* const elevations,
+                                                    elevation_method_type method,
+                                                    const char* surfaceName) {
+    assert(context);
+    assert(method);
+    std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = context->getErrorHandler();
+    if (numPoints && (!points || !elevations)) {
+        errorHandler->setError("NULL points or elevations array in batch query for elevation.");
+        return errorHandler->getStatus();
+    } // if
+
+    size_t iPoint = 0;
+    try {
+        size_t numMissing = 0;
+        for (iPoint = 0; iPoint < numPoints; ++iPoint) {
+            elevations[iPoint] = (query.*method)(points[2*iPoint+0], points[2*iPoint+1], context);
+            numMissing += (elevations[iPoint] == geomodelgrids::NODATA_VALUE) ? 1 : 0;
+        } // for
+        if (numMissing > 0) {
+            std::ostringstream warning;
+            warning << "WARNING: Could not find model containing " << numMissing << " of " << numPoints
+                    << " points when querying for elevation of " << surfaceName << ".";
+            errorHandler->setWarning(warning.str().c_str());
+            errorHandler->logMessage(warning.str().c_str());
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream error;
+        error << "ERROR: Fatal error when querying for elevation of " << surfaceName << " at point "
+              << std::resetiosflags(std::ios::fixed)
+              << std::setiosflags(std::ios::scientific)
+              << std::setprecision(6)
+              << points[2*iPoint+0] << ", " << points[2*iPoint+1] <<"\n" << err.what();
+        errorHandler->setError(error.str().c_str());
+        errorHandler->logMessage(error.str().c_str());
+    } // try/catch
+
+    return errorHandler->getStatus();
+} // queryElevationBatch
+
+
 // End of file
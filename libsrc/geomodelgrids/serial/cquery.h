@@ -2,6 +2,8 @@
  */
 #pragma once
 
+#include <stddef.h> /* USES size_t */
+
 #define GEOMODELGRIDS_NODATA_VALUE -1.0e+20
 #define GEOMODELGRIDS_SQUASH_NONE 0
 #define GEOMODELGRIDS_SQUASH_TOP_SURFACE 1
@@ -63,6 +65,19 @@ int geomodelgrids_squery_setSquashMinElev(void* handle,
 int geomodelgrids_squery_setSquashing(void* handle,
                                       const int value);
 
+/** Set parameters for reading data from model files.
+ *
+ * Must be called before geomodelgrids_squery_initialize() to apply to the models.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] profile I/O profile as preset name ('default', 'borehole', 'grid') and/or comma separated
+ *   KEY=VALUE parameters (see geomodelgrids::serial::IOProfile).
+ *
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_setIOProfile(void* handle,
+                                      const char* const profile);
+
 /** Query for elevation of top of model at point.
  *
  * @param[inout] handle Handle to query object.
@@ -114,6 +129,173 @@ int geomodelgrids_squery_query(void* handle,
                                const double y,
                                const double z);
 
+/** Query model for values at multiple points.
+ *
+ * Points are stored in row-major order with coordinates (x, y, z) for each point. Values are
+ * returned in row-major order with the query values for each point. Values for points not in any
+ * model are set to GEOMODELGRIDS_NODATA_VALUE. Arrays must be preallocated.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*3].
+ * @param[out] values Array of values returned in query [numPoints*numValues].
+ * @param[out] status Array of status for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_queryBatch(void* handle,
+                                    const size_t numPoints,
+                                    const double* const points,
+                                    double* const values,
+                                    int* const status);
+
+/** Query model for values at multiple points with values returned in single precision.
+ *
+ * Same as geomodelgrids_squery_queryBatch() with values stored as float.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*3].
+ * @param[out] values Array of values returned in query [numPoints*numValues].
+ * @param[out] status Array of status for each point [numPoints] (can be NULL).
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_queryBatchFloat(void* handle,
+                                         const size_t numPoints,
+                                         const double* const points,
+                                         float* const values,
+                                         int* const status);
+
+/** Query for elevation of top of model at multiple points.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*2].
+ * @param[out] elevations Array of elevations (m) of top of model at points [numPoints].
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_queryTopElevationBatch(void* handle,
+                                                const size_t numPoints,
+                                                const double* const points,
+                                                double* const elevations);
+
+/** Query for elevation of topography/bathymetry at multiple points.
+ *
+ * @param[inout] handle Handle to query object.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*2].
+ * @param[out] elevations Array of elevations (m) of ground surface at points [numPoints].
+ * @returns Status of error handler.
+ */
+int geomodelgrids_squery_queryTopoBathyElevationBatch(void* handle,
+                                                      const size_t numPoints,
+                                                      const double* const points,
+                                                      double* const elevations);
+
+/** Create query context for querying from a thread.
+ *
+ * Queries using a context are thread-safe when each thread uses its own context. Create contexts
+ * after the query is initialized and destroy them before the query is finalized.
+ *
+ * @param[inout] handle Handle to initialized query object.
+ * @returns Pointer to QueryContext object (NULL on failure).
+ */
+void* geomodelgrids_squery_createContext(void* handle);
+
+/** Destroy query context.
+ *
+ * @param[inout] context Query context.
+ */
+void geomodelgrids_squery_destroyContext(void** context);
+
+/** Get error handler of query context.
+ *
+ * @param[in] context Query context.
+ * @returns Error handler for queries using the context.
+ */
+void* geomodelgrids_squery_getContextErrorHandler(void* context);
+
+/** Query model for values at a point using a query context.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[inout] context Query context.
+ * @param[out] values Array of values returned in query.
+ * @param[in] x X coordinate of point (in input CRS).
+ * @param[in] y Y coordinate of point (in input CRS).
+ * @param[in] z Z coordinate of point (in input CRS).
+ * @returns Status of error handler of context.
+ */
+int geomodelgrids_squery_queryWithContext(void* handle,
+                                          void* context,
+                                          double* const values,
+                                          const double x,
+                                          const double y,
+                                          const double z);
+
+/** Query model for values at multiple points using a query context.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[inout] context Query context.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*3].
+ * @param[out] values Array of values returned in query [numPoints*numValues].
+ * @param[out] status Array of status for each point [numPoints] (can be NULL).
+ * @returns Status of error handler of context.
+ */
+int geomodelgrids_squery_queryBatchWithContext(void* handle,
+                                               void* context,
+                                               const size_t numPoints,
+                                               const double* const points,
+                                               double* const values,
+                                               int* const status);
+
+/** Query model for values at multiple points with values returned in single precision using a
+ * query context.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[inout] context Query context.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*3].
+ * @param[out] values Array of values returned in query [numPoints*numValues].
+ * @param[out] status Array of status for each point [numPoints] (can be NULL).
+ * @returns Status of error handler of context.
+ */
+int geomodelgrids_squery_queryBatchFloatWithContext(void* handle,
+                                                    void* context,
+                                                    const size_t numPoints,
+                                                    const double* const points,
+                                                    float* const values,
+                                                    int* const status);
+
+/** Query for elevation of top of model at multiple points using a query context.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[inout] context Query context.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*2].
+ * @param[out] elevations Array of elevations (m) of top of model at points [numPoints].
+ * @returns Status of error handler of context.
+ */
+int geomodelgrids_squery_queryTopElevationBatchWithContext(void* handle,
+                                                           void* context,
+                                                           const size_t numPoints,
+                                                           const double* const points,
+                                                           double* const elevations);
+
+/** Query for elevation of topography/bathymetry at multiple points using a query context.
+ *
+ * @param[in] handle Handle to query object.
+ * @param[inout] context Query context.
+ * @param[in] numPoints Number of points.
+ * @param[in] points Array of points (in input CRS) [numPoints*2].
+ * @param[out] elevations Array of elevations (m) of ground surface at points [numPoints].
+ * @returns Status of error handler of context.
+ */
+int geomodelgrids_squery_queryTopoBathyElevationBatchWithContext(void* handle,
+                                                                 void* context,
+                                                                 const size_t numPoints,
+                                                                 const double* const points,
+                                                                 double* const elevations);
+
 /* Cleanup after querying.
  *
  * @param[inout] handle Handle to query object.
@@ -8,8 +8,13 @@ namespace geomodelgrids {
         class Surface;
 
         class Query;
+        class ModelContext;
+        class QueryContext;
+        class FootprintIndex;
 
         class HDF5;
+        class HDF5Dataset;
+        class IOProfile;
         class Hyperslab;
     } // serial
 } // geomodelgrids
@@ -0,0 +1,218 @@
+#include <portinfo>
+
+#include "CRSInterpolator.hh" // implementation of class methods
+
+#include "CRSTransformer.hh" // USES CRSTransformer
+
+#include <cmath> // USES std::isfinite(), fabs(), floor(), HUGE_VAL
+#include <algorithm> // USES std::min(), std::max(), std::fill(), std::copy()
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::utils::CRSInterpolator::CRSInterpolator(void) :
+    _maxError(0.0),
+    _numCells(0) {
+    std::fill(_domain, _domain+6, 0.0);
+    _zSlope[0] = 0.0;
+    _zSlope[1] = 0.0;
+    _zSlope[2] = 1.0;
+    _cellSize[0] = 0.0;
+    _cellSize[1] = 0.0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::utils::CRSInterpolator::~CRSInterpolator(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Build interpolation grid.
+bool
+geomodelgrids::utils::CRSInterpolator::initialize(geomodelgrids::utils::CRSTransformer* transformer,
+                                                  const double srcDomain[6],
+                                                  const double tolerance,
+                                                  const size_t maxNumCells) {
+    assert(transformer);
+    assert(srcDomain);
+
+    _values.clear();
+    _numCells = 0;
+    _maxError = HUGE_VAL;
+    std::copy(srcDomain, srcDomain+6, _domain);
+    if (!(_domain[1] > _domain[0]) || !(_domain[3] > _domain[2]) || !(_domain[5] > _domain[4]) ||
+        !(tolerance > 0.0)) {
+        return false;
+    } // if
+
+    // Destination coordinates vary linearly with source z with the same slope everywhere in the
+    // domain (checked with the interpolation error).
+    const double xCenter = 0.5 * (_domain[0] + _domain[1]);
+    const double yCenter = 0.5 * (_domain[2] + _domain[3]);
+    double xyzBottom[3] = { 0.0, 0.0, 0.0 };
+    double xyzTop[3] = { 0.0, 0.0, 0.0 };
+    transformer->transform(&xyzBottom[0], &xyzBottom[1], &xyzBottom[2], xCenter, yCenter, _domain[4]);
+    transformer->transform(&xyzTop[0], &xyzTop[1], &xyzTop[2], xCenter, yCenter, _domain[5]);
+    for (size_t i = 0; i < 3; ++i) {
+        _zSlope[i] = (xyzTop[i] - xyzBottom[i]) / (_domain[5] - _domain[4]);
+        if (!std::isfinite(_zSlope[i])) {
+            return false;
+        } // if
+    } // for
+
+    // The error is only measured at sample points, so require the measured error to be within half
+    // the tolerance to leave a margin for larger errors between the sample points.
+    const double maxErrorAllowed = 0.5 * tolerance;
+    for (size_t numCells = 8; numCells <= maxNumCells; numCells *= 2) {
+        _numCells = numCells;
+        _cellSize[0] = (_domain[1] - _domain[0]) / numCells;
+        _cellSize[1] = (_domain[3] - _domain[2]) / numCells;
+
+        const size_t numNodes = (numCells+1) * (numCells+1);
+        _values.resize(3*numNodes);
+        for (size_t iy = 0, iNode = 0; iy <= numCells; ++iy) {
+            for (size_t ix = 0; ix <= numCells; ++ix, ++iNode) {
+                _values[3*iNode+0] = _domain[0] + ix*_cellSize[0];
+                _values[3*iNode+1] = _domain[2] + iy*_cellSize[1];
+                _values[3*iNode+2] = 0.0;
+            } // for
+        } // for
+        transformer->transformMany(&_values[0], &_values[0], numNodes);
+        for (size_t i = 0; i < _values.size(); ++i) {
+            if (!std::isfinite(_values[i])) {
+                _values.clear();
+                _numCells = 0;
+                return false;
+            } // if
+        } // for
+
+        _maxError = _computeMaxError(transformer, maxErrorAllowed);
+        if (_maxError <= maxErrorAllowed) {
+            return true;
+        } // if
+    } // for
+
+    _values.clear();
+    _numCells = 0;
+    return false;
+} // initialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of cells along each dimension of grid.
+size_t
+geomodelgrids::utils::CRSInterpolator::getNumCells(void) const {
+    return _numCells;
+} // getNumCells
+
+
+// ------------------------------------------------------------------------------------------------
+// Get maximum interpolation error measured when building grid.
+double
+geomodelgrids::utils::CRSInterpolator::getMaxError(void) const {
+    return _maxError;
+} // getMaxError
+
+
+// ------------------------------------------------------------------------------------------------
+// Transform coordinates from source to destination coordinate system.
+bool
+geomodelgrids::utils::CRSInterpolator::transform(double* destX,
+                                                 double* destY,
+                                                 double* destZ,
+                                                 const double srcX,
+                                                 const double srcY,
+                                                 const double srcZ) const {
+    assert(destX);
+    assert(destY);
+
+    if (!_numCells) {
+        return false;
+    } // if
+    const double xRel = (srcX - _domain[0]) / _cellSize[0];
+    const double yRel = (srcY - _domain[2]) / _cellSize[1];
+    if (!(xRel >= 0.0) || !(yRel >= 0.0) || (xRel > double(_numCells)) || (yRel > double(_numCells)) ||
+        !(srcZ >= _domain[4]) || !(srcZ <= _domain[5])) {
+        return false;
+    } // if
+
+    const size_t ix = std::min(size_t(floor(xRel)), _numCells-1);
+    const size_t iy = std::min(size_t(floor(yRel)), _numCells-1);
+    const double wx = xRel - ix;
+    const double wy = yRel - iy;
+    const double w00 = (1.0 - wx) * (1.0 - wy);
+    const double w10 = wx * (1.0 - wy);
+    const double w01 = (1.0 - wx) * wy;
+    const double w11 = wx * wy;
+
+    const size_t numNodesX = _numCells + 1;
+    const double* v00 = &_values[3*(iy*numNodesX+ix)];
+    const double* v10 = v00 + 3;
+    const double* v01 = v00 + 3*numNodesX;
+    const double* v11 = v01 + 3;
+    *destX = w00*v00[0] + w10*v10[0] + w01*v01[0] + w11*v11[0] + _zSlope[0]*srcZ;
+    *destY = w00*v00[1] + w10*v10[1] + w01*v01[1] + w11*v11[1] + _zSlope[1]*srcZ;
+    if (destZ) {
+        *destZ = w00*v00[2] + w10*v10[2] + w01*v01[2] + w11*v11[2] + _zSlope[2]*srcZ;
+    } // if
+
+    return true;
+} // transform
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute maximum interpolation error at quarter points of cells.
+double
+geomodelgrids::utils::CRSInterpolator::_computeMaxError(geomodelgrids::utils::CRSTransformer* transformer,
+                                                        const double maxErrorAllowed) const {
+    assert(transformer);
+
+    // Points on grid with a quarter of the cell size that are not grid nodes, processed one row at a
+    // time. These include the cell centers and midpoints of cell edges, where the error of bilinear
+    // interpolation of a smooth transformation is largest, and points in between that catch errors
+    // that are not symmetric within a cell. Alternate between bottom and top of domain to check
+    // variation with source z.
+    const size_t numQuarterNodes = 4*_numCells + 1;
+    std::vector<double> srcXYZ(3*numQuarterNodes);
+    std::vector<double> destXYZ(3*numQuarterNodes);
+    double maxError = 0.0;
+    for (size_t iy = 0; iy < numQuarterNodes; ++iy) {
+        const double y = std::min(_domain[2] + 0.25*iy*_cellSize[1], _domain[3]);
+        size_t numPoints = 0;
+        for (size_t ix = 0; ix < numQuarterNodes; ++ix) {
+            if (!(ix % 4) && !(iy % 4)) {
+                continue;
+            } // if
+            srcXYZ[3*numPoints+0] = std::min(_domain[0] + 0.25*ix*_cellSize[0], _domain[1]);
+            srcXYZ[3*numPoints+1] = y;
+            srcXYZ[3*numPoints+2] = ((ix + iy) % 2) ? _domain[5] : _domain[4];
+            ++numPoints;
+        } // for
+        transformer->transformMany(&destXYZ[0], &srcXYZ[0], numPoints);
+
+        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+            const double* src = &srcXYZ[3*iPoint];
+            const double* dest = &destXYZ[3*iPoint];
+            double xyz[3] = { 0.0, 0.0, 0.0 };
+            transform(&xyz[0], &xyz[1], &xyz[2], src[0], src[1], src[2]);
+            for (size_t i = 0; i < 3; ++i) {
+                const double error = fabs(xyz[i] - dest[i]);
+                if (!std::isfinite(error)) {
+                    return HUGE_VAL;
+                } // if
+                maxError = std::max(maxError, error);
+            } // for
+        } // for
+
+        // Grid will be refined, so the rest of the points do not need to be checked.
+        if (maxError > maxErrorAllowed) {
+            break;
+        } // if
+    } // for
+
+    return maxError;
+} // _computeMaxError
+
+
+// End of file
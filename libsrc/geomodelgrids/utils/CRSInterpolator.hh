@@ -0,0 +1,107 @@
+/** Approximate CRS transformation using bilinear interpolation on a grid of exact transformations.
+ *
+ * The grid is uniform in the source CRS and covers a domain. Its resolution is doubled until the
+ * interpolation error, measured against the exact transformation at the quarter points of every
+ * cell (including the cell centers and midpoints of cell edges, where the error of bilinear
+ * interpolation is largest), is within half of the tolerance. The margin of a factor of two covers
+ * larger errors between the sample points. The grid holds the destination coordinates at zero source z; variation with source
+ * z (for example, from datum transformations) is represented by a constant slope. Points outside
+ * the domain are not transformed, so the caller can fall back to the exact transformation.
+ */
+
+#if !defined(geomodelgrids_utils_crsinterpolator_hh)
+#define geomodelgrids_utils_crsinterpolator_hh
+
+#include "utilsfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <cstddef> // USES size_t
+
+class geomodelgrids::utils::CRSInterpolator {
+    friend class TestCRSInterpolator; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    CRSInterpolator(void);
+
+    /// Destructor
+    ~CRSInterpolator(void);
+
+    /** Build interpolation grid.
+     *
+     * @param[in] transformer Exact CRS transformation (initialized).
+     * @param[in] srcDomain Bounding box of domain in source CRS [xmin, xmax, ymin, ymax, zmin, zmax].
+     * @param[in] tolerance Maximum interpolation error (destination CRS units); the error measured at
+     *     the sample points must be within half of the tolerance.
+     * @param[in] maxNumCells Maximum number of cells along each dimension of grid.
+     * @returns True if the tolerance is met, false otherwise (grid is empty).
+     */
+    bool initialize(CRSTransformer* transformer,
+                    const double srcDomain[6],
+                    const double tolerance,
+                    const size_t maxNumCells=1024);
+
+    /** Get number of cells along each dimension of grid.
+     *
+     * @returns Number of cells (0 if grid is empty).
+     */
+    size_t getNumCells(void) const;
+
+    /** Get maximum interpolation error measured when building grid.
+     *
+     * @returns Maximum error (destination CRS units).
+     */
+    double getMaxError(void) const;
+
+    /** Transform coordinates from source to destination coordinate system.
+     *
+     * @param[out] destX X coordinate in destination coordinate system.
+     * @param[out] destY Y coordinate in destination coordinate system.
+     * @param[out] destZ Z coordinate in destination coordinate system (can be nullptr).
+     * @param[in] srcX X coordinate in source coordinate system.
+     * @param[in] srcY Y coordinate in source coordinate system.
+     * @param[in] srcZ Z coordinate in source coordinate system.
+     * @returns True if point is inside the domain and was transformed, false otherwise.
+     */
+    bool transform(double* destX,
+                   double* destY,
+                   double* destZ,
+                   const double srcX,
+                   const double srcY,
+                   const double srcZ) const;
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Compute maximum interpolation error at quarter points of cells.
+     *
+     * @param[in] transformer Exact CRS transformation.
+     * @param[in] maxErrorAllowed Maximum error allowed; stop checking points once it is exceeded.
+     * @returns Maximum error (infinite if exact transformation fails).
+     */
+    double _computeMaxError(CRSTransformer* transformer,
+                            const double maxErrorAllowed) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<double> _values; ///< Destination x, y, and z (at zero source z) at grid nodes [numNodes*3].
+    double _domain[6]; ///< Bounding box of grid in source CRS [xmin, xmax, ymin, ymax, zmin, zmax].
+    double _cellSize[2]; ///< Size of cells along each dimension of grid.
+    double _zSlope[3]; ///< Derivatives of destination x, y, and z with respect to source z.
+    double _maxError; ///< Maximum interpolation error measured when building grid.
+    size_t _numCells; ///< Number of cells along each dimension of grid.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    CRSInterpolator(const CRSInterpolator&); ///< Not implemented
+    const CRSInterpolator& operator=(const CRSInterpolator&); ///< Not implemented
+
+}; // CRSInterpolator
+
+#endif // geomodelgrids_utils_crsinterpolator_hh
+
+// End of file
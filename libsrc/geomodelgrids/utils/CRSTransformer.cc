@@ -2,10 +2,13 @@
 
 #include "CRSTransformer.hh" // implementation of class methods
 
-#include <cmath> // USES HUGE_VAL
+#include <cmath> // USES HUGE_VAL, std::isfinite(), fabs()
+#include <stdexcept> // USES std::runtime_error, std::logic_error
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
 #include <cstring> // USES strlen()
+#include <algorithm> // USES std::copy(), std::max()
+#include <vector> // USES std::vector
 #include <strings.h> // USES stdcasecmp()
 
 namespace geomodelgrids {
@@ -34,7 +37,8 @@ public:
 geomodelgrids::utils::CRSTransformer::CRSTransformer(void) :
     _srcString("EPSG:4326"), // latitude/longitude WGS84
     _destString("EPSG:3488"), // NAD83(HARN) California Albers
-    _proj(nullptr) {}
+    _proj(nullptr),
+    _context(nullptr) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -43,6 +47,9 @@ geomodelgrids::utils::CRSTransformer::~CRSTransformer(void) {
     if (_proj) {
         proj_destroy(_proj);_proj = nullptr;
     } // if
+    if (_context) {
+        proj_context_destroy(_context);_context = nullptr;
+    } // if
 } // destructor
 
 
@@ -80,6 +87,31 @@ geomodelgrids::utils::CRSTransformer::initialize(void) {
 } // initialize
 
 
+// ------------------------------------------------------------------------------------------------
+// Create copy of initialized transformer for use in another thread.
+geomodelgrids::utils::CRSTransformer*
+geomodelgrids::utils::CRSTransformer::clone(void) const {
+    if (!_proj) {
+        throw std::logic_error("Cannot clone CRS transformer before it is initialized.");
+    } // if
+
+    CRSTransformer* transformer = new CRSTransformer();
+    transformer->_srcString = _srcString;
+    transformer->_destString = _destString;
+    transformer->_context = proj_context_create();
+    transformer->_proj = proj_clone(transformer->_context, _proj);
+    if (!transformer->_proj) {
+        std::stringstream msg;
+        msg << "Error cloning CRS transformation from '" << _srcString << "' to '" << _destString << "'.\n"
+            << proj_errno_string(proj_context_errno(transformer->_context));
+        delete transformer;transformer = nullptr;
+        throw std::runtime_error(msg.str());
+    } // if
+
+    return transformer;
+} // clone
+
+
 // ------------------------------------------------------------------------------------------------
 // Compute from src CRS to dest CRS.
 void
@@ -102,6 +134,31 @@ geomodelgrids::utils::CRSTransformer::transform(double* destX,
 } // transform
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute from src CRS to dest CRS for array of points.
+void
+geomodelgrids::utils::CRSTransformer::transformMany(double* const destXYZ,
+                                                    const double* const srcXYZ,
+                                                    const size_t numPoints) {
+    assert(_proj);
+    if (!numPoints) { return; }
+    assert(destXYZ);
+    assert(srcXYZ);
+
+    if (destXYZ != srcXYZ) {
+        std::copy(srcXYZ, srcXYZ+3*numPoints, destXYZ);
+    } // if
+
+    // Transform in place using strided access into the array of points.
+    const size_t stride = 3*sizeof(double);
+    proj_trans_generic(_proj, PJ_FWD,
+                       &destXYZ[0], stride, numPoints,
+                       &destXYZ[1], stride, numPoints,
+                       &destXYZ[2], stride, numPoints,
+                       nullptr, 0, 0);
+} // transformMany
+
+
 // ------------------------------------------------------------------------------------------------
 // Compute from src CRS to dest CRS.
 void
@@ -124,6 +181,183 @@ geomodelgrids::utils::CRSTransformer::inverse_transform(double* srcX,
 } // transform
 
 
+// ------------------------------------------------------------------------------------------------
+// Compute affine transformation equivalent to the CRS transformation over a domain.
+bool
+geomodelgrids::utils::CRSTransformer::computeAffine(double coefsXY[6],
+                                                    double coefsZ[2],
+                                                    const double destDomain[6]) {
+    assert(coefsXY);
+    assert(coefsZ);
+    assert(destDomain);
+
+    if (_srcString == _destString) {
+        const double identityXY[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+        std::copy(identityXY, identityXY+6, coefsXY);
+        coefsZ[0] = 0.0;
+        coefsZ[1] = 1.0;
+        return true;
+    } // if
+    assert(_proj);
+
+    const double dx = destDomain[1] - destDomain[0];
+    const double dy = destDomain[3] - destDomain[2];
+    const double dz = destDomain[5] - destDomain[4];
+    if (!(dx > 0.0) || !(dy > 0.0) || !(dz > 0.0)) {
+        return false;
+    } // if
+
+    // Map grid of points over domain, with top and bottom layers, from destination to source CRS.
+    const size_t numSamples = 5;
+    const size_t numPoints = 2*numSamples*numSamples;
+    std::vector<double> srcXYZ(3*numPoints);
+    std::vector<double> destXYZ(3*numPoints);
+    for (size_t iZ = 0, iPoint = 0; iZ < 2; ++iZ) {
+        for (size_t iY = 0; iY < numSamples; ++iY) {
+            for (size_t iX = 0; iX < numSamples; ++iX, ++iPoint) {
+                double* dest = &destXYZ[3*iPoint];
+                double* src = &srcXYZ[3*iPoint];
+                dest[0] = destDomain[0] + dx * iX / (numSamples-1);
+                dest[1] = destDomain[2] + dy * iY / (numSamples-1);
+                dest[2] = destDomain[4] + dz * iZ;
+                inverse_transform(&src[0], &src[1], &src[2], dest[0], dest[1], dest[2]);
+                if (!std::isfinite(src[0]) || !std::isfinite(src[1]) || !std::isfinite(src[2])) {
+                    return false;
+                } // if
+            } // for
+        } // for
+    } // for
+
+    // Fit horizontal coefficients using corners (xmin, ymin), (xmax, ymin), (xmin, ymax) of bottom
+    // layer and vertical coefficients using (xmin, ymin) of bottom and top layers.
+    const double* src0 = &srcXYZ[0];
+    const double* src1 = &srcXYZ[3*(numSamples-1)];
+    const double* src2 = &srcXYZ[3*numSamples*(numSamples-1)];
+    const double* srcTop = &srcXYZ[3*numSamples*numSamples];
+    const double* dest0 = &destXYZ[0];
+    const double* dest1 = &destXYZ[3*(numSamples-1)];
+    const double* dest2 = &destXYZ[3*numSamples*(numSamples-1)];
+    const double* destTop = &destXYZ[3*numSamples*numSamples];
+
+    const double ds1[2] = { src1[0] - src0[0], src1[1] - src0[1] };
+    const double ds2[2] = { src2[0] - src0[0], src2[1] - src0[1] };
+    const double det = ds1[0]*ds2[1] - ds2[0]*ds1[1];
+    const double dsZ = srcTop[2] - src0[2];
+    if ((det == 0.0) || (dsZ == 0.0)) {
+        return false;
+    } // if
+    for (size_t i = 0; i < 2; ++i) {
+        const double dd1 = dest1[i] - dest0[i];
+        const double dd2 = dest2[i] - dest0[i];
+        coefsXY[3*i+1] = (dd1*ds2[1] - dd2*ds1[1]) / det;
+        coefsXY[3*i+2] = (ds1[0]*dd2 - ds2[0]*dd1) / det;
+        coefsXY[3*i+0] = dest0[i] - coefsXY[3*i+1]*src0[0] - coefsXY[3*i+2]*src0[1];
+    } // for
+    coefsZ[1] = (destTop[2] - dest0[2]) / dsZ;
+    coefsZ[0] = dest0[2] - coefsZ[1]*src0[2];
+
+    // Verify affine transformation reproduces the CRS transformation at all points.
+    std::vector<double> checkXYZ(3*numPoints);
+    transformMany(&checkXYZ[0], &srcXYZ[0], numPoints);
+    const double toleranceXY = 1.0e-9 * std::max(dx, dy);
+    const double toleranceZ = 1.0e-9 * dz;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double* src = &srcXYZ[3*iPoint];
+        const double* check = &checkXYZ[3*iPoint];
+        const double x = coefsXY[0] + coefsXY[1]*src[0] + coefsXY[2]*src[1];
+        const double y = coefsXY[3] + coefsXY[4]*src[0] + coefsXY[5]*src[1];
+        const double z = coefsZ[0] + coefsZ[1]*src[2];
+        if (!(fabs(x - check[0]) <= toleranceXY) || !(fabs(y - check[1]) <= toleranceXY) ||
+            !(fabs(z - check[2]) <= toleranceZ)) {
+            return false;
+        } // if
+    } // for
+
+    return true;
+} // computeAffine
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute affine vertical transformation when horizontal coordinates do not depend on elevation.
+bool
+geomodelgrids::utils::CRSTransformer::computeAffineZ(double coefsZ[2],
+                                                     const double destDomain[6]) {
+    assert(coefsZ);
+    assert(destDomain);
+
+    if (_srcString == _destString) {
+        coefsZ[0] = 0.0;
+        coefsZ[1] = 1.0;
+        return true;
+    } // if
+    assert(_proj);
+
+    const double dx = destDomain[1] - destDomain[0];
+    const double dy = destDomain[3] - destDomain[2];
+    const double dz = destDomain[5] - destDomain[4];
+    if (!(dx > 0.0) || !(dy > 0.0) || !(dz > 0.0)) {
+        return false;
+    } // if
+
+    // Fit vertical coefficients using bottom and top of domain at (xmin, ymin).
+    double src0[3];
+    double srcTop[3];
+    inverse_transform(&src0[0], &src0[1], &src0[2], destDomain[0], destDomain[2], destDomain[4]);
+    inverse_transform(&srcTop[0], &srcTop[1], &srcTop[2], destDomain[0], destDomain[2], destDomain[5]);
+    const double dsZ = srcTop[2] - src0[2];
+    if (!std::isfinite(src0[2]) || !std::isfinite(srcTop[2]) || !(dsZ != 0.0)) {
+        return false;
+    } // if
+    coefsZ[1] = dz / dsZ;
+    coefsZ[0] = destDomain[4] - coefsZ[1]*src0[2];
+
+    // Map grid of points over domain from destination to source CRS, and transform each horizontal
+    // location back at the source elevations of the bottom and top of the domain.
+    const size_t numSamples = 5;
+    const size_t numPoints = 2*numSamples*numSamples;
+    std::vector<double> srcXYZ(3*numPoints);
+    std::vector<double> destXY(2*numSamples*numSamples);
+    for (size_t iY = 0, iPoint = 0; iY < numSamples; ++iY) {
+        for (size_t iX = 0; iX < numSamples; ++iX, ++iPoint) {
+            double* dest = &destXY[2*iPoint];
+            dest[0] = destDomain[0] + dx * iX / (numSamples-1);
+            dest[1] = destDomain[2] + dy * iY / (numSamples-1);
+            double srcX = 0.0;
+            double srcY = 0.0;
+            inverse_transform(&srcX, &srcY, nullptr, dest[0], dest[1], destDomain[4]);
+            if (!std::isfinite(srcX) || !std::isfinite(srcY)) {
+                return false;
+            } // if
+            for (size_t iZ = 0; iZ < 2; ++iZ) {
+                double* src = &srcXYZ[3*(iZ*numSamples*numSamples+iPoint)];
+                src[0] = srcX;
+                src[1] = srcY;
+                src[2] = (iZ) ? srcTop[2] : src0[2];
+            } // for
+        } // for
+    } // for
+
+    // Verify horizontal coordinates do not depend on elevation and vertical coefficients reproduce
+    // the CRS transformation at all points.
+    std::vector<double> checkXYZ(3*numPoints);
+    transformMany(&checkXYZ[0], &srcXYZ[0], numPoints);
+    const double toleranceXY = 1.0e-9 * std::max(dx, dy);
+    const double toleranceZ = 1.0e-9 * dz;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double* src = &srcXYZ[3*iPoint];
+        const double* check = &checkXYZ[3*iPoint];
+        const double* dest = &destXY[2*(iPoint % (numSamples*numSamples))];
+        const double z = coefsZ[0] + coefsZ[1]*src[2];
+        if (!(fabs(dest[0] - check[0]) <= toleranceXY) || !(fabs(dest[1] - check[1]) <= toleranceXY) ||
+            !(fabs(z - check[2]) <= toleranceZ)) {
+            return false;
+        } // if
+    } // for
+
+    return true;
+} // computeAffineZ
+
+
 // ------------------------------------------------------------------------------------------------
 // Get boundary box in x/y order from bounding box in CRS.
 geomodelgrids::utils::CRSTransformer*
@@ -41,6 +41,14 @@ public:
     /// Initialize transfomer.
     void initialize(void);
 
+    /** Create copy of initialized transformer for use in another thread.
+     *
+     * The copy uses its own PROJ context, so the original and the copy can be used concurrently.
+     *
+     * @returns Copy of transformer (caller takes ownership).
+     */
+    CRSTransformer* clone(void) const;
+
     /** Transform coordinates from source to destination coordinate system.
      *
      * @param[out] destX X coordinate in destination coordinate system.
@@ -57,6 +65,19 @@ public:
                    const double srcY,
                    const double srcZ);
 
+    /** Transform array of points from source to destination coordinate system.
+     *
+     * Points are stored in row-major order with coordinates (x, y, z) for each point. The source and
+     * destination arrays may be the same array.
+     *
+     * @param[out] destXYZ Array of coordinates in destination coordinate system [numPoints*3].
+     * @param[in] srcXYZ Array of coordinates in source coordinate system [numPoints*3].
+     * @param[in] numPoints Number of points.
+     */
+    void transformMany(double* const destXYZ,
+                       const double* const srcXYZ,
+                       const size_t numPoints);
+
     /** Transform coordinates from destination to source coordinate system.
      *
      * @param[out] srcX X coordinate in source coordinate system.
@@ -73,6 +94,44 @@ public:
                            const double destY,
                            const double destZ);
 
+    /** Compute affine transformation equivalent to the CRS transformation over a domain.
+     *
+     * The CRS transformation is affine when the source and destination CRS are identical or differ
+     * only in linear units, axis order, or a false origin. The affine coefficients are fit to the
+     * CRS transformation at corners of the domain and accepted only if they reproduce the CRS
+     * transformation at a grid of points over the domain to within 1.0e-9 of the domain size.
+     *
+     * destX = coefsXY[0] + coefsXY[1]*srcX + coefsXY[2]*srcY
+     * destY = coefsXY[3] + coefsXY[4]*srcX + coefsXY[5]*srcY
+     * destZ = coefsZ[0] + coefsZ[1]*srcZ
+     *
+     * @param[out] coefsXY Coefficients of horizontal transformation [6].
+     * @param[out] coefsZ Coefficients of vertical transformation [2].
+     * @param[in] destDomain Bounding box of domain in destination CRS [xmin, xmax, ymin, ymax, zmin, zmax].
+     * @returns True if the CRS transformation is affine over the domain, false otherwise.
+     */
+    bool computeAffine(double coefsXY[6],
+                       double coefsZ[2],
+                       const double destDomain[6]);
+
+    /** Compute affine vertical transformation when horizontal coordinates do not depend on elevation.
+     *
+     * This holds for most transformations between map projections and geographic coordinates with
+     * the same vertical datum, even though the horizontal transformation is not affine. The vertical
+     * coefficients are fit at the origin of the domain and accepted only if, at a grid of points over
+     * the domain, the CRS transformation of the bottom and top elevations gives the same horizontal
+     * coordinates and reproduces the vertical coordinate to within 1.0e-9 of the domain size.
+     *
+     * destZ = coefsZ[0] + coefsZ[1]*srcZ
+     *
+     * @param[out] coefsZ Coefficients of vertical transformation [2].
+     * @param[in] destDomain Bounding box of domain in destination CRS [xmin, xmax, ymin, ymax, zmin, zmax].
+     * @returns True if the CRS transformation is separable with an affine vertical transformation
+     * over the domain, false otherwise.
+     */
+    bool computeAffineZ(double coefsZ[2],
+                        const double destDomain[6]);
+
     /** Create CRSTransformer that transforms axis order from geo to xy order.
      *
      * @param[in] crsString CRS for coordinate system.
@@ -100,6 +159,7 @@ private:
     std::string _srcString;
     std::string _destString;
     PJ* _proj;
+    PJ_CONTEXT* _context; ///< PROJ context (nullptr for default context).
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -6,6 +6,7 @@
 #include "proj.h" // USES PJ
 
 #include <cassert>
+#include <cstring> // USES strlen()
 #include <sstream> // USES std::ostringstream
 #include <stdexcept> // USES std::runtime_error
 
@@ -17,7 +18,9 @@ geomodelgrids::utils::GeoTiff::GeoTiff(void) :
     _noDataValue(-1.0e+20),
     _numCols(0),
     _numRows(0),
-    _numBands(0) {
+    _numBands(0),
+    _tileSize(0),
+    _cloudOptimized(false) {
     GDALAllRegister();
     for (int i = 0; i < 6; ++i) {
         _transform[i] = 0.0;
@@ -27,7 +30,9 @@ geomodelgrids::utils::GeoTiff::GeoTiff(void) :
 
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::utils::GeoTiff::~GeoTiff(void) {
-    this->close();
+    try {
+        this->close();
+    } catch (...) {} // Destructor must not throw.
 }
 
 
@@ -148,7 +153,7 @@ geomodelgrids::utils::GeoTiff::getBBox(double* minX,
 
     const double _maxY = _transform[3];
     const double dy = _transform[5];
-    if (minY) { *minY = _maxY - dy * _numRows; }
+    if (minY) { *minY = _maxY + dy * _numRows; }
     if (maxY) { *maxY = _maxY; }
 }
 
@@ -160,6 +165,32 @@ geomodelgrids::utils::GeoTiff::setNoDataValue(const float value) {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::setTileSize(const size_t value) {
+    if (value % 16) {
+        std::ostringstream msg;
+        msg << "Size of tiles in image (" << value << ") must be a multiple of 16.";
+        throw std::invalid_argument(msg.str());
+    } // if
+    _tileSize = value;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+size_t
+geomodelgrids::utils::GeoTiff::getTileSize(void) const {
+    return _tileSize;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::setCloudOptimized(const bool value) {
+    _cloudOptimized = value;
+}
+
+
 // ------------------------------------------------------------------------------------------------
 float*
 geomodelgrids::utils::GeoTiff::getBands(void) {
@@ -172,14 +203,33 @@ geomodelgrids::utils::GeoTiff::getBands(void) {
 void
 geomodelgrids::utils::GeoTiff::create(const char* filename) {
     this->close();
+    if (_cloudOptimized && (_tileSize > 0) && (_tileSize < 128)) {
+        std::ostringstream msg;
+        msg << "Size of tiles in cloud optimized GeoTiff (" << _tileSize << ") must be at least 128.";
+        throw std::invalid_argument(msg.str());
+    } // if
     _driver = GetGDALDriverManager()->GetDriverByName("GTiff");
     if (!_driver) {
         throw std::runtime_error("Could not get GDAL GeoTiff driver.");
     } // if
 
+    // The COG driver only supports CreateCopy(), so a cloud optimized GeoTiff is written to a
+    // temporary tiled GeoTiff and converted when the file is closed.
+    _filename = filename;
+    _tmpFilename = (_cloudOptimized) ? _filename + ".tmp.tif" : "";
+    const size_t tileSize = (_cloudOptimized && !_tileSize) ? 512 : _tileSize;
+
     char** options = nullptr;
     options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
-    _dataset = _driver->Create(filename, _numCols, _numRows, _numBands, GDT_Float32, options);
+    options = CSLSetNameValue(options, "BIGTIFF", "IF_SAFER");
+    if (tileSize > 0) {
+        const std::string blockSize = std::to_string(tileSize);
+        options = CSLSetNameValue(options, "TILED", "YES");
+        options = CSLSetNameValue(options, "BLOCKXSIZE", blockSize.c_str());
+        options = CSLSetNameValue(options, "BLOCKYSIZE", blockSize.c_str());
+    } // if
+    const char* createFilename = (_cloudOptimized) ? _tmpFilename.c_str() : filename;
+    _dataset = _driver->Create(createFilename, _numCols, _numRows, _numBands, GDT_Float32, options);
     CSLDestroy(options);options = nullptr;
     if (!_dataset) {
         std::ostringstream msg;
@@ -216,6 +266,27 @@ geomodelgrids::utils::GeoTiff::write(void) {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::writeRows(const float* rows,
+                                         const size_t rowStart,
+                                         const size_t numRows) {
+    if (!_dataset) {
+        throw std::runtime_error("GeoTiff file must be open before writing rows of raster bands.");
+    } // if
+    if (rowStart + numRows > _numRows) {
+        std::ostringstream msg;
+        msg << "Block of rows [" << rowStart << ", " << rowStart + numRows << ") exceeds number of rows in image ("
+            << _numRows << ").";
+        throw std::out_of_range(msg.str());
+    } // if
+
+    CPLErr err = _dataset->RasterIO(GF_Write, 0, rowStart, _numCols, numRows, const_cast<float*>(rows),
+                                    _numCols, numRows, GDT_Float32, _numBands, nullptr, 0, 0, 0, nullptr);
+    if (err != CE_None) { throw std::runtime_error("Error while writing block of rows of raster bands."); }
+}
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::utils::GeoTiff::read(const char* filename) {
@@ -272,14 +343,49 @@ geomodelgrids::utils::GeoTiff::read(const char* filename) {
 void
 geomodelgrids::utils::GeoTiff::close(void) {
     delete[] _buffer;_buffer = nullptr;
+    std::string errorMsg;
     if (_dataset) {
         GDALClose(_dataset);
         _dataset = nullptr;
     } // if
+    if (!_tmpFilename.empty()) {
+        const std::string tmpFilename = _tmpFilename;
+        _tmpFilename = "";
+
+        GDALDataset* tmpDataset = (GDALDataset*) GDALOpen(tmpFilename.c_str(), GA_ReadOnly);
+        GDALDriver* cogDriver = GetGDALDriverManager()->GetDriverByName("COG");
+        bool converted = false;
+        if (tmpDataset && cogDriver) {
+            const std::string blockSize = std::to_string((_tileSize > 0) ? _tileSize : 512);
+            char** options = nullptr;
+            options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
+            options = CSLSetNameValue(options, "BIGTIFF", "IF_SAFER");
+            options = CSLSetNameValue(options, "RESAMPLING", "AVERAGE");
+            options = CSLSetNameValue(options, "BLOCKSIZE", blockSize.c_str());
+            GDALDataset* cogDataset = cogDriver->CreateCopy(_filename.c_str(), tmpDataset, FALSE, options, nullptr, nullptr);
+            CSLDestroy(options);options = nullptr;
+            if (cogDataset) {
+                GDALClose(cogDataset);cogDataset = nullptr;
+                converted = true;
+            } // if
+        } // if
+        if (tmpDataset) {
+            GDALClose(tmpDataset);tmpDataset = nullptr;
+        } // if
+        VSIUnlink(tmpFilename.c_str());
+        if (!cogDriver) {
+            errorMsg = "Could not get GDAL cloud optimized GeoTiff driver (requires GDAL 3.1 or later).";
+        } else if (!converted) {
+            errorMsg = "Could not write cloud optimized GeoTiff file '" + _filename + "'.";
+        } // if/else
+    } // if
     if (_driver) {
         GDALDestroyDriverManager();
         _driver = nullptr;
     } // if
+    if (!errorMsg.empty()) {
+        throw std::runtime_error(errorMsg);
+    } // if
 }
 
 
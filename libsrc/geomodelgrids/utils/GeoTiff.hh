@@ -120,6 +120,27 @@ public:
      */
     void setNoDataValue(const float value);
 
+    /** Set size of tiles in image.
+     *
+     * @param[in] value Width and height of square tiles (multiple of 16); 0 for strips.
+     */
+    void setTileSize(const size_t value);
+
+    /** Get size of tiles in image.
+     *
+     * @returns Width and height of square tiles; 0 for strips.
+     */
+    size_t getTileSize(void) const;
+
+    /** Set whether to write a cloud optimized GeoTiff (COG) with overviews.
+     *
+     * The image is written to a temporary tiled GeoTiff file and converted to a COG when the file
+     * is closed. The GDAL COG driver requires tiles of at least 128x128 (default is 512x512).
+     *
+     * @param[in] value True to write a cloud optimized GeoTiff, false otherwise.
+     */
+    void setCloudOptimized(const bool value);
+
     /** Get buffer for raster bands.
      *
      * Image data is pixel sequential [row, column, band].
@@ -139,13 +160,30 @@ public:
     /// Write data to file.
     void write(void);
 
+    /** Write block of rows to file.
+     *
+     * Image data is band sequential [band, row, column].
+     *
+     * @pre Must have opened file using create().
+     *
+     * @param[in] rows Image data for block of rows [numBands*numRows*numCols].
+     * @param[in] rowStart Index of first row in block.
+     * @param[in] numRows Number of rows in block.
+     */
+    void writeRows(const float* rows,
+                   const size_t rowStart,
+                   const size_t numRows);
+
     /** Read data from file.
      *
      * @param[in] filename Name of image file.
      */
     void read(const char* filename);
 
-    /// Close file.
+    /** Close file.
+     *
+     * If writing a cloud optimized GeoTiff, convert the temporary file to the output file.
+     */
     void close(void);
 
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
@@ -158,8 +196,12 @@ private:
     size_t _numCols; ///< Number of columns in image.
     size_t _numRows; ///< Number of rows in image.
     size_t _numBands; ///< Number of raster bands.
+    size_t _tileSize; ///< Width and height of tiles (0 for strips).
+    bool _cloudOptimized; ///< Write cloud optimized GeoTiff.
     std::vector<std::string> _bandLabels; ///< Labels of raster bands.
     std::string _crs; ///< CRS for image data.
+    std::string _filename; ///< Name of output file.
+    std::string _tmpFilename; ///< Name of temporary file for cloud optimized GeoTiff.
     double _transform[6]; ///< Geographic transformation.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
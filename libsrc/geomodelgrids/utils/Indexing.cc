@@ -2,7 +2,8 @@
 
 #include "Indexing.hh" // implementation of class methods
 
-#include <algorithm> // USES std::sort()
+#include <algorithm> // USES std::sort(), std::min(), std::max()
+#include <cmath> // USES ceil()
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
 
@@ -25,19 +26,16 @@ geomodelgrids::utils::IndexingUniform::IndexingUniform(const double dx) :
 }
 
 
-// ------------------------------------------------------------------------------------------------
-double
-geomodelgrids::utils::IndexingUniform::getIndex(const double x) const {
-    assert(_dx > 0.0);
-    return x / _dx;
-}
-
-
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::utils::IndexingVariable::IndexingVariable(const double* x,
                                                          const size_t numX,
                                                          SortOrder sortOrder) :
-    _numX(numX) {
+    _x(nullptr),
+    _distance(nullptr),
+    _buckets(nullptr),
+    _numX(numX),
+    _numBuckets(0),
+    _bucketScale(0.0) {
     if (!x) {
         std::ostringstream msg;
         msg << "nullptr coordinates array for variable resolution indexing.";
@@ -60,45 +58,44 @@ geomodelgrids::utils::IndexingVariable::IndexingVariable(const double* x,
     } else {
         std::sort(_x, _x + _numX, greater);
     } // if/else
-}
 
+    _distance = new double[_numX];
+    double minSpacing = 0.0;
+    for (size_t i = 0; i < _numX; ++i) {
+        _distance[i] = (ASCENDING == _order) ? _x[i] - _x[0] : _x[0] - _x[i];
+        const double spacing = (i > 0) ? _distance[i] - _distance[i-1] : 0.0;
+        if ((spacing > 0.0) && ((minSpacing <= 0.0) || (spacing < minSpacing))) {
+            minSpacing = spacing;
+        } // if
+    } // for
 
-// ------------------------------------------------------------------------------------------------
-geomodelgrids::utils::IndexingVariable::~IndexingVariable(void) {
-    delete[] _x;_x = nullptr;
+    // Buckets no wider than the smallest spacing, limited to maxBucketsPerCoordinate per coordinate.
+    const size_t maxBucketsPerCoordinate = 16;
+    const double length = _distance[_numX-1];
+    _numBuckets = _numX;
+    if ((length > 0.0) && (minSpacing > 0.0)) {
+        const double numBucketsSpacing = ceil(length / minSpacing);
+        _numBuckets = size_t(std::min(numBucketsSpacing, double(maxBucketsPerCoordinate*_numX)));
+        _numBuckets = std::max(_numBuckets, _numX);
+    } // if
+    _bucketScale = (length > 0.0) ? double(_numBuckets) / length : 0.0;
+
+    _buckets = new size_t[_numBuckets];
+    size_t indexL = 0;
+    for (size_t iBucket = 0; iBucket < _numBuckets; ++iBucket) {
+        while ((indexL+2 < _numX) && (_distance[indexL+1]*_bucketScale <= double(iBucket))) {
+            ++indexL;
+        } // while
+        _buckets[iBucket] = indexL;
+    } // for
 }
 
 
 // ------------------------------------------------------------------------------------------------
-double
-geomodelgrids::utils::IndexingVariable::getIndex(const double x) const {
-    assert(_x);
-
-    double index = -1.0;
-    size_t indexL = 0;
-    size_t indexR = _numX - 1;
-    const double xN = (_order == ASCENDING) ? _x[0] + x : _x[0] - x;
-    const double tolerance = 1.0e-6;
-    assert((ASCENDING == _order && (xN >= _x[indexL]-tolerance) && (xN <= _x[indexR]+tolerance)) ||
-           (DESCENDING == _order && (xN <= _x[indexL]+tolerance) && (xN >= _x[indexR]-tolerance)));
-
-    typedef bool (*cmp_fn)(const double,
-                           const double);
-    cmp_fn compare = (ASCENDING == _order) ? less : greater;
-
-    while (indexR - indexL > 1) {
-        size_t indexM = indexL + (indexR-indexL) / 2;
-        if (compare(xN, _x[indexM])) {
-            indexR = indexM;
-        } else {
-            indexL = indexM;
-        } // if/else
-    } // while
-    assert((ASCENDING == _order && xN >= _x[indexL]-tolerance && _x[indexR] > _x[indexL]) ||
-           (DESCENDING == _order && xN <= _x[indexL]+tolerance && _x[indexR] <= _x[indexL]));
-
-    index = double(indexL) + (xN - _x[indexL]) / (_x[indexR] - _x[indexL]);
-    return index;
+geomodelgrids::utils::IndexingVariable::~IndexingVariable(void) {
+    delete[] _x;_x = nullptr;
+    delete[] _distance;_distance = nullptr;
+    delete[] _buckets;_buckets = nullptr;
 }
 
 
@@ -7,6 +7,7 @@
 #include "utilsfwd.hh" // forward declarations
 
 #include <cstddef> // USES size_t
+#include <cassert> // USES assert()
 
 class geomodelgrids::utils::Indexing {
     // PUBLIC METHODS -----------------------------------------------------------------------------
@@ -34,7 +35,7 @@ private:
 
 }; // Indexing
 
-class geomodelgrids::utils::IndexingUniform : public Indexing {
+class geomodelgrids::utils::IndexingUniform final : public Indexing {
     // PUBLIC METHODS -----------------------------------------------------------------------------
 public:
 
@@ -48,7 +49,8 @@ public:
      *
      * @param[in] x Distance along coordinate axis from beginning.
      */
-    double getIndex(const double x) const;
+    inline
+    double getIndex(const double x) const override;
 
     // PRIVATE ------------------------------------------------------------------------------------
 private:
@@ -63,7 +65,14 @@ private:
 
 }; // IndexingUniform
 
-class geomodelgrids::utils::IndexingVariable : public Indexing {
+/** Indexing for variable resolution along a coordinate axis.
+ *
+ * The constructor builds a table of uniform buckets over the extent of the axis. Each bucket holds
+ * the interval containing the start of the bucket. Buckets are no wider than the smallest spacing
+ * between coordinates (up to a limit on the number of buckets), so a lookup checks at most one
+ * additional interval.
+ */
+class geomodelgrids::utils::IndexingVariable final : public Indexing {
     // PUBLIC ENUMS -------------------------------------------------------------------------------
 public:
 
@@ -92,7 +101,8 @@ public:
      *
      * @param[in] x Distance along coordinate axis from beginning.
      */
-    double getIndex(const double x) const;
+    inline
+    double getIndex(const double x) const override;
 
     inline static
     bool less(const double x,
@@ -110,7 +120,11 @@ public:
 private:
 
     double* _x; ///< Coordinates along axis.
+    double* _distance; ///< Distance of coordinates along axis from beginning (ascending).
+    size_t* _buckets; ///< Index of interval containing start of each bucket.
     const size_t _numX; ///< Number of coordinates along axis.
+    size_t _numBuckets; ///< Number of buckets.
+    double _bucketScale; ///< Number of buckets per unit distance along axis.
     SortOrder _order; ///< Order of coordinates.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
@@ -121,6 +135,40 @@ private:
 
 }; // IndexingVariable
 
+// ------------------------------------------------------------------------------------------------
+// Get index for uniform resolution.
+inline
+double
+geomodelgrids::utils::IndexingUniform::getIndex(const double x) const {
+    assert(_dx > 0.0);
+    return x / _dx;
+} // getIndex
+
+
+// ------------------------------------------------------------------------------------------------
+// Get index for variable resolution.
+inline
+double
+geomodelgrids::utils::IndexingVariable::getIndex(const double x) const {
+    assert(_distance);
+    assert(_buckets);
+    assert((x >= -1.0e-6) && (x <= _distance[_numX-1]+1.0e-6));
+
+    const double bucket = x * _bucketScale;
+    const size_t iBucket = (bucket > 0.0) ? ((bucket < double(_numBuckets)) ? size_t(bucket) : _numBuckets-1) : 0;
+    size_t indexL = _buckets[iBucket];
+    while ((indexL+2 < _numX) && (x >= _distance[indexL+1])) {
+        ++indexL;
+    } // while
+    while ((indexL > 0) && (x < _distance[indexL])) { // Guard against roundoff in bucket start.
+        --indexL;
+    } // while
+    const size_t indexR = (indexL+1 < _numX) ? indexL+1 : indexL;
+
+    return double(indexL) + (x - _distance[indexL]) / (_distance[indexR] - _distance[indexL]);
+} // getIndex
+
+
 #endif // geomodelgrids_utils_indexing_hh
 
 // End of file
@@ -4,6 +4,7 @@
 namespace geomodelgrids {
     namespace utils {
         class CRSTransformer;
+        class CRSInterpolator;
         class GeoTiff;
         class LineSearch;
 
@@ -4,9 +4,19 @@
 namespace py = pybind11;
 
 #include "geomodelgrids/serial/Query.hh"
+#include "geomodelgrids/serial/QueryContext.hh"
+#include "geomodelgrids/serial/IOProfile.hh"
 #include "geomodelgrids/utils/ErrorHandler.hh"
 #include "geomodelgrids/utils/constants.hh"
 
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 namespace geomodelgrids {
     class PyQuery;
 }
@@ -23,7 +33,31 @@ public:
 
 
     inline
-    py::array_t<double> query_top_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
+    void initialize(const std::vector<std::string>& modelFilenames,
+                    const std::vector<std::string>& valueNames,
+                    const std::string& inputCRSString) {
+        _clearContexts();
+        geomodelgrids::serial::Query::initialize(modelFilenames, valueNames, inputCRSString);
+    }
+
+
+    inline
+    void finalize(void) {
+        _clearContexts();
+        geomodelgrids::serial::Query::finalize();
+    }
+
+
+    inline
+    void set_io_profile(const char* profile) {
+        geomodelgrids::serial::Query::setIOProfile(geomodelgrids::serial::IOProfile::fromString(profile));
+    }
+
+
+    inline
+    py::array_t<double> query_top_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray,
+                                            py::object out,
+                                            const size_t numThreads) {
         py::buffer_info pointsInfo = pointsArray.request();
         const double* const points = static_cast<const double*>(pointsInfo.ptr);
 
@@ -33,21 +67,25 @@ public:
         const size_t numPoints = pointsInfo.shape[0];
         const size_t spaceDim = pointsInfo.shape[1];
 
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
+        py::array_t<double> resultArray = _getOutputArray<double>(out, { numPoints });
+        double* result = resultArray.mutable_data();
 
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Query::queryTopElevation(x[0], x[1]);
-        }
+        _forEachRange(numPoints, numThreads, [&](geomodelgrids::serial::QueryContext* context,
+                                                 const size_t pointBegin,
+                                                 const size_t pointEnd) {
+            for (size_t iPoint = pointBegin; iPoint < pointEnd; ++iPoint) {
+                const double* x = &points[iPoint*spaceDim];
+                result[iPoint] = geomodelgrids::serial::Query::queryTopElevation(x[0], x[1], context);
+            }
+        });
 
         return resultArray;
     }
 
     inline
-    py::array_t<double> query_topobathy_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
+    py::array_t<double> query_topobathy_elevation(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray,
+                                                  py::object out,
+                                                  const size_t numThreads) {
         py::buffer_info pointsInfo = pointsArray.request();
         const double* const points = static_cast<const double*>(pointsInfo.ptr);
 
@@ -57,21 +95,26 @@ public:
         const size_t numPoints = pointsInfo.shape[0];
         const size_t spaceDim = pointsInfo.shape[1];
 
-        const size_t resultSize = pointsInfo.shape[0];
-        py::array_t<double> resultArray(resultSize);
-        py::buffer_info resultInfo = resultArray.request();
+        py::array_t<double> resultArray = _getOutputArray<double>(out, { numPoints });
+        double* result = resultArray.mutable_data();
 
-        double* result = static_cast<double*>(resultInfo.ptr);
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            result[iPoint] = geomodelgrids::serial::Query::queryTopoBathyElevation(x[0], x[1]);
-        }
+        _forEachRange(numPoints, numThreads, [&](geomodelgrids::serial::QueryContext* context,
+                                                 const size_t pointBegin,
+                                                 const size_t pointEnd) {
+            for (size_t iPoint = pointBegin; iPoint < pointEnd; ++iPoint) {
+                const double* x = &points[iPoint*spaceDim];
+                result[iPoint] = geomodelgrids::serial::Query::queryTopoBathyElevation(x[0], x[1], context);
+            }
+        });
 
         return resultArray;
     }
 
     inline
-    std::tuple < py::array_t<double>, py::array_t<int> > query(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray) {
+    std::tuple < py::array, py::array_t<int> > query(py::array_t<double, py::array::c_style | py::array::forcecast> pointsArray,
+                                                     py::object out,
+                                                     const size_t numThreads,
+                                                     py::object dtype) {
         py::buffer_info pointsInfo = pointsArray.request();
         const double* const points = static_cast<const double*>(pointsInfo.ptr);
 
@@ -79,29 +122,210 @@ public:
             throw std::runtime_error("Points must be an array with shape [numPoints, 3].");
         }
         const size_t numPoints = pointsInfo.shape[0];
-        const size_t spaceDim = pointsInfo.shape[1];
         const size_t numValues = geomodelgrids::serial::Query::getValueNames().size();
 
-        py::array_t<double> resultArray({numPoints, numValues});
-        py::buffer_info resultInfo = resultArray.request();
-        double* result = static_cast<double*>(resultInfo.ptr);
-
         py::array_t<int> errorArray(numPoints);
-        py::buffer_info errorInfo = errorArray.request();
-        int* error = static_cast<int*>(errorInfo.ptr);
+        int* error = errorArray.mutable_data();
+
+        if (_isSinglePrecision(out, dtype)) {
+            py::array_t<float> resultArray = _getOutputArray<float>(out, { numPoints, numValues });
+            _queryRanges(resultArray.mutable_data(), error, points, numPoints, numValues, numThreads);
+            return std::make_tuple(py::array(resultArray), errorArray);
+        } else {
+            py::array_t<double> resultArray = _getOutputArray<double>(out, { numPoints, numValues });
+            _queryRanges(resultArray.mutable_data(), error, points, numPoints, numValues, numThreads);
+            return std::make_tuple(py::array(resultArray), errorArray);
+        }
+    }
 
-        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
-            const double* x = &points[iPoint*spaceDim];
-            const int errorCode = geomodelgrids::serial::Query::query(&result[iPoint*numValues], x[0], x[1], x[2]);
-            error[iPoint] = errorCode;
+private:
+
+    /** Query values for contiguous ranges of points in parallel.
+     *
+     * Each range is a batch query, so CRS transformations and per-model setup are shared by the
+     * points in the range.
+     *
+     * @param[out] values Array of values [numPoints*numValues].
+     * @param[out] status Array of query status for each point [numPoints].
+     * @param[in] points Array of points [numPoints*3].
+     * @param[in] numPoints Number of points.
+     * @param[in] numValues Number of values queried at each point.
+     * @param[in] numThreads Number of threads (0 for number of hardware threads).
+     */
+    template<typename T>
+    void _queryRanges(T* const values,
+                      int* const status,
+                      const double* const points,
+                      const size_t numPoints,
+                      const size_t numValues,
+                      const size_t numThreads) {
+        _forEachRange(numPoints, numThreads, [&](geomodelgrids::serial::QueryContext* context,
+                                                 const size_t pointBegin,
+                                                 const size_t pointEnd) {
+            if (pointEnd == pointBegin) {
+                return;
+            }
+            const int errorCode = _queryMany(&values[pointBegin*numValues], &status[pointBegin], &points[pointBegin*3],
+                                             pointEnd-pointBegin, context);
             if (errorCode == geomodelgrids::utils::ErrorHandler::ERROR) {
-                throw std::runtime_error(geomodelgrids::serial::Query::getErrorHandler()->getMessage());
+                throw std::runtime_error(context->getErrorHandler()->getMessage());
+            }
+        });
+    }
+
+    /// Query::queryMany() for values in double precision.
+    int _queryMany(double* const values,
+                   int* const status,
+                   const double* const points,
+                   const size_t numPoints,
+                   geomodelgrids::serial::QueryContext* const context) const {
+        return geomodelgrids::serial::Query::queryMany(values, status, points, numPoints, context);
+    }
+
+    /// Query::queryManyFloat() for values in single precision.
+    int _queryMany(float* const values,
+                   int* const status,
+                   const double* const points,
+                   const size_t numPoints,
+                   geomodelgrids::serial::QueryContext* const context) const {
+        return geomodelgrids::serial::Query::queryManyFloat(values, status, points, numPoints, context);
+    }
+
+    /** Are values returned in single precision?
+     *
+     * @param[in] out Array provided by caller (None to create a new array).
+     * @param[in] dtype Data type of values, float32 or float64 (None for type of out, float64 if out is None).
+     * @returns True if values are returned as float32, false if values are returned as float64.
+     */
+    static
+    bool _isSinglePrecision(py::object out,
+                            py::object dtype) {
+        if (!dtype.is_none()) {
+            const py::dtype valuesType = py::dtype::from_args(dtype);
+            if ((valuesType.kind() != 'f') || ((valuesType.itemsize() != 4) && (valuesType.itemsize() != 8))) {
+                throw std::runtime_error("Data type of values must be float32 or float64.");
             }
+            return 4 == valuesType.itemsize();
         }
+        return !out.is_none() && py::isinstance<py::array_t<float> >(out);
+    }
+
+    /** Get array for results, either the array provided by the caller or a new array.
+     *
+     * @param[in] out Array provided by caller (None to create a new array).
+     * @param[in] shape Shape of array.
+     * @returns Array for results.
+     */
+    template<typename T>
+    static
+    py::array_t<T> _getOutputArray(py::object out,
+                                   const std::vector<size_t>& shape) {
+        if (out.is_none()) {
+            return py::array_t<T>(shape);
+        }
+
+        if (!py::isinstance<py::array_t<T, py::array::c_style> >(out)) {
+            std::ostringstream msg;
+            msg << "Output array must be a C-contiguous NumPy array of " << ((sizeof(T) == 4) ? "float32" : "float64")
+                << " values.";
+            throw std::runtime_error(msg.str());
+        }
+        py::array_t<T> outArray = py::reinterpret_borrow<py::array_t<T> >(out);
+        bool isShapeOkay = size_t(outArray.ndim()) == shape.size();
+        for (size_t i = 0; isShapeOkay && i < shape.size(); ++i) {
+            isShapeOkay = size_t(outArray.shape(i)) == shape[i];
+        }
+        if (!isShapeOkay) {
+            std::ostringstream msg;
+            msg << "Output array must have shape [";
+            for (size_t i = 0; i < shape.size(); ++i) {
+                msg << (i ? ", " : "") << shape[i];
+            }
+            msg << "].";
+            throw std::runtime_error(msg.str());
+        }
+        if (!outArray.writeable()) {
+            throw std::runtime_error("Output array must be writeable.");
+        }
+
+        return outArray;
+    }
+
+    /** Apply function to contiguous ranges of points with the GIL released.
+     *
+     * The points are split into one range per thread. The first range uses the default query
+     * context, and the others use query contexts created on the calling thread before any worker
+     * threads start. The contexts are kept for later calls, so they are created only when a call
+     * uses more threads than any previous call.
+     *
+     * @param[in] numPoints Number of points.
+     * @param[in] numThreads Number of threads (0 for number of hardware threads).
+     * @param[in] function Function(context, pointBegin, pointEnd) applied to each range of points.
+     */
+    template<typename Function>
+    void _forEachRange(const size_t numPoints,
+                       const size_t numThreads,
+                       Function function) {
+        if (!geomodelgrids::serial::Query::getContext()) {
+            throw std::runtime_error("Query not initialized. Call initialize() before querying.");
+        }
+        size_t numRanges = (numThreads > 0) ? numThreads : std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+        numRanges = std::max(std::min(numRanges, numPoints), size_t(1));
+
+        std::vector<std::exception_ptr> errors(numRanges);
+        auto worker = [&](const size_t iRange) {
+            try {
+                const size_t pointBegin = iRange * numPoints / numRanges;
+                const size_t pointEnd = (iRange + 1) * numPoints / numRanges;
+                geomodelgrids::serial::QueryContext* const context = (!iRange) ?
+                                                                     geomodelgrids::serial::Query::getContext() :
+                                                                     _contexts[iRange-1].get();
+                function(context, pointBegin, pointEnd);
+            } catch (...) {
+                errors[iRange] = std::current_exception();
+            }
+        };
 
-        return std::make_tuple(resultArray, errorArray);
+        { // GIL released
+            py::gil_scoped_release release;
+            // The default context and the thread contexts are shared by all callers of this query.
+            std::lock_guard<std::mutex> lock(_contextMutex);
+
+            while (_contexts.size() < numRanges-1) {
+                _contexts.push_back(std::unique_ptr<geomodelgrids::serial::QueryContext>(
+                                        new geomodelgrids::serial::QueryContext(*this)));
+            }
+
+            std::vector<std::thread> threads;
+            for (size_t iRange = 1; iRange < numRanges; ++iRange) {
+                threads.push_back(std::thread(worker, iRange));
+            }
+            worker(0);
+            for (size_t iThread = 0; iThread < threads.size(); ++iThread) {
+                threads[iThread].join();
+            }
+        } // GIL released
+
+        for (size_t iRange = 0; iRange < numRanges; ++iRange) {
+            if (errors[iRange]) {
+                std::rethrow_exception(errors[iRange]);
+            }
+        }
+    }
+
+    /** Destroy query contexts for threads.
+     *
+     * The contexts refer to the current models, so they must be destroyed when the models change.
+     */
+    void _clearContexts(void) {
+        py::gil_scoped_release release;
+        std::lock_guard<std::mutex> lock(_contextMutex);
+        _contexts.clear();
     }
 
+    std::mutex _contextMutex; ///< Mutex for default query context and thread contexts.
+    std::vector<std::unique_ptr<geomodelgrids::serial::QueryContext> > _contexts; ///< Query contexts for threads.
+
 };
 
 void
@@ -138,19 +362,41 @@ init_query(py::module_& m) {
          "Set type of squashing.",
          py::arg("squash_type"))
 
+    .def("set_single_precision", &geomodelgrids::PyQuery::setSinglePrecision,
+         "Store model values in single precision (must be called before initialize).",
+         py::arg("value"))
+
+    .def("set_transform_tolerance", &geomodelgrids::PyQuery::setTransformTolerance,
+         "Approximate the CRS transformation of points to within the tolerance (model CRS units) using "
+         "interpolation over each model footprint; the grid is refined until the error measured at sample points "
+         "is within half of the tolerance (0 for exact; must be called before initialize).",
+         py::arg("tolerance"))
+
+    .def("set_io_profile", &geomodelgrids::PyQuery::set_io_profile,
+         "Set parameters for reading models as preset ('default', 'borehole', 'grid') and/or comma separated "
+         "KEY=VALUE parameters (must be called before initialize).",
+         py::arg("profile"))
+
     .def("query_top_elevation", &geomodelgrids::PyQuery::query_top_elevation,
          "Query for elevation (m) of top of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none(),
+         py::arg("num_threads")=1
          )
 
     .def("query_topobathy_elevation", &geomodelgrids::PyQuery::query_topobathy_elevation,
          "Query for elevation (m) of topography/bathymetry of model at points using bilinear interpolation.",
-         py::arg("points")
+         py::arg("points"),
+         py::arg("out")=py::none(),
+         py::arg("num_threads")=1
          )
 
     .def("query", &geomodelgrids::PyQuery::query,
          "Query for model values at points using bilinear interpolation.",
-         py::arg("points"))
+         py::arg("points"),
+         py::arg("out")=py::none(),
+         py::arg("num_threads")=1,
+         py::arg("dtype")=py::none())
 
     ;
 }
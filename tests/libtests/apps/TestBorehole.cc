@@ -328,7 +328,7 @@ geomodelgrids::apps::TestBorehole::testPrintHelp(void) {
     Borehole borehole;
     borehole._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1196) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -349,7 +349,7 @@ geomodelgrids::apps::TestBorehole::testRunHelp(void) {
     borehole.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1196) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -84,6 +84,9 @@ public:
     /// Test run() wth three-blocks-topo.
     void testRunThreeBlocksTopo(void);
 
+    /// Test run() wth three-blocks-topo with multiple threads.
+    void testRunThreads(void);
+
     /// Test run() wth bad output file.
     void testRunBadOutput(void);
 
@@ -141,6 +144,9 @@ TEST_CASE("TestIsosurface::testRunOneBlockFlat", "[TestIsosurface]") {
 TEST_CASE("TestIsosurface::testRunThreeBlocksTopo", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunThreeBlocksTopo();
 }
+TEST_CASE("TestIsosurface::testRunThreads", "[TestIsosurface]") {
+    geomodelgrids::apps::TestIsosurface().testRunThreads();
+}
 TEST_CASE("TestIsosurface::testRunBadOutput", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunBadOutput();
 }
@@ -183,8 +189,11 @@ geomodelgrids::apps::TestIsosurface::testConstructor(void) {
     CHECK(10.0 == isosurface._vertRes);
     CHECK(0.0 == isosurface._maxDepth);
     CHECK(10 == isosurface._numSearchPoints);
+    CHECK(size_t(1) == isosurface._numThreads);
+    CHECK(size_t(256) == isosurface._tileSize);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == isosurface._depthSurface);
     CHECK(true == isosurface._preferShallow);
+    CHECK(false == isosurface._cloudOptimized);
 
     CHECK(size_t(2) == isosurface._isosurfaces.size());
     CHECK(std::string("Vs") == isosurface._isosurfaces[0].first);
@@ -367,6 +376,21 @@ geomodelgrids::apps::TestIsosurface::testParseArgsWrong(void) {
 
     Isosurface isosurface;
     CHECK_THROWS_AS(isosurface._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+
+    optind = 1; // reset parsing of argc and argv
+    const int nargsTile = 2;
+    const char* const argsTile[nargsTile] = { "test", "--tile-size=100" };
+    CHECK_THROWS_AS(isosurface._parseArgs(nargsTile, const_cast<char**>(argsTile)), std::invalid_argument);
+
+    const size_t numThreadsBad = 4;
+    const char* const threadsBad[numThreadsBad] = { "--threads=0", "--threads=-2", "--threads=two", "--threads=2x" };
+    for (size_t i = 0; i < numThreadsBad; ++i) {
+        optind = 1; // reset parsing of argc and argv
+        const int nargsThreads = 2;
+        const char* const argsThreads[nargsThreads] = { "test", threadsBad[i] };
+        INFO("Argument " << threadsBad[i]);
+        CHECK_THROWS_AS(isosurface._parseArgs(nargsThreads, const_cast<char**>(argsThreads)), std::invalid_argument);
+    } // for
 } // testParseArgsWrong
 
 
@@ -418,7 +442,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
-    const int nargs = 14;
+    const int nargs = 17;
     const char* const args[nargs] = {
         "test",
         "--log=my.log",
@@ -434,6 +458,9 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
         "--output=iso.tiff",
         "--prefer-deep",
         "--bbox-coordsys=EPSG:3311",
+        "--threads=4",
+        "--tile-size=128",
+        "--cloud-optimized",
     };
 
     Isosurface isosurface;
@@ -454,8 +481,11 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
     CHECK(0.4 == isosurface._vertRes);
     CHECK(2.0 == isosurface._maxDepth);
     CHECK(5 == isosurface._numSearchPoints);
+    CHECK(size_t(4) == isosurface._numThreads);
+    CHECK(size_t(128) == isosurface._tileSize);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == isosurface._depthSurface);
     CHECK(false == isosurface._preferShallow);
+    CHECK(true == isosurface._cloudOptimized);
 
     CHECK(size_t(2) == isosurface._modelFilenames.size());
     CHECK(std::string("one.h5") == isosurface._modelFilenames[0]);
@@ -476,7 +506,7 @@ geomodelgrids::apps::TestIsosurface::testPrintHelp(void) {
     Isosurface isosurface;
     isosurface._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(1986) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -497,7 +527,7 @@ geomodelgrids::apps::TestIsosurface::testRunHelp(void) {
     isosurface.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(1986) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -559,6 +589,36 @@ geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopo(void) {
 } // testRunThreeBlocksTopo
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo with multiple threads.
+void
+geomodelgrids::apps::TestIsosurface::testRunThreads(void) {
+    const int nargs = 14;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/three-blocks-topo.h5",
+        "--bbox=34.6,34.8,-117.7,-117.3",
+        "--hresolution=0.1",
+        "--vresolution=500.0",
+        "--isosurface=one,12.0e+4",
+        "--isosurface=two,40.0e+3",
+        "--max-depth=45.0e+3",
+        "--depth-reference=topography_bathymetry",
+        "--prefer-deep",
+        "--output=three-blocks-topo-isosurface.tiff",
+        "--bbox-coordsys=EPSG:4326",
+        "--log=error.log",
+        "--threads=3",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoIsosurface isosurfaceThree;
+
+    Isosurface isosurface;
+    isosurface.run(nargs, const_cast<char**>(args));
+
+    _TestIsosurface::checkIsosurface("three-blocks-topo-isosurface.tiff", 12.0e+4, 40.0e+3, isosurfaceThree);
+} // testRunThreads
+
+
 // ------------------------------------------------------------------------------------------------
 // Test run() with bad output specification.
 void
@@ -0,0 +1,316 @@
+/**
+ * C++ unit testing of geomodelgrids::apps::PointsReader and geomodelgrids::apps::PointsWriter.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/apps/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/apps/PointsWriter.hh" // USES PointsWriter
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <cmath> // USES std::signbit()
+#include <sstream> // USES std::ostringstream
+#include <memory> // USES std::unique_ptr
+#include <vector> // USES std::vector
+
+namespace geomodelgrids {
+    namespace apps {
+        class TestPointsIO;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::TestPointsIO {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test create() with unknown format and missing files.
+    static
+    void testCreateBad(void);
+
+    /// Test writing and reading points in text format.
+    static
+    void testText(void);
+
+    /// Test reading points in text format with invalid token.
+    static
+    void testTextInvalid(void);
+
+    /// Test writing and reading points in text format with extreme values and varied notation.
+    static
+    void testTextNotation(void);
+
+    /// Test writing and reading points in raw format.
+    static
+    void testRaw(void);
+
+    /// Test reading truncated points in raw format.
+    static
+    void testRawTruncated(void);
+
+    /// Test writing and reading points in NumPy format.
+    static
+    void testNpy(void);
+
+    /// Test writing and reading points in HDF5 format.
+    static
+    void testHDF5(void);
+
+    /** Write points with values using writer and read them back with reader.
+     *
+     * @param[in] format Format of file.
+     * @param[in] filename Name of file.
+     */
+    static
+    void checkRoundTrip(const std::string& format,
+                        const std::string& filename);
+
+}; // class TestPointsIO
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestPointsIO::testCreateBad", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testCreateBad();
+}
+TEST_CASE("TestPointsIO::testText", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testText();
+}
+TEST_CASE("TestPointsIO::testTextInvalid", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testTextInvalid();
+}
+TEST_CASE("TestPointsIO::testTextNotation", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testTextNotation();
+}
+TEST_CASE("TestPointsIO::testRaw", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testRaw();
+}
+TEST_CASE("TestPointsIO::testRawTruncated", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testRawTruncated();
+}
+TEST_CASE("TestPointsIO::testNpy", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testNpy();
+}
+TEST_CASE("TestPointsIO::testHDF5", "[TestPointsIO]") {
+    geomodelgrids::apps::TestPointsIO::testHDF5();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test create() with unknown format and missing files.
+void
+geomodelgrids::apps::TestPointsIO::testCreateBad(void) {
+    CHECK_THROWS_AS(PointsReader::create("csv", "points.in"), std::runtime_error);
+    CHECK_THROWS_AS(PointsWriter::create("csv", "points.out", 2), std::runtime_error);
+
+    CHECK_THROWS_AS(PointsReader::create("text", "blah/points.in"), std::runtime_error);
+    CHECK_THROWS_AS(PointsReader::create("raw", "blah/points.in"), std::runtime_error);
+    CHECK_THROWS_AS(PointsReader::create("npy", "blah/points.in"), std::runtime_error);
+    CHECK_THROWS_AS(PointsReader::create("hdf5", "blah/points.in"), std::runtime_error);
+    CHECK_THROWS_AS(PointsReader::create("hdf5", "-"), std::runtime_error);
+
+    CHECK_THROWS_AS(PointsWriter::create("text", "blah/points.out", 2), std::runtime_error);
+    CHECK_THROWS_AS(PointsWriter::create("raw", "blah/points.out", 2), std::runtime_error);
+    CHECK_THROWS_AS(PointsWriter::create("npy", "blah/points.out", 2), std::runtime_error);
+    CHECK_THROWS_AS(PointsWriter::create("npy", "-", 2), std::runtime_error);
+    CHECK_THROWS_AS(PointsWriter::create("hdf5", "blah/points.out", 2), std::runtime_error);
+} // testCreateBad
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading points in text format.
+void
+geomodelgrids::apps::TestPointsIO::testText(void) {
+    checkRoundTrip("text", "points_io.txt");
+
+    // Columns match fixed-width scientific notation.
+    const size_t numValues = 1;
+    const double points[3] = { 37.5, -122.25, -1.5e+3 };
+    const double values[numValues] = { -2.0e-12 };
+    std::unique_ptr<PointsWriter> writer(PointsWriter::create("text", "points_io.txt", numValues));
+    writer->writeHeader("# header\n");
+    writer->write(points, values, 1);
+    writer->close();
+
+    std::ifstream sin("points_io.txt");REQUIRE(sin.is_open());
+    std::ostringstream contents;
+    contents << sin.rdbuf();
+    CHECK(std::string("# header\n  3.750000e+01 -1.222500e+02 -1.500000e+03 -2.000000e-12\n") == contents.str());
+} // testText
+
+
+// ------------------------------------------------------------------------------------------------
+// Test reading points in text format with invalid token.
+void
+geomodelgrids::apps::TestPointsIO::testTextInvalid(void) {
+    std::ofstream sout("points_io.txt");REQUIRE(sout.is_open());
+    sout << "  1.0 +2.0\t3.0e+2\n"
+         << "4 5 6\n"
+         << "7 8 nine\n"
+         << "10 11 12\n";
+    sout.close();
+
+    std::unique_ptr<PointsReader> reader(PointsReader::create("text", "points_io.txt"));
+    double points[3*4];
+    REQUIRE(size_t(2) == reader->read(points, 4));
+    const double pointsE[3*2] = { 1.0, 2.0, 300.0, 4.0, 5.0, 6.0 };
+    for (size_t i = 0; i < 3*2; ++i) {
+        CHECK(pointsE[i] == points[i]);
+    } // for
+    CHECK(size_t(0) == reader->read(points, 4));
+} // testTextInvalid
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading points in text format with extreme values and varied notation.
+void
+geomodelgrids::apps::TestPointsIO::testTextNotation(void) {
+    { // Writing
+        const size_t numValues = 3;
+        const double points[3] = { 1.0e+100, -0.0, 4.9406564584124654e-324 };
+        const double values[numValues] = { 1.7976931348623157e+308, -9.9999996e-1, 0.0 };
+        std::unique_ptr<PointsWriter> writer(PointsWriter::create("text", "points_io.txt", numValues));
+        writer->write(points, values, 1);
+        writer->close();
+
+        std::ifstream sin("points_io.txt");REQUIRE(sin.is_open());
+        std::ostringstream contents;
+        contents << sin.rdbuf();
+        CHECK(std::string(" 1.000000e+100 -0.000000e+00 4.940656e-324 1.797693e+308 -1.000000e+00  0.000000e+00\n")
+              == contents.str());
+    } // Writing
+
+    { // Reading
+        std::ofstream sout("points_io.txt");REQUIRE(sout.is_open());
+        sout << "+2.5 -.5 5.\n"
+             << "1E3 -0.5e-3 4.940656e-324\n"
+             << "-0 1.797693e+308 0012.50\n";
+        sout.close();
+
+        std::unique_ptr<PointsReader> reader(PointsReader::create("text", "points_io.txt"));
+        double points[3*4];
+        REQUIRE(size_t(3) == reader->read(points, 4));
+        const double pointsE[3*3] = {
+            2.5, -0.5, 5.0,
+            1.0e+3, -0.5e-3, 4.940656e-324,
+            0.0, 1.797693e+308, 12.5,
+        };
+        for (size_t i = 0; i < 3*3; ++i) {
+            INFO("Mismatch in value " << i << ".");
+            CHECK(pointsE[i] == points[i]);
+        } // for
+        CHECK(std::signbit(points[6]));
+    } // Reading
+} // testTextNotation
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading points in raw format.
+void
+geomodelgrids::apps::TestPointsIO::testRaw(void) {
+    checkRoundTrip("raw", "points_io.bin");
+} // testRaw
+
+
+// ------------------------------------------------------------------------------------------------
+// Test reading truncated points in raw format.
+void
+geomodelgrids::apps::TestPointsIO::testRawTruncated(void) {
+    const double values[4] = { 1.0, 2.0, 3.0, 4.0 };
+    std::ofstream sout("points_io.bin", std::ios::binary);REQUIRE(sout.is_open());
+    sout.write(reinterpret_cast<const char*>(values), sizeof(values));
+    sout.close();
+
+    std::unique_ptr<PointsReader> reader(PointsReader::create("raw", "points_io.bin"));
+    double points[3*2];
+    CHECK_THROWS_AS(reader->read(points, 2), std::runtime_error);
+} // testRawTruncated
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading points in NumPy format.
+void
+geomodelgrids::apps::TestPointsIO::testNpy(void) {
+    checkRoundTrip("npy", "points_io.npy");
+
+    // Header has shape of array.
+    std::ifstream sin("points_io.npy", std::ios::binary);REQUIRE(sin.is_open());
+    std::string header(128, ' ');
+    sin.read(&header[0], header.length());
+    CHECK(std::string("\x93NUMPY\x01\x00", 8) == header.substr(0, 8));
+    CHECK(header.find("'shape': (5, 5)") != std::string::npos);
+    CHECK('\n' == header[127]);
+
+    // Not a NumPy file.
+    std::ofstream sout("points_io.npy");REQUIRE(sout.is_open());
+    sout << "1.0 2.0 3.0\n";
+    sout.close();
+    CHECK_THROWS_AS(PointsReader::create("npy", "points_io.npy"), std::runtime_error);
+} // testNpy
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading points in HDF5 format.
+void
+geomodelgrids::apps::TestPointsIO::testHDF5(void) {
+    checkRoundTrip("hdf5", "points_io.h5");
+
+    // Missing dataset.
+    CHECK_THROWS_AS(PointsReader::create("hdf5", "points_io.h5", "/blah"), std::runtime_error);
+} // testHDF5
+
+
+// ------------------------------------------------------------------------------------------------
+// Write points with values using writer and read them back with reader.
+void
+geomodelgrids::apps::TestPointsIO::checkRoundTrip(const std::string& format,
+                                                  const std::string& filename) {
+    const size_t numPoints = 5;
+    const double pointsE[numPoints*3] = {
+        37.5, -122.25, -1.5e+3,
+        38.0, -121.75, 0.0,
+        36.125, -120.5, 250.0,
+        35.0, -119.0, -5.0e+3,
+        34.5, -118.125, 1.25e+3,
+    };
+    const size_t numValues = 2;
+    const double valuesE[numPoints*numValues] = {
+        1.0, 2.0,
+        3.0, 4.0,
+        5.0, 6.0,
+        7.0, 8.0,
+        9.0, 10.0,
+    };
+
+    { // Write points without values in two batches.
+        std::unique_ptr<PointsWriter> writer(PointsWriter::create(format, filename, 0, "/points"));
+        writer->write(pointsE, nullptr, 3);
+        writer->write(&pointsE[3*3], nullptr, numPoints-3);
+        writer->close();
+    } // Write
+
+    { // Read points in batches smaller than number of points.
+        std::unique_ptr<PointsReader> reader(PointsReader::create(format, filename, "/points"));
+        double points[numPoints*3];
+        REQUIRE(size_t(3) == reader->read(points, 3));
+        REQUIRE(size_t(numPoints-3) == reader->read(&points[3*3], 3));
+        CHECK(size_t(0) == reader->read(points, 3));
+        for (size_t i = 0; i < numPoints*3; ++i) {
+            INFO("Mismatch in coordinate " << i << " for format '" << format << "'.");
+            CHECK(pointsE[i] == points[i]);
+        } // for
+    } // Read
+
+    if (format != "text") { // Write points with values and check size of file.
+        std::unique_ptr<PointsWriter> writer(PointsWriter::create(format, filename, numValues));
+        writer->write(pointsE, valuesE, numPoints);
+        writer->close();
+
+        if ((format == "raw") || (format == "npy")) {
+            std::ifstream sin(filename, std::ios::binary | std::ios::ate);REQUIRE(sin.is_open());
+            const size_t headerSize = (format == "npy") ? 128 : 0;
+            CHECK(size_t(headerSize + numPoints*(3+numValues)*sizeof(double)) == size_t(sin.tellg()));
+        } // if
+    } // if
+} // checkRoundTrip
+
+
+// End of file
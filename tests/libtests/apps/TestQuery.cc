@@ -5,6 +5,7 @@
 #include <portinfo>
 
 #include "geomodelgrids/apps/Query.hh" // USES Query
+#include "geomodelgrids/apps/PointsWriter.hh" // USES PointsWriter
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include "tests/data/ModelPoints.hh"
@@ -18,6 +19,8 @@
 #include <iomanip> // USES ios::setf(), ios::setprecision()
 #include <getopt.h> // USES optind
 #include <cmath> // USES fabs()
+#include <memory> // USES std::unique_ptr
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace apps {
@@ -83,6 +86,12 @@ public:
     /// Test run() wth one-block-flat and three-blocks-topo.
     void testRunTwoModels(void);
 
+    /// Test run() wth one-block-flat with NumPy input and raw output.
+    void testRunBinary(void);
+
+    /// Test run() wth one-block-flat and three-blocks-topo with multiple threads.
+    void testRunThreads(void);
+
     /// Test run() wth bad input.
     void testRunBadInput(void);
 
@@ -146,6 +155,12 @@ TEST_CASE("TestQuery::testRunThreeBlocksSquashTopoBathy", "[TestQuery]") {
 TEST_CASE("TestQuery::testRunTwoModels", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testRunTwoModels();
 }
+TEST_CASE("TestQuery::testRunBinary", "[TestQuery]") {
+    geomodelgrids::apps::TestQuery().testRunBinary();
+}
+TEST_CASE("TestQuery::testRunThreads", "[TestQuery]") {
+    geomodelgrids::apps::TestQuery().testRunThreads();
+}
 TEST_CASE("TestQuery::testRunBadInput", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testRunBadInput();
 }
@@ -194,6 +209,7 @@ geomodelgrids::apps::TestQuery::testConstructor(void) {
     CHECK(std::string("EPSG:4326") == query._pointsCRS);
     CHECK(-10.0e+3 == query._squashMinElev);
     CHECK(geomodelgrids::serial::Query::SQUASH_NONE == query._squash);
+    CHECK(size_t(1) == query._numThreads);
     CHECK(false == query._showHelp);
 } // testConstructor
 
@@ -281,6 +297,16 @@ geomodelgrids::apps::TestQuery::testParseArgsWrong(void) {
 
     Query query;
     CHECK_THROWS_AS(query._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+
+    const size_t numThreadsBad = 4;
+    const char* const threadsBad[numThreadsBad] = { "--threads=0", "--threads=-2", "--threads=two", "--threads=2x" };
+    for (size_t i = 0; i < numThreadsBad; ++i) {
+        optind = 1; // reset parsing of argc and argv
+        const int nargsThreads = 2;
+        const char* const argsThreads[nargsThreads] = { "test", threadsBad[i] };
+        INFO("Argument " << threadsBad[i]);
+        CHECK_THROWS_AS(query._parseArgs(nargsThreads, const_cast<char**>(argsThreads)), std::invalid_argument);
+    } // for
 } // testParseArgsWrong
 
 
@@ -305,7 +331,9 @@ geomodelgrids::apps::TestQuery::testParseArgsMinimal(void) {
     CHECK(size_t(1) == query._modelFilenames.size());
     CHECK(std::string("B") == query._modelFilenames[0]);
     CHECK(std::string("points.in") == query._pointsFilename);
+    CHECK(std::string("text") == query._pointsFormat);
     CHECK(std::string("points.out") == query._outputFilename);
+    CHECK(std::string("text") == query._outputFormat);
     CHECK(!query._showHelp);
 } // testParseArgsMinimal
 
@@ -314,17 +342,22 @@ geomodelgrids::apps::TestQuery::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
-    const int nargs = 9;
+    const int nargs = 14;
     const char* const args[nargs] = {
         "test",
         "--values=one,two,three",
         "--models=A",
         "--points=points.in",
+        "--points-format=hdf5",
+        "--points-dataset=/a/points",
         "--output=points.out",
+        "--output-format=npy",
+        "--output-dataset=/a/values",
         "--points-coordsys=EPSG:26910",
         "--squash-min-elev=-2.0e+3",
         "--squash-surface=top_surface",
         "--log=error.log",
+        "--threads=4",
     };
     const size_t numValues = 3;
     const char* const valueNamesE[numValues] = { "one", "two", "three" };
@@ -338,11 +371,16 @@ geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
     CHECK(size_t(1) == query._modelFilenames.size());
     CHECK(std::string("A") == query._modelFilenames[0]);
     CHECK(std::string("points.in") == query._pointsFilename);
+    CHECK(std::string("hdf5") == query._pointsFormat);
+    CHECK(std::string("/a/points") == query._pointsDataset);
     CHECK(std::string("points.out") == query._outputFilename);
+    CHECK(std::string("npy") == query._outputFormat);
+    CHECK(std::string("/a/values") == query._outputDataset);
     CHECK(std::string("EPSG:26910") == query._pointsCRS);
     CHECK(-2.0e+3 == query._squashMinElev);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == query._squash);
     CHECK(std::string("error.log") == query._logFilename);
+    CHECK(size_t(4) == query._numThreads);
     CHECK(!query._showHelp);
 } // testParseArgsAll
 
@@ -358,7 +396,7 @@ geomodelgrids::apps::TestQuery::testPrintHelp(void) {
     Query query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(1810) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -379,7 +417,7 @@ geomodelgrids::apps::TestQuery::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(1810) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -533,6 +571,97 @@ geomodelgrids::apps::TestQuery::testRunTwoModels(void) {
 } // testRunTwoModels
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with one-block-flat with NumPy input and raw output.
+void
+geomodelgrids::apps::TestQuery::testRunBinary(void) {
+    const int nargs = 8;
+    const char* const args[nargs] = {
+        "test",
+        "--values=two,one",
+        "--models=../../data/one-block-flat.h5",
+        "--points=one-block-flat.npy",
+        "--points-format=npy",
+        "--output=one-block-flat.bin",
+        "--output-format=raw",
+        "--points-coordsys=EPSG:4326",
+    };
+    geomodelgrids::testdata::OneBlockFlatPoints pointsOne;
+    const size_t numPoints = pointsOne.getNumPoints();
+    { // Write points
+        std::unique_ptr<PointsWriter> writer(PointsWriter::create("npy", "one-block-flat.npy", 0));
+        writer->write(pointsOne.getLatLonElev(), nullptr, numPoints);
+        writer->close();
+    } // Write points
+
+    Query query;
+    query.run(nargs, const_cast<char**>(args));
+
+    // Convert rows of binary output to text to check values.
+    const size_t rowSize = 5;
+    std::vector<double> rows(numPoints*rowSize);
+    std::ifstream sin("one-block-flat.bin", std::ios::binary);assert(sin.is_open() && sin.good());
+    sin.read(reinterpret_cast<char*>(&rows[0]), rows.size()*sizeof(double));
+    CHECK(sin.good());
+    CHECK(sin.peek() == std::ifstream::traits_type::eof());
+    sin.close();
+
+    std::stringstream srows;
+    srows << std::scientific << std::setprecision(16);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        srows << " " << rows[i];
+    } // for
+    srows << "\n";
+    _TestQuery::checkQuery(srows, pointsOne);
+} // testRunBinary
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with one-block-flat and three-blocks-topo with multiple threads.
+void
+geomodelgrids::apps::TestQuery::testRunThreads(void) {
+    const int nargs = 9;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/one-block-flat.h5,../../data/three-blocks-topo.h5",
+        "--points=two-models.h5",
+        "--points-format=hdf5",
+        "--output=two-models.out",
+        "--points-coordsys=EPSG:4326",
+        "--values=two,one",
+        "--threads=3",
+        "--log=error.log",
+    };
+    geomodelgrids::testdata::OneBlockFlatPoints pointsOne;
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+
+    // Repeat points, so the input spans many batches.
+    const size_t numRepeat = 1000;
+    { // Write points
+        std::unique_ptr<PointsWriter> writer(PointsWriter::create("hdf5", "two-models.h5", 0, "/points"));
+        for (size_t i = 0; i < numRepeat; ++i) {
+            writer->write(pointsOne.getLatLonElev(), nullptr, pointsOne.getNumPoints());
+            writer->write(pointsThree.getLatLonElev(), nullptr, pointsThree.getNumPoints());
+        } // for
+        writer->close();
+    } // Write points
+
+    Query query;
+    query.run(nargs, const_cast<char**>(args));
+
+    std::ifstream sin("two-models.out");assert(sin.is_open() && sin.good());
+    _TestQuery::readHeader(sin);
+    for (size_t i = 0; i < numRepeat; ++i) {
+        _TestQuery::checkQuery(sin, pointsOne);
+        _TestQuery::checkQuery(sin, pointsThree);
+    } // for
+    std::string extra;
+    sin >> extra;
+    CHECK(sin.eof());
+    sin.close();
+} // testRunThreads
+
+
 // ------------------------------------------------------------------------------------------------
 // Test run() with bad input.
 void
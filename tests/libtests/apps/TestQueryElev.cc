@@ -308,7 +308,7 @@ geomodelgrids::apps::TestQueryElev::testPrintHelp(void) {
     QueryElev query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(901) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -329,7 +329,7 @@ geomodelgrids::apps::TestQueryElev::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(901) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -172,6 +172,11 @@ geomodelgrids::serial::TestBlock::testLoadMetadata(void) {
     REQUIRE(_data->numY == dims[1]);
     REQUIRE(_data->numZ == dims[2]);
 
+    const size_t* const chunkDims = block.getChunkDims();
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(_data->chunkDims[i] == chunkDims[i]);
+    } // for
+
     const double tolerance = 1.0e-6;
     double* x = block.getCoordinatesX();
     if (_data->coordinatesX) {
@@ -271,7 +276,11 @@ geomodelgrids::serial::TestBlock_Data::TestBlock_Data(void) :
     numX(0),
     numY(0),
     numZ(0),
-    points(nullptr) {}
+    points(nullptr) {
+    for (size_t i = 0; i < 4; ++i) {
+        chunkDims[i] = 0;
+    } // for
+}
 
 
 // ------------------------------------------------------------------------------------------------
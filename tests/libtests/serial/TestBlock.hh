@@ -78,6 +78,7 @@ public:
     size_t numX; ///< Number of coordinates along x axis.
     size_t numY; ///< Number of coordinates along y axis.
     size_t numZ; ///< Number of coordinates along z axis.
+    size_t chunkDims[4]; ///< Dimensions of chunks in dataset.
 
     geomodelgrids::testdata::ModelPoints* points;
 
@@ -51,6 +51,10 @@ geomodelgrids::serial::TestBlock_Cases::Uniform(void) {
     data->numX = 5;
     data->numY = 5;
     data->numZ = 2;
+    data->chunkDims[0] = 1;
+    data->chunkDims[1] = 1;
+    data->chunkDims[2] = 2;
+    data->chunkDims[3] = 2;
 
     data->points = new geomodelgrids::testdata::OneBlockFlatPoints;
 
@@ -83,6 +87,10 @@ geomodelgrids::serial::TestBlock_Cases::VarZ(void) {
     data->numX = 5;
     data->numY = 5;
     data->numZ = numZ;
+    data->chunkDims[0] = 1;
+    data->chunkDims[1] = 1;
+    data->chunkDims[2] = 3;
+    data->chunkDims[3] = 2;
 
     data->points = new geomodelgrids::testdata::OneBlockFlatPoints;
 
@@ -120,6 +128,10 @@ geomodelgrids::serial::TestBlock_Cases::VarXY(void) {
     data->numX = numX;
     data->numY = numY;
     data->numZ = 2;
+    data->chunkDims[0] = 1;
+    data->chunkDims[1] = 1;
+    data->chunkDims[2] = 2;
+    data->chunkDims[3] = 2;
 
     data->points = new geomodelgrids::testdata::OneBlockTopoPoints;
 
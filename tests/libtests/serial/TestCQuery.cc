@@ -10,6 +10,7 @@ extern "C" {
 #include "geomodelgrids/serial/cquery.h"
 }
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
@@ -17,6 +18,8 @@ extern "C" {
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath>
+#include <thread> // USES std::thread
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace serial {
@@ -64,6 +67,18 @@ public:
     static
     void testQuerySquashTopoBathy(void);
 
+    /// Test queryBatch(), queryBatchFloat(), and queryBatchFloatWithContext().
+    static
+    void testQueryBatch(void);
+
+    /// Test queryTopElevationBatch() and queryTopoBathyElevationBatch().
+    static
+    void testQueryElevationBatch(void);
+
+    /// Test concurrent queries with query contexts.
+    static
+    void testQueryContext(void);
+
 }; // class TestCQuery
 
 // ------------------------------------------------------------------------------------------------
@@ -94,6 +109,15 @@ TEST_CASE("TestCQuery::testQuerySquashTop", "[TestCQuery]") {
 TEST_CASE("TestCQuery::testQuerySquashTopoBathy", "[TestCQuery]") {
     geomodelgrids::serial::TestCQuery().testQuerySquashTopoBathy();
 }
+TEST_CASE("TestCQuery::testQueryBatch", "[TestCQuery]") {
+    geomodelgrids::serial::TestCQuery().testQueryBatch();
+}
+TEST_CASE("TestCQuery::testQueryElevationBatch", "[TestCQuery]") {
+    geomodelgrids::serial::TestCQuery().testQueryElevationBatch();
+}
+TEST_CASE("TestCQuery::testQueryContext", "[TestCQuery]") {
+    geomodelgrids::serial::TestCQuery().testQueryContext();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -130,6 +154,16 @@ geomodelgrids::serial::TestCQuery::testAccessors(void) {
     err = geomodelgrids_squery_setSquashing(handle, GEOMODELGRIDS_SQUASH_TOP_SURFACE);REQUIRE(!err);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == query->_squash);
 
+    err = geomodelgrids_squery_setIOProfile(handle, "borehole,tile_cache_size=2M");REQUIRE(!err);
+    REQUIRE(query->_ioProfile);
+    CHECK(IOProfile::borehole().getBlockHyperslabDims()[0] == query->_ioProfile->getBlockHyperslabDims()[0]);
+    CHECK(size_t(2*1024*1024) == query->_ioProfile->getTileCacheSize());
+
+    // Bad I/O profile
+    err = geomodelgrids_squery_setIOProfile(handle, "unknown");
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
+    query->getErrorHandler()->resetStatus();
+
     // Bad handles
     err = geomodelgrids_squery_setSquashMinElev(nullptr, minElev);
     CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
@@ -137,6 +171,9 @@ geomodelgrids::serial::TestCQuery::testAccessors(void) {
     err = geomodelgrids_squery_setSquashing(nullptr, false);
     CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
 
+    err = geomodelgrids_squery_setIOProfile(nullptr, "borehole");
+    CHECK(int(geomodelgrids::utils::ErrorHandler::ERROR) == err);
+
     geomodelgrids_squery_destroy(&handle);REQUIRE(!handle);
 } // testAccessors
 
@@ -793,4 +830,311 @@ geomodelgrids::serial::TestCQuery::testQuerySquashTopoBathy(void) {
 } // testQuerySquashTopoBathy
 
 
+// ------------------------------------------------------------------------------------------------
+// Test queryBatch(), queryBatchFloat(), and queryBatchFloatWithContext().
+void
+geomodelgrids::serial::TestCQuery::testQueryBatch(void) {
+    const size_t numModels = 2;
+    const char* const filenames[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+
+    const size_t numValues = 2;
+    const char* const valueNames[numValues] = { "two", "one" };
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Points in model followed by points outside domain.
+    std::vector<double> points(pointsThree.getLatLonElev(),
+                               pointsThree.getLatLonElev()+pointsThree.getNumPoints()*spaceDim);
+    points.insert(points.end(), pointsOutside.getLatLonElev(),
+                  pointsOutside.getLatLonElev()+pointsOutside.getNumPoints()*spaceDim);
+    const size_t numPoints = points.size() / spaceDim;
+
+    void* handle = geomodelgrids_squery_create();REQUIRE(handle);
+    int err = geomodelgrids_squery_queryBatch(handle, 0, nullptr, nullptr, nullptr);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;REQUIRE(query);
+    query->getErrorHandler()->resetStatus();
+
+    err = geomodelgrids_squery_initialize(handle, filenames, numModels, valueNames, numValues, crs.c_str());
+    REQUIRE(!err);
+
+    // Expected values from queries at individual points.
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        statusE[iPt] = query->query(&valuesE[iPt*numValues], points[iPt*spaceDim+0], points[iPt*spaceDim+1],
+                                    points[iPt*spaceDim+2]);
+    } // for
+
+    { // In domain
+        const size_t numPointsIn = pointsThree.getNumPoints();
+        std::vector<double> values(numPointsIn*numValues);
+        std::vector<int> status(numPointsIn);
+        err = geomodelgrids_squery_queryBatch(handle, numPointsIn, &points[0], &values[0], &status[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::OK == err);
+
+        const double tolerance = 1.0e-10;
+        for (size_t iPt = 0; iPt < numPointsIn; ++iPt) {
+            CHECK(statusE[iPt] == status[iPt]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch at point (" << points[iPt*spaceDim+0] << ", " << points[iPt*spaceDim+1]
+                                           << ", " << points[iPt*spaceDim+2] << ") for value '" << valueNames[iValue] << "'.");
+                const double valueE = valuesE[iPt*numValues+iValue];
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+            } // for
+        } // for
+    } // In domain
+
+    { // In and outside domain
+        std::vector<double> values(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        err = geomodelgrids_squery_queryBatch(handle, numPoints, &points[0], &values[0], &status[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            CHECK(statusE[iPt] == status[iPt]);
+        } // for
+        query->getErrorHandler()->resetStatus();
+
+        err = geomodelgrids_squery_queryBatch(handle, numPoints, &points[0], &values[0], nullptr);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        query->getErrorHandler()->resetStatus();
+    } // In and outside domain
+
+    { // Single precision
+        std::vector<float> values(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        err = geomodelgrids_squery_queryBatchFloat(handle, numPoints, &points[0], &values[0], &status[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        query->getErrorHandler()->resetStatus();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            CHECK(statusE[iPt] == status[iPt]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch at point " << iPt << " for value '" << valueNames[iValue] << "'.");
+                CHECK(float(valuesE[iPt*numValues+iValue]) == values[iPt*numValues+iValue]);
+            } // for
+        } // for
+
+        void* context = geomodelgrids_squery_createContext(handle);REQUIRE(context);
+        std::vector<float> valuesContext(numPoints*numValues);
+        err = geomodelgrids_squery_queryBatchFloatWithContext(handle, context, numPoints, &points[0],
+                                                              &valuesContext[0], nullptr);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        CHECK(values == valuesContext);
+        geomodelgrids_squery_destroyContext(&context);REQUIRE(!context);
+
+        err = geomodelgrids_squery_queryBatchFloat(handle, 1, &points[0], nullptr, nullptr);
+        CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+        query->getErrorHandler()->resetStatus();
+    } // Single precision
+
+    { // nullptr values
+        err = geomodelgrids_squery_queryBatch(handle, 1, &points[0], nullptr, nullptr);
+        CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+        query->getErrorHandler()->resetStatus();
+    } // nullptr values
+
+    // Bad handle
+    err = geomodelgrids_squery_queryBatch(nullptr, 1, &points[0], &valuesE[0], nullptr);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+    std::vector<float> valuesFloat(numValues);
+    err = geomodelgrids_squery_queryBatchFloat(nullptr, 1, &points[0], &valuesFloat[0], nullptr);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+    err = geomodelgrids_squery_queryBatchFloatWithContext(handle, nullptr, 1, &points[0], &valuesFloat[0], nullptr);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+
+    geomodelgrids_squery_destroy(&handle);REQUIRE(!handle);
+} // testQueryBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryTopElevationBatch() and queryTopoBathyElevationBatch().
+void
+geomodelgrids::serial::TestCQuery::testQueryElevationBatch(void) {
+    const size_t numModels = 2;
+    const char* const filenames[numModels] = {
+        "../../data/one-block-flat.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+
+    const size_t numValues = 0;
+    const char* const* valueNames = nullptr;
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    geomodelgrids::testdata::OutsideDomainPoints pointsOutside;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Horizontal coordinates of points in model followed by points outside domain (skip first 2 points
+    // with z causing point to be outside domain).
+    std::vector<double> points;
+    for (size_t iPt = 0; iPt < pointsThree.getNumPoints(); ++iPt) {
+        points.push_back(pointsThree.getLatLonElev()[iPt*spaceDim+0]);
+        points.push_back(pointsThree.getLatLonElev()[iPt*spaceDim+1]);
+    } // for
+    const size_t numPointsIn = points.size() / 2;
+    for (size_t iPt = 2; iPt < pointsOutside.getNumPoints(); ++iPt) {
+        points.push_back(pointsOutside.getLatLonElev()[iPt*spaceDim+0]);
+        points.push_back(pointsOutside.getLatLonElev()[iPt*spaceDim+1]);
+    } // for
+    const size_t numPoints = points.size() / 2;
+
+    void* handle = geomodelgrids_squery_create();REQUIRE(handle);
+    int err = geomodelgrids_squery_initialize(handle, filenames, numModels, valueNames, numValues, crs.c_str());
+    REQUIRE(!err);
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;REQUIRE(query);
+
+    const double tolerance = 1.0e-10;
+    std::vector<double> elevations(numPoints);
+    { // Top elevation
+        err = geomodelgrids_squery_queryTopElevationBatch(handle, numPointsIn, &points[0], &elevations[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::OK == err);
+        err = geomodelgrids_squery_queryTopElevationBatch(handle, numPoints, &points[0], &elevations[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        query->getErrorHandler()->resetStatus();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double elevationE = geomodelgrids_squery_queryTopElevation(handle, points[2*iPt+0], points[2*iPt+1]);
+            INFO("Mismatch for point (" << points[2*iPt+0] << ", " << points[2*iPt+1] << ").");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(elevationE));
+            CHECK_THAT(elevations[iPt], Catch::Matchers::WithinAbs(elevationE, valueTolerance));
+        } // for
+        query->getErrorHandler()->resetStatus();
+    } // Top elevation
+
+    { // Topography/bathymetry elevation
+        err = geomodelgrids_squery_queryTopoBathyElevationBatch(handle, numPointsIn, &points[0], &elevations[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::OK == err);
+        err = geomodelgrids_squery_queryTopoBathyElevationBatch(handle, numPoints, &points[0], &elevations[0]);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        query->getErrorHandler()->resetStatus();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double elevationE = geomodelgrids_squery_queryTopoBathyElevation(handle, points[2*iPt+0], points[2*iPt+1]);
+            INFO("Mismatch for point (" << points[2*iPt+0] << ", " << points[2*iPt+1] << ").");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(elevationE));
+            CHECK_THAT(elevations[iPt], Catch::Matchers::WithinAbs(elevationE, valueTolerance));
+        } // for
+        query->getErrorHandler()->resetStatus();
+    } // Topography/bathymetry elevation
+
+    // Bad arguments
+    err = geomodelgrids_squery_queryTopElevationBatch(handle, numPoints, nullptr, &elevations[0]);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+    query->getErrorHandler()->resetStatus();
+    err = geomodelgrids_squery_queryTopoBathyElevationBatch(nullptr, numPoints, &points[0], &elevations[0]);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == err);
+
+    geomodelgrids_squery_destroy(&handle);REQUIRE(!handle);
+} // testQueryElevationBatch
+
+
+// ------------------------------------------------------------------------------------------------
+// Test concurrent queries with query contexts.
+void
+geomodelgrids::serial::TestCQuery::testQueryContext(void) {
+    const size_t numModels = 2;
+    const char* const filenames[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+
+    const size_t numValues = 2;
+    const char* const valueNames[numValues] = { "two", "one" };
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const double* pointsLLE = points.getLatLonElev();
+    const std::string& crs = points.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    void* handle = geomodelgrids_squery_create();REQUIRE(handle);
+    CHECK(!geomodelgrids_squery_createContext(handle));
+    geomodelgrids::serial::Query* query = (geomodelgrids::serial::Query*) handle;REQUIRE(query);
+    query->getErrorHandler()->resetStatus();
+
+    int err = geomodelgrids_squery_initialize(handle, filenames, numModels, valueNames, numValues, crs.c_str());
+    REQUIRE(!err);
+
+    // Expected values using default context.
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<double> elevationE(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* xyz = &pointsLLE[iPt*spaceDim];
+        err = geomodelgrids_squery_query(handle, &valuesE[iPt*numValues], xyz[0], xyz[1], xyz[2]);REQUIRE(!err);
+        elevationE[iPt] = geomodelgrids_squery_queryTopElevation(handle, xyz[0], xyz[1]);
+    } // for
+    std::vector<double> pointsXY(numPoints*2);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        pointsXY[2*iPt+0] = pointsLLE[iPt*spaceDim+0];
+        pointsXY[2*iPt+1] = pointsLLE[iPt*spaceDim+1];
+    } // for
+
+    const size_t numThreads = 4;
+    std::vector<std::vector<double> > values(numThreads, std::vector<double>(numPoints*numValues));
+    std::vector<std::vector<double> > valuesBatch(numThreads, std::vector<double>(numPoints*numValues));
+    std::vector<std::vector<int> > statusBatch(numThreads, std::vector<int>(numPoints));
+    std::vector<std::vector<double> > elevation(numThreads, std::vector<double>(numPoints));
+    std::vector<int> errThread(numThreads, geomodelgrids::utils::ErrorHandler::ERROR);
+
+    std::vector<std::thread> threads;
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads.push_back(std::thread([&, iThread](void) {
+            void* context = geomodelgrids_squery_createContext(handle);
+            if (!context) { return; }
+            int errTotal = 0;
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                const double* xyz = &pointsLLE[iPt*spaceDim];
+                errTotal += geomodelgrids_squery_queryWithContext(handle, context, &values[iThread][iPt*numValues],
+                                                                  xyz[0], xyz[1], xyz[2]);
+            } // for
+            errTotal += geomodelgrids_squery_queryBatchWithContext(handle, context, numPoints, pointsLLE,
+                                                                   &valuesBatch[iThread][0], &statusBatch[iThread][0]);
+            errTotal += geomodelgrids_squery_queryTopElevationBatchWithContext(handle, context, numPoints, &pointsXY[0],
+                                                                               &elevation[iThread][0]);
+            errTotal += geomodelgrids_squery_getContextErrorHandler(context) ? 0 : 1;
+            geomodelgrids_squery_destroyContext(&context);
+            errTotal += context ? 1 : 0;
+            errThread[iThread] = errTotal;
+        }));
+    } // for
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads[iThread].join();
+    } // for
+
+    const double tolerance = 1.0e-10;
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        CHECK(0 == errThread[iThread]);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for thread " << iThread << " at point (" << pointsLLE[iPt*spaceDim+0] << ", "
+                                        << pointsLLE[iPt*spaceDim+1] << ", " << pointsLLE[iPt*spaceDim+2] << ").");
+            CHECK(geomodelgrids::utils::ErrorHandler::OK == statusBatch[iThread][iPt]);
+            CHECK_THAT(elevation[iThread][iPt], Catch::Matchers::WithinAbs(elevationE[iPt], tolerance));
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                const double valueE = valuesE[iPt*numValues+iValue];
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                CHECK_THAT(values[iThread][iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                CHECK_THAT(valuesBatch[iThread][iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+            } // for
+        } // for
+    } // for
+
+    // Bad arguments
+    double valuesBad[numValues];
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == geomodelgrids_squery_queryWithContext(handle, nullptr, valuesBad, 0.0, 0.0, 0.0));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == geomodelgrids_squery_queryBatchWithContext(nullptr, nullptr, 0, nullptr, nullptr, nullptr));
+    CHECK(!geomodelgrids_squery_getContextErrorHandler(nullptr));
+    CHECK(!geomodelgrids_squery_createContext(nullptr));
+    geomodelgrids_squery_destroyContext(nullptr);
+
+    geomodelgrids_squery_destroy(&handle);REQUIRE(!handle);
+} // testQueryContext
+
+
 // End of file
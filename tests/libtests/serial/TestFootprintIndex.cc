@@ -0,0 +1,223 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::FootprintIndex.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/FootprintIndex.hh" // USES FootprintIndex
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cmath> // USES M_PI, cos(), sin()
+#include <vector> // USES std::vector
+#include <limits> // USES std::numeric_limits
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestFootprintIndex;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestFootprintIndex {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test initialize() and isCandidate().
+    static
+    void testCandidates(void);
+
+    /// Test initialize() with unknown footprints.
+    static
+    void testUnknown(void);
+
+    /// Test initialize() with curved footprint.
+    static
+    void testCurved(void);
+
+}; // class TestFootprintIndex
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestFootprintIndex::testConstructor", "[TestFootprintIndex]") {
+    geomodelgrids::serial::TestFootprintIndex::testConstructor();
+}
+TEST_CASE("TestFootprintIndex::testCandidates", "[TestFootprintIndex]") {
+    geomodelgrids::serial::TestFootprintIndex::testCandidates();
+}
+TEST_CASE("TestFootprintIndex::testUnknown", "[TestFootprintIndex]") {
+    geomodelgrids::serial::TestFootprintIndex::testUnknown();
+}
+TEST_CASE("TestFootprintIndex::testCurved", "[TestFootprintIndex]") {
+    geomodelgrids::serial::TestFootprintIndex::testCurved();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestFootprintIndex::testConstructor(void) {
+    FootprintIndex index;
+
+    CHECK(size_t(0) == index.getNumModels());
+    CHECK(size_t(0) == index._numCells[0]);
+    CHECK(size_t(0) == index._numCells[1]);
+    CHECK(index._cellModels.empty());
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize() and isCandidate().
+void
+geomodelgrids::serial::TestFootprintIndex::testCandidates(void) {
+    // Small model nested inside rotated model nested inside large model.
+    std::vector<std::vector<double> > footprints(3);
+    const double small[4*2] = {
+        1.0, 1.0,
+        2.0, 1.0,
+        2.0, 2.0,
+        1.0, 2.0,
+    };
+    footprints[0].assign(small, small+8);
+    const double rotated[4*2] = {
+        0.0, -5.0,
+        5.0, 0.0,
+        0.0, 5.0,
+        -5.0, 0.0,
+    };
+    footprints[1].assign(rotated, rotated+8);
+    const double large[4*2] = {
+        -10.0, -10.0,
+        +10.0, -10.0,
+        +10.0, +10.0,
+        -10.0, +10.0,
+    };
+    footprints[2].assign(large, large+8);
+
+    FootprintIndex index;
+    index.initialize(footprints, std::vector<double>(3, 0.1), 40);
+    REQUIRE(size_t(3) == index.getNumModels());
+
+    struct Point {
+        double x;
+        double y;
+        bool isCandidate[3];
+    };
+    const size_t numPoints = 6;
+    const Point points[numPoints] = {
+        { 1.5, 1.5, { true, true, true } },
+        { 0.0, 0.0, { false, true, true } },
+        { 4.0, -4.0, { false, false, true } },
+        { 9.9, 9.9, { false, false, true } },
+        { -9.9, 0.0, { false, false, true } },
+        { 30.0, 0.0, { false, false, false } },
+    };
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const Point& pt = points[iPt];
+        for (size_t iModel = 0; iModel < 3; ++iModel) {
+            INFO("Mismatch for model " << iModel << " at point (" << pt.x << ", " << pt.y << ").");
+            CHECK(pt.isCandidate[iModel] == index.isCandidate(iModel, pt.x, pt.y));
+        } // for
+    } // for
+
+    // Every vertex of a footprint is a candidate for its model.
+    for (size_t iModel = 0; iModel < 3; ++iModel) {
+        const std::vector<double>& polygon = footprints[iModel];
+        for (size_t iVertex = 0; iVertex < polygon.size()/2; ++iVertex) {
+            CHECK(index.isCandidate(iModel, polygon[2*iVertex+0], polygon[2*iVertex+1]));
+        } // for
+    } // for
+} // testCandidates
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize() with unknown footprints.
+void
+geomodelgrids::serial::TestFootprintIndex::testUnknown(void) {
+    std::vector<std::vector<double> > footprints(4);
+    const double square[4*2] = {
+        0.0, 0.0,
+        1.0, 0.0,
+        1.0, 1.0,
+        0.0, 1.0,
+    };
+    footprints[0].assign(square, square+8);
+    footprints[2].assign(square, square+8);
+    footprints[2][3] = std::numeric_limits<double>::infinity();
+    footprints[3].assign(square, square+8);
+
+    std::vector<double> margins(4, 0.01);
+    margins[3] = -1.0;
+
+    FootprintIndex index;
+    index.initialize(footprints, margins);
+
+    CHECK(index.isCandidate(0, 0.5, 0.5));
+    CHECK(index.isCandidate(1, 0.5, 0.5));
+    CHECK(index.isCandidate(2, 0.5, 0.5));
+    CHECK(index.isCandidate(3, 0.5, 0.5));
+
+    CHECK_FALSE(index.isCandidate(0, 5.0, 5.0));
+    CHECK(index.isCandidate(1, 5.0, 5.0));
+    CHECK(index.isCandidate(2, 5.0, 5.0));
+    CHECK(index.isCandidate(3, 5.0, 5.0));
+
+    { // No known footprints
+        FootprintIndex indexEmpty;
+        indexEmpty.initialize(std::vector<std::vector<double> >(2), std::vector<double>(2, 0.0));
+        CHECK(indexEmpty.isCandidate(0, 0.5, 0.5));
+        CHECK(indexEmpty.isCandidate(1, 5.0, 5.0));
+    } // No known footprints
+} // testUnknown
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize() with curved footprint.
+void
+geomodelgrids::serial::TestFootprintIndex::testCurved(void) {
+    // Circle approximated by chords between 8 vertices. The boundary deviates from each chord by the
+    // sagitta, which is largest at the midpoint of the arc.
+    const double radius = 10.0;
+    const size_t numVertices = 8;
+    const double dAngle = 2.0*M_PI / numVertices;
+    std::vector<std::vector<double> > footprints(1);
+    for (size_t iVertex = 0; iVertex < numVertices; ++iVertex) {
+        footprints[0].push_back(radius*cos(iVertex*dAngle));
+        footprints[0].push_back(radius*sin(iVertex*dAngle));
+    } // for
+    const double sagitta = radius * (1.0 - cos(0.5*dAngle));
+
+    // Cells are much smaller than the sagitta.
+    const size_t numCells = 200;
+    FootprintIndex index;
+    index.initialize(footprints, std::vector<double>(1, sagitta), numCells);
+
+    // Without padding, points on the boundary at the midpoints of the arcs are outside the footprint.
+    FootprintIndex indexNoMargin;
+    indexNoMargin.initialize(footprints, std::vector<double>(1, 0.0), numCells);
+
+    const size_t numPoints = 360;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double angle = 2.0*M_PI * iPt / numPoints;
+        const double x = radius*cos(angle);
+        const double y = radius*sin(angle);
+        INFO("Mismatch for point (" << x << ", " << y << ").");
+        CHECK(index.isCandidate(0, x, y));
+    } // for
+    for (size_t iVertex = 0; iVertex < numVertices; ++iVertex) {
+        const double angle = (iVertex+0.5) * dAngle;
+        const double x = radius*cos(angle);
+        const double y = radius*sin(angle);
+        INFO("Mismatch for point (" << x << ", " << y << ").");
+        CHECK(index.isCandidate(0, x, y));
+        CHECK_FALSE(indexNoMargin.isCandidate(0, x, y));
+    } // for
+
+    // Points well outside the padded footprint are not candidates.
+    CHECK_FALSE(index.isCandidate(0, 0.0, radius + 2.0*sagitta));
+    CHECK_FALSE(index.isCandidate(0, 0.95*radius, 0.95*radius));
+} // testCurved
+
+
+// End of file
@@ -42,6 +42,9 @@ public:
     /// Test getDatasetDims().
     void testGetDatasetDims(void);
 
+    /// Test getDatasetChunkDims().
+    void testGetDatasetChunkDims(void);
+
     /// Test getGroupDatasets().
     void testGetGroupDatasets(void);
 
@@ -81,6 +84,9 @@ TEST_CASE("TestHDF5::testAccessors", "[TestHDF5]") {
 TEST_CASE("TestHDF5::testGetDatasetDims", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testGetDatasetDims();
 }
+TEST_CASE("TestHDF5::testGetDatasetChunkDims", "[TestHDF5]") {
+    geomodelgrids::serial::TestHDF5().testGetDatasetChunkDims();
+}
 TEST_CASE("TestHDF5::testGetGroupDatasets", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testGetGroupDatasets();
 }
@@ -204,6 +210,32 @@ geomodelgrids::serial::TestHDF5::testGetDatasetDims(void) {
 } // testGetDatasetDims
 
 
+// ------------------------------------------------------------------------------------------------
+// Test getDatasetChunkDims().
+void
+geomodelgrids::serial::TestHDF5::testGetDatasetChunkDims(void) {
+    HDF5 h5;
+    h5.open("../../data/three-blocks-flat.h5", H5F_ACC_RDONLY);
+
+    const int ndimsE = 4;
+    const hsize_t dimsE[ndimsE] = { 2, 2, 3, 2 };
+    hsize_t* dims = nullptr;
+    int ndims = 0;
+    h5.getDatasetChunkDims(&dims, &ndims, "/blocks/middle");
+    REQUIRE(ndimsE == ndims);
+    for (int i = 0; i < ndimsE; ++i) {
+        CHECK(dimsE[i] == dims[i]);
+    } // for
+    delete[] dims;dims = nullptr;
+
+    CHECK_THROWS_AS(h5.getDatasetChunkDims(&dims, &ndims, "blah"), std::runtime_error);
+    CHECK(!dims);
+    CHECK(0 == ndims);
+
+    h5.close();
+} // testGetDatasetChunkDims
+
+
 // ------------------------------------------------------------------------------------------------
 // Test getGroupDatasets().
 void
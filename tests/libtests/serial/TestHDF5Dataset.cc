@@ -0,0 +1,182 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::HDF5Dataset.
+ */
+
+#include <portinfo>
+
+#include "tests/data/ModelPoints.hh" // USES ModelPoints
+
+#include "geomodelgrids/serial/HDF5Dataset.hh" // USES HDF5Dataset
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <cmath> // USES fabs()
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestHDF5Dataset;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestHDF5Dataset {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestHDF5Dataset(void);
+
+    /// Destructor.
+    ~TestHDF5Dataset(void);
+
+    /// Test constructor and accessors.
+    void testConstructor(void);
+
+    /// Test readHyperslab().
+    void testReadHyperslab(void);
+
+private:
+
+    H5E_auto2_t _errFunc;
+    void* _errData;
+
+}; // class TestHDF5Dataset
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestHDF5Dataset::testConstructor", "[TestHDF5Dataset]") {
+    geomodelgrids::serial::TestHDF5Dataset().testConstructor();
+}
+TEST_CASE("TestHDF5Dataset::testReadHyperslab", "[TestHDF5Dataset]") {
+    geomodelgrids::serial::TestHDF5Dataset().testReadHyperslab();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::TestHDF5Dataset::TestHDF5Dataset(void) {
+    // Temporarily turn off HDF5 error handler.
+    H5Eget_auto(H5E_DEFAULT, &_errFunc, &_errData);
+    H5Eset_auto(H5E_DEFAULT, nullptr, nullptr);
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::TestHDF5Dataset::~TestHDF5Dataset(void) {
+    // Restore default HDF5 error handler.
+    H5Eset_auto(H5E_DEFAULT, _errFunc, _errData);
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor and accessors.
+void
+geomodelgrids::serial::TestHDF5Dataset::testConstructor(void) {
+    HDF5 h5;
+    h5.open("../../data/three-blocks-flat.h5", H5F_ACC_RDONLY);
+
+    { // Existing dataset
+        HDF5Dataset dataset(&h5, "/blocks/top");
+        CHECK(std::string("/blocks/top") == dataset.getPath());
+        CHECK(dataset._dataset >= 0);
+        CHECK(dataset._dataspace >= 0);
+        CHECK(dataset._memspace < 0);
+
+        hsize_t* dimsE = nullptr;
+        int ndimsE = 0;
+        h5.getDatasetDims(&dimsE, &ndimsE, "/blocks/top");
+        const std::vector<hsize_t>& dims = dataset.getDims();
+        REQUIRE(size_t(ndimsE) == dims.size());
+        for (int i = 0; i < ndimsE; ++i) {
+            CHECK(dimsE[i] == dims[i]);
+        } // for
+        delete[] dimsE;dimsE = nullptr;
+    } // Existing dataset
+
+    CHECK_THROWS_AS(HDF5Dataset(&h5, "/blocks/nonexistent"), std::runtime_error);
+
+    h5.close();
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test readHyperslab().
+void
+geomodelgrids::serial::TestHDF5Dataset::testReadHyperslab(void) {
+    const char* path = "/blocks/top";
+
+    HDF5 h5;
+    h5.open("../../data/three-blocks-flat.h5", H5F_ACC_RDONLY);
+
+    double dx = 0.0;
+    double dy = 0.0;
+    double dz = 0.0;
+    double z_top = 0.0;
+    h5.readAttribute(path, "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    h5.readAttribute(path, "y_resolution", H5T_NATIVE_DOUBLE, &dy);
+    h5.readAttribute(path, "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    h5.readAttribute(path, "z_top", H5T_NATIVE_DOUBLE, &z_top);
+
+    HDF5Dataset dataset(&h5, path);
+
+    // Read several hyperslabs with the same dimensions and then one with different dimensions.
+    const int ndims = 4;
+    const size_t numSlabs = 3;
+    const hsize_t originSlabs[numSlabs][ndims] = {
+        { 3, 3, 1, 0 },
+        { 0, 1, 0, 0 },
+        { 1, 0, 0, 0 },
+    };
+    const hsize_t dimsSlabs[numSlabs][ndims] = {
+        { 2, 3, 1, 2 },
+        { 2, 3, 1, 2 },
+        { 1, 2, 2, 2 },
+    };
+    const int nvalues = 2*3*1*2;
+    double values[nvalues];
+
+    const double tolerance = 1.0e-6;
+    for (size_t iSlab = 0; iSlab < numSlabs; ++iSlab) {
+        const hsize_t* origin = originSlabs[iSlab];
+        const hsize_t* dims = dimsSlabs[iSlab];
+        dataset.readHyperslab((void*)values, origin, dims, ndims, H5T_NATIVE_DOUBLE);
+        CHECK(dataset._memspace >= 0);
+        CHECK(std::vector<hsize_t>(dims, dims+ndims) == dataset._memspaceDims);
+
+        for (hsize_t ix = 0, i = 0; ix < dims[0]; ++ix) {
+            const double x = dx * (origin[0] + ix);
+            for (hsize_t iy = 0; iy < dims[1]; ++iy) {
+                const double y = dy * (origin[1] + iy);
+                for (hsize_t iz = 0; iz < dims[2]; ++iz) {
+                    const double z = z_top - dz * (origin[2] + iz);
+
+                    { // Value 0
+                        INFO("Checking hyperslab "<<iSlab<<" index ("<<ix<<","<<iy<<","<<iz<<",0).");
+                        const double valueE = geomodelgrids::testdata::ModelPoints::computeValueOne(x, y, z);
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                        CHECK_THAT(values[i++], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                    } // Value 0
+                    { // Value 1
+                        INFO("Checking hyperslab "<<iSlab<<" index ("<<ix<<","<<iy<<","<<iz<<",1).");
+                        const double valueE = geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z);
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                        CHECK_THAT(values[i++], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                    } // Value 1
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // Bad number of dimensions
+    hsize_t origin[ndims] = { 3, 3, 1, 0 };
+    hsize_t dims[ndims] = { 2, 3, 1, 2 };
+    CHECK_THROWS_AS(dataset.readHyperslab((void*)values, origin, dims, 1, H5T_NATIVE_DOUBLE), std::runtime_error);
+
+    // Bad dimensions
+    origin[ndims-1] = 99999;
+    CHECK_THROWS_AS(dataset.readHyperslab((void*)values, origin, dims, ndims, H5T_NATIVE_DOUBLE),
+                    std::runtime_error);
+} // testReadHyperslab
+
+
+// End of file
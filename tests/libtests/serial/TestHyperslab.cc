@@ -14,6 +14,7 @@
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <stdexcept> // USES std::length_error
 
 namespace geomodelgrids {
     namespace serial {
@@ -49,6 +50,24 @@ public:
     /// Test interpolate in 2D.
     void testInterpolate3D(void);
 
+    /// Test query with interpolation or nearest point for each value.
+    void testQuery(void);
+
+    /// Test interpolation at multiple points.
+    void testInterpolateMany(void);
+
+    /// Test tile cache.
+    void testCache(void);
+
+    /// Test chunk-aligned tiles.
+    void testChunks(void);
+
+    /// Test dataset resident in memory.
+    void testResident(void);
+
+    /// Test values stored in single precision.
+    void testSinglePrecision(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -76,6 +95,24 @@ TEST_CASE("TestHyperslab::testInterpolate2D", "[TestHyperslab]") {
 TEST_CASE("TestHyperslab::testInterpolate3D", "[TestHyperslab]") {
     geomodelgrids::serial::TestHyperslab().testInterpolate3D();
 }
+TEST_CASE("TestHyperslab::testQuery", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testQuery();
+}
+TEST_CASE("TestHyperslab::testInterpolateMany", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testInterpolateMany();
+}
+TEST_CASE("TestHyperslab::testCache", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testCache();
+}
+TEST_CASE("TestHyperslab::testChunks", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testChunks();
+}
+TEST_CASE("TestHyperslab::testResident", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testResident();
+}
+TEST_CASE("TestHyperslab::testSinglePrecision", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testSinglePrecision();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor.
@@ -98,6 +135,7 @@ geomodelgrids::serial::TestHyperslab::testConstructor2D(void) {
     const std::string dataset("/surfaces/top_surface");
     const size_t ndims(3);
     const hsize_t dims[ndims] = { 3, 4, 1 };
+    const hsize_t dimsE[ndims] = { 4, 4, 1 }; // Whole chunks (2x2), limited to dataset.
     const hsize_t dimsAll[ndims] = { 4, 5, 1 };
 
     Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
@@ -108,14 +146,14 @@ geomodelgrids::serial::TestHyperslab::testConstructor2D(void) {
     CHECK(!hyperslab._origin);
 
     for (size_t i = 0; i < ndims; ++i) {
-        CHECK(dims[i] == hyperslab._dims[i]);
+        CHECK(dimsE[i] == hyperslab._dims[i]);
     } // for
 
     for (size_t i = 0; i < ndims; ++i) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructor2D
 
@@ -127,6 +165,7 @@ geomodelgrids::serial::TestHyperslab::testConstructor3D(void) {
     const std::string dataset("/blocks/block");
     const size_t ndims(4);
     const hsize_t dims[ndims] = { 3, 2, 1, 2 };
+    const hsize_t dimsE[ndims] = { 3, 2, 2, 2 }; // Whole chunks (1x1x2), limited to dataset.
     const hsize_t dimsAll[ndims] = { 4, 5, 2, 2 };
 
     Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
@@ -137,14 +176,14 @@ geomodelgrids::serial::TestHyperslab::testConstructor3D(void) {
     CHECK(!hyperslab._origin);
 
     for (size_t i = 0; i < ndims; ++i) {
-        CHECK(dims[i] == hyperslab._dims[i]);
+        CHECK(dimsE[i] == hyperslab._dims[i]);
     } // for
 
     for (size_t i = 0; i < ndims; ++i) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructor3D
 
@@ -173,7 +212,7 @@ geomodelgrids::serial::TestHyperslab::testConstructorOversize3D(void) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructorOversize3D
 
@@ -292,4 +331,491 @@ geomodelgrids::serial::TestHyperslab::testInterpolate3D(void) {
 } // testInterplate3D
 
 
+// ------------------------------------------------------------------------------------------------
+// Test query with interpolation or nearest point for each value.
+void
+geomodelgrids::serial::TestHyperslab::testQuery(void) {
+    const size_t npoints(5);
+    const size_t numValues = 2;
+    const size_t flags[4][numValues] = {
+        { 1, 1 },
+        { 0, 0 },
+        { 1, 0 },
+        { 0, 1 },
+    };
+
+    { // 3-D
+        const std::string dataset("/blocks/block");
+        const size_t ndims(4);
+        const hsize_t dims[ndims] = { 2, 3, 2, 2 };
+        const size_t spaceDim = 3;
+        const double index[npoints*spaceDim] = {
+            0.0, 1.0, 0.2,
+            1.3, 1.2, 0.3,
+            2.4, 2.5, 0.9,
+            1.5, 3.5, 0.5,
+            3.0, 1.5, 0.8,
+        };
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        for (size_t i = 0; i < npoints; ++i) {
+            double valuesInterpolate[numValues];
+            double valuesNearest[numValues];
+            hyperslab.interpolate(valuesInterpolate, &index[i*spaceDim]);
+            hyperslab.nearest(valuesNearest, &index[i*spaceDim]);
+            for (size_t iFlags = 0; iFlags < 4; ++iFlags) {
+                double values[numValues] = { -999.0, -999.0 };
+                hyperslab.query(values, &index[i*spaceDim], flags[iFlags]);
+                for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                    INFO("Mismatch in value " << iValue << " with flags " << iFlags << " for index ("
+                                              << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ", "
+                                              << index[i*spaceDim+2] << ").");
+                    const double valueE = (flags[iFlags][iValue]) ? valuesInterpolate[iValue] : valuesNearest[iValue];
+                    CHECK(valueE == values[iValue]);
+                } // for
+            } // for
+        } // for
+    } // 3-D
+
+    { // 2-D
+        const std::string dataset("/surfaces/top_surface");
+        const size_t ndims(3);
+        const hsize_t dims[ndims] = { 2, 2, 1 };
+        const size_t spaceDim = 2;
+        const double index[npoints*spaceDim] = {
+            0.0, 0.0,
+            0.5, 0.5,
+            2.5, 3.5,
+            1.5, 1.5,
+            2.2, 0.7,
+        };
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        for (size_t i = 0; i < npoints; ++i) {
+            double valueInterpolate = -999.0;
+            double valueNearest = -999.0;
+            hyperslab.interpolate(&valueInterpolate, &index[i*spaceDim]);
+            hyperslab.nearest(&valueNearest, &index[i*spaceDim]);
+            for (size_t iFlags = 0; iFlags < 2; ++iFlags) {
+                INFO("Mismatch with flags " << iFlags << " for index (" << index[i*spaceDim+0] << ", "
+                                            << index[i*spaceDim+1] << ").");
+                double value = -999.0;
+                hyperslab.query(&value, &index[i*spaceDim], flags[iFlags]);
+                CHECK(((flags[iFlags][0]) ? valueInterpolate : valueNearest) == value);
+            } // for
+        } // for
+    } // 2-D
+} // testQuery
+
+
+// ------------------------------------------------------------------------------------------------
+// Test interpolation at multiple points.
+void
+geomodelgrids::serial::TestHyperslab::testInterpolateMany(void) {
+    const size_t npoints(5);
+
+    { // 3-D
+        const std::string dataset("/blocks/block");
+        const size_t ndims(4);
+        const hsize_t dims[ndims] = { 2, 3, 2, 2 };
+        const size_t spaceDim = 3;
+        const size_t numValues = 2;
+        const double index[npoints*spaceDim] = {
+            0.0, 1.0, 0.2,
+            1.3, 1.2, 0.3,
+            2.4, 2.5, 0.9,
+            1.5, 3.5, 0.5,
+            3.0, 1.5, 0.8,
+        };
+
+        Hyperslab hyperslabMany(&_h5, dataset.c_str(), dims, ndims);
+        double values[npoints*numValues];
+        hyperslabMany.interpolateMany(values, index, npoints);
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        for (size_t i = 0; i < npoints; ++i) {
+            double valuesE[numValues];
+            hyperslab.interpolate(valuesE, &index[i*spaceDim]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch in value " << iValue << " for index (" << index[i*spaceDim+0] << ", "
+                                          << index[i*spaceDim+1] << ", " << index[i*spaceDim+2] << ").");
+                CHECK(valuesE[iValue] == values[i*numValues+iValue]);
+            } // for
+        } // for
+
+        // Points in one tile are interpolated with a single tile lookup.
+        const size_t nrun(4);
+        const double indexRun[nrun*spaceDim] = {
+            0.2, 0.5, 0.3,
+            0.9, 1.7, 0.1,
+            0.5, 1.2, 0.8,
+            1.0, 2.0, 1.0,
+        };
+        Hyperslab hyperslabRun(&_h5, dataset.c_str(), dims, ndims);
+        double valuesRun[nrun*numValues];
+        hyperslabRun.interpolateMany(valuesRun, indexRun, nrun);
+
+        size_t numHits = 0;
+        size_t numMisses = 0;
+        hyperslabRun.getCacheStats(&numHits, &numMisses);
+        CHECK(size_t(0) == numHits);
+        CHECK(size_t(1) == numMisses);
+        for (size_t i = 0; i < nrun; ++i) {
+            double valuesE[numValues];
+            hyperslab.interpolate(valuesE, &indexRun[i*spaceDim]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch in value " << iValue << " for index (" << indexRun[i*spaceDim+0] << ", "
+                                          << indexRun[i*spaceDim+1] << ", " << indexRun[i*spaceDim+2] << ").");
+                CHECK(valuesE[iValue] == valuesRun[i*numValues+iValue]);
+            } // for
+        } // for
+    } // 3-D
+
+    { // 2-D
+        const std::string dataset("/surfaces/top_surface");
+        const size_t ndims(3);
+        const hsize_t dims[ndims] = { 2, 2, 1 };
+        const size_t spaceDim = 2;
+        const double index[npoints*spaceDim] = {
+            0.0, 0.0,
+            0.5, 0.5,
+            2.5, 3.5,
+            1.5, 1.5,
+            2.2, 0.7,
+        };
+
+        Hyperslab hyperslabMany(&_h5, dataset.c_str(), dims, ndims);
+        double values[npoints];
+        hyperslabMany.interpolateMany(values, index, npoints);
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        for (size_t i = 0; i < npoints; ++i) {
+            INFO("Mismatch for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ").");
+            double valueE = -999.0;
+            hyperslab.interpolate(&valueE, &index[i*spaceDim]);
+            CHECK(valueE == values[i]);
+        } // for
+
+        // No points.
+        hyperslabMany.interpolateMany(nullptr, nullptr, 0);
+    } // 2-D
+} // testInterpolateMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Test tile cache.
+void
+geomodelgrids::serial::TestHyperslab::testCache(void) {
+    const std::string dataset("/surfaces/top_surface");
+    const size_t ndims(3);
+    const hsize_t dims[ndims] = { 2, 2, 1 }; // One chunk (2x2).
+
+    // Sequence of points with expected cumulative hits and misses.
+    const size_t npoints(6);
+    const size_t spaceDim = 2;
+    const double index[npoints*spaceDim] = {
+        0.5, 0.5, // miss, tile (0,0)
+        0.2, 0.7, // hit, current tile
+        2.5, 2.5, // miss, tile (1,1)
+        0.5, 0.5, // hit, resident tile (0,0)
+        2.5, 0.5, // miss, tile (1,0), evicts tile (1,1)
+        2.5, 2.5, // miss, tile (1,1)
+    };
+    const size_t numHitsE[npoints] = { 0, 1, 1, 2, 2, 2 };
+    const size_t numMissesE[npoints] = { 1, 1, 2, 2, 3, 4 };
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+    const size_t tileBytes = 2*2*1*sizeof(double);
+    hyperslab.setCacheSize(2*tileBytes);
+    CHECK(2*tileBytes == hyperslab.getCacheSize());
+    CHECK(size_t(2) == hyperslab.getCacheCapacity());
+
+    double dx = 0.0;
+    double dy = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, &dy);
+
+    double elevation = -999.0;
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < npoints; ++i) {
+        hyperslab.interpolate(&elevation, &index[i*spaceDim]);
+
+        const double x = dx * index[i*spaceDim + 0];
+        const double y = dy * index[i*spaceDim + 1];
+        const double elevationE = geomodelgrids::testdata::ModelPoints::computeTopElevation(x, y);
+
+        INFO("Mismatch for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ").");
+        const double toleranceV = std::max(tolerance, tolerance*fabs(elevationE));
+        CHECK_THAT(elevation, Catch::Matchers::WithinAbs(elevationE, toleranceV));
+
+        size_t numHits = 0;
+        size_t numMisses = 0;
+        hyperslab.getCacheStats(&numHits, &numMisses);
+        CHECK(numHitsE[i] == numHits);
+        CHECK(numMissesE[i] == numMisses);
+    } // for
+
+    // Cache always holds at least one tile.
+    hyperslab.setCacheSize(0);
+    CHECK(size_t(1) == hyperslab.getCacheCapacity());
+    hyperslab.resetCacheStats();
+    size_t numHits = 1;
+    size_t numMisses = 1;
+    hyperslab.getCacheStats(&numHits, &numMisses);
+    CHECK(size_t(0) == numHits);
+    CHECK(size_t(0) == numMisses);
+
+    hyperslab.interpolate(&elevation, &index[0]);
+    hyperslab.interpolate(&elevation, &index[4*spaceDim]);
+    hyperslab.getCacheStats(&numHits, &numMisses);
+    CHECK(size_t(0) == numHits);
+    CHECK(size_t(2) == numMisses);
+} // testCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Test chunk-aligned tiles.
+void
+geomodelgrids::serial::TestHyperslab::testChunks(void) {
+    { // 2-D: dataset 4x5 with 2x2 chunks, so 2x3 tiles (last row of tiles is 1 point wide).
+        const std::string dataset("/surfaces/top_surface");
+        const size_t ndims(3);
+        const hsize_t dims[ndims] = { 2, 2, 1 };
+        const size_t spaceDim = 2;
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        Hyperslab hyperslabE(&_h5, dataset.c_str(), dims, ndims);
+        hyperslabE.setResident(Hyperslab::readResident(&_h5, dataset.c_str()));
+
+        // Points on a grid with spacing of 0.5 cover cells within tiles and cells spanning tiles.
+        for (size_t ix = 0; ix <= 6; ++ix) {
+            for (size_t iy = 0; iy <= 8; ++iy) {
+                const double index[spaceDim] = { 0.5*ix, 0.5*iy };
+                double value = -999.0;
+                hyperslab.interpolate(&value, index);
+                double valueE = -999.0;
+                hyperslabE.interpolate(&valueE, index);
+
+                INFO("Mismatch for index (" << index[0] << ", " << index[1] << ").");
+                CHECK_THAT(value, Catch::Matchers::WithinAbs(valueE, 1.0e-10*fabs(valueE)));
+            } // for
+        } // for
+
+        // Each chunk is read once.
+        CHECK(size_t(6) == hyperslab.getNumChunksRead());
+        size_t numMisses = 0;
+        hyperslab.getCacheStats(nullptr, &numMisses);
+        CHECK(size_t(6) == numMisses);
+
+        hyperslab.resetCacheStats();
+        CHECK(size_t(0) == hyperslab.getNumChunksRead());
+    } // 2-D
+
+    { // 3-D: dataset 4x5x2 with 1x1x2 chunks, so 2x3x1 tiles (last row of tiles is 1 point wide).
+        const std::string dataset("/blocks/block");
+        const size_t ndims(4);
+        const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+        const size_t spaceDim = 3;
+        const size_t numValues = 2;
+        const size_t useInterpolation[numValues] = { 1, 0 };
+
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        Hyperslab hyperslabE(&_h5, dataset.c_str(), dims, ndims);
+        hyperslabE.setResident(Hyperslab::readResident(&_h5, dataset.c_str()));
+
+        for (size_t ix = 0; ix <= 6; ++ix) {
+            for (size_t iy = 0; iy <= 8; ++iy) {
+                for (size_t iz = 0; iz <= 2; ++iz) {
+                    const double index[spaceDim] = { 0.5*ix, 0.5*iy, 0.4*iz };
+                    double values[numValues] = { -999.0, -999.0 };
+                    hyperslab.query(values, index, useInterpolation);
+                    double valuesE[numValues] = { -999.0, -999.0 };
+                    hyperslabE.query(valuesE, index, useInterpolation);
+
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        INFO("Mismatch in value " << iValue << " for index (" << index[0] << ", " << index[1]
+                                                  << ", " << index[2] << ").");
+                        CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], 1.0e-10*fabs(valuesE[iValue])));
+                    } // for
+                } // for
+            } // for
+        } // for
+
+        // Each chunk is read once.
+        CHECK(size_t(20) == hyperslab.getNumChunksRead());
+    } // 3-D
+} // testChunks
+
+
+// ------------------------------------------------------------------------------------------------
+// Test dataset resident in memory.
+void
+geomodelgrids::serial::TestHyperslab::testResident(void) {
+    const std::string dataset("/surfaces/top_surface");
+    const size_t ndims(3);
+    const hsize_t dims[ndims] = { 2, 2, 1 };
+
+    const size_t npoints(4);
+    const size_t spaceDim = 2;
+    const double index[npoints*spaceDim] = {
+        0.5, 0.5,
+        2.5, 3.5,
+        1.5, 1.5,
+        0.0, 0.0,
+    };
+
+    std::shared_ptr<const std::vector<double> > values = Hyperslab::readResident(&_h5, dataset.c_str());
+    REQUIRE(values);
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+    CHECK(!hyperslab.isResident());
+    hyperslab.setResident(values);
+    CHECK(hyperslab.isResident());
+    for (size_t i = 0; i < ndims; ++i) {
+        CHECK(hyperslab._dimsAll[i] == hyperslab._dims[i]);
+    } // for
+    CHECK(values->data() == hyperslab._values);
+
+    double dx = 0.0;
+    double dy = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, &dy);
+
+    double elevation = -999.0;
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < npoints; ++i) {
+        hyperslab.interpolate(&elevation, &index[i*spaceDim]);
+
+        const double x = dx * index[i*spaceDim + 0];
+        const double y = dy * index[i*spaceDim + 1];
+        const double elevationE = geomodelgrids::testdata::ModelPoints::computeTopElevation(x, y);
+
+        INFO("Mismatch for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ").");
+        const double toleranceV = std::max(tolerance, tolerance*fabs(elevationE));
+        CHECK_THAT(elevation, Catch::Matchers::WithinAbs(elevationE, toleranceV));
+    } // for
+
+    // No reads from the HDF5 file.
+    size_t numHits = 0;
+    size_t numMisses = 1;
+    hyperslab.getCacheStats(&numHits, &numMisses);
+    CHECK(npoints == numHits);
+    CHECK(size_t(0) == numMisses);
+
+    // Resident values must match size of dataset.
+    std::shared_ptr<const std::vector<double> > valuesBad = std::make_shared<const std::vector<double> >(3);
+    CHECK_THROWS_AS(hyperslab.setResident(valuesBad), std::length_error);
+} // testResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Test values stored in single precision.
+void
+geomodelgrids::serial::TestHyperslab::testSinglePrecision(void) {
+    const size_t npoints(5);
+    const double tolerance = 1.0e-6;
+
+    { // 3-D
+        const std::string dataset("/blocks/block");
+        const size_t ndims(4);
+        const hsize_t dims[ndims] = { 2, 3, 2, 2 };
+        const size_t spaceDim = 3;
+        const size_t numValues = 2;
+        const size_t flags[numValues] = { 1, 0 };
+        const double index[npoints*spaceDim] = {
+            0.0, 1.0, 0.2,
+            1.3, 1.2, 0.3,
+            2.4, 2.5, 0.9,
+            1.5, 3.5, 0.5,
+            3.0, 1.5, 0.8,
+        };
+
+        Hyperslab hyperslabE(&_h5, dataset.c_str(), dims, ndims);
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        CHECK(!hyperslab.isSinglePrecision());
+        const size_t capacityDouble = hyperslab.getCacheCapacity();
+        hyperslab.setSinglePrecision(true);
+        CHECK(hyperslab.isSinglePrecision());
+        CHECK(hyperslab.getCacheCapacity() >= 2*capacityDouble);
+
+        Hyperslab hyperslabResident(&_h5, dataset.c_str(), dims, ndims);
+        std::shared_ptr<const std::vector<float> > valuesResident = Hyperslab::readResidentFloat(&_h5, dataset.c_str());
+        REQUIRE(valuesResident);
+        hyperslabResident.setResident(valuesResident);
+        CHECK(hyperslabResident.isResident());
+        CHECK(hyperslabResident.isSinglePrecision());
+        CHECK(valuesResident->data() == hyperslabResident._values);
+
+        Hyperslab* hyperslabs[2] = { &hyperslab, &hyperslabResident };
+        for (size_t i = 0; i < npoints; ++i) {
+            double valuesInterpolateE[numValues];
+            double valuesNearestE[numValues];
+            double valuesQueryE[numValues];
+            hyperslabE.interpolate(valuesInterpolateE, &index[i*spaceDim]);
+            hyperslabE.nearest(valuesNearestE, &index[i*spaceDim]);
+            hyperslabE.query(valuesQueryE, &index[i*spaceDim], flags);
+            for (size_t iHyperslab = 0; iHyperslab < 2; ++iHyperslab) {
+                double valuesInterpolate[numValues];
+                double valuesNearest[numValues];
+                double valuesQuery[numValues];
+                hyperslabs[iHyperslab]->interpolate(valuesInterpolate, &index[i*spaceDim]);
+                hyperslabs[iHyperslab]->nearest(valuesNearest, &index[i*spaceDim]);
+                hyperslabs[iHyperslab]->query(valuesQuery, &index[i*spaceDim], flags);
+                for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                    INFO("Mismatch in value " << iValue << " for hyperslab " << iHyperslab << " at index ("
+                                              << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ", "
+                                              << index[i*spaceDim+2] << ").");
+                    double toleranceV = std::max(tolerance, tolerance*fabs(valuesInterpolateE[iValue]));
+                    CHECK_THAT(valuesInterpolate[iValue], Catch::Matchers::WithinAbs(valuesInterpolateE[iValue], toleranceV));
+                    toleranceV = std::max(tolerance, tolerance*fabs(valuesNearestE[iValue]));
+                    CHECK_THAT(valuesNearest[iValue], Catch::Matchers::WithinAbs(valuesNearestE[iValue], toleranceV));
+                    toleranceV = std::max(tolerance, tolerance*fabs(valuesQueryE[iValue]));
+                    CHECK_THAT(valuesQuery[iValue], Catch::Matchers::WithinAbs(valuesQueryE[iValue], toleranceV));
+                } // for
+            } // for
+        } // for
+
+        // Precision of resident values cannot be changed.
+        CHECK_THROWS_AS(hyperslabResident.setSinglePrecision(false), std::logic_error);
+    } // 3-D
+
+    { // 2-D
+        const std::string dataset("/surfaces/top_surface");
+        const size_t ndims(3);
+        const hsize_t dims[ndims] = { 2, 2, 1 };
+        const size_t spaceDim = 2;
+        const double index[npoints*spaceDim] = {
+            0.0, 0.0,
+            0.5, 0.5,
+            2.5, 3.5,
+            1.5, 1.5,
+            2.2, 0.7,
+        };
+
+        Hyperslab hyperslabE(&_h5, dataset.c_str(), dims, ndims);
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        hyperslab.setSinglePrecision(true);
+        for (size_t i = 0; i < npoints; ++i) {
+            INFO("Mismatch for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1] << ").");
+            double valueE = -999.0;
+            double value = -999.0;
+            hyperslabE.interpolate(&valueE, &index[i*spaceDim]);
+            hyperslab.interpolate(&value, &index[i*spaceDim]);
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(value, Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // for
+
+        // Switching back to double precision discards tiles in cache.
+        hyperslab.setSinglePrecision(false);
+        CHECK(!hyperslab.isSinglePrecision());
+        CHECK(!hyperslab._values);
+        double value = -999.0;
+        double valueE = -999.0;
+        hyperslabE.interpolate(&valueE, &index[spaceDim]);
+        hyperslab.interpolate(&value, &index[spaceDim]);
+        CHECK(valueE == value);
+    } // 2-D
+} // testSinglePrecision
+
+
 // End of file
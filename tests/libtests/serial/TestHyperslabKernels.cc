@@ -0,0 +1,228 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::HyperslabKernels.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/HyperslabKernels.hh" // Test subject
+
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <algorithm> // USES std::max()
+#include <cmath> // USES fabs()
+#include <stdexcept> // USES std::domain_error
+#include <string> // USES std::string
+#include <vector> // USES std::vector
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestHyperslabKernels;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestHyperslabKernels {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test getInstructionSet(), isSupported(), and getName().
+    static
+    void testInstructionSet(void);
+
+    /// Test kernels for values in double precision against scalar kernels.
+    static
+    void testKernelsDouble(void);
+
+    /// Test kernels for values in single precision against scalar kernels.
+    static
+    void testKernelsFloat(void);
+
+    /// Test getKernel() with bad number of corners.
+    static
+    void testBadCorners(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Check kernels for all supported instruction sets against scalar kernels.
+     *
+     * Values at corners include NODATA_VALUE, and the number of values covers partial vectors for
+     * all instruction sets.
+     */
+    template<typename T>
+    static
+    void _checkKernels(void);
+
+}; // class TestHyperslabKernels
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestHyperslabKernels::testInstructionSet", "[TestHyperslabKernels]") {
+    geomodelgrids::serial::TestHyperslabKernels::testInstructionSet();
+}
+TEST_CASE("TestHyperslabKernels::testKernelsDouble", "[TestHyperslabKernels]") {
+    geomodelgrids::serial::TestHyperslabKernels::testKernelsDouble();
+}
+TEST_CASE("TestHyperslabKernels::testKernelsFloat", "[TestHyperslabKernels]") {
+    geomodelgrids::serial::TestHyperslabKernels::testKernelsFloat();
+}
+TEST_CASE("TestHyperslabKernels::testBadCorners", "[TestHyperslabKernels]") {
+    geomodelgrids::serial::TestHyperslabKernels::testBadCorners();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test getInstructionSet(), isSupported(), and getName().
+void
+geomodelgrids::serial::TestHyperslabKernels::testInstructionSet(void) {
+    CHECK(HyperslabKernels::isSupported(HyperslabKernels::INSTRUCTIONS_SCALAR));
+
+    const HyperslabKernels::InstructionSetEnum instructionSet = HyperslabKernels::getInstructionSet();
+    CHECK(HyperslabKernels::isSupported(instructionSet));
+    for (int i = instructionSet+1; i <= HyperslabKernels::INSTRUCTIONS_AVX512; ++i) {
+        INFO("Instruction set " << HyperslabKernels::getName(HyperslabKernels::InstructionSetEnum(i)) << ".");
+        CHECK(!HyperslabKernels::isSupported(HyperslabKernels::InstructionSetEnum(i)));
+    } // for
+
+    CHECK(std::string("scalar") == HyperslabKernels::getName(HyperslabKernels::INSTRUCTIONS_SCALAR));
+    CHECK(std::string("SSE2") == HyperslabKernels::getName(HyperslabKernels::INSTRUCTIONS_SSE2));
+    CHECK(std::string("AVX2") == HyperslabKernels::getName(HyperslabKernels::INSTRUCTIONS_AVX2));
+    CHECK(std::string("AVX-512") == HyperslabKernels::getName(HyperslabKernels::INSTRUCTIONS_AVX512));
+} // testInstructionSet
+
+
+// ------------------------------------------------------------------------------------------------
+// Test kernels for values in double precision against scalar kernels.
+void
+geomodelgrids::serial::TestHyperslabKernels::testKernelsDouble(void) {
+    _checkKernels<double>();
+} // testKernelsDouble
+
+
+// ------------------------------------------------------------------------------------------------
+// Test kernels for values in single precision against scalar kernels.
+void
+geomodelgrids::serial::TestHyperslabKernels::testKernelsFloat(void) {
+    _checkKernels<float>();
+} // testKernelsFloat
+
+
+// ------------------------------------------------------------------------------------------------
+// Test getKernel() with bad number of corners.
+void
+geomodelgrids::serial::TestHyperslabKernels::testBadCorners(void) {
+    CHECK_THROWS_AS(HyperslabKernels::getKernel<double>(HyperslabKernels::INSTRUCTIONS_SCALAR, 2, false),
+                    std::domain_error);
+    CHECK_THROWS_AS(HyperslabKernels::getKernel<float>(HyperslabKernels::INSTRUCTIONS_SCALAR, 6, true),
+                    std::domain_error);
+} // testBadCorners
+
+
+// ------------------------------------------------------------------------------------------------
+// Check kernels for all supported instruction sets against scalar kernels.
+template<typename T>
+void
+geomodelgrids::serial::TestHyperslabKernels::_checkKernels(void) {
+    const size_t maxValues = 19;
+    const size_t maxCorners = 8;
+
+    // Values at corners followed by values at nearest point, with every fourth value NODATA_VALUE in
+    // every third row.
+    std::vector<T> data((maxCorners+1)*maxValues);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < data.size(); ++i) {
+        seed = 1103515245 * seed + 12345;
+        data[i] = T(-2.0e+3 + 4.0e+3 * double((seed >> 8) % 65536) / 65536.0);
+    } // for
+    for (size_t iCorner = 2; iCorner < maxCorners+1; iCorner += 3) {
+        for (size_t iValue = iCorner % 4; iValue < maxValues; iValue += 4) {
+            data[iCorner*maxValues+iValue] = T(geomodelgrids::NODATA_VALUE);
+        } // for
+    } // for
+
+    const size_t cornerOffsets[maxCorners] = {
+        0*maxValues, 1*maxValues, 2*maxValues, 3*maxValues,
+        4*maxValues, 5*maxValues, 6*maxValues, 7*maxValues,
+    };
+    const size_t nearestOffset = maxCorners*maxValues;
+    const double xRef[3] = { 0.3, 0.85, 0.6 };
+    double wts[maxCorners];
+    for (size_t iCorner = 0; iCorner < maxCorners; ++iCorner) {
+        wts[iCorner] = ((iCorner & 4) ? xRef[0] : 1.0 - xRef[0]) *
+                       ((iCorner & 2) ? xRef[1] : 1.0 - xRef[1]) *
+                       ((iCorner & 1) ? xRef[2] : 1.0 - xRef[2]);
+    } // for
+    size_t useInterpolation[maxValues];
+    for (size_t iValue = 0; iValue < maxValues; ++iValue) {
+        useInterpolation[iValue] = (iValue % 3) ? 1 : 0;
+    } // for
+
+    const size_t numCornersAll[2] = { 4, 8 };
+    const bool checkNoDataAll[2] = { false, true };
+    for (int iSet = HyperslabKernels::INSTRUCTIONS_SCALAR; iSet <= HyperslabKernels::INSTRUCTIONS_AVX512; ++iSet) {
+        const HyperslabKernels::InstructionSetEnum instructionSet = HyperslabKernels::InstructionSetEnum(iSet);
+        if (!HyperslabKernels::isSupported(instructionSet)) {
+            continue;
+        } // if
+
+        for (size_t iCorners = 0; iCorners < 2; ++iCorners) {
+            for (size_t iCheck = 0; iCheck < 2; ++iCheck) {
+                const size_t numCorners = numCornersAll[iCorners];
+                const bool checkNoData = checkNoDataAll[iCheck];
+                typename HyperslabKernels::Kernel<T>::fn_type kernel =
+                    HyperslabKernels::getKernel<T>(instructionSet, numCorners, checkNoData);
+                typename HyperslabKernels::Kernel<T>::fn_type kernelE =
+                    HyperslabKernels::getKernel<T>(HyperslabKernels::INSTRUCTIONS_SCALAR, numCorners, checkNoData);
+
+                for (size_t numValues = 1; numValues <= maxValues; ++numValues) {
+                    for (size_t iQuery = 0; iQuery < 2; ++iQuery) {
+                        const size_t* flags = (iQuery) ? useInterpolation : nullptr;
+                        double values[maxValues];
+                        double valuesE[maxValues];
+                        kernel(values, data.data(), cornerOffsets, wts, nearestOffset, flags, numValues);
+                        kernelE(valuesE, data.data(), cornerOffsets, wts, nearestOffset, flags, numValues);
+
+                        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                            INFO("Mismatch for instruction set " << HyperslabKernels::getName(instructionSet)
+                                                                 << ", numCorners=" << numCorners
+                                                                 << ", checkNoData=" << checkNoData
+                                                                 << ", numValues=" << numValues
+                                                                 << ", useInterpolation=" << bool(flags)
+                                                                 << ", value " << iValue << ".");
+                            const double tolerance = 1.0e-14 * std::max(1.0, fabs(valuesE[iValue]));
+                            CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], tolerance));
+                        } // for
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // Scalar kernel against values computed directly.
+    const size_t numValues = maxValues;
+    double values[maxValues];
+    HyperslabKernels::getKernel<T>(HyperslabKernels::INSTRUCTIONS_SCALAR, 8, true)(
+        values, data.data(), cornerOffsets, wts, nearestOffset, useInterpolation, numValues);
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        double valueE = 0.0;
+        bool hasNoDataValue = false;
+        for (size_t iCorner = 0; iCorner < maxCorners; ++iCorner) {
+            const T cornerValue = data[cornerOffsets[iCorner]+iValue];
+            hasNoDataValue = hasNoDataValue || (T(geomodelgrids::NODATA_VALUE) == cornerValue);
+            valueE += wts[iCorner] * cornerValue;
+        } // for
+        const T nearestValue = data[nearestOffset+iValue];
+        if (!useInterpolation[iValue]) {
+            valueE = (T(geomodelgrids::NODATA_VALUE) == nearestValue) ? geomodelgrids::NODATA_VALUE : nearestValue;
+        } else if (hasNoDataValue) {
+            valueE = geomodelgrids::NODATA_VALUE;
+        } // if/else
+
+        INFO("Mismatch in scalar kernel for value " << iValue << ".");
+        const double tolerance = 1.0e-14 * std::max(1.0, fabs(valueE));
+        CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valueE, tolerance));
+    } // for
+} // _checkKernels
+
+
+// End of file
@@ -0,0 +1,175 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::IOProfile.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/IOProfile.hh" // USES IOProfile
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <stdexcept> // USES std::invalid_argument, std::length_error
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestIOProfile;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestIOProfile {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test getters and setters.
+    static
+    void testAccessors(void);
+
+    /// Test borehole() and grid().
+    static
+    void testPresets(void);
+
+    /// Test fromString().
+    static
+    void testFromString(void);
+
+}; // class TestIOProfile
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestIOProfile::testConstructor", "[TestIOProfile]") {
+    geomodelgrids::serial::TestIOProfile::testConstructor();
+}
+TEST_CASE("TestIOProfile::testAccessors", "[TestIOProfile]") {
+    geomodelgrids::serial::TestIOProfile::testAccessors();
+}
+TEST_CASE("TestIOProfile::testPresets", "[TestIOProfile]") {
+    geomodelgrids::serial::TestIOProfile::testPresets();
+}
+TEST_CASE("TestIOProfile::testFromString", "[TestIOProfile]") {
+    geomodelgrids::serial::TestIOProfile::testFromString();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestIOProfile::testConstructor(void) {
+    IOProfile profile;
+
+    CHECK(size_t(0) == profile._chunkCacheSize);
+    CHECK(size_t(521) == profile._chunkCacheNumSlots);
+    CHECK(0.75 == profile._chunkCachePreemption);
+    CHECK(size_t(0) == profile._tileCacheSize);
+
+    CHECK(size_t(64) == profile._blockHyperslabDims[0]);
+    CHECK(size_t(64) == profile._blockHyperslabDims[1]);
+    CHECK(size_t(0) == profile._blockHyperslabDims[2]);
+
+    CHECK(size_t(128) == profile._surfaceHyperslabDims[0]);
+    CHECK(size_t(128) == profile._surfaceHyperslabDims[1]);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test getters and setters.
+void
+geomodelgrids::serial::TestIOProfile::testAccessors(void) {
+    IOProfile profile;
+
+    profile.setChunkCache(8*1024*1024, 1031, 1.5);
+    CHECK(size_t(8*1024*1024) == profile.getChunkCacheSize());
+    CHECK(size_t(1031) == profile.getChunkCacheNumSlots());
+    CHECK(1.0 == profile.getChunkCachePreemption());
+
+    profile.setTileCacheSize(1024);
+    CHECK(size_t(1024) == profile.getTileCacheSize());
+
+    const size_t blockDims[3] = { 4, 5, 6 };
+    profile.setBlockHyperslabDims(blockDims, 3);
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(blockDims[i] == profile.getBlockHyperslabDims()[i]);
+    } // for
+    CHECK_THROWS_AS(profile.setBlockHyperslabDims(blockDims, 2), std::length_error);
+
+    const size_t surfaceDims[2] = { 7, 8 };
+    profile.setSurfaceHyperslabDims(surfaceDims, 2);
+    for (size_t i = 0; i < 2; ++i) {
+        CHECK(surfaceDims[i] == profile.getSurfaceHyperslabDims()[i]);
+    } // for
+    CHECK_THROWS_AS(profile.setSurfaceHyperslabDims(surfaceDims, 3), std::length_error);
+} // testAccessors
+
+
+// ------------------------------------------------------------------------------------------------
+// Test borehole() and grid().
+void
+geomodelgrids::serial::TestIOProfile::testPresets(void) {
+    const IOProfile& borehole = IOProfile::borehole();
+    const IOProfile& grid = IOProfile::grid();
+
+    CHECK(borehole.getBlockHyperslabDims()[0] < grid.getBlockHyperslabDims()[0]);
+    CHECK(borehole.getBlockHyperslabDims()[1] < grid.getBlockHyperslabDims()[1]);
+    CHECK(size_t(0) == borehole.getBlockHyperslabDims()[2]);
+    CHECK(borehole.getSurfaceHyperslabDims()[0] < grid.getSurfaceHyperslabDims()[0]);
+    CHECK(borehole.getChunkCacheSize() > 0);
+    CHECK(borehole.getChunkCacheSize() < grid.getChunkCacheSize());
+    CHECK(borehole.getTileCacheSize() < grid.getTileCacheSize());
+} // testPresets
+
+
+// ------------------------------------------------------------------------------------------------
+// Test fromString().
+void
+geomodelgrids::serial::TestIOProfile::testFromString(void) {
+    { // Preset
+        const IOProfile& profile = IOProfile::fromString("grid");
+        const IOProfile& profileE = IOProfile::grid();
+        CHECK(profileE.getChunkCacheSize() == profile.getChunkCacheSize());
+        CHECK(profileE.getChunkCacheNumSlots() == profile.getChunkCacheNumSlots());
+        CHECK(profileE.getChunkCachePreemption() == profile.getChunkCachePreemption());
+        CHECK(profileE.getTileCacheSize() == profile.getTileCacheSize());
+        CHECK(profileE.getBlockHyperslabDims()[0] == profile.getBlockHyperslabDims()[0]);
+        CHECK(profileE.getSurfaceHyperslabDims()[0] == profile.getSurfaceHyperslabDims()[0]);
+    } // Preset
+
+    { // Preset with parameters
+        const IOProfile& profile =
+            IOProfile::fromString("borehole,chunk_cache_size=2M,chunk_cache_slots=1031,chunk_cache_preemption=0.5,"
+                                  "tile_cache_size=16K,block_hyperslab=4x4x32,surface_hyperslab=8x16");
+        CHECK(size_t(2*1024*1024) == profile.getChunkCacheSize());
+        CHECK(size_t(1031) == profile.getChunkCacheNumSlots());
+        CHECK(0.5 == profile.getChunkCachePreemption());
+        CHECK(size_t(16*1024) == profile.getTileCacheSize());
+        CHECK(size_t(4) == profile.getBlockHyperslabDims()[0]);
+        CHECK(size_t(4) == profile.getBlockHyperslabDims()[1]);
+        CHECK(size_t(32) == profile.getBlockHyperslabDims()[2]);
+        CHECK(size_t(8) == profile.getSurfaceHyperslabDims()[0]);
+        CHECK(size_t(16) == profile.getSurfaceHyperslabDims()[1]);
+    } // Preset with parameters
+
+    { // Parameters only
+        const IOProfile& profile = IOProfile::fromString("tile_cache_size=1G");
+        CHECK(size_t(1024*1024*1024) == profile.getTileCacheSize());
+        CHECK(IOProfile().getChunkCacheSize() == profile.getChunkCacheSize());
+    } // Parameters only
+
+    { // Empty string
+        const IOProfile& profile = IOProfile::fromString("");
+        CHECK(IOProfile().getTileCacheSize() == profile.getTileCacheSize());
+    } // Empty string
+
+    // Errors
+    CHECK_THROWS_AS(IOProfile::fromString("unknown"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("tile_cache_size=1G,grid"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("unknown=4"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("tile_cache_size=4T"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("tile_cache_size=-4"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("chunk_cache_preemption=2.0"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("block_hyperslab=4x4"), std::invalid_argument);
+    CHECK_THROWS_AS(IOProfile::fromString("surface_hyperslab=4x4x4"), std::invalid_argument);
+} // testFromString
+
+
+// End of file
@@ -7,15 +7,21 @@
 #include "tests/data/ModelPoints.hh" // USES ModelPoints
 
 #include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/FootprintIndex.hh" // USES FootprintIndex
+#include "geomodelgrids/serial/ModelContext.hh" // USES ModelContext
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
+#include "geomodelgrids/utils/CRSInterpolator.hh" // USES CRSInterpolator
 #include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
-#include <cmath> // USES fabs()
+#include <cmath> // USES fabs(), sqrt()
+#include <algorithm> // USES std::copy(), std::max()
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace serial {
@@ -55,10 +61,22 @@ public:
     static
     void testToModelXYZTopo(void);
 
+    /// Test _toModelXYZ() and toModelXYZ() with affine transformation from input CRS.
+    static
+    void testToModelXYZAffine(void);
+
+    /// Test _toModelXYZ() and toModelXYZ() with approximate transformation from input CRS.
+    static
+    void testToModelXYZApprox(void);
+
     /// Test contains().
     static
     void testContains(void);
 
+    /// Test getFootprint().
+    static
+    void testGetFootprint(void);
+
     /// Test queryTopElevation().
     static
     void testQueryTopElevation(void);
@@ -75,6 +93,10 @@ public:
     static
     void testQueryVarXYZ(void);
 
+    /// Test locate() and relocate().
+    static
+    void testLocate(void);
+
 }; // class TestModel
 
 // ------------------------------------------------------------------------------------------------
@@ -99,9 +121,18 @@ TEST_CASE("TestModel::testToModelXYZFlat", "[TestModel]") {
 TEST_CASE("TestModel::testToModelXYZTopo", "[TestModel]") {
     geomodelgrids::serial::TestModel::testToModelXYZTopo();
 }
+TEST_CASE("TestModel::testToModelXYZAffine", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testToModelXYZAffine();
+}
+TEST_CASE("TestModel::testToModelXYZApprox", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testToModelXYZApprox();
+}
 TEST_CASE("TestModel::testContains", "[TestModel]") {
     geomodelgrids::serial::TestModel::testContains();
 }
+TEST_CASE("TestModel::testGetFootprint", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testGetFootprint();
+}
 TEST_CASE("TestModel::testQueryTopElevation", "[TestModel]") {
     geomodelgrids::serial::TestModel::testQueryTopElevation();
 }
@@ -114,6 +145,9 @@ TEST_CASE("TestModel::testQuery", "[TestModel]") {
 TEST_CASE("TestModel::testQueryVarXYZ", "[TestModel]") {
     geomodelgrids::serial::TestModel::testQueryVarXYZ();
 }
+TEST_CASE("TestModel::testLocate", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testLocate();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -340,15 +374,20 @@ geomodelgrids::serial::TestModel::testInitialize(void) {
     model.initialize();
 
     CHECK(model._crsTransformer);
+    REQUIRE(model._context);
+    CHECK(model._context->_crsTransformer);
+    CHECK(model._blocks.size() == model._context->_blocks.size());
 
     std::shared_ptr<Surface>& surfaceTop = model._surfaceTop;
     if (surfaceTop) {
-        CHECK_NOTHROW(surfaceTop->query(0.0, 0.0));
+        REQUIRE(model._context->_surfaceTop);
+        CHECK_NOTHROW(surfaceTop->query(model._context->_surfaceTop.get(), 0.0, 0.0));
     } // if
 
     std::shared_ptr<Surface>& surfaceTopoBathy = model._surfaceTopoBathy;
     if (surfaceTopoBathy) {
-        CHECK_NOTHROW(surfaceTopoBathy->query(0.0, 0.0));
+        REQUIRE(model._context->_surfaceTopoBathy);
+        CHECK_NOTHROW(surfaceTopoBathy->query(model._context->_surfaceTopoBathy.get(), 0.0, 0.0));
     } // if
 
     model.close();
@@ -418,6 +457,114 @@ geomodelgrids::serial::TestModel::testToModelXYZTopo(void) {
 } // testToModelXYZTopo
 
 
+// ------------------------------------------------------------------------------------------------
+// Test _toModelXYZ() and toModelXYZ() with affine transformation from input CRS.
+void
+geomodelgrids::serial::TestModel::testToModelXYZAffine(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    CHECK_FALSE(model._isAffine);
+    CHECK_FALSE(model._isAffineZ);
+    model.close();
+
+    model.setInputCRS("EPSG:4152");
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    CHECK_FALSE(model._isAffine);
+    CHECK(model._isAffineZ);
+    model.close();
+
+    const std::string modelCRS = model.getCRSString();
+    model.setInputCRS(modelCRS);
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    REQUIRE(model._isAffine);
+    CHECK(model._isAffineZ);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    geomodelgrids::utils::CRSTransformer transformer;
+    transformer.setSrc("EPSG:4326");
+    transformer.setDest(modelCRS.c_str());
+    transformer.initialize();
+    std::vector<double> pointsCRS(numPoints*spaceDim);
+    transformer.transformMany(&pointsCRS[0], pointsLLE, numPoints);
+
+    std::vector<double> pointsModel(numPoints*spaceDim);
+    model.toModelXYZ(&pointsModel[0], &pointsCRS[0], numPoints);
+
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        double xyz[spaceDim] = { 0.0, 0.0, 0.0 };
+        model._toModelXYZ(&xyz[0], &xyz[1], &xyz[2],
+                          pointsCRS[iPt*spaceDim+0], pointsCRS[iPt*spaceDim+1], pointsCRS[iPt*spaceDim+2]);
+
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for component " << iDim << ".");
+            const double valueE = pointsXYZ[iPt*spaceDim+iDim];
+            const double tolerance = 1.0e-6;
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(xyz[iDim], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+            CHECK_THAT(pointsModel[iPt*spaceDim+iDim], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // for
+    } // for
+
+    model.close();
+} // testToModelXYZAffine
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _toModelXYZ() and toModelXYZ() with approximate transformation from input CRS.
+void
+geomodelgrids::serial::TestModel::testToModelXYZApprox(void) {
+    const double transformTolerance = 1.0e-3;
+
+    Model model;
+    model.setTransformTolerance(transformTolerance);
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    CHECK_FALSE(model._isAffine);
+    REQUIRE(model._crsInterpolator);
+    CHECK(model._crsInterpolator->getMaxError() <= transformTolerance);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    std::vector<double> pointsModel(numPoints*spaceDim);
+    model.toModelXYZ(&pointsModel[0], pointsLLE, numPoints);
+
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        double xyz[spaceDim] = { 0.0, 0.0, 0.0 };
+        model._toModelXYZ(&xyz[0], &xyz[1], &xyz[2],
+                          pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for component " << iDim << ".");
+            const double valueE = pointsXYZ[iPt*spaceDim+iDim];
+            const double tolerance = 1.0e-6;
+            const double valueTolerance = std::max(2.0*transformTolerance, tolerance*fabs(valueE));
+            CHECK_THAT(xyz[iDim], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+            CHECK_THAT(pointsModel[iPt*spaceDim+iDim], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // for
+    } // for
+
+    model.close();
+} // testToModelXYZApprox
+
+
 // ------------------------------------------------------------------------------------------------
 // Test contains().
 void
@@ -467,6 +614,91 @@ geomodelgrids::serial::TestModel::testContains(void) {
 } // testContains
 
 
+// ------------------------------------------------------------------------------------------------
+// Test getFootprint().
+void
+geomodelgrids::serial::TestModel::testGetFootprint(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+
+    const size_t numEdgePoints = 8;
+    std::vector<double> footprint;
+    double margin = 0.0;
+    model.getFootprint(&footprint, &margin, numEdgePoints);
+    REQUIRE(2*4*numEdgePoints == footprint.size());
+    CHECK(margin > 0.0);
+
+    FootprintIndex index;
+    index.initialize(std::vector<std::vector<double> >(1, footprint), std::vector<double>(1, margin));
+
+    { // inside domain
+        geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+        const size_t numPoints = points.getNumPoints();
+        const size_t spaceDim = 3;
+        const double* pointsLLE = points.getLatLonElev();
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1] << ").");
+            CHECK(index.isCandidate(0, pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1]));
+        } // for
+    } // inside domain
+
+    { // curved boundary
+        // Sides of the model are curved in the input CRS (geographic), so with one vertex per side, the
+        // margin must cover the deviation of the boundary from the chords between the corners.
+        std::vector<double> footprintCorners;
+        double marginCorners = 0.0;
+        model.getFootprint(&footprintCorners, &marginCorners, 1);
+        REQUIRE(size_t(2*4) == footprintCorners.size());
+        CHECK(marginCorners > margin);
+
+        FootprintIndex indexCorners;
+        indexCorners.initialize(std::vector<std::vector<double> >(1, footprintCorners),
+                                std::vector<double>(1, marginCorners), 256);
+
+        // Points on the boundary of the model.
+        const size_t numSidePoints = 100;
+        const double corners[5][2] = {
+            { 0.0, 0.0 },
+            { model._dims[0], 0.0 },
+            { model._dims[0], model._dims[1] },
+            { 0.0, model._dims[1] },
+            { 0.0, 0.0 },
+        };
+        double maxDeviation = 0.0;
+        for (size_t iSide = 0; iSide < 4; ++iSide) {
+            for (size_t iPt = 0; iPt < numSidePoints; ++iPt) {
+                const double t = double(iPt) / double(numSidePoints);
+                double xModelCRS = 0.0;
+                double yModelCRS = 0.0;
+                model._toModelCRS(&xModelCRS, &yModelCRS,
+                                  (1.0-t)*corners[iSide][0] + t*corners[iSide+1][0],
+                                  (1.0-t)*corners[iSide][1] + t*corners[iSide+1][1]);
+                double x = 0.0;
+                double y = 0.0;
+                model._context->_crsTransformer->inverse_transform(&x, &y, nullptr, xModelCRS, yModelCRS, 0.0);
+
+                INFO("Mismatch for point (" << x << ", " << y << ") on side " << iSide << ".");
+                CHECK(indexCorners.isCandidate(0, x, y));
+
+                // Distance from point to chord along side.
+                const size_t iNext = (iSide+1) % 4;
+                const double x0 = footprintCorners[2*iSide+0];
+                const double y0 = footprintCorners[2*iSide+1];
+                const double dx = footprintCorners[2*iNext+0] - x0;
+                const double dy = footprintCorners[2*iNext+1] - y0;
+                const double deviation = fabs((x-x0)*dy - (y-y0)*dx) / sqrt(dx*dx + dy*dy);
+                maxDeviation = std::max(maxDeviation, deviation);
+            } // for
+        } // for
+        CHECK(maxDeviation > 0.0);
+        CHECK(marginCorners >= maxDeviation);
+    } // curved boundary
+} // testGetFootprint
+
+
 // ------------------------------------------------------------------------------------------------
 // Test queryTopElevation().
 void
@@ -611,4 +843,62 @@ geomodelgrids::serial::TestModel::testQueryVarXYZ(void) {
 } // testQueryVarXYZ
 
 
+// ------------------------------------------------------------------------------------------------
+// Test locate() and relocate().
+void
+geomodelgrids::serial::TestModel::testLocate(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    ModelContext* context = model.getContext();
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    const double tolerance = 1.0e-5;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double x = pointsLLE[iPt*spaceDim+0];
+        const double y = pointsLLE[iPt*spaceDim+1];
+        const double z = pointsLLE[iPt*spaceDim+2];
+        INFO("Mismatch for point (" << x << ", " << y << ", " << z << ").");
+
+        Model::Location location;
+        model.locate(&location, x, y, z, context);
+        REQUIRE(location.inModel);
+        CHECK(location.iBlock < model._blocks.size());
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            const double valueE = pointsXYZ[iPt*spaceDim+iDim];
+            const double value = (0 == iDim) ? location.xModel : (1 == iDim) ? location.yModel : location.zModel;
+            CHECK_THAT(value, Catch::Matchers::WithinAbs(valueE, std::max(tolerance, tolerance*fabs(valueE))));
+        } // for
+
+        const double topElevE = model.queryTopElevation(x, y);
+        CHECK_THAT(model.queryTopElevation(location, context), Catch::Matchers::WithinAbs(topElevE, tolerance));
+        const double topoBathyElevE = model.queryTopoBathyElevation(x, y);
+        CHECK_THAT(model.queryTopoBathyElevation(location, context), Catch::Matchers::WithinAbs(topoBathyElevE, tolerance));
+
+        const size_t numValues = model.getValueNames().size();
+        std::vector<double> valuesE(numValues);
+        const double* valuesPt = model.query(x, y, z);
+        std::copy(valuesPt, valuesPt+numValues, valuesE.begin());
+        const double* values = model.query(location, context);
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], std::max(tolerance, tolerance*fabs(valuesE[iValue]))));
+        } // for
+
+        // Relocate to just below top surface and far below bottom of model.
+        model.relocate(&location, x, y, topElevE-1.0, context);
+        CHECK(location.inModel);
+        CHECK(model.contains(x, y, topElevE-1.0));
+        model.relocate(&location, x, y, -1.0e+6, context);
+        CHECK(!location.inModel);
+        CHECK(model._blocks.size() == location.iBlock);
+    } // for
+} // testLocate
+
+
 // End of file
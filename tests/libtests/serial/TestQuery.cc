@@ -7,12 +7,21 @@
 #include "tests/data/ModelPoints.hh"
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/serial/QueryContext.hh" // USES QueryContext
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
+#include <algorithm> // USES std::count()
 #include <cmath>
+#include <stdexcept> // USES std::logic_error
+#include <thread> // USES std::thread
 
 namespace geomodelgrids {
     namespace serial {
@@ -60,6 +69,38 @@ public:
     static
     void testQuerySquashTopoBathy(void);
 
+    /// Test queryMany().
+    static
+    void testQueryMany(void);
+
+    /// Test queryProfile() and queryProfileDepth().
+    static
+    void testQueryProfile(void);
+
+    /// Test queryGrid() and queryGridHDF5().
+    static
+    void testQueryGrid(void);
+
+    /// Test chunking and compression of dataset written by queryGridHDF5().
+    static
+    void testQueryGridHDF5Layout(void);
+
+    /// Test concurrent queries with per-thread contexts.
+    static
+    void testQueryContext(void);
+
+    /// Test query() with surfaces and blocks resident in memory.
+    static
+    void testResident(void);
+
+    /// Test query with values stored and returned in single precision.
+    static
+    void testSinglePrecision(void);
+
+    /// Test batched query visiting points in spatial order.
+    static
+    void testSpatialOrdering(void);
+
 }; // class TestQuery
 
 // ------------------------------------------------------------------------------------------------
@@ -90,6 +131,30 @@ TEST_CASE("TestQuery::testQuerySquashTop", "[TestQuery]") {
 TEST_CASE("TestQuery::testQuerySquashTopoBathy", "[TestQuery]") {
     geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy();
 }
+TEST_CASE("TestQuery::testQueryMany", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryMany();
+}
+TEST_CASE("TestQuery::testQueryProfile", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryProfile();
+}
+TEST_CASE("TestQuery::testQueryGrid", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryGrid();
+}
+TEST_CASE("TestQuery::testQueryGridHDF5Layout", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryGridHDF5Layout();
+}
+TEST_CASE("TestQuery::testQueryContext", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryContext();
+}
+TEST_CASE("TestQuery::testResident", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testResident();
+}
+TEST_CASE("TestQuery::testSinglePrecision", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testSinglePrecision();
+}
+TEST_CASE("TestQuery::testSpatialOrdering", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testSpatialOrdering();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -695,4 +760,722 @@ geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy(void) {
 } // TestQuerySquash
 
 
+// ------------------------------------------------------------------------------------------------
+// Test queryMany().
+void
+geomodelgrids::serial::TestQuery::testQueryMany(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsOne.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Interleave points from both models and add a point outside all models.
+    std::vector<double> points;
+    const size_t numPointsOne = pointsOne.getNumPoints();
+    const size_t numPointsThree = pointsThree.getNumPoints();
+    for (size_t iPt = 0; iPt < std::max(numPointsOne, numPointsThree); ++iPt) {
+        if (iPt < numPointsOne) {
+            points.insert(points.end(), &pointsOne.getLatLonElev()[iPt*spaceDim], &pointsOne.getLatLonElev()[(iPt+1)*spaceDim]);
+        } // if
+        if (iPt < numPointsThree) {
+            points.insert(points.end(), &pointsThree.getLatLonElev()[iPt*spaceDim], &pointsThree.getLatLonElev()[(iPt+1)*spaceDim]);
+        } // if
+    } // for
+    const double outside[spaceDim] = { 0.0, 0.0, 0.0 };
+    points.insert(points.end(), outside, outside+spaceDim);
+    const size_t numPoints = points.size() / spaceDim;
+
+    const size_t numSquash = 2;
+    const Query::SquashingEnum squashing[numSquash] = { Query::SQUASH_NONE, Query::SQUASH_TOP_SURFACE };
+    for (size_t iSquash = 0; iSquash < numSquash; ++iSquash) {
+        Query query;
+        query.initialize(filenames, valueNames, crs);
+        query.setSquashMinElev(-4.999e+3);
+        query.setSquashing(squashing[iSquash]);
+
+        std::vector<double> values(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        const int err = query.queryMany(&values[0], &status[0], &points[0], numPoints);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            double valuesE[numValues];
+            const int statusE = query.query(valuesE, points[iPt*spaceDim+0], points[iPt*spaceDim+1], points[iPt*spaceDim+2]);
+            INFO("Mismatch at point (" << points[iPt*spaceDim+0] << ", " << points[iPt*spaceDim+1]
+                                       << ", " << points[iPt*spaceDim+2] << ") with squashing " << squashing[iSquash] << ".");
+            CHECK(statusE == status[iPt]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                const double tolerance = 1.0e-10;
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+            } // for
+        } // for
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == status[numPoints-1]);
+        CHECK(geomodelgrids::NODATA_VALUE == values[(numPoints-1)*numValues]);
+
+        // Return value is OK only if all points are in a model.
+        const bool allFound = std::count(status.begin(), status.end()-1, int(geomodelgrids::utils::ErrorHandler::OK)) == int(numPoints-1);
+        const int errE = (allFound) ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+        CHECK(errE == query.queryMany(&values[0], nullptr, &points[0], numPoints-1));
+    } // for
+
+    Query query;
+    double values[numValues];
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryMany(values, nullptr, &points[0], 1));
+    query.initialize(filenames, valueNames, crs);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryMany(nullptr, nullptr, &points[0], 1));
+    CHECK(geomodelgrids::utils::ErrorHandler::OK == query.queryMany(nullptr, nullptr, nullptr, 0));
+} // testQueryMany
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryProfile() and queryProfileDepth().
+void
+geomodelgrids::serial::TestQuery::testQueryProfile(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsOne.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Horizontal locations of profiles in each model and outside all models.
+    std::vector<double> locations;
+    for (size_t iPt = 0; iPt < pointsOne.getNumPoints(); ++iPt) {
+        locations.insert(locations.end(), &pointsOne.getLatLonElev()[iPt*spaceDim], &pointsOne.getLatLonElev()[iPt*spaceDim+2]);
+    } // for
+    for (size_t iPt = 0; iPt < pointsThree.getNumPoints(); ++iPt) {
+        locations.insert(locations.end(), &pointsThree.getLatLonElev()[iPt*spaceDim], &pointsThree.getLatLonElev()[iPt*spaceDim+2]);
+    } // for
+    locations.push_back(0.0);
+    locations.push_back(0.0);
+    const size_t numLocations = locations.size() / 2;
+
+    // Points above, within, and below the models, including both sides of squashing elevation.
+    const size_t numPoints = 12;
+    const double z[numPoints] = {
+        +2.0e+3, +200.0, 0.0, -10.0, -4.0e+3, -4.999e+3, -5.001e+3, -1.0e+4, -2.0e+4, -4.0e+4, -4.4e+4, -6.0e+4,
+    };
+    const double tolerance = 1.0e-10;
+
+    const size_t numSquash = 3;
+    const Query::SquashingEnum squashing[numSquash] = {
+        Query::SQUASH_NONE,
+        Query::SQUASH_TOP_SURFACE,
+        Query::SQUASH_TOPOGRAPHY_BATHYMETRY,
+    };
+    for (size_t iSquash = 0; iSquash < numSquash; ++iSquash) {
+        Query query;
+        query.initialize(filenames, valueNames, crs);
+        query.setSquashMinElev(-4.999e+3);
+        query.setSquashing(squashing[iSquash]);
+
+        for (size_t iLoc = 0; iLoc < numLocations; ++iLoc) {
+            const double x = locations[2*iLoc+0];
+            const double y = locations[2*iLoc+1];
+
+            std::vector<double> values(numPoints*numValues);
+            std::vector<int> status(numPoints);
+            const int err = query.queryProfile(&values[0], &status[0], x, y, z, numPoints);
+
+            bool allFound = true;
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                double valuesE[numValues];
+                const int statusE = query.query(valuesE, x, y, z[iPt]);
+                allFound = allFound && (geomodelgrids::utils::ErrorHandler::OK == statusE);
+                INFO("Mismatch at point (" << x << ", " << y << ", " << z[iPt] << ") with squashing " << squashing[iSquash] << ".");
+                CHECK(statusE == status[iPt]);
+                for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                    const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                    CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                } // for
+            } // for
+            const int errE = (allFound) ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+            CHECK(errE == err);
+
+            // Depth relative to each surface.
+            const double depth[numPoints] = {
+                0.0, 1.0, 10.0, 100.0, 1.0e+3, 4.0e+3, 5.0e+3, 1.0e+4, 2.0e+4, 3.0e+4, 4.0e+4, 5.0e+4,
+            };
+            for (size_t iSurface = 0; iSurface < numSquash; ++iSurface) {
+                double surfaceElev = 0.0;
+                if (Query::SQUASH_TOP_SURFACE == squashing[iSurface]) {
+                    surfaceElev = query.queryTopElevation(x, y);
+                } else if (Query::SQUASH_TOPOGRAPHY_BATHYMETRY == squashing[iSurface]) {
+                    surfaceElev = query.queryTopoBathyElevation(x, y);
+                } // if/else
+
+                query.queryProfileDepth(&values[0], &status[0], x, y, depth, numPoints, squashing[iSurface]);
+                for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                    double valuesE[numValues];
+                    int statusE = geomodelgrids::utils::ErrorHandler::WARNING;
+                    if (geomodelgrids::NODATA_VALUE != surfaceElev) {
+                        statusE = query.query(valuesE, x, y, surfaceElev-depth[iPt]);
+                    } else {
+                        std::fill(valuesE, valuesE+numValues, geomodelgrids::NODATA_VALUE);
+                    } // if/else
+                    INFO("Mismatch at point (" << x << ", " << y << ") and depth " << depth[iPt]
+                                               << " relative to surface " << squashing[iSurface]
+                                               << " with squashing " << squashing[iSquash] << ".");
+                    CHECK(statusE == status[iPt]);
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                        CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+
+    Query query;
+    double values[numValues];
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryProfile(values, nullptr, 0.0, 0.0, z, 1));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryProfileDepth(values, nullptr, 0.0, 0.0, z, 1, Query::SQUASH_NONE));
+    query.initialize(filenames, valueNames, crs);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryProfile(nullptr, nullptr, 0.0, 0.0, z, 1));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryProfileDepth(values, nullptr, 0.0, 0.0, nullptr, 1, Query::SQUASH_NONE));
+    CHECK(geomodelgrids::utils::ErrorHandler::OK == query.queryProfile(nullptr, nullptr, 0.0, 0.0, nullptr, 0));
+} // testQueryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryGrid() and queryGridHDF5().
+void
+geomodelgrids::serial::TestQuery::testQueryGrid(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    const std::string& crs = pointsOne.getCRSLatLonElev();
+
+    // Grid extends beyond the models laterally and vertically.
+    const double origin[3] = { 34.55, -117.75, +2.0e+3 };
+    const double spacing[3] = { 0.05, 0.1, -5.0e+3 };
+    const size_t dims[3] = { 6, 6, 10 };
+    const size_t numPoints = dims[0]*dims[1]*dims[2];
+    const double tolerance = 1.0e-10;
+
+    std::vector<double> values(numPoints*numValues);
+    std::vector<int> status(numPoints);
+
+    // Input CRS with horizontal transformation that depends on elevation and one that does not.
+    const size_t numCRS = 2;
+    const char* const inputCRS[numCRS] = { crs.c_str(), "EPSG:4152" };
+    for (size_t iCRS = 0; iCRS < numCRS; ++iCRS) {
+        Query query;
+        query.initialize(filenames, valueNames, inputCRS[iCRS]);
+        query.setSquashMinElev(-4.999e+3);
+        query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+
+        const int err = query.queryGrid(&values[0], &status[0], origin, spacing, dims);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+
+        for (size_t iX = 0, iPt = 0; iX < dims[0]; ++iX) {
+            for (size_t iY = 0; iY < dims[1]; ++iY) {
+                for (size_t iZ = 0; iZ < dims[2]; ++iZ, ++iPt) {
+                    const double x = origin[0] + iX * spacing[0];
+                    const double y = origin[1] + iY * spacing[1];
+                    const double z = origin[2] + iZ * spacing[2];
+
+                    double valuesE[numValues];
+                    const int statusE = query.query(valuesE, x, y, z);
+                    INFO("Mismatch at point (" << x << ", " << y << ", " << z << ") for input CRS " << inputCRS[iCRS] << ".");
+                    CHECK(statusE == status[iPt]);
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                        CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+    query.setSquashMinElev(-4.999e+3);
+    query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+    query.queryGrid(&values[0], nullptr, origin, spacing, dims);
+
+    // Values written to HDF5 dataset match values in buffer.
+    const char* filename = "../../data/tmp.h5";
+    CHECK(geomodelgrids::utils::ErrorHandler::WARNING == query.queryGridHDF5(filename, "/grid/values", origin, spacing, dims));
+    query.finalize();
+    {
+        HDF5 h5;
+        h5.open(filename, H5F_ACC_RDONLY);
+        hsize_t* dimsH5 = nullptr;
+        int ndims = 0;
+        h5.getDatasetDims(&dimsH5, &ndims, "/grid/values");
+        REQUIRE(4 == ndims);
+        CHECK(dims[0] == dimsH5[0]);
+        CHECK(dims[1] == dimsH5[1]);
+        CHECK(dims[2] == dimsH5[2]);
+        CHECK(numValues == dimsH5[3]);
+
+        std::vector<double> valuesH5(numPoints*numValues);
+        const hsize_t originH5[4] = { 0, 0, 0, 0 };
+        h5.readDatasetHyperslab(&valuesH5[0], "/grid/values", originH5, dimsH5, ndims, H5T_NATIVE_DOUBLE);
+        delete[] dimsH5;dimsH5 = nullptr;
+        for (size_t i = 0; i < numPoints*numValues; ++i) {
+            CHECK(values[i] == valuesH5[i]);
+        } // for
+    } // HDF5
+
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGrid(&values[0], nullptr, origin, spacing, dims));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGridHDF5(filename, "/values", origin, spacing, dims));
+    query.initialize(filenames, valueNames, crs);
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGrid(nullptr, nullptr, origin, spacing, dims));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGrid(&values[0], nullptr, nullptr, spacing, dims));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGridHDF5("blah/tmp.h5", "/values", origin, spacing, dims));
+    const size_t dimsEmpty[3] = { 0, 1, 1 };
+    CHECK(geomodelgrids::utils::ErrorHandler::OK == query.queryGrid(nullptr, nullptr, origin, spacing, dimsEmpty));
+} // testQueryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Test chunking and compression of dataset written by queryGridHDF5().
+void
+geomodelgrids::serial::TestQuery::testQueryGridHDF5Layout(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    const std::string& crs = pointsOne.getCRSLatLonElev();
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+    query.setSquashMinElev(-4.999e+3);
+    query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+
+    // Chunks span a slab of constant x unless a slab exceeds 1 MiB (131072 values), in which case
+    // the slab is split along y.
+    const double origin[3] = { 34.55, -117.75, +2.0e+3 };
+    const double spacing[3] = { 0.05, 0.005, -10.0 };
+    const size_t numCases = 2;
+    const size_t dimsCases[numCases][3] = {
+        { 3, 6, 10 },
+        { 2, 70, 1000 },
+    };
+    const hsize_t chunkCases[numCases][4] = {
+        { 1, 6, 10, numValues },
+        { 1, 65, 1000, numValues },
+    };
+    const int deflateCases[numCases] = { 0, 6 };
+
+    const char* filename = "../../data/tmp.h5";
+    for (size_t iCase = 0; iCase < numCases; ++iCase) {
+        const size_t* dims = dimsCases[iCase];
+        const size_t numPoints = dims[0]*dims[1]*dims[2];
+        std::vector<double> values(numPoints*numValues);
+        query.queryGrid(&values[0], nullptr, origin, spacing, dims);
+
+        const int deflateLevel = deflateCases[iCase];
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING ==
+              query.queryGridHDF5(filename, "/values", origin, spacing, dims, deflateLevel));
+
+        INFO("Mismatch for grid " << dims[0] << "x" << dims[1] << "x" << dims[2] << " with deflate level "
+                                  << deflateLevel << ".");
+        hid_t h5File = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5File >= 0);
+        hid_t h5Dataset = H5Dopen2(h5File, "/values", H5P_DEFAULT);REQUIRE(h5Dataset >= 0);
+        hid_t datasetProperties = H5Dget_create_plist(h5Dataset);REQUIRE(datasetProperties >= 0);
+
+        CHECK(H5D_CHUNKED == H5Pget_layout(datasetProperties));
+        hsize_t chunk[4] = { 0, 0, 0, 0 };
+        REQUIRE(4 == H5Pget_chunk(datasetProperties, 4, chunk));
+        for (size_t i = 0; i < 4; ++i) {
+            CHECK(chunkCases[iCase][i] == chunk[i]);
+        } // for
+
+        if (deflateLevel > 0) {
+            unsigned int flags = 0;
+            size_t numParams = 1;
+            unsigned int params[1] = { 0 };
+            REQUIRE(H5Pget_filter_by_id2(datasetProperties, H5Z_FILTER_DEFLATE, &flags, &numParams, params,
+                                         0, nullptr, nullptr) >= 0);
+            CHECK(unsigned(deflateLevel) == params[0]);
+        } else {
+            CHECK(0 == H5Pget_nfilters(datasetProperties));
+        } // if/else
+
+        std::vector<double> valuesH5(numPoints*numValues);
+        CHECK(H5Dread(h5Dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, &valuesH5[0]) >= 0);
+        H5Pclose(datasetProperties);
+        H5Dclose(h5Dataset);
+        H5Fclose(h5File);
+
+        size_t numMismatch = 0;
+        for (size_t i = 0; i < numPoints*numValues; ++i) {
+            numMismatch += (values[i] != valuesH5[i]) ? 1 : 0;
+        } // for
+        CHECK(0 == numMismatch);
+    } // for
+
+    const size_t dims[3] = { 2, 2, 2 };
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGridHDF5(filename, "/values", origin, spacing, dims, -1));
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGridHDF5(filename, "/values", origin, spacing, dims, 10));
+    query.finalize();
+} // testQueryGridHDF5Layout
+
+
+// ------------------------------------------------------------------------------------------------
+// Test concurrent queries with per-thread contexts.
+void
+geomodelgrids::serial::TestQuery::testQueryContext(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const double* pointsLLE = points.getLatLonElev();
+    const std::string& crs = points.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+    query.setSquashMinElev(-4.999e+3);
+    query.setSquashing(Query::SQUASH_TOP_SURFACE);
+
+    // Expected values using default context.
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    std::vector<double> elevationE(numPoints);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* xyz = &pointsLLE[iPt*spaceDim];
+        statusE[iPt] = query.query(&valuesE[iPt*numValues], xyz[0], xyz[1], xyz[2]);
+        elevationE[iPt] = query.queryTopElevation(xyz[0], xyz[1]);
+    } // for
+
+    const size_t numThreads = 4;
+    const size_t numRepeat = 8;
+    std::vector<std::vector<double> > values(numThreads, std::vector<double>(numRepeat*numPoints*numValues));
+    std::vector<std::vector<int> > status(numThreads, std::vector<int>(numRepeat*numPoints));
+    std::vector<std::vector<double> > elevation(numThreads, std::vector<double>(numRepeat*numPoints));
+    std::vector<std::vector<double> > valuesMany(numThreads, std::vector<double>(numPoints*numValues));
+    std::vector<std::vector<int> > statusMany(numThreads, std::vector<int>(numPoints));
+
+    std::vector<std::thread> threads;
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads.push_back(std::thread([&, iThread](void) {
+            QueryContext context(query);
+            context.setCacheSize(16*1024);
+            for (size_t iRepeat = 0; iRepeat < numRepeat; ++iRepeat) {
+                for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                    const size_t index = iRepeat*numPoints + iPt;
+                    const double* xyz = &pointsLLE[iPt*spaceDim];
+                    status[iThread][index] = query.query(&values[iThread][index*numValues], xyz[0], xyz[1], xyz[2], &context);
+                    elevation[iThread][index] = query.queryTopElevation(xyz[0], xyz[1], &context);
+                } // for
+            } // for
+            query.queryMany(&valuesMany[iThread][0], &statusMany[iThread][0], pointsLLE, numPoints, &context);
+        }));
+    } // for
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        threads[iThread].join();
+    } // for
+
+    const double tolerance = 1.0e-10;
+    for (size_t iThread = 0; iThread < numThreads; ++iThread) {
+        for (size_t iRepeat = 0; iRepeat < numRepeat; ++iRepeat) {
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                const size_t index = iRepeat*numPoints + iPt;
+                INFO("Mismatch for thread " << iThread << " at point (" << pointsLLE[iPt*spaceDim+0] << ", "
+                                            << pointsLLE[iPt*spaceDim+1] << ", " << pointsLLE[iPt*spaceDim+2] << ").");
+                CHECK(statusE[iPt] == status[iThread][index]);
+                CHECK_THAT(elevation[iThread][index], Catch::Matchers::WithinAbs(elevationE[iPt], tolerance));
+                for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                    const double valueE = valuesE[iPt*numValues+iValue];
+                    const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                    CHECK_THAT(values[iThread][index*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                    if (!iRepeat) {
+                        CHECK_THAT(valuesMany[iThread][iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                    } // if
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // Context requires an initialized query.
+    Query queryEmpty;
+    CHECK_THROWS_AS(QueryContext(queryEmpty), std::logic_error);
+} // testQueryContext
+
+
+// ------------------------------------------------------------------------------------------------
+// Test query() with surfaces and blocks resident in memory.
+void
+geomodelgrids::serial::TestQuery::testResident(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const double* pointsLLE = points.getLatLonElev();
+    const std::string& crs = points.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    Query queryE;
+    queryE.initialize(filenames, valueNames, crs);
+    CHECK(size_t(0) == queryE.getResidentSize());
+
+    // Budget large enough for everything, for only the surfaces of the first model, and for nothing.
+    Query queryAll;
+    queryAll.setResidentBudget(size_t(1) << 30);
+    queryAll.initialize(filenames, valueNames, crs);
+    const size_t residentSizeAll = queryAll.getResidentSize();
+    CHECK(residentSizeAll > 0);
+    CHECK(queryAll._models[0]->getTopSurface()->isResident());
+    CHECK(queryAll._models[1]->getBlocks()[0]->isResident());
+
+    const size_t surfaceSize = queryAll._models[0]->getTopSurface()->getValuesSize();
+    Query querySurface;
+    querySurface.setResidentBudget(surfaceSize);
+    querySurface.initialize(filenames, valueNames, crs);
+    CHECK(surfaceSize == querySurface.getResidentSize());
+    CHECK(querySurface._models[0]->getTopSurface()->isResident());
+    CHECK(!querySurface._models[0]->getBlocks()[0]->isResident());
+
+    Query queryNone;
+    queryNone.setResidentBudget(1);
+    queryNone.initialize(filenames, valueNames, crs);
+    CHECK(size_t(0) == queryNone.getResidentSize());
+
+    Query* queries[3] = { &queryAll, &querySurface, &queryNone };
+    for (size_t iQuery = 0; iQuery < 3; ++iQuery) {
+        queries[iQuery]->setSquashMinElev(-4.999e+3);
+        queries[iQuery]->setSquashing(Query::SQUASH_TOP_SURFACE);
+    } // for
+    queryE.setSquashMinElev(-4.999e+3);
+    queryE.setSquashing(Query::SQUASH_TOP_SURFACE);
+
+    const double tolerance = 1.0e-10;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* xyz = &pointsLLE[iPt*spaceDim];
+        double valuesE[numValues];
+        const int errE = queryE.query(valuesE, xyz[0], xyz[1], xyz[2]);
+        for (size_t iQuery = 0; iQuery < 3; ++iQuery) {
+            INFO("Mismatch for budget " << iQuery << " at point (" << xyz[0] << ", " << xyz[1] << ", " << xyz[2] << ").");
+            double values[numValues];
+            const int err = queries[iQuery]->query(values, xyz[0], xyz[1], xyz[2]);
+            CHECK(errE == err);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+            } // for
+        } // for
+    } // for
+
+    // Queries with everything resident do not read from the model files.
+    size_t numHits = 0;
+    size_t numMisses = 1;
+    queryAll.getCacheStats(&numHits, &numMisses);
+    CHECK(numHits > 0);
+    CHECK(size_t(0) == numMisses);
+} // testResident
+
+
+// ------------------------------------------------------------------------------------------------
+// Test query with values stored and returned in single precision.
+void
+geomodelgrids::serial::TestQuery::testSinglePrecision(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const double* pointsLLE = points.getLatLonElev();
+    const std::string& crs = points.getCRSLatLonElev();
+
+    Query queryE;
+    queryE.setResidentBudget(size_t(1) << 30);
+    queryE.initialize(filenames, valueNames, crs);
+    const size_t residentSizeDouble = queryE.getResidentSize();
+
+    // Tile cache and resident values in single precision.
+    Query queryCache;
+    queryCache.setSinglePrecision(true);
+    queryCache.initialize(filenames, valueNames, crs);
+
+    Query queryResident;
+    queryResident.setSinglePrecision(true);
+    queryResident.setResidentBudget(size_t(1) << 30);
+    queryResident.initialize(filenames, valueNames, crs);
+    CHECK(residentSizeDouble == 2*queryResident.getResidentSize());
+
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    const int errE = queryE.queryMany(valuesE.data(), statusE.data(), pointsLLE, numPoints);
+
+    const double tolerance = 1.0e-6;
+    Query* queries[2] = { &queryCache, &queryResident };
+    for (size_t iQuery = 0; iQuery < 2; ++iQuery) {
+        std::vector<double> values(numPoints*numValues);
+        std::vector<float> valuesFloat(numPoints*numValues);
+        std::vector<int> status(numPoints);
+        std::vector<int> statusFloat(numPoints);
+        CHECK(errE == queries[iQuery]->queryMany(values.data(), status.data(), pointsLLE, numPoints));
+        CHECK(errE == queries[iQuery]->queryManyFloat(valuesFloat.data(), statusFloat.data(), pointsLLE, numPoints));
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            INFO("Mismatch for query " << iQuery << " at point " << iPt << ".");
+            CHECK(statusE[iPt] == status[iPt]);
+            CHECK(statusE[iPt] == statusFloat[iPt]);
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                const double valueE = valuesE[iPt*numValues+iValue];
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+                CHECK_THAT(valuesFloat[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valueE, toleranceV));
+            } // for
+        } // for
+    } // for
+
+    // Not initialized.
+    Query queryEmpty;
+    float value = 0.0;
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == queryEmpty.queryManyFloat(&value, nullptr, pointsLLE, 1));
+} // testSinglePrecision
+
+
+// ------------------------------------------------------------------------------------------------
+// Test batched query visiting points in spatial order.
+void
+geomodelgrids::serial::TestQuery::testSpatialOrdering(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::OneBlockTopoPoints pointsOne;
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsOne.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    // Repeat sequence of points from both models and a point outside all models, so consecutive
+    // points in input order are in different tiles.
+    std::vector<double> points;
+    const size_t numRepeat = 4;
+    for (size_t iRepeat = 0; iRepeat < numRepeat; ++iRepeat) {
+        points.insert(points.end(), pointsOne.getLatLonElev(), pointsOne.getLatLonElev()+pointsOne.getNumPoints()*spaceDim);
+        points.insert(points.end(), pointsThree.getLatLonElev(), pointsThree.getLatLonElev()+pointsThree.getNumPoints()*spaceDim);
+        const double outside[spaceDim] = { 0.0, 0.0, 0.0 };
+        points.insert(points.end(), outside, outside+spaceDim);
+    } // for
+    const size_t numPoints = points.size() / spaceDim;
+
+    Query queryE;
+    queryE.initialize(filenames, valueNames, crs);
+
+    Query query;
+    query.setSpatialOrdering(true);
+    query.initialize(filenames, valueNames, crs);
+
+    // Small tiles and a cache holding a single tile for each block, so tiles are read again whenever
+    // consecutive points fall in different tiles.
+    Query* queries[2] = { &queryE, &query };
+    for (size_t iQuery = 0; iQuery < 2; ++iQuery) {
+        queries[iQuery]->setCacheSize(1);
+        for (size_t iModel = 0; iModel < numModels; ++iModel) {
+            const std::vector<std::shared_ptr<Block> >& blocks = queries[iQuery]->_models[iModel]->getBlocks();
+            for (size_t iBlock = 0; iBlock < blocks.size(); ++iBlock) {
+                const size_t dims[3] = { 2, 2, 2 };
+                blocks[iBlock]->setHyperslabDims(dims, 3);
+            } // for
+        } // for
+    } // for
+    QueryContext contextE(queryE);
+    QueryContext context(query);
+
+    std::vector<double> valuesE(numPoints*numValues);
+    std::vector<int> statusE(numPoints);
+    const int errE = queryE.queryMany(&valuesE[0], &statusE[0], &points[0], numPoints, &contextE);
+
+    std::vector<double> values(numPoints*numValues);
+    std::vector<int> status(numPoints);
+    const int err = query.queryMany(&values[0], &status[0], &points[0], numPoints, &context);
+    CHECK(errE == err);
+    CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+
+    // Values are returned in input order.
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        INFO("Mismatch at point (" << points[iPt*spaceDim+0] << ", " << points[iPt*spaceDim+1]
+                                   << ", " << points[iPt*spaceDim+2] << ").");
+        CHECK(statusE[iPt] == status[iPt]);
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            CHECK(valuesE[iPt*numValues+iValue] == values[iPt*numValues+iValue]);
+        } // for
+    } // for
+
+    // Visiting points in spatial order requires fewer reads.
+    size_t numMissesE = 0;
+    size_t numMisses = 0;
+    contextE.getCacheStats(nullptr, &numMissesE);
+    context.getCacheStats(nullptr, &numMisses);
+    CHECK(numMisses < numMissesE);
+} // testSpatialOrdering
+
+
 // End of file
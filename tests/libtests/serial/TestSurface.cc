@@ -146,6 +146,11 @@ geomodelgrids::serial::TestSurface::testLoadMetadata(void) {
     REQUIRE(_data->numX == dims[0]);
     REQUIRE(_data->numY == dims[1]);
 
+    const size_t* const chunkDims = surf.getChunkDims();
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(_data->chunkDims[i] == chunkDims[i]);
+    } // for
+
     const double tolerance = 1.0e-6;
     double* x = surf.getCoordinatesX();
     if (_data->coordinatesX) {
@@ -213,7 +218,11 @@ geomodelgrids::serial::TestSurface_Data::TestSurface_Data(void) :
     coordinatesX(nullptr),
     coordinatesY(nullptr),
     numX(0),
-    numY(0) {}
+    numY(0) {
+    for (size_t i = 0; i < 3; ++i) {
+        chunkDims[i] = 0;
+    } // for
+}
 
 
 // ------------------------------------------------------------------------------------------------
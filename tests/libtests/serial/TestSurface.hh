@@ -72,6 +72,7 @@ public:
     double* coordinatesY; ///< Coordinages along y axis (only if variable resolution).
     size_t numX; ///< Number of coordinates along x axis.
     size_t numY; ///< Number of coordinates along y axis.
+    size_t chunkDims[3]; ///< Dimensions of chunks in dataset.
 }; // class TestSurface_Data
 
 // End of file
@@ -48,6 +48,9 @@ geomodelgrids::serial::TestSurface_Cases::UniformResolution(void) {
     data->resolutionY = 10.0e+3;
     data->numX = 4;
     data->numY = 5;
+    data->chunkDims[0] = 2;
+    data->chunkDims[1] = 2;
+    data->chunkDims[2] = 1;
 
     return data;
 } // UniformResolution
@@ -78,6 +81,9 @@ geomodelgrids::serial::TestSurface_Cases::VariableResolution(void) {
 
     data->numX = numX;
     data->numY = numY;
+    data->chunkDims[0] = 2;
+    data->chunkDims[1] = 2;
+    data->chunkDims[2] = 1;
 
     data->coordinatesX = const_cast<double*>(x);
     data->coordinatesY = const_cast<double*>(y);
@@ -0,0 +1,210 @@
+/**
+ * C++ unit testing of geomodelgrids::utils::CRSInterpolator.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/utils/CRSInterpolator.hh" // USES CRSInterpolator
+#include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <algorithm> // USES std::max()
+#include <cmath> // USES fabs()
+#include <random> // USES std::mt19937, std::uniform_real_distribution
+
+namespace geomodelgrids {
+    namespace utils {
+        class TestCRSInterpolator;
+    } // utils
+} // geomodelgrids
+
+class geomodelgrids::utils::TestCRSInterpolator {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test initialize().
+    static
+    void testInitialize(void);
+
+    /// Test transform().
+    static
+    void testTransform(void);
+
+    /// Test transform() at random points inside cells against the exact transformation.
+    static
+    void testTransformRandom(void);
+
+}; // class TestCRSInterpolator
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestCRSInterpolator::testConstructor", "[TestCRSInterpolator]") {
+    geomodelgrids::utils::TestCRSInterpolator::testConstructor();
+}
+TEST_CASE("TestCRSInterpolator::testInitialize", "[TestCRSInterpolator]") {
+    geomodelgrids::utils::TestCRSInterpolator::testInitialize();
+}
+TEST_CASE("TestCRSInterpolator::testTransform", "[TestCRSInterpolator]") {
+    geomodelgrids::utils::TestCRSInterpolator::testTransform();
+}
+TEST_CASE("TestCRSInterpolator::testTransformRandom", "[TestCRSInterpolator]") {
+    geomodelgrids::utils::TestCRSInterpolator::testTransformRandom();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::utils::TestCRSInterpolator::testConstructor(void) {
+    CRSInterpolator interpolator;
+
+    CHECK(size_t(0) == interpolator.getNumCells());
+    CHECK(interpolator._values.empty());
+    CHECK(0.0 == interpolator._zSlope[0]);
+    CHECK(0.0 == interpolator._zSlope[1]);
+    CHECK(1.0 == interpolator._zSlope[2]);
+
+    double xyz[3];
+    CHECK_FALSE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], 0.0, 0.0, 0.0));
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize().
+void
+geomodelgrids::utils::TestCRSInterpolator::testInitialize(void) {
+    CRSTransformer transformer;
+    transformer.setSrc("EPSG:4326");
+    transformer.setDest("EPSG:3311");
+    transformer.initialize();
+
+    const double domain[6] = { 35.0, 36.0, -119.0, -118.0, -5.0e+3, 5.0e+3 };
+
+    { // Tolerance met
+        CRSInterpolator interpolator;
+        const double tolerance = 1.0e-3;
+        REQUIRE(interpolator.initialize(&transformer, domain, tolerance));
+        CHECK(interpolator.getNumCells() >= size_t(8));
+        CHECK(interpolator.getMaxError() <= 0.5*tolerance);
+        CHECK(3*(interpolator.getNumCells()+1)*(interpolator.getNumCells()+1) == interpolator._values.size());
+    } // Tolerance met
+
+    { // Tolerance not met with maximum number of cells
+        CRSInterpolator interpolator;
+        CHECK_FALSE(interpolator.initialize(&transformer, domain, 1.0e-9, 16));
+        CHECK(size_t(0) == interpolator.getNumCells());
+        CHECK(interpolator._values.empty());
+        CHECK(interpolator.getMaxError() > 1.0e-9);
+    } // Tolerance not met with maximum number of cells
+
+    { // Bad arguments
+        CRSInterpolator interpolator;
+        CHECK_FALSE(interpolator.initialize(&transformer, domain, 0.0));
+
+        const double domainBad[6] = { 35.0, 35.0, -119.0, -118.0, -5.0e+3, 5.0e+3 };
+        CHECK_FALSE(interpolator.initialize(&transformer, domainBad, 1.0e-3));
+        CHECK(size_t(0) == interpolator.getNumCells());
+    } // Bad arguments
+} // testInitialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Test transform().
+void
+geomodelgrids::utils::TestCRSInterpolator::testTransform(void) {
+    CRSTransformer transformer;
+    transformer.setSrc("EPSG:4326");
+    transformer.setDest("EPSG:3311");
+    transformer.initialize();
+
+    const double domain[6] = { 35.0, 36.0, -119.0, -118.0, -5.0e+3, 5.0e+3 };
+    const double tolerance = 1.0e-3;
+    CRSInterpolator interpolator;
+    REQUIRE(interpolator.initialize(&transformer, domain, tolerance));
+
+    const size_t numPoints = 6;
+    const double pointsLLE[numPoints*3] = {
+        35.0, -119.0, -5.0e+3,
+        36.0, -118.0, 5.0e+3,
+        35.123, -118.456, 0.0,
+        35.5, -118.5, 250.0,
+        35.987, -118.001, -4.0e+3,
+        35.31, -118.77, 1.5e+3,
+    };
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* lle = &pointsLLE[3*iPt];
+        double xyzE[3];
+        transformer.transform(&xyzE[0], &xyzE[1], &xyzE[2], lle[0], lle[1], lle[2]);
+
+        double xyz[3];
+        REQUIRE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], lle[0], lle[1], lle[2]));
+        for (size_t iDim = 0; iDim < 3; ++iDim) {
+            INFO("Mismatch for point (" << lle[0] << ", " << lle[1] << ", " << lle[2] << ") for component " << iDim << ".");
+            CHECK_THAT(xyz[iDim], Catch::Matchers::WithinAbs(xyzE[iDim], tolerance));
+        } // for
+
+        double xy[2];
+        REQUIRE(interpolator.transform(&xy[0], &xy[1], nullptr, lle[0], lle[1], lle[2]));
+        CHECK(xyz[0] == xy[0]);
+        CHECK(xyz[1] == xy[1]);
+    } // for
+
+    // Outside domain
+    double xyz[3];
+    CHECK_FALSE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], 34.9, -118.5, 0.0));
+    CHECK_FALSE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], 35.5, -117.9, 0.0));
+    CHECK_FALSE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], 35.5, -118.5, 6.0e+3));
+} // testTransform
+
+
+// ------------------------------------------------------------------------------------------------
+// Test transform() at random points inside cells against the exact transformation.
+void
+geomodelgrids::utils::TestCRSInterpolator::testTransformRandom(void) {
+    const size_t numCRS = 2;
+    const char* const destCRS[numCRS] = { "EPSG:3311", "EPSG:32611" };
+    const double domain[6] = { 34.8, 36.2, -119.3, -117.7, -10.0e+3, 5.0e+3 };
+    const size_t numTolerances = 3;
+    const double tolerances[numTolerances] = { 1.0, 1.0e-1, 1.0e-2 };
+    const size_t numPoints = 5000;
+
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> randomX(domain[0], domain[1]);
+    std::uniform_real_distribution<double> randomY(domain[2], domain[3]);
+    std::uniform_real_distribution<double> randomZ(domain[4], domain[5]);
+    for (size_t iCRS = 0; iCRS < numCRS; ++iCRS) {
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:4326");
+        transformer.setDest(destCRS[iCRS]);
+        transformer.initialize();
+
+        for (size_t iTolerance = 0; iTolerance < numTolerances; ++iTolerance) {
+            const double tolerance = tolerances[iTolerance];
+            CRSInterpolator interpolator;
+            INFO("Destination CRS " << destCRS[iCRS] << ", tolerance " << tolerance << ".");
+            REQUIRE(interpolator.initialize(&transformer, domain, tolerance));
+
+            double maxError = 0.0;
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                const double lle[3] = { randomX(generator), randomY(generator), randomZ(generator) };
+                double xyzE[3];
+                transformer.transform(&xyzE[0], &xyzE[1], &xyzE[2], lle[0], lle[1], lle[2]);
+
+                double xyz[3];
+                REQUIRE(interpolator.transform(&xyz[0], &xyz[1], &xyz[2], lle[0], lle[1], lle[2]));
+                for (size_t iDim = 0; iDim < 3; ++iDim) {
+                    maxError = std::max(maxError, fabs(xyz[iDim] - xyzE[iDim]));
+                } // for
+            } // for
+            INFO(interpolator.getNumCells() << " cells, measured error " << interpolator.getMaxError() << ".");
+            CHECK(maxError <= tolerance);
+        } // for
+    } // for
+} // testTransformRandom
+
+
+// End of file
@@ -41,6 +41,14 @@ public:
     static
     void testTransform(void);
 
+    /// Test computeAffine().
+    static
+    void testComputeAffine(void);
+
+    /// Test computeAffineZ().
+    static
+    void testComputeAffineZ(void);
+
     /// Test getCRSUnits().
     static
     void testUnits(void);
@@ -63,6 +71,12 @@ TEST_CASE("TestCRSTransformer::testInitialize", "[TestCRSTransformer]") {
 TEST_CASE("TestCRSTransformer::testTransform", "[TestCRSTransformer]") {
     geomodelgrids::utils::TestCRSTransformer::testTransform();
 }
+TEST_CASE("TestCRSTransformer::testComputeAffine", "[TestCRSTransformer]") {
+    geomodelgrids::utils::TestCRSTransformer::testComputeAffine();
+}
+TEST_CASE("TestCRSTransformer::testComputeAffineZ", "[TestCRSTransformer]") {
+    geomodelgrids::utils::TestCRSTransformer::testComputeAffineZ();
+}
 TEST_CASE("TestCRSTransformer::testUnits", "[TestCRSTransformer]") {
     geomodelgrids::utils::TestCRSTransformer::testUnits();
 }
@@ -160,6 +174,137 @@ geomodelgrids::utils::TestCRSTransformer::testTransform(void) {
 } // testTransform
 
 
+// ------------------------------------------------------------------------------------------------
+// Test computeAffine().
+void
+geomodelgrids::utils::TestCRSTransformer::testComputeAffine(void) {
+    double coefsXY[6];
+    double coefsZ[2];
+    const double tolerance = 1.0e-8;
+
+    { // Identical CRS
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:3311");
+        transformer.setDest("EPSG:3311");
+        transformer.initialize();
+
+        const double domain[6] = { -200.0e+3, 0.0, 0.0, 100.0e+3, -25.0e+3, 25.0e+3 };
+        REQUIRE(transformer.computeAffine(coefsXY, coefsZ, domain));
+        const double coefsXYE[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+        for (size_t i = 0; i < 6; ++i) {
+            CHECK(coefsXYE[i] == coefsXY[i]);
+        } // for
+        CHECK(0.0 == coefsZ[0]);
+        CHECK(1.0 == coefsZ[1]);
+    } // Identical CRS
+
+    { // Linear units
+        CRSTransformer transformer;
+        transformer.setSrc("+proj=tmerc +lon_0=-123.0 +lat_0=35.0 +k_0=0.9996 +datum=NAD83 +units=km +type=crs");
+        transformer.setDest("+proj=tmerc +lon_0=-123.0 +lat_0=35.0 +k_0=0.9996 +datum=NAD83 +units=m +type=crs");
+        transformer.initialize();
+
+        const double domain[6] = { -50.0e+3, 50.0e+3, 0.0, 200.0e+3, -25.0e+3, 5.0e+3 };
+        REQUIRE(transformer.computeAffine(coefsXY, coefsZ, domain));
+        const double coefsXYE[6] = { 0.0, 1000.0, 0.0, 0.0, 0.0, 1000.0 };
+        for (size_t i = 0; i < 6; ++i) {
+            INFO("Mismatch for coefficient " << i << ".");
+            CHECK_THAT(coefsXY[i], Catch::Matchers::WithinAbs(coefsXYE[i], tolerance*1000.0));
+        } // for
+        CHECK_THAT(coefsZ[0], Catch::Matchers::WithinAbs(0.0, tolerance));
+        CHECK_THAT(coefsZ[1], Catch::Matchers::WithinAbs(1.0, tolerance));
+    } // Linear units
+
+    { // Axis order
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:4326");
+        transformer.setDest("+proj=longlat +datum=WGS84 +type=crs");
+        transformer.initialize();
+
+        const double domain[6] = { -122.5, -121.0, 36.5, 38.0, -5.0e+3, 5.0e+3 };
+        REQUIRE(transformer.computeAffine(coefsXY, coefsZ, domain));
+        const double coefsXYE[6] = { 0.0, 0.0, 1.0, 0.0, 1.0, 0.0 };
+        for (size_t i = 0; i < 6; ++i) {
+            INFO("Mismatch for coefficient " << i << ".");
+            CHECK_THAT(coefsXY[i], Catch::Matchers::WithinAbs(coefsXYE[i], tolerance));
+        } // for
+    } // Axis order
+
+    { // Map projection
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:4326");
+        transformer.setDest("EPSG:3311");
+        transformer.initialize();
+
+        const double domain[6] = { -200.0e+3, 0.0, 0.0, 100.0e+3, -25.0e+3, 25.0e+3 };
+        CHECK_FALSE(transformer.computeAffine(coefsXY, coefsZ, domain));
+    } // Map projection
+
+    { // Degenerate domain
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:26910");
+        transformer.setDest("+proj=utm +zone=10 +datum=NAD83 +units=km +type=crs");
+        transformer.initialize();
+
+        const double domain[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        CHECK_FALSE(transformer.computeAffine(coefsXY, coefsZ, domain));
+    } // Degenerate domain
+} // testComputeAffine
+
+
+// ------------------------------------------------------------------------------------------------
+// Test computeAffineZ().
+void
+geomodelgrids::utils::TestCRSTransformer::testComputeAffineZ(void) {
+    double coefsZ[2];
+    const double tolerance = 1.0e-8;
+
+    { // Identical CRS
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:3311");
+        transformer.setDest("EPSG:3311");
+        transformer.initialize();
+
+        const double domain[6] = { -200.0e+3, 0.0, 0.0, 100.0e+3, -25.0e+3, 25.0e+3 };
+        REQUIRE(transformer.computeAffineZ(coefsZ, domain));
+        CHECK(0.0 == coefsZ[0]);
+        CHECK(1.0 == coefsZ[1]);
+    } // Identical CRS
+
+    { // Map projection with same datum
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:4326");
+        transformer.setDest("EPSG:32610");
+        transformer.initialize();
+
+        const double domain[6] = { 500.0e+3, 700.0e+3, 4000.0e+3, 4200.0e+3, -25.0e+3, 5.0e+3 };
+        REQUIRE(transformer.computeAffineZ(coefsZ, domain));
+        CHECK_THAT(coefsZ[0], Catch::Matchers::WithinAbs(0.0, tolerance));
+        CHECK_THAT(coefsZ[1], Catch::Matchers::WithinAbs(1.0, tolerance));
+    } // Map projection with same datum
+
+    { // Map projection with datum transformation depending on elevation
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:4326");
+        transformer.setDest("EPSG:3311");
+        transformer.initialize();
+
+        const double domain[6] = { -200.0e+3, 0.0, 0.0, 100.0e+3, -25.0e+3, 25.0e+3 };
+        CHECK_FALSE(transformer.computeAffineZ(coefsZ, domain));
+    } // Map projection with datum transformation depending on elevation
+
+    { // Degenerate domain
+        CRSTransformer transformer;
+        transformer.setSrc("EPSG:26910");
+        transformer.setDest("+proj=utm +zone=10 +datum=NAD83 +units=km +type=crs");
+        transformer.initialize();
+
+        const double domain[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        CHECK_FALSE(transformer.computeAffineZ(coefsZ, domain));
+    } // Degenerate domain
+} // testComputeAffineZ
+
+
 // ------------------------------------------------------------------------------------------------
 // Test getCRSUnits().
 void
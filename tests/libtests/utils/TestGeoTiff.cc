@@ -0,0 +1,263 @@
+/**
+ * C++ unit testing of geomodelgrids::utils::GeoTiff.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/utils/GeoTiff.hh" // USES GeoTiff
+
+#include "gdal/gdal_priv.h" // USES GDALDataset, GDALRasterBand
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <algorithm> // USES std::min()
+#include <fstream> // USES std::ifstream
+#include <sstream> // USES std::ostringstream
+#include <string> // USES std::string
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::invalid_argument, std::out_of_range, std::runtime_error
+
+namespace geomodelgrids {
+    namespace utils {
+        class TestGeoTiff;
+    } // utils
+} // geomodelgrids
+
+class geomodelgrids::utils::TestGeoTiff {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test writing tiled GeoTiff in blocks of rows.
+    static
+    void testTiled(void);
+
+    /// Test writing cloud optimized GeoTiff in blocks of rows.
+    static
+    void testCloudOptimized(void);
+
+    /// Test setTileSize() and writeRows() with bad values.
+    static
+    void testBadValues(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Write image in blocks of rows.
+     *
+     * @param[in] filename Name of image file.
+     * @param[in] tileSize Width and height of tiles.
+     * @param[in] cloudOptimized True to write cloud optimized GeoTiff.
+     */
+    static
+    void _writeImage(const char* filename,
+                     const size_t tileSize,
+                     const bool cloudOptimized);
+
+    /** Read image and check it against the image written by _writeImage().
+     *
+     * @param[in] filename Name of image file.
+     * @param[in] tileSize Expected width and height of tiles.
+     * @param[in] cloudOptimized True if image is expected to be a cloud optimized GeoTiff.
+     */
+    static
+    void _checkImage(const char* filename,
+                     const size_t tileSize,
+                     const bool cloudOptimized);
+
+    /** Compute value of pixel.
+     *
+     * @param[in] iBand Index of raster band.
+     * @param[in] iRow Index of row.
+     * @param[in] iCol Index of column.
+     * @returns Value of pixel.
+     */
+    static
+    float _pixelValue(const size_t iBand,
+                      const size_t iRow,
+                      const size_t iCol);
+
+    static const size_t _numRows;
+    static const size_t _numCols;
+    static const size_t _numBands;
+
+}; // class TestGeoTiff
+
+const size_t geomodelgrids::utils::TestGeoTiff::_numRows = 140;
+const size_t geomodelgrids::utils::TestGeoTiff::_numCols = 300;
+const size_t geomodelgrids::utils::TestGeoTiff::_numBands = 2;
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestGeoTiff::testTiled", "[TestGeoTiff]") {
+    geomodelgrids::utils::TestGeoTiff::testTiled();
+}
+TEST_CASE("TestGeoTiff::testCloudOptimized", "[TestGeoTiff]") {
+    geomodelgrids::utils::TestGeoTiff::testCloudOptimized();
+}
+TEST_CASE("TestGeoTiff::testBadValues", "[TestGeoTiff]") {
+    geomodelgrids::utils::TestGeoTiff::testBadValues();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test writing tiled GeoTiff in blocks of rows.
+void
+geomodelgrids::utils::TestGeoTiff::testTiled(void) {
+    const size_t tileSize = 32;
+    _writeImage("geotiff_tiled.tiff", tileSize, false);
+    _checkImage("geotiff_tiled.tiff", tileSize, false);
+} // testTiled
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing cloud optimized GeoTiff in blocks of rows.
+void
+geomodelgrids::utils::TestGeoTiff::testCloudOptimized(void) {
+    const size_t tileSize = 128;
+    _writeImage("geotiff_cog.tiff", tileSize, true);
+    _checkImage("geotiff_cog.tiff", tileSize, true);
+
+    std::ifstream sin("geotiff_cog.tiff.tmp.tif");
+    CHECK(!sin.is_open());
+} // testCloudOptimized
+
+
+// ------------------------------------------------------------------------------------------------
+// Test setTileSize() and writeRows() with bad values.
+void
+geomodelgrids::utils::TestGeoTiff::testBadValues(void) {
+    GeoTiff geotiff;
+    CHECK_THROWS_AS(geotiff.setTileSize(20), std::invalid_argument);
+
+    const std::vector<float> rows(_numBands*_numCols);
+    CHECK_THROWS_AS(geotiff.writeRows(rows.data(), 0, 1), std::runtime_error);
+
+    geotiff.setNumRows(_numRows);
+    geotiff.setNumCols(_numCols);
+    geotiff.setNumBands(_numBands);
+    geotiff.setBandLabels(std::vector<std::string>(_numBands, "a"));
+    geotiff.setCRS("EPSG:4326");
+    geotiff.setBBox(-120.0, -119.0, 35.0, 35.7);
+    geotiff.create("geotiff_bad.tiff");
+    CHECK_THROWS_AS(geotiff.writeRows(rows.data(), _numRows, 1), std::out_of_range);
+    geotiff.close();
+
+    geotiff.setTileSize(64);
+    geotiff.setCloudOptimized(true);
+    CHECK_THROWS_AS(geotiff.create("geotiff_bad.tiff"), std::invalid_argument);
+} // testBadValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Write image in blocks of rows.
+void
+geomodelgrids::utils::TestGeoTiff::_writeImage(const char* filename,
+                                               const size_t tileSize,
+                                               const bool cloudOptimized) {
+    GeoTiff writer;
+    writer.setNumRows(_numRows);
+    writer.setNumCols(_numCols);
+    writer.setNumBands(_numBands);
+    std::vector<std::string> labels(_numBands);
+    for (size_t iBand = 0; iBand < _numBands; ++iBand) {
+        std::ostringstream label;
+        label << "band" << iBand;
+        labels[iBand] = label.str();
+    } // for
+    writer.setBandLabels(labels);
+    writer.setCRS("EPSG:4326");
+    writer.setBBox(-120.0, -119.0, 35.0, 35.7);
+    writer.setTileSize(tileSize);
+    writer.setCloudOptimized(cloudOptimized);
+    writer.create(filename);
+
+    // Blocks of rows match the tiles, with a partial block at the bottom of the image.
+    std::vector<float> rows(_numBands*tileSize*_numCols);
+    for (size_t rowStart = 0; rowStart < _numRows; rowStart += tileSize) {
+        const size_t numRows = std::min(tileSize, _numRows - rowStart);
+        for (size_t iBand = 0, index = 0; iBand < _numBands; ++iBand) {
+            for (size_t iRow = 0; iRow < numRows; ++iRow) {
+                for (size_t iCol = 0; iCol < _numCols; ++iCol, ++index) {
+                    rows[index] = _pixelValue(iBand, rowStart+iRow, iCol);
+                } // for
+            } // for
+        } // for
+        writer.writeRows(rows.data(), rowStart, numRows);
+    } // for
+    writer.close();
+} // _writeImage
+
+
+// ------------------------------------------------------------------------------------------------
+// Read image and check it against the image written by _writeImage().
+void
+geomodelgrids::utils::TestGeoTiff::_checkImage(const char* filename,
+                                               const size_t tileSize,
+                                               const bool cloudOptimized) {
+    GeoTiff reader;
+    reader.read(filename);
+
+    REQUIRE(_numRows == reader.getNumRows());
+    REQUIRE(_numCols == reader.getNumCols());
+    REQUIRE(_numBands == reader.getNumBands());
+
+    const std::vector<std::string>& labels = reader.getBandLabels();
+    REQUIRE(_numBands == labels.size());
+    CHECK(std::string("band0") == labels[0]);
+    CHECK(std::string("band1") == labels[1]);
+
+    const double tolerance = 1.0e-10;
+    double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+    reader.getBBox(&minX, &maxX, &minY, &maxY);
+    CHECK_THAT(minX, Catch::Matchers::WithinAbs(-120.0, tolerance));
+    CHECK_THAT(maxX, Catch::Matchers::WithinAbs(-119.0, tolerance));
+    CHECK_THAT(minY, Catch::Matchers::WithinAbs(35.0, tolerance));
+    CHECK_THAT(maxY, Catch::Matchers::WithinAbs(35.7, tolerance));
+
+    // Layout of file.
+    REQUIRE(reader._dataset);
+    for (size_t iBand = 0; iBand < _numBands; ++iBand) {
+        GDALRasterBand* band = reader._dataset->GetRasterBand(iBand+1);REQUIRE(band);
+        int blockXSize = 0;
+        int blockYSize = 0;
+        band->GetBlockSize(&blockXSize, &blockYSize);
+        CHECK(int(tileSize) == blockXSize);
+        CHECK(int(tileSize) == blockYSize);
+        if (cloudOptimized) {
+            CHECK(band->GetOverviewCount() > 0);
+        } else {
+            CHECK(0 == band->GetOverviewCount());
+        } // if/else
+    } // for
+    const char* layout = reader._dataset->GetMetadataItem("LAYOUT", "IMAGE_STRUCTURE");
+    if (cloudOptimized) {
+        REQUIRE(layout);
+        CHECK(std::string("COG") == layout);
+    } else {
+        CHECK(!layout);
+    } // if/else
+
+    // Image data is band sequential [band, row, column].
+    const float* bands = reader.getBands();
+    for (size_t iBand = 0, index = 0; iBand < _numBands; ++iBand) {
+        for (size_t iRow = 0; iRow < _numRows; ++iRow) {
+            for (size_t iCol = 0; iCol < _numCols; ++iCol, ++index) {
+                INFO("Mismatch for band " << iBand << ", row " << iRow << ", column " << iCol << ".");
+                CHECK(_pixelValue(iBand, iRow, iCol) == bands[index]);
+            } // for
+        } // for
+    } // for
+    reader.close();
+} // _checkImage
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute value of pixel.
+float
+geomodelgrids::utils::TestGeoTiff::_pixelValue(const size_t iBand,
+                                               const size_t iRow,
+                                               const size_t iCol) {
+    return float(1000*iBand + 10*iRow) + 0.25f*float(iCol);
+} // _pixelValue
+
+
+// End of file
@@ -9,7 +9,9 @@
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
-#include <cmath> // USES fabs()
+#include <cmath> // USES fabs(), pow(), floor()
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::min()
 
 namespace geomodelgrids {
     namespace utils {
@@ -33,6 +35,10 @@ public:
     static
     void testVariableDescending(void);
 
+    /// Test indexing for variable resolution with widely varying spacing.
+    static
+    void testVariableGraded(void);
+
 }; // class TestIndexing
 
 // ------------------------------------------------------------------------------------------------
@@ -45,6 +51,9 @@ TEST_CASE("TestIndexing::testVariableAscending", "[TestIndexing]") {
 TEST_CASE("TestIndexing::testVariableDescending", "[TestIndexing]") {
     geomodelgrids::utils::TestIndexing::testVariableDescending();
 }
+TEST_CASE("TestIndexing::testVariableGraded", "[TestIndexing]") {
+    geomodelgrids::utils::TestIndexing::testVariableGraded();
+}
 
 // ------------------------------------------------------------------------------------------------
 void
@@ -105,4 +114,43 @@ geomodelgrids::utils::TestIndexing::testVariableDescending(void) {
 } // testVariableDescending
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::TestIndexing::testVariableGraded(void) {
+    const double tolerance = 1.0e-6;
+
+    // Spacing grows geometrically, so many coordinates share a bucket near the beginning.
+    const size_t numX = 300;
+    std::vector<double> x(numX);
+    x[0] = 0.0;
+    for (size_t i = 1; i < numX; ++i) {
+        x[i] = x[i-1] + 0.1 * pow(1.03, double(i));
+    } // for
+    const double length = x[numX-1];
+
+    IndexingVariable indexingAsc(&x[0], numX);
+    IndexingVariable indexingDesc(&x[0], numX, IndexingVariable::DESCENDING);
+
+    const size_t numPoints = 20000;
+    for (size_t iPt = 0; iPt <= numPoints; ++iPt) {
+        const double distance = length * double(iPt) / double(numPoints);
+
+        // Expected index from linear search.
+        size_t indexL = 0;
+        while ((indexL+2 < numX) && (distance >= x[indexL+1])) {
+            ++indexL;
+        } // while
+        const double indexE = double(indexL) + (distance - x[indexL]) / (x[indexL+1] - x[indexL]);
+        INFO("Mismatch for distance " << distance << ".");
+        CHECK_THAT(indexingAsc.getIndex(distance), Catch::Matchers::WithinAbs(indexE, tolerance));
+
+        // Descending coordinates measure distance from the largest coordinate.
+        const double indexDesc = indexingDesc.getIndex(distance);
+        const size_t iDesc = size_t(std::min(floor(indexDesc), double(numX-2)));
+        const double xDesc = x[numX-1-iDesc] + (indexDesc - double(iDesc)) * (x[numX-2-iDesc] - x[numX-1-iDesc]);
+        CHECK_THAT(xDesc, Catch::Matchers::WithinAbs(length - distance, tolerance*length));
+    } // for
+} // testVariableGraded
+
+
 // End of file
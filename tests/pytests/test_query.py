@@ -161,6 +161,126 @@ class TestQuery(unittest.TestCase):
         self.assertLess(diff, 1.0e-6)
         assert numpy.sum(err) == 0
 
+    def test_query_single_precision(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 0.0],
+            [37.479, -121.734, -5.0e+3],
+            [35.3, -118.2, -3.0e+3],
+            [34.7, -117.5, -40.0e+3],
+        ])
+        valuesE, errE = self.query.query(POINTS)
+
+        query = geomodelgrids.Query()
+        query.set_single_precision(True)
+        query.initialize(self.FILENAMES, self.VALUES, self.CRS)
+        values, err = query.query(POINTS)
+        query.finalize()
+
+        diff = numpy.sum(numpy.abs(numpy.array(values) - valuesE)/numpy.abs(valuesE))
+        self.assertLess(diff, 1.0e-6)
+        assert numpy.all(err == errE)
+
+    def test_query_transform_tolerance(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 0.0],
+            [37.479, -121.734, -5.0e+3],
+            [35.3, -118.2, -3.0e+3],
+            [34.7, -117.5, -40.0e+3],
+        ])
+        valuesE, errE = self.query.query(POINTS)
+
+        query = geomodelgrids.Query()
+        query.set_transform_tolerance(1.0e-3)
+        query.initialize(self.FILENAMES, self.VALUES, self.CRS)
+        values, err = query.query(POINTS)
+        query.finalize()
+
+        self.assertTrue(numpy.allclose(values, valuesE, rtol=1.0e-6))
+        assert numpy.all(err == errE)
+
+    def test_query_threads(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 0.0],
+            [37.479, -121.734, -5.0e+3],
+            [37.381, -121.581, -3.0e+3],
+            [35.3, -118.2, -3.0e+3],
+            [35.5, -117.9, -45.0e+3],
+            [34.7, -117.5, -40.0e+3],
+            [-37.479, +121.734, -5.0e+3],
+        ])
+        valuesE, errE = self.query.query(POINTS)
+        elevE = self.query.query_top_elevation(POINTS[:,0:2])
+        groundE = self.query.query_topobathy_elevation(POINTS[:,0:2])
+
+        for num_threads in [0, 2, 4, 16]:
+            values, err = self.query.query(POINTS, num_threads=num_threads)
+            self.assertTrue(numpy.allclose(values, valuesE, rtol=1.0e-10))
+            assert numpy.all(err == errE)
+
+            elev = self.query.query_top_elevation(POINTS[:,0:2], num_threads=num_threads)
+            self.assertTrue(numpy.allclose(elev, elevE, rtol=1.0e-10))
+
+            ground = self.query.query_topobathy_elevation(POINTS[:,0:2], num_threads=num_threads)
+            self.assertTrue(numpy.allclose(ground, groundE, rtol=1.0e-10))
+
+        out = numpy.zeros(valuesE.shape)
+        values, err = self.query.query(POINTS, out=out, num_threads=2)
+        self.assertIs(values, out)
+        self.assertTrue(numpy.allclose(out, valuesE, rtol=1.0e-10))
+
+        out = numpy.zeros(elevE.shape)
+        elev = self.query.query_top_elevation(POINTS[:,0:2], out=out, num_threads=2)
+        self.assertIs(elev, out)
+        self.assertTrue(numpy.allclose(out, elevE, rtol=1.0e-10))
+
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=numpy.zeros((2, 2)))
+
+        # Single precision values are double precision values rounded to float32.
+        out = numpy.zeros(valuesE.shape, dtype=numpy.float32)
+        values, err = self.query.query(POINTS, out=out, num_threads=2)
+        self.assertIs(values, out)
+        self.assertTrue(numpy.array_equal(out, valuesE.astype(numpy.float32)))
+        self.assertTrue(numpy.array_equal(err, errE))
+
+        values, err = self.query.query(POINTS, num_threads=2, dtype=numpy.float32)
+        self.assertEqual(numpy.float32, values.dtype)
+        self.assertTrue(numpy.array_equal(values, valuesE.astype(numpy.float32)))
+
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=numpy.zeros(valuesE.shape), dtype=numpy.float32)
+        self.assertRaises(RuntimeError, self.query.query, POINTS, dtype=numpy.int32)
+        self.assertRaises(RuntimeError, self.query.query, POINTS, out=numpy.zeros(valuesE.shape, order="F"))
+
+        # Thread contexts are recreated for the new models after initializing again.
+        self.query.finalize()
+        self.query.initialize(self.FILENAMES[0:1], self.VALUES, self.CRS)
+        valuesE, errE = self.query.query(POINTS)
+        values, err = self.query.query(POINTS, num_threads=4)
+        self.assertTrue(numpy.allclose(values, valuesE, rtol=1.0e-10))
+        assert numpy.all(err == errE)
+
+    def test_query_io_profile(self):
+        POINTS = numpy.array([
+            [37.455, -121.941, 0.0],
+            [37.479, -121.734, -5.0e+3],
+            [35.3, -118.2, -3.0e+3],
+            [34.7, -117.5, -40.0e+3],
+        ])
+        valuesE, errE = self.query.query(POINTS)
+
+        for profile in ["borehole", "grid", "chunk_cache_size=1M,block_hyperslab=2x2x0,surface_hyperslab=2x2"]:
+            query = geomodelgrids.Query()
+            query.set_io_profile(profile)
+            query.initialize(self.FILENAMES, self.VALUES, self.CRS)
+            values, err = query.query(POINTS)
+            query.finalize()
+
+            self.assertTrue(numpy.allclose(values, valuesE, rtol=1.0e-10))
+            assert numpy.all(err == errE)
+
+        query = geomodelgrids.Query()
+        with self.assertRaises(ValueError):
+            query.set_io_profile("unknown")
+
     def test_query_squashed(self):
         POINTS = numpy.array([
             # one-block-squashed